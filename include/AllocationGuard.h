@@ -0,0 +1,57 @@
+// Class for checking that no heap allocation occurs within a region of code, such as the
+// evaluation of the models and of the likelihood. The state of the check is kept separately for each 
+// thread, so that several threads can evaluate the likelihood at the same time. The check is only active
+// if the code is compiled with the CMake option DEBUG_ALLOCATIONS, otherwise the class does nothing.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "AllocationGuard.h"
+// Implementations contained in "AllocationGuard.cpp"
+
+
+#ifndef ALLOCATIONGUARD_H
+#define ALLOCATIONGUARD_H
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <Eigen/Dense>
+
+using namespace std;
+
+
+class AllocationGuard
+{
+    public:
+    
+        AllocationGuard(const char *regionName);
+        ~AllocationGuard();
+
+        static unsigned long getNallocations();
+
+
+        // Scope within which heap allocations are permitted inside a guarded region, 
+        // as for the first allocation of the scratch buffers
+
+        class Permission
+        {
+            public:
+
+                Permission();
+                ~Permission();
+        };
+
+
+    protected:
+
+
+    private:
+
+        const char *regionName;
+        const char *previousRegionName;
+        unsigned long initialNallocations;
+
+}; 
+
+
+#endif
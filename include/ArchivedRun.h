@@ -0,0 +1,48 @@
+// Class for reading the output files of a previous run, whether they are kept in the output folder
+// of the run or have been collected into the archive of its results (see ResultsArchive.h). In the
+// latter case the archive is extracted into a temporary directory, which is removed together with
+// the object, so that the archive remains the only copy of the output files of the run.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "ArchivedRun.h"
+// Implementations contained in "ArchivedRun.cpp"
+
+
+#ifndef ARCHIVEDRUN_H
+#define ARCHIVEDRUN_H
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "ResultsArchive.h"
+
+using namespace std;
+
+
+class ArchivedRun
+{
+    public:
+
+        ArchivedRun(const string runPathPrefix);
+        ~ArchivedRun();
+
+        string getPathPrefix();
+
+
+    protected:
+
+
+    private:
+
+        string pathPrefix;
+        string temporaryDirectoryName;
+        vector<string> extractedFileNames;
+
+};
+
+
+#endif
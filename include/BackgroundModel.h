@@ -9,13 +9,24 @@
 #define BACKGROUNDMODEL_H
 
 #include <iostream>
+#include <limits>
+#include <new>
+#include <string>
+#include <vector>
 #include "Model.h"
 #include "Functions.h"
 #include "File.h"
+#include "VectorKernels.h"
+#include "ScratchArena.h"
 
 using namespace std;
 using Eigen::ArrayXd;
+using Eigen::ArrayXf;
+using Eigen::ArrayXXd;
 typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+typedef Eigen::Ref<const Eigen::ArrayXd> ConstRefArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXXd> RefArrayXXd;
+typedef Eigen::Ref<Eigen::ArrayXf> RefArrayXf;
 
 
 class BackgroundModel : public Model
@@ -23,23 +34,85 @@ class BackgroundModel : public Model
     public:
     
         BackgroundModel(const RefArrayXd covariates);
-        ~BackgroundModel();
+        virtual ~BackgroundModel();
         
+        ArrayXd getCovariates();
         ArrayXd getResponseFunction();
         double getNyquistFrequency();
+        bool isUniformGridActive();
+        bool isSinglePrecisionActive();
 
         void readNyquistFrequencyFromFile(const string inputFileName);
+        void setNyquistFrequency(const double inputNyquistFrequency);
+        void shareResponseFunction(const Eigen::Map<const ArrayXd> &sharedResponseFunction);
+        static ArrayXd computeResponseFunction(const ConstRefArrayXd frequencies, const double NyquistFrequency);
+        bool activateUniformGrid(const double relativeTolerance = 1.e-6);
+        void activateSinglePrecision();
         virtual void predict(RefArrayXd predictions, RefArrayXd const modelParameters) = 0;
+        virtual void predictSinglePrecision(RefArrayXf predictions, RefArrayXd const modelParameters) = 0;
         virtual void computeVariance(RefArrayXd modelVariance, const RefArrayXd modelParameters){};
+        vector<string> getComponentNames();
+        void predictComponents(RefArrayXd predictions, RefArrayXXd componentPredictions, RefArrayXd const modelParameters);
 
     protected:
 
         double NyquistFrequency;
-        ArrayXd responseFunction;
+
+
+        // The response function is accessed through a map, which refers either to the array
+        // owned by the model, or to a read-only array shared among processes (see SpectrumCache.h)
+
+        Eigen::Map<const ArrayXd> responseFunction;
+
+        void updateResponseFunction();
+        void addComponent(const string componentName, const int scaleParameterIndex);
+
+
+        // Implicit uniform frequency grid, defined by its starting frequency, frequency resolution
+        // and number of bins. The response function is stored in single precision only if the
+        // single-precision mode is active.
+
+        bool uniformGrid;
+        double gridStartingFrequency;
+        double gridFrequencyResolution;
+        unsigned long gridNbins;
+        ArrayXf compressedResponseFunction;
+
+        ArrayXd::RandomAccessLinSpacedReturnType gridCovariates();
+        ArrayXf::RandomAccessLinSpacedReturnType singlePrecisionGridCovariates();
+
+
+        // Single-precision storage of the covariates, used in place of the double-precision 
+        // covariates when the single-precision mode is active
+
+        bool singlePrecision;
+        ArrayXf singlePrecisionCovariates;
+
+
+        // Workspace for the terms of the model that are computed by the vectorized kernels, in addition
+        // to the array of the predictions. The workspace is taken from the scratch arena of the calling thread.
+
+        template <typename Scalar>
+        Eigen::Map<Eigen::Array<Scalar, Eigen::Dynamic, 1> > getWorkspace(const long Nbins);
 
     private:
 
+        ArrayXd ownedResponseFunction;
+
+
+        // Additive components of the model, each one identified by the free parameter
+        // that scales it, so that the component vanishes when the parameter is zero
+
+        vector<string> componentNames;
+        vector<int> componentScaleParameters;
+
+        void releaseResponseFunction();
+
 }; 
 
 
+template <> Eigen::Map<ArrayXd> BackgroundModel::getWorkspace<double>(const long Nbins);
+template <> Eigen::Map<ArrayXf> BackgroundModel::getWorkspace<float>(const long Nbins);
+
+
 #endif
@@ -0,0 +1,54 @@
+// Class for creating the background models implemented in the Background code 
+// from their reference name given at runtime.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "BackgroundModelRegistry.h"
+// Implementations contained in "BackgroundModelRegistry.cpp"
+
+
+#ifndef BACKGROUNDMODELREGISTRY_H
+#define BACKGROUNDMODELREGISTRY_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "BackgroundModel.h"
+#include "ThreeHarveyColorBackgroundModel.h"
+#include "ThreeHarveyColorNoGaussianBackgroundModel.h"
+#include "ThreeHarveyBackgroundModel.h"
+#include "ThreeHarveyNoGaussianBackgroundModel.h"
+#include "TwoHarveyColorBackgroundModel.h"
+#include "TwoHarveyBackgroundModel.h"
+#include "TwoHarveyNoGaussianBackgroundModel.h"
+#include "OneHarveyColorBackgroundModel.h"
+#include "OneHarveyBackgroundModel.h"
+#include "OneHarveyFreeSlopeBackgroundModel.h"
+#include "OneHarveyFreeSlopeNoGaussianBackgroundModel.h"
+#include "OneHarveyNoGaussianBackgroundModel.h"
+#include "OriginalBackgroundModel.h"
+#include "FlatBackgroundModel.h"
+#include "FlatNoGaussianBackgroundModel.h"
+
+using namespace std;
+using Eigen::ArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class BackgroundModelRegistry
+{
+    public:
+    
+        static BackgroundModel * createModel(const string backgroundModelName, const RefArrayXd covariates, 
+                                             const string inputNyquistFrequencyFileName);
+        static vector<string> getParameterNames(const string backgroundModelName);
+
+
+    protected:
+
+
+    private:
+
+}; 
+
+
+#endif
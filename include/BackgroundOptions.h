@@ -0,0 +1,49 @@
+// Class for reading optional configuring options of a Background run.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "BackgroundOptions.h"
+// Implementations contained in "BackgroundOptions.cpp"
+
+
+#ifndef BACKGROUNDOPTIONS_H
+#define BACKGROUNDOPTIONS_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include "File.h"
+
+using namespace std;
+
+
+class BackgroundOptions
+{
+    public:
+    
+        BackgroundOptions(const string inputFileName);
+        ~BackgroundOptions();
+        
+        bool isAvailable();
+        bool isDefined(const string optionName);
+        string getString(const string optionName, const string defaultValue);
+        double getDouble(const string optionName, const double defaultValue);
+        int getInt(const string optionName, const int defaultValue);
+        void printOptions();
+
+
+    protected:
+
+        map<string, string> options;
+
+
+    private:
+
+        bool optionsFileIsAvailable;
+
+}; 
+
+
+#endif
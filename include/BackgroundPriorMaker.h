@@ -0,0 +1,68 @@
+// Class for building the uniform priors of the background models from a raw guess of nuMax,
+// with the same scaling relations and dataset-based estimates of the routine set_background_priors
+// of tutorials/background.py, so that a fit can start without the files of the prior boundaries
+// and of the configuring parameters. The boundaries are rounded to the same four significant digits
+// written by the python routine, and can also be written into files with the same format.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "BackgroundPriorMaker.h"
+// Implementations contained in "BackgroundPriorMaker.cpp"
+
+
+#ifndef BACKGROUNDPRIORMAKER_H
+#define BACKGROUNDPRIORMAKER_H
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <algorithm>
+#include <Eigen/Dense>
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+typedef Eigen::Ref<const Eigen::ArrayXd> ConstRefArrayXd;
+
+
+class BackgroundPriorMaker
+{
+    public:
+
+        BackgroundPriorMaker(const ConstRefArrayXd frequencies, const ConstRefArrayXd spectralDensity, const double nuMax);
+        ~BackgroundPriorMaker();
+
+        ArrayXXd getBoundaries(const string backgroundModelName);
+        void writeBoundariesToFile(const string fileName, const string backgroundModelName);
+
+        static ArrayXd getNSMCconfiguringParameters();
+        static ArrayXd getXmeansConfiguringParameters();
+        static void writeConfiguringParametersToFile(const string fileName, const ArrayXd &configuringParameters,
+                                                     const int Ndecimals);
+        static string formatShortest(const double value);
+
+
+    protected:
+
+
+    private:
+
+        map<string, pair<double, double> > ranges;
+
+        double smoothedMaximum(const ConstRefArrayXd frequencies, const ConstRefArrayXd spectralDensity, const int windowLength,
+                               const double lowerFrequency, const double upperFrequency);
+        static double maximumInRange(const ConstRefArrayXd frequencies, const ConstRefArrayXd spectralDensity,
+                                     const double lowerFrequency, const double upperFrequency);
+        static vector<string> getComponents(const string backgroundModelName);
+        static double roundToFileDigits(const double value);
+
+};
+
+
+#endif
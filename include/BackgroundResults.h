@@ -0,0 +1,59 @@
+// Derived class for writing the results of a Background run, in addition to
+// the ASCII output provided by the class Results. The ASCII files of the posterior sample
+// are written with the same content of the class Results, but through a fast buffered writer,
+// and the summary of the parameters is computed for all the parameters in parallel.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "BackgroundResults.h"
+// Implementations contained in "BackgroundResults.cpp"
+
+
+#ifndef BACKGROUNDRESULTS_H
+#define BACKGROUNDRESULTS_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include "Results.h"
+#include "NestedSampler.h"
+#include "NpyFile.h"
+#include "TextFileWriter.h"
+#include "File.h"
+#include "ParameterSummary.h"
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+
+
+class BackgroundResults : public Results
+{
+    public:
+    
+        BackgroundResults(NestedSampler &nestedSampler);
+        ~BackgroundResults();
+
+        ArrayXXd getSampleColumns();
+        void writeSamplesToNpyFile(string fileName);
+        void writeParametersToFile(string fileName, string outputFileExtension = ".txt");
+        void writeLogLikelihoodToFile(string fileName);
+        void writeLogWeightsToFile(string fileName);
+        void writePosteriorProbabilityToFile(string fileName);
+        void writeParametersSummaryToFile(string fileName, const double credibleLevel = 68.3, 
+                                          const bool writeMarginalDistributionToFile = false, const int Nthreads = 1);
+        static ArrayXXd readSampleColumns(const string runPathPrefix);
+
+
+    protected:
+
+        NestedSampler &backgroundNestedSampler;
+
+
+    private:
+
+}; 
+
+
+#endif
@@ -0,0 +1,50 @@
+// Derived class for evaluating a model averaged over the width of each bin of a
+// rebinned power spectrum, instead of at the central frequency of the bin.
+// The average is computed by Gauss-Legendre quadrature, by evaluating an integrand model
+// on a set of nodes placed within each bin.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "BinIntegratedModel.h"
+// Implementations contained in "BinIntegratedModel.cpp"
+
+
+#ifndef BININTEGRATEDMODEL_H
+#define BININTEGRATEDMODEL_H
+
+#include <iostream>
+#include <Eigen/Dense>
+#include "Model.h"
+#include "ScratchArena.h"
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class BinIntegratedModel : public Model
+{
+    public:
+    
+        BinIntegratedModel(const RefArrayXd covariates, const RefArrayXd binWidths, const int NnodesPerBin);
+        ~BinIntegratedModel();
+        
+        ArrayXd getNodeCovariates();
+        void setIntegrandModel(Model *newIntegrandModel);
+        virtual void predict(RefArrayXd predictions, RefArrayXd const modelParameters);
+
+
+    protected:
+
+        int NnodesPerBin;
+        ArrayXd nodeCovariates;
+        ArrayXd nodeWeights;
+        Model *integrandModel;
+
+
+    private:
+
+}; 
+
+
+#endif
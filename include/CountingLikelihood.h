@@ -0,0 +1,47 @@
+// Derived class for counting the evaluations of a likelihood, e.g. to compare the cost of the levels
+// of a multi-fidelity schedule (see FidelityLadder.h). Each evaluation is forwarded to the wrapped likelihood.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "CountingLikelihood.h"
+// Implementations contained in "CountingLikelihood.cpp"
+
+
+#ifndef COUNTINGLIKELIHOOD_H
+#define COUNTINGLIKELIHOOD_H
+
+#include <iostream>
+#include "Likelihood.h"
+#include "Model.h"
+
+using namespace std;
+using Eigen::ArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class CountingLikelihood : public Likelihood
+{
+    public:
+    
+        CountingLikelihood(Likelihood &likelihood, Model &model);
+        ~CountingLikelihood();
+        
+        virtual double logValue(RefArrayXd const modelParameters);
+        long getNevaluations();
+
+
+    protected:
+
+
+    private:
+
+        Likelihood &likelihood;
+        long Nevaluations;
+
+        // The observations are held by the wrapped likelihood only
+
+        static ArrayXd noObservations;
+
+}; 
+
+
+#endif
@@ -0,0 +1,23 @@
+// Configuration of Eigen for the allocation checks of class AllocationGuard. This header is included
+// before any other one when the code is compiled with the CMake option DEBUG_ALLOCATIONS.
+// Eigen checks each of its heap allocations by means of an assertion on a flag that is shared by all
+// the threads (EIGEN_RUNTIME_NO_MALLOC). The assertion is redirected here to a function that checks
+// the state of the calling thread instead, so that threads evaluating the likelihood at the same time
+// do not interfere with each other.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "EigenAllocationCheck.h"
+// Implementations contained in "AllocationGuard.cpp"
+
+
+#ifndef EIGENALLOCATIONCHECK_H
+#define EIGENALLOCATIONCHECK_H
+
+#define EIGEN_RUNTIME_NO_MALLOC
+#define eigen_assert(x) ((x) ? static_cast<void>(0) : checkEigenAssertion(#x, __FILE__, __LINE__))
+
+
+void checkEigenAssertion(const char *condition, const char *fileName, const int line);
+
+
+#endif
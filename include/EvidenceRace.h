@@ -0,0 +1,79 @@
+// Class for racing several background models of the same star against each other, while they are fitted
+// by concurrent processes. Each run posts the lower and upper bounds of its log-evidence to a race board
+// shared by all the runs, namely an ASCII file locked during each update. A run is dominated, and can be
+// stopped, when its upper bound is below the largest lower bound of the other runs by more than a given
+// margin in natural logarithm of the Bayes factor, since it can no longer reach the evidence of the leader.
+// The upper bound adds the remaining prior mass times the largest likelihood of the live points, which only
+// bounds the remainder once the live points have reached the bulk of the posterior. A run is therefore only
+// tested for domination when it is close to termination, i.e. when the ratio of the estimated remainder
+// to the evidence accumulated so far is below a given threshold.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "EvidenceRace.h"
+// Implementations contained in "EvidenceRace.cpp"
+
+
+#ifndef EVIDENCERACE_H
+#define EVIDENCERACE_H
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+
+using namespace std;
+
+
+class EvidenceRace
+{
+    public:
+
+        // One entry of the race board, for each run taking part in the race
+
+        struct Entry
+        {
+            string runNumber;
+            string backgroundModelName;
+            string status;
+            double lowerLogEvidence;
+            double upperLogEvidence;
+            int Niterations;
+        };
+
+        EvidenceRace(const string fileName, const string runNumber, const string backgroundModelName, const double margin,
+                     const double maxRemainderRatio);
+        ~EvidenceRace();
+
+        bool isDominated(const double lowerLogEvidence, const double upperLogEvidence, const int Niterations);
+        void finish(const double logEvidence, const int Niterations, const bool aborted);
+        double getMargin();
+        Entry getLeader();
+        static vector<Entry> readBoard(const string fileName);
+
+
+    protected:
+
+
+    private:
+
+        string fileName;
+        Entry ownEntry;
+        Entry leader;
+        double margin;
+        double maxRemainderRatio;
+
+        vector<Entry> updateBoard();
+        static vector<Entry> parseBoard(const string &content);
+        static string readContent(const int fileDescriptor);
+
+};
+
+
+#endif
@@ -0,0 +1,101 @@
+// Class for a multi-fidelity schedule of the likelihood of a background fit. The nested sampling explores the
+// prior with the likelihood of the dataset rebinned by a large factor, which is cheaper by the same factor and
+// still correct for the averaged bins (see GammaLikelihood.h), but broader than that of the full dataset. 
+// The resolution is then refined level by level, each time dividing the rebinning factor by the same amount down
+// to the full dataset, by moving the posterior sample of each level to the next one with SMC tempering 
+// (see TemperedRefitter.h). The evidence and the posterior of the last level are those of the full dataset,
+// while most of the likelihood evaluations are made on the coarse levels.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "FidelityLadder.h"
+// Implementations contained in "FidelityLadder.cpp"
+
+
+#ifndef FIDELITYLADDER_H
+#define FIDELITYLADDER_H
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include "Prior.h"
+#include "Likelihood.h"
+#include "GammaLikelihood.h"
+#include "SinglePrecisionLikelihood.h"
+#include "CountingLikelihood.h"
+#include "BackgroundModel.h"
+#include "BackgroundModelRegistry.h"
+#include "SpectrumRebinner.h"
+#include "PreviousRun.h"
+#include "TemperedRefitter.h"
+#include "NestedSampler.h"
+#include "ResultsWriter.h"
+#include "File.h"
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+typedef Eigen::Ref<const Eigen::ArrayXd> ConstRefArrayXd;
+
+
+class FidelityLadder
+{
+    public:
+
+        FidelityLadder(const string backgroundModelName, const ConstRefArrayXd covariates, const ConstRefArrayXd observations, 
+                       const double NyquistFrequency, const int Nlevels, const int rebinningFactor, 
+                       const bool singlePrecision, Likelihood &likelihood, Model &model);
+        ~FidelityLadder();
+
+        Likelihood &getCoarsestLikelihood();
+        Likelihood &getFullLikelihood();
+        bool refine(vector<Prior*> ptrPriors, const ArrayXXd &posteriorSample, const ArrayXd &logLikelihoodOfPosteriorSample,
+                    const ArrayXd &logWeightOfPosteriorSample, const double logEvidence, const double logEvidenceError, 
+                    const double informationGain, const int Nparticles, const int NmovesPerStep, const int maxNsteps);
+        bool refine(NestedSampler &nestedSampler, vector<Prior*> ptrPriors, const int Nparticles, 
+                    const int NmovesPerStep, const int maxNsteps);
+        ArrayXXd getPosteriorSample();
+        ArrayXd getLogLikelihoodOfPosteriorSample();
+        ArrayXd getLogWeightOfPosteriorSample();
+        double getLogEvidence();
+        double getLogEvidenceError();
+        double getInformationGain();
+        string getFailureReason();
+        int getNlevels();
+        long getNbinEvaluations();
+        void writeToFile(const string fileName);
+        void writeScheduleInformation(ofstream &outputFile);
+
+
+    protected:
+
+
+    private:
+
+        int rebinningFactorPerLevel;
+        bool refined;
+        vector<int> rebinningFactors;
+        vector<long> Nbins;
+        vector<BackgroundModel*> levelModels;
+        vector<GammaLikelihood> levelLikelihoods;
+        vector<SinglePrecisionLikelihood> singlePrecisionLevelLikelihoods;
+        vector<CountingLikelihood> countingLikelihoods;
+        vector<int> NtemperingSteps;
+        vector<double> levelLogEvidences;
+        ArrayXXd posteriorSample;
+        ArrayXd logLikelihoodOfPosteriorSample;
+        ArrayXd logWeightOfPosteriorSample;
+        double logEvidence;
+        double logEvidenceError;
+        double informationGain;
+        string failureReason;
+
+};
+
+
+#endif
@@ -24,6 +24,7 @@ class FlatBackgroundModel : public BackgroundModel
         ~FlatBackgroundModel();
 
         virtual void predict(RefArrayXd predictions, RefArrayXd const modelParameters);
+        virtual void predictSinglePrecision(RefArrayXf predictions, RefArrayXd const modelParameters);
 
 
     protected:
@@ -31,6 +32,10 @@ class FlatBackgroundModel : public BackgroundModel
 
     private:
 
+        template <typename PredictionArray, typename FrequencyArray, typename ResponseArray>
+        void predictOnFrequencies(PredictionArray predictions, const Eigen::ArrayBase<FrequencyArray> &frequencies, 
+                                  const Eigen::ArrayBase<ResponseArray> &response, RefArrayXd const modelParameters);
+
 }; 
 
 
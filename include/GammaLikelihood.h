@@ -0,0 +1,51 @@
+// Derived class for the likelihood of a rebinned power spectrum.
+// Each rebinned bin is the average of M independent bins, so that it follows a 
+// chi-square distribution with 2M degrees of freedom, i.e. a Gamma distribution of shape M.
+// For M = 1 this reduces to the ExponentialLikelihood.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "GammaLikelihood.h"
+// Implementations contained in "GammaLikelihood.cpp"
+
+
+#ifndef GAMMALIKELIHOOD_H
+#define GAMMALIKELIHOOD_H
+
+#include <iostream>
+#include <cmath>
+#include "Likelihood.h"
+#include "Model.h"
+#include "VectorKernels.h"
+#include "ScratchArena.h"
+#include "AllocationGuard.h"
+
+using namespace std;
+using Eigen::ArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class GammaLikelihood : public Likelihood
+{
+    public:
+    
+        GammaLikelihood(const RefArrayXd observations, const RefArrayXd binWeights, Model &model);
+        ~GammaLikelihood();
+        
+        ArrayXd getBinWeights();
+        virtual double logValue(RefArrayXd const modelParameters);
+
+
+    protected:
+
+        ArrayXd binWeights;
+
+
+    private:
+
+        bool weightsAreUnity;
+        double logNormalizationConstant;
+
+}; 
+
+
+#endif
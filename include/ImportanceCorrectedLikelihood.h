@@ -0,0 +1,54 @@
+// Derived class for the likelihood of a run warm-started from a previous run (see WarmStartPrior.h).
+// The log-likelihood of the background model is corrected by the natural logarithm of the ratio of the
+// original prior to the warm-start prior, so that the product of the prior and of the likelihood, and
+// hence the evidence and the posterior distribution, are the same as for the original prior.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "ImportanceCorrectedLikelihood.h"
+// Implementations contained in "ImportanceCorrectedLikelihood.cpp"
+
+
+#ifndef IMPORTANCECORRECTEDLIKELIHOOD_H
+#define IMPORTANCECORRECTEDLIKELIHOOD_H
+
+#include <iostream>
+#include <cmath>
+#include "Likelihood.h"
+#include "Model.h"
+#include "NestedSampler.h"
+#include "WarmStartPrior.h"
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class ImportanceCorrectedLikelihood : public Likelihood
+{
+    public:
+    
+        ImportanceCorrectedLikelihood(Likelihood &likelihood, WarmStartPrior &warmStartPrior, Model &model);
+        ~ImportanceCorrectedLikelihood();
+        
+        virtual double logValue(RefArrayXd const modelParameters);
+        ArrayXd removeCorrection(const ArrayXXd &sample, const ArrayXd &logLikelihoodOfSample);
+        void correctResults(NestedSampler &nestedSampler);
+
+
+    protected:
+
+
+    private:
+
+        Likelihood &likelihood;
+        WarmStartPrior &warmStartPrior;
+
+        // The observations are held by the likelihood of the background model only
+
+        static ArrayXd noObservations;
+
+}; 
+
+
+#endif
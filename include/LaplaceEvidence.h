@@ -0,0 +1,92 @@
+// Class for a fast estimate of the Bayesian evidence of a background model by means of the Laplace
+// approximation, namely by approximating the posterior distribution with a multivariate Gaussian centered
+// on the maximum a posteriori (MAP), with the covariance given by the inverse Hessian of the log-posterior.
+// The MAP is found by a Nelder-Mead search started from the best of a set of points drawn from the priors,
+// and then refined by Newton steps. The Hessian is computed by central finite differences.
+// The error of the evidence is estimated by importance sampling the posterior with the Gaussian approximation.
+// The evidence is intended for pre-screening the models before the full nested sampling runs.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "LaplaceEvidence.h"
+// Implementations contained in "LaplaceEvidence.cpp"
+
+
+#ifndef LAPLACEEVIDENCE_H
+#define LAPLACEEVIDENCE_H
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <Eigen/Dense>
+#include "Prior.h"
+#include "UniformPrior.h"
+#include "Likelihood.h"
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class LaplaceEvidence
+{
+    public:
+
+        LaplaceEvidence(vector<Prior*> ptrPriors, Likelihood &likelihood);
+        ~LaplaceEvidence();
+
+        void compute(const int NinitialDraws, const int maxNevaluations, const int NimportanceDraws);
+        double getLogEvidence();
+        double getLogEvidenceError();
+        double getHessianConditionNumber();
+        double getInformationGain();
+        double getLogMaxLikelihood();
+        ArrayXd getMaximumAPosteriori();
+        MatrixXd getCovariance();
+        long getNevaluations();
+        bool isMaximumOnBoundary();
+        void writeEvidenceInformationToFile(const string fileName);
+        void writeParametersToFile(const string fileName);
+        void writeComputationInformation(ofstream &outputFile);
+
+
+    protected:
+
+
+    private:
+
+        vector<Prior*> ptrPriors;
+        Likelihood &likelihood;
+        int Ndimensions;
+        ArrayXd scales;
+        long Nevaluations;
+        int NimportanceDraws;
+        double logEvidence;
+        double logEvidenceError;
+        double importanceLogEvidence;
+        double hessianConditionNumber;
+        double informationGain;
+        double logMaxLikelihood;
+        ArrayXd maximumAPosteriori;
+        MatrixXd covariance;
+        bool maximumOnBoundary;
+        mt19937 engine;
+        normal_distribution<> normal;
+
+        double logPosterior(const ArrayXd &parameters, const bool includeUniformPriors = true);
+        void searchNelderMead(ArrayXd &parameters, double &value, const double simplexSize, const int maxNevaluations);
+        MatrixXd computeHessian(const ArrayXd &parameters, const ArrayXd &steps, VectorXd &gradient);
+
+};
+
+
+#endif
@@ -0,0 +1,45 @@
+// Class for writing and reading arrays in the binary .npy format of numpy.
+// The arrays are stored in column-major (Fortran) order, which is the storage order of Eigen,
+// so that each column is contiguous on disk and can be memory-mapped from Python with 
+// numpy.load(fileName, mmap_mode='r').
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "NpyFile.h"
+// Implementations contained in "NpyFile.cpp"
+
+
+#ifndef NPYFILE_H
+#define NPYFILE_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdint>
+#include <Eigen/Dense>
+
+using namespace std;
+using Eigen::ArrayXXd;
+
+
+class NpyFile
+{
+    public:
+    
+        static void arrayXXdToFile(const string fileName, const ArrayXXd &array);
+        static string arrayXXdToString(const ArrayXXd &array);
+        static ArrayXXd arrayXXdFromFile(const string fileName);
+        static string makeHeader(const long Nrows, const long Ncolumns);
+
+
+    protected:
+
+
+    private:
+
+        static bool hostIsLittleEndian();
+
+}; 
+
+
+#endif
@@ -0,0 +1,73 @@
+// Class for a fast estimate of nuMax and of the background level at nuMax from the power spectral
+// density of a star, without any prior knowledge of the star. The spectrum is averaged on a logarithmic
+// grid of frequencies, where the envelope of the oscillations has a nearly constant relative width,
+// and the power excess is detected as the difference between a smoothing of the spectrum at the scale
+// of the envelope and a local quadratic fit of the background over a much wider scale. All the smoothings
+// are computed as convolutions by means of the fast Fourier transform, so that the estimate takes
+// a few milliseconds even for datasets of millions of bins.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "NuMaxEstimator.h"
+// Implementations contained in "NuMaxEstimator.cpp"
+
+
+#ifndef NUMAXESTIMATOR_H
+#define NUMAXESTIMATOR_H
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <complex>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <Eigen/Dense>
+#include <unsupported/Eigen/FFT>
+
+using namespace std;
+using Eigen::ArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+typedef Eigen::Ref<const Eigen::ArrayXd> ConstRefArrayXd;
+
+
+class NuMaxEstimator
+{
+    public:
+
+        NuMaxEstimator(const ConstRefArrayXd frequencies, const ConstRefArrayXd spectralDensity, const int NlogBins = 1024);
+        ~NuMaxEstimator();
+
+        double getNuMax();
+        double getSignificance();
+        double getBackgroundLevel();
+        double getWhiteNoiseLevel();
+        double getGranulationLevel();
+        void writeToFile(const string fileName);
+
+
+    protected:
+
+
+    private:
+
+        // Widths of the smoothings, in natural logarithm of frequency, of the power excess
+        // and of the background, and width of the upper edge excluded from the search
+
+        static constexpr double envelopeWidth = 0.05;
+        static constexpr double backgroundWidth = 0.4;
+        static constexpr double upperEdgeWidth = 0.1;
+
+        double nuMax;
+        double significance;
+        double backgroundLevel;
+        double whiteNoiseLevel;
+
+        static ArrayXd convolve(const ArrayXd &signal, const ArrayXd &kernel);
+        static ArrayXd smoothLocalPolynomial(const ArrayXd &signal, const double kernelWidth, const int degree);
+
+};
+
+
+#endif
@@ -25,6 +25,7 @@ class OneHarveyBackgroundModel : public BackgroundModel
         ~OneHarveyBackgroundModel();
 
         virtual void predict(RefArrayXd predictions, RefArrayXd const modelParameters);
+        virtual void predictSinglePrecision(RefArrayXf predictions, RefArrayXd const modelParameters);
 
 
     protected:
@@ -32,6 +33,10 @@ class OneHarveyBackgroundModel : public BackgroundModel
 
     private:
 
+        template <typename PredictionArray, typename FrequencyArray, typename ResponseArray>
+        void predictOnFrequencies(PredictionArray predictions, const Eigen::ArrayBase<FrequencyArray> &frequencies, 
+                                  const Eigen::ArrayBase<ResponseArray> &response, RefArrayXd const modelParameters);
+
 }; 
 
 
@@ -26,6 +26,7 @@ class OneHarveyFreeSlopeBackgroundModel : public BackgroundModel
         ~OneHarveyFreeSlopeBackgroundModel();
 
         virtual void predict(RefArrayXd predictions, RefArrayXd const modelParameters);
+        virtual void predictSinglePrecision(RefArrayXf predictions, RefArrayXd const modelParameters);
 
 
     protected:
@@ -33,6 +34,10 @@ class OneHarveyFreeSlopeBackgroundModel : public BackgroundModel
 
     private:
 
+        template <typename PredictionArray, typename FrequencyArray, typename ResponseArray>
+        void predictOnFrequencies(PredictionArray predictions, const Eigen::ArrayBase<FrequencyArray> &frequencies, 
+                                  const Eigen::ArrayBase<ResponseArray> &response, RefArrayXd const modelParameters);
+
 }; 
 
 
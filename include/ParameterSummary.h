@@ -0,0 +1,57 @@
+// Class for computing the summary statistics and the marginal distributions of all the free parameters
+// of a run from its posterior sample. The parameters are processed in parallel, each one from a contiguous
+// copy of its sampling, with a single pass for the moments and the histogram of the marginal distribution,
+// and with a weighted selection algorithm for the median, so that no sorting of the sample is needed.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "ParameterSummary.h"
+// Implementations contained in "ParameterSummary.cpp"
+
+
+#ifndef PARAMETERSUMMARY_H
+#define PARAMETERSUMMARY_H
+
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <thread>
+#include <Eigen/Dense>
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+
+
+class ParameterSummary
+{
+    public:
+
+        ParameterSummary(const int Nthreads);
+        ~ParameterSummary();
+
+        void compute(const ArrayXXd &posteriorSample, const ArrayXd &posteriorProbability, const double credibleLevel);
+        ArrayXXd getSummary();
+        ArrayXXd getMarginalDistribution(const int parameter);
+
+        static double weightedQuantile(vector<pair<double, double> > &sample, const double probability);
+
+
+    protected:
+
+
+    private:
+
+        int Nthreads;
+        ArrayXXd summary;
+        vector<ArrayXXd> marginalDistributions;
+
+        void summarizeParameter(const int parameter, const double *values, const ArrayXd &weights,
+                                const double credibleLevel);
+
+};
+
+
+#endif
@@ -0,0 +1,63 @@
+// Class for computing the posterior-predictive bands of a background model, namely the median and
+// the credible band of the model and of each of its components at each frequency, over the posterior
+// sample of a run. The model is evaluated in parallel, by means of the same implementation used in the fit,
+// and the bands are saved in a single .npz file that can be read directly by the plotting routines.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "PredictiveBands.h"
+// Implementations contained in "PredictiveBands.cpp"
+
+
+#ifndef PREDICTIVEBANDS_H
+#define PREDICTIVEBANDS_H
+
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <Eigen/Dense>
+#include "BackgroundModel.h"
+#include "BackgroundModelRegistry.h"
+#include "NpyFile.h"
+#include "ResultsArchive.h"
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class PredictiveBands
+{
+    public:
+
+        PredictiveBands(const string backgroundModelName, const RefArrayXd frequencies, const double NyquistFrequency,
+                        const int Nthreads);
+        ~PredictiveBands();
+
+        void compute(const ArrayXXd &posteriorSample, const ArrayXd &logWeights, const int Ndraws, const double credibleLevel);
+        void writeToFile(const string fileName);
+        vector<string> getCurveNames();
+        ArrayXXd getBand(const int curve);
+
+
+    protected:
+
+
+    private:
+
+        BackgroundModel *model;
+        ArrayXd frequencies;
+        int Nthreads;
+        vector<string> curveNames;
+        vector<ArrayXXd> bands;
+
+        static vector<long> resample(const ArrayXd &logWeights, const int Ndraws);
+
+};
+
+
+#endif
@@ -0,0 +1,87 @@
+// Class for reading the results of a previous run of the same star, which are used to refit the
+// background model after a change of the frequency thresholds (see ThresholdReweighter.h) or of the
+// dataset (see TemperedRefitter.h) without running a new nested sampling from scratch. The posterior 
+// sample, the evidence, the uniform priors and the settings of the dataset of the run are read from its output files,
+// or from the archive of its results.
+// The results of a run can also be held in memory, e.g. to temper them to another likelihood of the same dataset
+// (see FidelityLadder.h).
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "PreviousRun.h"
+// Implementations contained in "PreviousRun.cpp"
+
+
+#ifndef PREVIOUSRUN_H
+#define PREVIOUSRUN_H
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include "Prior.h"
+#include "UniformPrior.h"
+#include "File.h"
+#include "BackgroundResults.h"
+#include "ArchivedRun.h"
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+
+
+class PreviousRun
+{
+    public:
+
+        PreviousRun(const string runPathPrefix);
+        PreviousRun(vector<Prior*> ptrPriors, const ArrayXXd &posteriorSample, const ArrayXd &logLikelihoodOfPosteriorSample,
+                    const ArrayXd &logWeightOfPosteriorSample, const double logEvidence, const double logEvidenceError, 
+                    const double informationGain);
+        ~PreviousRun();
+
+        string getRunPathPrefix();
+        ArrayXXd getPosteriorSample();
+        ArrayXd getLogLikelihoodOfPosteriorSample();
+        ArrayXd getLogWeightOfPosteriorSample();
+        double getLogEvidence();
+        double getLogEvidenceError();
+        double getInformationGain();
+        double getLowFrequencyThreshold();
+        double getHighFrequencyThreshold();
+        string getBackgroundModelName();
+        string getRebinningMode();
+        double getLogPriorRatio(vector<Prior*> ptrPriors, ArrayXd &minima, ArrayXd &maxima);
+
+        static bool getUniformPriorRanges(vector<Prior*> ptrPriors, ArrayXd &minima, ArrayXd &maxima);
+        static double computeEffectiveSampleSize(const ArrayXd &logWeights);
+
+
+    protected:
+
+
+    private:
+
+        string runPathPrefix;
+        ArrayXXd posteriorSample;
+        ArrayXd logLikelihoodOfPosteriorSample;
+        ArrayXd logWeightOfPosteriorSample;
+        double logEvidence;
+        double logEvidenceError;
+        double informationGain;
+        ArrayXd priorMinima;
+        ArrayXd priorMaxima;
+        double lowFrequencyThreshold;
+        double highFrequencyThreshold;
+        string backgroundModelName;
+        string rebinningMode;
+
+        void readComputationParameters(const string filePathPrefix);
+
+};
+
+
+#endif
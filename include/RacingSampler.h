@@ -0,0 +1,57 @@
+// Derived class of the multi-ellipsoidal sampler taking part in an evidence race against the runs of other
+// background models of the same star (see EvidenceRace.h). Every given number of nested iterations, the bounds
+// of the log-evidence of the run are posted to the race board, and if the run is dominated by the leader of
+// the race, no further point is drawn, which makes the nested sampler stop as for a failed drawing.
+// Without a race, the sampler is the same as the multi-ellipsoidal sampler.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "RacingSampler.h"
+// Implementations contained in "RacingSampler.cpp"
+
+
+#ifndef RACINGSAMPLER_H
+#define RACINGSAMPLER_H
+
+#include <iostream>
+#include <cmath>
+#include <limits>
+#include "MultiEllipsoidSampler.h"
+#include "Functions.h"
+#include "EvidenceRace.h"
+
+using namespace std;
+
+
+class RacingSampler : public MultiEllipsoidSampler
+{
+    public:
+
+        RacingSampler(const bool printOnTheScreen, vector<Prior*> ptrPriors, Likelihood &likelihood, Metric &metric, 
+                      Clusterer &clusterer, const int initialNlivePoints, const int minNlivePoints, 
+                      const double initialEnlargementFraction, const double shrinkingRate, 
+                      EvidenceRace *evidenceRace = nullptr, const int NiterationsPerUpdate = 100);
+        ~RacingSampler();
+
+        virtual bool drawWithConstraint(const RefArrayXXd totalSample, const unsigned int Nclusters, const vector<int> &clusterIndices,
+                                        const vector<int> &clusterSizes, RefArrayXd drawnPoint, 
+                                        double &logLikelihoodOfDrawnPoint, const int maxNdrawAttempts) override;
+        void setEvidenceRace(EvidenceRace *newEvidenceRace);
+        bool isAborted();
+        double getLowerLogEvidence();
+        double getUpperLogEvidence();
+
+
+    protected:
+
+
+    private:
+
+        EvidenceRace *evidenceRace;
+        int NiterationsPerUpdate;
+        int lastUpdateIteration;
+        bool aborted;
+
+};
+
+
+#endif
@@ -0,0 +1,77 @@
+// Class for collecting all the output files of a run into a single compressed archive, and for
+// extracting them back. The archive is a standard ZIP file, whose central directory is the table
+// of contents of the archive, so that it can also be read by the zipfile module of Python and by
+// common archive tools. The files are compressed with the fastest level of the deflate codec of zlib.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "ResultsArchive.h"
+// Implementations contained in "ResultsArchive.cpp"
+
+
+#ifndef RESULTSARCHIVE_H
+#define RESULTSARCHIVE_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#ifdef BACKGROUND_USE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace std;
+
+
+class ResultsArchive
+{
+    public:
+
+        static void writeArchive(const string directoryName, const string prefix, const string archiveFileName,
+                                 const bool removeArchivedFiles = true);
+        static void writeArchive(const string archivePath, const vector<string> &entryNames, const vector<string> &contents);
+        static vector<string> extractArchive(const string archiveFileName, const string outputDirectoryName);
+
+
+    protected:
+
+
+    private:
+
+        struct ArchiveEntry
+        {
+            string fileName;
+            uint16_t compressionMethod;         // 0 = stored, 8 = deflate
+            uint16_t modificationTime;          // MS-DOS format
+            uint16_t modificationDate;          // MS-DOS format
+            uint32_t crc;
+            uint32_t compressedSize;
+            uint32_t uncompressedSize;
+            uint32_t localHeaderOffset;
+        };
+
+        static void appendEntry(ofstream &archiveFile, const string archivePath, const string entryName, string &content,
+                                const time_t modificationTime, vector<ArchiveEntry> &entries, uint64_t &offset);
+        static void finishArchive(ofstream &archiveFile, const string archivePath, const vector<ArchiveEntry> &entries,
+                                  const uint64_t offset);
+        static vector<string> listFiles(const string directoryName, const string prefix);
+        static string readFile(const string fileName);
+        static uint32_t computeCrc(const string &content);
+        static bool compress(const string &content, string &compressedContent);
+        static void appendUint16(string &buffer, const uint16_t value);
+        static void appendUint32(string &buffer, const uint32_t value);
+        static uint16_t readUint16(const string &buffer, const size_t position);
+        static uint32_t readUint32(const string &buffer, const size_t position);
+
+};
+
+
+#endif
@@ -0,0 +1,67 @@
+// Class for collecting the results of the completed runs of a whole catalog into a single
+// SQLite database file, so that they can be queried without reading the output files of each star.
+// Each run is identified by the catalog and star ID, the background model and the run number.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "ResultsDatabase.h"
+// Implementations contained in "ResultsDatabase.cpp"
+
+
+#ifndef RESULTSDATABASE_H
+#define RESULTSDATABASE_H
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include "File.h"
+#include "NestedSampler.h"
+
+#ifdef BACKGROUND_USE_SQLITE
+#include <sqlite3.h>
+#endif
+
+using namespace std;
+using Eigen::ArrayXXd;
+
+
+class ResultsDatabase
+{
+    public:
+
+        ResultsDatabase(const string fileName);
+        ~ResultsDatabase();
+
+        void addConfiguration(const string name, const double value);
+        void addConfiguration(const string name, const string value);
+        void insertRun(const string starID, const string modelName, const string runNumber, NestedSampler &nestedSampler,
+                       const double lowFrequencyThreshold, const double highFrequencyThreshold);
+        void printQuery(const string query, const vector<string> &values = vector<string>(), ostream &output = cout);
+
+        static bool isAvailable();
+
+
+    protected:
+
+
+    private:
+
+#ifdef BACKGROUND_USE_SQLITE
+        sqlite3 *database;
+#endif
+        string fileName;
+        vector<string> configurationNames;
+        vector<string> configurationTexts;
+        vector<double> configurationValues;
+        vector<bool> configurationIsNumeric;
+
+        void execute(const string statement);
+        void checkError(const int errorCode, const string action);
+
+};
+
+
+#endif
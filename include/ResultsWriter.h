@@ -0,0 +1,82 @@
+// Class for writing the output files of a Background run in parallel, by means of a
+// pool of worker threads that runs in the background of the main program.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "ResultsWriter.h"
+// Implementations contained in "ResultsWriter.cpp"
+
+
+#ifndef RESULTSWRITER_H
+#define RESULTSWRITER_H
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "NestedSampler.h"
+#include "BackgroundResults.h"
+
+using namespace std;
+
+
+class ResultsWriter
+{
+    public:
+
+        // Settings of the dataset and identification of the run, which are saved at the end of
+        // the computation parameters of the run, and are read back when the run is refitted
+
+        struct RunInformation
+        {
+            string rebinningMode;
+            int rebinningParameter;
+            int NnodesPerBin;
+            double lowFrequencyThreshold;
+            double highFrequencyThreshold;
+            string localPath;
+            string starID;
+            string runNumber;
+            string backgroundModelName;
+            bool featureProjectionActivated;
+        };
+
+        ResultsWriter(const int Nthreads);
+        ~ResultsWriter();
+
+        void submit(function<void()> task);
+        void waitForCompletion();
+        void writeResults(NestedSampler &nestedSampler, const string outputFormat,
+                          const double credibleLevel, const bool writeMarginalDistributionToFile);
+        int getNthreads();
+
+        static void setResults(NestedSampler &nestedSampler, const ArrayXXd &posteriorSample, 
+                               const ArrayXd &logLikelihoodOfPosteriorSample, const ArrayXd &logWeightOfPosteriorSample, 
+                               const double logEvidence, const double logEvidenceError, const double informationGain);
+        static void writeRunInformation(ofstream &outputFile, const RunInformation &runInformation);
+
+
+    protected:
+
+
+    private:
+
+        int NpendingTasks;
+        bool stopRequested;
+        vector<thread> workers;
+        queue<function<void()> > tasks;
+        mutex queueMutex;
+        condition_variable taskAvailable;
+        condition_variable tasksCompleted;
+
+        void runWorker();
+
+};
+
+
+#endif
@@ -0,0 +1,59 @@
+// Class for the per-thread scratch buffers used by the evaluation of the models and of the likelihood.
+// Each thread owns one arena, whose buffers are allocated at the first evaluation and reused afterwards,
+// so that the evaluation of the likelihood does not allocate memory from the heap.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "ScratchArena.h"
+// Implementations contained in "ScratchArena.cpp"
+
+
+#ifndef SCRATCHARENA_H
+#define SCRATCHARENA_H
+
+#include <iostream>
+#include <vector>
+#include <Eigen/Dense>
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXf;
+
+
+class ScratchArena
+{
+    public:
+
+        // Slots of the arena. Each slot identifies a buffer used by one stage of the evaluation,
+        // so that the stages can use their buffers at the same time.
+
+        enum BufferSlot
+        {
+            likelihoodPredictions,          // Predictions of the model used by the likelihood
+            integrationNodePredictions,     // Predictions of the integrand model on the quadrature nodes
+            modelWorkspace,                 // Terms of the model computed by the vectorized kernels
+            Nslots
+        };
+
+        ScratchArena();
+        ~ScratchArena();
+
+        static ScratchArena & getThreadArena();
+
+        Eigen::Map<ArrayXd> getDoubleBuffer(const BufferSlot slot, const long Nvalues);
+        Eigen::Map<ArrayXf> getFloatBuffer(const BufferSlot slot, const long Nvalues);
+        unsigned long getNgrowths();
+
+
+    protected:
+
+
+    private:
+
+        vector<ArrayXd> doubleBuffers;
+        vector<ArrayXf> floatBuffers;
+        unsigned long Ngrowths;
+
+}; 
+
+
+#endif
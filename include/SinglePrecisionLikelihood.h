@@ -0,0 +1,53 @@
+// Derived class for the likelihood of a power spectrum computed in mixed precision.
+// The observations and the predictions of the background model are stored in single precision,
+// while the log-likelihood is accumulated in double precision by means of a compensated summation.
+// Observations can be the average of M bins (rebinned spectrum), as in the GammaLikelihood.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "SinglePrecisionLikelihood.h"
+// Implementations contained in "SinglePrecisionLikelihood.cpp"
+
+
+#ifndef SINGLEPRECISIONLIKELIHOOD_H
+#define SINGLEPRECISIONLIKELIHOOD_H
+
+#include <iostream>
+#include <cmath>
+#include "Likelihood.h"
+#include "BackgroundModel.h"
+#include "ScratchArena.h"
+#include "AllocationGuard.h"
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXf;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class SinglePrecisionLikelihood : public Likelihood
+{
+    public:
+    
+        SinglePrecisionLikelihood(const RefArrayXd observations, const RefArrayXd binWeights, BackgroundModel &model);
+        ~SinglePrecisionLikelihood();
+        
+        virtual double logValue(RefArrayXd const modelParameters);
+
+
+    protected:
+
+        BackgroundModel &backgroundModel;
+        ArrayXf singlePrecisionObservations;
+        ArrayXf singlePrecisionBinWeights;
+
+
+    private:
+
+        bool weightsAreUnity;
+        double logNormalizationConstant;
+        int NbinsPerBlock;
+
+}; 
+
+
+#endif
@@ -0,0 +1,98 @@
+// Class for a node-local cache of the trimmed datasets, shared by all the processes fitting the same star.
+// Each entry of the cache is a file holding the trimmed frequencies, the trimmed power spectral density
+// and the response function of a dataset, identified by the source file of the dataset, the frequency
+// thresholds and the Nyquist frequency. The first process fitting a dataset writes the entry, and all
+// the processes map it read-only into memory, so that they share the same physical pages. Note that the
+// model and the likelihood keep their own copy of the frequencies and of the power spectral density.
+// A cache directory on a memory-backed file system, e.g. /dev/shm, avoids any disk access.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "SpectrumCache.h"
+// Implementations contained in "SpectrumCache.cpp"
+
+
+#ifndef SPECTRUMCACHE_H
+#define SPECTRUMCACHE_H
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include <Eigen/Dense>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+using Eigen::ArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+typedef Eigen::Ref<const Eigen::ArrayXd> ConstRefArrayXd;
+
+
+class SpectrumCache
+{
+    public:
+
+        // Layout of an entry: a header of 64 bytes, followed by the frequencies, the power
+        // spectral density and the response function, each one made of Nbins values.
+
+        struct Header
+        {
+            char magic[8];                      // "BKGCACH" followed by a null character
+            uint32_t version;
+            uint32_t byteOrderMark;             // 0x01020304 in the byte order of the machine that wrote the file
+            uint64_t key;                       // Hash of the source, thresholds and Nyquist frequency
+            uint64_t Nbins;
+            double lowFrequencyThreshold;       // muHz, 0 if the dataset was not trimmed at low frequency
+            double highFrequencyThreshold;      // muHz, 0 if the dataset was not trimmed at high frequency
+            double NyquistFrequency;            // muHz, as adopted for the response function
+            char reserved[8];
+        };
+
+        SpectrumCache(const string directoryName, const string starID, const string sourceFileName,
+                      const double lowFrequencyThreshold, const double highFrequencyThreshold,
+                      const double NyquistFrequency);
+        ~SpectrumCache();
+
+        bool load();
+        void store(const ConstRefArrayXd covariates, const ConstRefArrayXd observations,
+                   const double lowFrequencyThreshold, const double highFrequencyThreshold,
+                   const double adoptedNyquistFrequency);
+
+        string getFileName();
+        Eigen::Map<const ArrayXd> getCovariates();
+        Eigen::Map<const ArrayXd> getObservations();
+        Eigen::Map<const ArrayXd> getResponseFunction();
+        double getLowFrequencyThreshold();
+        double getHighFrequencyThreshold();
+        double getNyquistFrequency();
+
+
+    protected:
+
+
+    private:
+
+        static const uint32_t currentVersion = 1;
+        static const uint32_t byteOrderMark = 0x01020304;
+
+        string fileName;
+        uint64_t key;
+        double NyquistFrequency;
+        const char *mappedFile;
+        size_t fileSize;
+        const Header *header;
+
+        static uint64_t hash(const void *bytes, const size_t Nbytes, uint64_t value);
+        const double * getColumn(const int column);
+
+};
+
+
+#endif
@@ -0,0 +1,95 @@
+// Class for reading and writing a container file that packs the power spectra of many stars.
+// The container holds, for each star, the frequencies and the power spectral density of the dataset,
+// its Nyquist frequency and the description of its frequency grid. The stars are listed in an index
+// sorted by ID, so that the spectrum of a star is found by a binary search on the memory-mapped file,
+// without opening and parsing one ASCII file per star.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "SpectrumContainer.h"
+// Implementations contained in "SpectrumContainer.cpp"
+
+
+#ifndef SPECTRUMCONTAINER_H
+#define SPECTRUMCONTAINER_H
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <Eigen/Dense>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+
+
+class SpectrumContainer
+{
+    public:
+
+        // Layout of the file: a header of 64 bytes, the spectra, each one starting at a multiple
+        // of 64 bytes and stored as the column of the frequencies followed by the column of the
+        // power spectral density, and the index of the stars at the end of the file.
+
+        struct Header
+        {
+            char magic[8];                      // "BKGSPEC" followed by a null character
+            uint32_t version;
+            uint32_t byteOrderMark;             // 0x01020304 in the byte order of the machine that wrote the file
+            uint64_t Nstars;
+            uint64_t indexOffset;               // Position of the index, in bytes from the start of the file
+            char reserved[32];
+        };
+
+        struct IndexEntry
+        {
+            char starID[32];                    // Catalog and star ID, e.g. KIC012008916, null-terminated
+            uint64_t dataOffset;                // Position of the spectrum, in bytes from the start of the file
+            uint64_t Nbins;
+            double NyquistFrequency;            // muHz
+            double startingFrequency;           // muHz
+            double frequencyResolution;         // muHz, average spacing of the frequencies
+            uint32_t uniformGrid;               // 1 if the frequencies are uniformly spaced, 0 otherwise
+            uint32_t reserved;
+        };
+
+        SpectrumContainer(const string fileName);
+        ~SpectrumContainer();
+
+        const IndexEntry * findStar(const string starID);
+        ArrayXXd getSpectrum(const IndexEntry &entry);
+        uint64_t getNstars();
+        const IndexEntry & getEntry(const uint64_t entryNumber);
+
+        static void pack(const string fileName, const vector<string> &starIDs, const vector<string> &spectrumFileNames,
+                         const vector<double> &NyquistFrequencies, const double gridTolerance = 1.e-6);
+
+
+    protected:
+
+
+    private:
+
+        string fileName;
+        int fileDescriptor;
+        size_t fileSize;
+        const char *mappedFile;
+        const Header *header;
+        const IndexEntry *index;
+
+        static const uint32_t currentVersion = 1;
+        static const uint32_t byteOrderMark = 0x01020304;
+        static const size_t alignment = 64;
+
+};
+
+
+#endif
@@ -0,0 +1,60 @@
+// Class for rebinning an input power spectrum, either by an integer factor or
+// by logarithmically-spaced bins. Each rebinned bin stores the average of the original
+// bins that it contains, together with its weight (number of averaged bins) and edges.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "SpectrumRebinner.h"
+// Implementations contained in "SpectrumRebinner.cpp"
+
+
+#ifndef SPECTRUMREBINNER_H
+#define SPECTRUMREBINNER_H
+
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <Eigen/Dense>
+#include "Functions.h"
+
+using namespace std;
+using Eigen::ArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+typedef Eigen::Ref<const Eigen::ArrayXd> ConstRefArrayXd;
+
+
+class SpectrumRebinner
+{
+    public:
+    
+        SpectrumRebinner(const ConstRefArrayXd covariates, const ConstRefArrayXd observations);
+        ~SpectrumRebinner();
+        
+        void rebinByFactor(const int rebinningFactor);
+        void rebinLogarithmically(const int NbinsPerDecade);
+
+        ArrayXd getCovariates();
+        ArrayXd getObservations();
+        ArrayXd getBinWeights();
+        ArrayXd getBinWidths();
+        int getNbins();
+
+
+    protected:
+
+        ArrayXd originalCovariates;
+        ArrayXd originalObservations;
+        ArrayXd covariates;
+        ArrayXd observations;
+        ArrayXd binWeights;
+        ArrayXd binWidths;
+
+
+    private:
+
+        double frequencyResolution;
+        void averageBins(const vector<int> &firstIndices);
+
+}; 
+
+
+#endif
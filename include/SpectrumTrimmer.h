@@ -0,0 +1,50 @@
+// Class for trimming an input power spectrum in a given frequency range. The range is found
+// by a binary search on the sorted frequencies, and the trimmed spectrum is accessed through
+// views of the input arrays, so that no copy of the dataset is made.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "SpectrumTrimmer.h"
+// Implementations contained in "SpectrumTrimmer.cpp"
+
+
+#ifndef SPECTRUMTRIMMER_H
+#define SPECTRUMTRIMMER_H
+
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+#include <Eigen/Dense>
+
+using namespace std;
+using Eigen::ArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+typedef Eigen::Ref<const Eigen::ArrayXd> ConstRefArrayXd;
+
+
+class SpectrumTrimmer
+{
+    public:
+    
+        SpectrumTrimmer(const ConstRefArrayXd frequencies);
+        ~SpectrumTrimmer();
+        
+        void trim(double &lowFrequencyThreshold, double &highFrequencyThreshold);
+        long getFirstBin();
+        long getNbins();
+        Eigen::Map<const ArrayXd> getTrimmedView(const ConstRefArrayXd array);
+
+
+    protected:
+
+
+    private:
+
+        const double *frequencies;
+        long NinputBins;
+        long firstBin;
+        long Nbins;
+
+};
+
+
+#endif
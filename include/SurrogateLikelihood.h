@@ -0,0 +1,120 @@
+// Derived class for screening the points drawn by the nested sampler with a surrogate of the log-likelihood,
+// namely a quadratic function of the free parameters fitted by least squares to the most recent exact evaluations.
+// While the sampler draws a new point with a likelihood larger than the given constraint (see SurrogateSampler.h),
+// a point whose predicted log-likelihood lies below the constraint by more than a safety factor times the RMS
+// of the recent prediction errors is rejected without evaluating the likelihood, and its prediction is returned.
+// All the other points, and thus all the accepted points, are evaluated exactly. A random fraction of the
+// rejected points is audited with an exact evaluation, which measures the prediction errors where the points
+// are rejected and counts the points that would have been accepted. When the rate of these false rejections
+// exceeds a tolerance, the safety factor is widened, and the screening is stopped if widening does not help.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "SurrogateLikelihood.h"
+// Implementations contained in "SurrogateLikelihood.cpp"
+
+
+#ifndef SURROGATELIKELIHOOD_H
+#define SURROGATELIKELIHOOD_H
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <Eigen/Dense>
+#include "Likelihood.h"
+#include "Model.h"
+#include "File.h"
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class SurrogateLikelihood : public Likelihood
+{
+    public:
+    
+        SurrogateLikelihood(Likelihood &likelihood, Model &model, const int Ndimensions, const int NtrainingPoints, 
+                            const double safetyFactor, const double auditFraction, const double maxFalseRejectionRate);
+        ~SurrogateLikelihood();
+        
+        virtual double logValue(RefArrayXd const modelParameters);
+        void setLogLikelihoodConstraint(const double logLikelihoodConstraint);
+        long getNevaluations();
+        long getNscreenedPoints();
+        long getNauditedPoints();
+        long getNfalseRejections();
+        double getResidualRms();
+        double getSafetyFactor();
+        bool isScreening();
+        void writeToFile(const string fileName);
+
+
+    protected:
+
+
+    private:
+
+        Likelihood &likelihood;
+        int Ndimensions;
+        int NtrainingPoints;
+        int Ncoefficients;
+        double safetyFactor;
+        double auditFraction;
+        double maxFalseRejectionRate;
+        bool screening;
+        int Nwidenings;
+        mt19937 engine;
+        uniform_real_distribution<> uniform;
+        double logLikelihoodConstraint;
+
+        // Ring buffers of the most recent exact evaluations and of the squared prediction errors,
+        // kept apart for the points evaluated because not rejected and for the audited points
+
+        ArrayXXd trainingPoints;
+        ArrayXd trainingLogLikelihood;
+        int NstoredPoints;
+        int nextTrainingPoint;
+        int NevaluationsSinceFit;
+        ArrayXd squaredResiduals;
+        int Nresiduals;
+        int nextResidual;
+        ArrayXd auditedSquaredResiduals;
+        int NauditedResiduals;
+        int nextAuditedResidual;
+
+        // Quadratic surrogate of the standardized free parameters
+
+        bool surrogateIsFitted;
+        ArrayXd parameterMean;
+        ArrayXd parameterScale;
+        double logLikelihoodMean;
+        VectorXd coefficients;
+
+        long Nevaluations;
+        long NscreenedPoints;
+        long NauditedPoints;
+        long NfalseRejections;
+        long NauditedPointsSinceCheck;
+        long NfalseRejectionsSinceCheck;
+
+        // The observations are held by the wrapped likelihood only
+
+        static ArrayXd noObservations;
+
+        void addTrainingPoint(RefArrayXd const modelParameters, const double logLikelihoodValue);
+        void addResidual(ArrayXd &buffer, int &Nstored, int &next, const double residual);
+        void checkFalseRejections();
+        void fit();
+        double predict(RefArrayXd const modelParameters);
+        VectorXd computeFeatures(const ArrayXd &scaledParameters);
+
+}; 
+
+
+#endif
@@ -0,0 +1,49 @@
+// Derived class of the racing sampler (see RacingSampler.h) screening the drawn points with a surrogate of the
+// log-likelihood (see SurrogateLikelihood.h). The likelihood constraint of each new point is passed to the 
+// surrogate while the point is drawn, so that the drawn points predicted well below the constraint are rejected
+// without evaluating the likelihood on the dataset. Without a surrogate, the sampler is the same as the racing sampler.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "SurrogateSampler.h"
+// Implementations contained in "SurrogateSampler.cpp"
+
+
+#ifndef SURROGATESAMPLER_H
+#define SURROGATESAMPLER_H
+
+#include <iostream>
+#include <cmath>
+#include <limits>
+#include "RacingSampler.h"
+#include "SurrogateLikelihood.h"
+
+using namespace std;
+
+
+class SurrogateSampler : public RacingSampler
+{
+    public:
+
+        SurrogateSampler(const bool printOnTheScreen, vector<Prior*> ptrPriors, Likelihood &likelihood, Metric &metric, 
+                         Clusterer &clusterer, const int initialNlivePoints, const int minNlivePoints, 
+                         const double initialEnlargementFraction, const double shrinkingRate, 
+                         EvidenceRace *evidenceRace = nullptr, const int NiterationsPerUpdate = 100,
+                         SurrogateLikelihood *surrogateLikelihood = nullptr);
+        ~SurrogateSampler();
+
+        virtual bool drawWithConstraint(const RefArrayXXd totalSample, const unsigned int Nclusters, const vector<int> &clusterIndices,
+                                        const vector<int> &clusterSizes, RefArrayXd drawnPoint, 
+                                        double &logLikelihoodOfDrawnPoint, const int maxNdrawAttempts) override;
+
+
+    protected:
+
+
+    private:
+
+        SurrogateLikelihood *surrogateLikelihood;
+
+};
+
+
+#endif
@@ -0,0 +1,104 @@
+// Class for refitting a background model when a new dataset of the same star is available, e.g. after new
+// observing sectors or quarters, starting from the posterior sample of a previous run on the previous dataset.
+// The posterior sample is moved from the previous likelihood to the new one by sequential Monte Carlo (SMC)
+// tempering, namely through a sequence of intermediate distributions proportional to the prior times
+// L_previous^(1 - beta) * L_new^beta, with beta increasing from 0 to 1. At each step the increment of beta is
+// chosen so that the effective sample size of the particles stays at half of their number, the particles are
+// resampled and then moved by a few Metropolis steps with a Gaussian proposal scaled on their covariance.
+// The evidence of the new dataset is that of the previous run times the product of the mean weights of the steps.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "TemperedRefitter.h"
+// Implementations contained in "TemperedRefitter.cpp"
+
+
+#ifndef TEMPEREDREFITTER_H
+#define TEMPEREDREFITTER_H
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include "Prior.h"
+#include "Likelihood.h"
+#include "Functions.h"
+#include "File.h"
+#include "NestedSampler.h"
+#include "GammaLikelihood.h"
+#include "BackgroundModel.h"
+#include "BackgroundModelRegistry.h"
+#include "SpectrumTrimmer.h"
+#include "ResultsWriter.h"
+#include "PreviousRun.h"
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+
+class TemperedRefitter
+{
+    public:
+
+        TemperedRefitter(PreviousRun &previousRun, vector<Prior*> ptrPriors, Likelihood &previousLikelihood, Likelihood &likelihood);
+        ~TemperedRefitter();
+
+        bool refit(const int Nparticles, const int NmovesPerStep, const int maxNsteps);
+        ArrayXXd getPosteriorSample();
+        ArrayXd getLogLikelihoodOfPosteriorSample();
+        ArrayXd getLogWeightOfPosteriorSample();
+        double getLogEvidence();
+        double getLogEvidenceError();
+        double getInformationGain();
+        double getPosteriorShift();
+        string getFailureReason();
+        int getNsteps();
+        long getNevaluations();
+        void writeToFile(const string fileName);
+
+        static bool refitDataset(NestedSampler &nestedSampler, PreviousRun &previousRun, vector<Prior*> ptrPriors, 
+                                 Likelihood &likelihood, const string previousDatasetFileName, const string backgroundModelName, 
+                                 const double NyquistFrequency, const int Nparticles, const int NmovesPerStep, 
+                                 const int maxNsteps, const double maxPosteriorShift, const string outputPathPrefix);
+
+
+    protected:
+
+
+    private:
+
+        PreviousRun &previousRun;
+        vector<Prior*> ptrPriors;
+        Likelihood &previousLikelihood;
+        Likelihood &likelihood;
+        mt19937 engine;
+        ArrayXd minima;
+        ArrayXd maxima;
+        ArrayXXd particles;
+        ArrayXd previousLogLikelihood;
+        ArrayXd logLikelihoodOfParticles;
+        double logEvidence;
+        double logEvidenceVariance;
+        double proposalScale;
+        double acceptanceRate;
+        double posteriorShift;
+        int Nsteps;
+        long Nevaluations;
+        string failureReason;
+
+        vector<long> resample(const ArrayXd &logWeights, const int Nparticles);
+        void move(const double beta, const int Nmoves);
+        double findTemperatureIncrement(const double beta, const double targetEffectiveSampleSize);
+
+};
+
+
+#endif
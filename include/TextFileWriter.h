@@ -0,0 +1,61 @@
+// Class for writing ASCII output files with a fast formatting of the numbers.
+// The numbers are formatted in scientific notation with a fixed number of decimal digits,
+// giving the same characters as an ostream set to scientific and setprecision, and are collected
+// in a large buffer that is written to disk in a few system calls.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "TextFileWriter.h"
+// Implementations contained in "TextFileWriter.cpp"
+
+
+#ifndef TEXTFILEWRITER_H
+#define TEXTFILEWRITER_H
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+
+
+class TextFileWriter
+{
+    public:
+
+        TextFileWriter(const string fileName, const int precision = 9, const size_t bufferSize = 1 << 20);
+        ~TextFileWriter();
+
+        void writeValue(const double value);
+        void writeText(const string &text);
+        void writeArrayXd(const ArrayXd &array, const string terminator = "\n");
+        void writeArrayXXd(const ArrayXXd &array, const string separator = "  ", const string terminator = "\n");
+        void flush();
+
+        static int formatScientific(const double value, const int precision, char *output);
+
+
+    protected:
+
+
+    private:
+
+        FILE *outputFile;
+        int precision;
+        vector<char> buffer;
+        size_t bufferPosition;
+
+        void reserve(const size_t Ncharacters);
+        static int formatWithPrintf(const double value, const int precision, char *output);
+
+};
+
+
+#endif
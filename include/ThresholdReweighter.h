@@ -0,0 +1,89 @@
+// Class for refitting a background model after a change of the frequency thresholds, by reweighting the
+// posterior sample of a previous run of the same model instead of running a new nested sampling.
+// Since the likelihood is a product over the frequency bins, the log-likelihood of each sampling point
+// only changes by the contribution of the bins added to the frequency range, minus that of the bins removed
+// from it, which are only a small fraction of the dataset. The nested sampling weights of the previous run are
+// corrected by this change, and by the ratio of the new priors to the previous ones, which gives the posterior
+// sample and the evidence of the new run. The reweighting is reliable only if the effective sample size
+// of the reweighted posterior is not much smaller than that of the previous posterior.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "ThresholdReweighter.h"
+// Implementations contained in "ThresholdReweighter.cpp"
+
+
+#ifndef THRESHOLDREWEIGHTER_H
+#define THRESHOLDREWEIGHTER_H
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include "Prior.h"
+#include "Likelihood.h"
+#include "Functions.h"
+#include "File.h"
+#include "NestedSampler.h"
+#include "GammaLikelihood.h"
+#include "BackgroundModel.h"
+#include "BackgroundModelRegistry.h"
+#include "SpectrumTrimmer.h"
+#include "ResultsWriter.h"
+#include "PreviousRun.h"
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+
+
+class ThresholdReweighter
+{
+    public:
+
+        ThresholdReweighter(PreviousRun &previousRun);
+        ~ThresholdReweighter();
+
+        void selectBins(ArrayXXd &data, const long firstBin, const long Nbins);
+        bool refit(NestedSampler &nestedSampler, vector<Prior*> ptrPriors, const string backgroundModelName, 
+                   const double NyquistFrequency, const double minEfficiency, const string outputPathPrefix);
+        void reweight(vector<Prior*> ptrPriors, Likelihood *addedBinsLikelihood, Likelihood *removedBinsLikelihood);
+        ArrayXXd getPosteriorSample();
+        ArrayXd getLogLikelihoodOfPosteriorSample();
+        ArrayXd getLogWeightOfPosteriorSample();
+        double getLogEvidence();
+        double getLogEvidenceError();
+        double getInformationGain();
+        double getEffectiveSampleSize();
+        double getEfficiency();
+        void writeToFile(const string fileName);
+
+
+    protected:
+
+
+    private:
+
+        PreviousRun &previousRun;
+        double previousEffectiveSampleSize;
+        ArrayXXd posteriorSample;
+        ArrayXd logLikelihoodOfPosteriorSample;
+        ArrayXd logWeightOfPosteriorSample;
+        double logEvidence;
+        double logEvidenceError;
+        double informationGain;
+        double effectiveSampleSize;
+        ArrayXXd addedBins;
+        ArrayXXd removedBins;
+
+        static ArrayXXd selectBinsOutside(const ArrayXXd &data, const long firstBin, const long endBin, 
+                                          const long otherFirstBin, const long otherEndBin);
+
+};
+
+
+#endif
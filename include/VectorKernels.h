@@ -0,0 +1,71 @@
+// Class for the vectorized kernels of the model and likelihood computation.
+// The kernels are compiled for the SSE4.2, AVX2 and AVX-512 instruction sets, and the widest
+// instruction set supported by the CPU is selected at startup.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "VectorKernels.h"
+// Implementations contained in "VectorKernels.cpp", "VectorKernelsSSE42.cpp",
+// "VectorKernelsAVX2.cpp", "VectorKernelsAVX512.cpp" and "VectorKernelsTemplate.h"
+
+
+#ifndef VECTORKERNELS_H
+#define VECTORKERNELS_H
+
+#include <iostream>
+#include <cmath>
+#include <string>
+
+using namespace std;
+
+
+class VectorKernels
+{
+    public:
+    
+        static bool selectInstructionSet(const string instructionSetName);
+        static string getInstructionSetName();
+        static bool isInstructionSetSupported(const string instructionSetName);
+
+        static void exponential(double *values, const long Nvalues);
+        static void exponential(float *values, const long Nvalues);
+        static void logarithm(double *values, const long Nvalues);
+        static void logarithm(float *values, const long Nvalues);
+        static void power(double *values, const double exponent, const long Nvalues);
+        static void power(float *values, const double exponent, const long Nvalues);
+        static double sumLogLikelihoodTerms(const double *observations, const double *predictions, 
+                                            const double *weights, const long Nvalues);
+        static double sumLogLikelihoodTerms(const float *observations, const float *predictions, 
+                                            const float *weights, const long Nvalues);
+
+
+    protected:
+
+
+    private:
+
+        // Table of the kernels compiled for a given instruction set
+
+        struct KernelTable
+        {
+            string instructionSetName;
+            void (*exponentialDouble)(double *values, const long Nvalues);
+            void (*exponentialFloat)(float *values, const long Nvalues);
+            void (*logarithmDouble)(double *values, const long Nvalues);
+            void (*logarithmFloat)(float *values, const long Nvalues);
+            void (*powerDouble)(double *values, const double exponent, const long Nvalues);
+            void (*powerFloat)(float *values, const double exponent, const long Nvalues);
+            double (*sumLogLikelihoodTermsDouble)(const double *observations, const double *predictions, 
+                                                  const double *weights, const long Nvalues);
+            double (*sumLogLikelihoodTermsFloat)(const float *observations, const float *predictions, 
+                                                 const float *weights, const long Nvalues);
+        };
+
+        static KernelTable kernels;
+
+        static KernelTable makeKernelTable(const string instructionSetName);
+        static KernelTable makeWidestKernelTable();
+
+}; 
+
+
+#endif
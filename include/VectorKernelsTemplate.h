@@ -0,0 +1,556 @@
+// Generic implementation of the vectorized kernels of class VectorKernels.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "VectorKernelsTemplate.h"
+// Included by "VectorKernelsSSE42.cpp", "VectorKernelsAVX2.cpp" and "VectorKernelsAVX512.cpp"
+//
+// This file is included inside the namespace of each instruction set, after the definition of
+// the vector types VectorDouble, MaskDouble, VectorFloat and MaskFloat, of the number of lanes
+// NdoubleLanes and NfloatLanes, and of the elementary operations on these types.
+// It must not include any header file, so that all the code compiled for a given instruction set
+// is private to its namespace and is never shared with the code compiled for a different one.
+//
+// Accuracy of the vectorized functions, as the largest error measured against the long double
+// functions of the C library on 2 x 10^7 random arguments for each instruction set:
+//      exponentialDouble:  1.2 ulp (0.9 ulp with FMA) for x in [-708.39, 709.78], i.e. for normal results.
+//                          Subnormal results have an absolute error of at most 5e-324.
+//                          The result is 0 for x < -745.2 and +inf for x > 709.79.
+//      logarithmDouble:    2.0 ulp for all the positive finite arguments, subnormals included.
+//                          The result is -inf for x = 0, NaN for x < 0 and +inf for x = +inf.
+//      exponentialFloat:   1.2 ulp (0.9 ulp with FMA) for x in [-87.33, 88.72], i.e. for normal results.
+//                          Subnormal results have an absolute error of at most 1.4e-45.
+//                          The result is 0 for x < -104 and +inf for x > 88.73.
+//      logarithmFloat:     1.9 ulp for all the positive finite arguments, subnormals included.
+//      power:              computed as exp(y*log(x)), so that the relative error is at most
+//                          (1 + 2|y*log(x)|) ulp. For the Harvey profiles |y*log(x)| < 30.
+// NaN arguments are propagated by all the functions.
+
+
+// Elementary functions for a vector of doubles
+
+static inline VectorDouble exponentialDouble(VectorDouble x)
+{
+    // Clamp the argument to the range where the result is neither 0 nor +inf.
+    // The order of the operands of min and max preserves NaN arguments.
+
+    x = minDouble(setDouble(709.79), maxDouble(setDouble(-745.2), x));
+
+
+    // Range reduction x = n ln2 + r, with |r| <= ln2/2. The Cody-Waite splitting of ln2
+    // makes n*ln2High exact, so that r is accurate to the last bit.
+
+    VectorDouble n = roundDouble(mulDouble(x, setDouble(1.4426950408889634074)));
+    VectorDouble r = fmaDouble(n, setDouble(-6.93147180369123816490e-01), x);
+    r = fmaDouble(n, setDouble(-1.90821492927058770002e-10), r);
+
+
+    // Taylor polynomial of degree 13 for exp(r), whose truncation error is below 6e-18 for |r| <= ln2/2
+
+    VectorDouble p = setDouble(1.6059043836821614599e-10);
+    p = fmaDouble(p, r, setDouble(2.0876756987868098979e-09));
+    p = fmaDouble(p, r, setDouble(2.5052108385441718775e-08));
+    p = fmaDouble(p, r, setDouble(2.7557319223985890653e-07));
+    p = fmaDouble(p, r, setDouble(2.7557319223985890653e-06));
+    p = fmaDouble(p, r, setDouble(2.4801587301587301587e-05));
+    p = fmaDouble(p, r, setDouble(1.9841269841269841270e-04));
+    p = fmaDouble(p, r, setDouble(1.3888888888888888889e-03));
+    p = fmaDouble(p, r, setDouble(8.3333333333333333333e-03));
+    p = fmaDouble(p, r, setDouble(4.1666666666666666667e-02));
+    p = fmaDouble(p, r, setDouble(1.6666666666666666667e-01));
+    p = fmaDouble(p, r, setDouble(0.5));
+    p = fmaDouble(p, r, setDouble(1.0));
+    p = fmaDouble(p, r, setDouble(1.0));
+
+
+    // Scale by 2^n in two steps, so that both factors are normal numbers and the
+    // subnormal results are obtained by gradual underflow.
+
+    VectorDouble n1 = floorDouble(mulDouble(n, setDouble(0.5)));
+    VectorDouble n2 = subDouble(n, n1);
+
+    return mulDouble(mulDouble(p, powerOfTwoDouble(n1)), powerOfTwoDouble(n2));
+}
+
+
+
+
+
+
+
+
+
+
+static inline VectorDouble logarithmDouble(VectorDouble x)
+{
+    // Bring subnormal arguments to the normal range
+
+    MaskDouble isSubnormal = lessDouble(x, setDouble(2.2250738585072014e-308));
+    VectorDouble scaledX = selectDouble(isSubnormal, mulDouble(x, setDouble(18014398509481984.0)), x);
+    VectorDouble exponent = subDouble(exponentOfDouble(scaledX), selectDouble(isSubnormal, setDouble(1077.0), setDouble(1023.0)));
+
+
+    // Write x = 2^exponent * m, with m in [sqrt(2)/2, sqrt(2))
+
+    VectorDouble m = mantissaOfDouble(scaledX);
+    MaskDouble isLarge = lessDouble(setDouble(1.4142135623730950488), m);
+    m = selectDouble(isLarge, mulDouble(m, setDouble(0.5)), m);
+    exponent = selectDouble(isLarge, addDouble(exponent, setDouble(1.0)), exponent);
+
+
+    // log(m) = 2 atanh(s) = 2s + 2s (s^2/3 + s^4/5 + ...), with s = (m - 1)/(m + 1) and |s| <= 0.1716.
+    // The series is truncated at s^21, with a truncation error below 1e-17.
+
+    VectorDouble s = divDouble(subDouble(m, setDouble(1.0)), addDouble(m, setDouble(1.0)));
+    VectorDouble z = mulDouble(s, s);
+    VectorDouble q = setDouble(1.0/21.0);
+    q = fmaDouble(q, z, setDouble(1.0/19.0));
+    q = fmaDouble(q, z, setDouble(1.0/17.0));
+    q = fmaDouble(q, z, setDouble(1.0/15.0));
+    q = fmaDouble(q, z, setDouble(1.0/13.0));
+    q = fmaDouble(q, z, setDouble(1.0/11.0));
+    q = fmaDouble(q, z, setDouble(1.0/9.0));
+    q = fmaDouble(q, z, setDouble(1.0/7.0));
+    q = fmaDouble(q, z, setDouble(1.0/5.0));
+    q = fmaDouble(q, z, setDouble(1.0/3.0));
+    q = mulDouble(q, z);
+
+    VectorDouble twoS = addDouble(s, s);
+    VectorDouble result = fmaDouble(twoS, q, mulDouble(exponent, setDouble(1.90821492927058770002e-10)));
+    result = addDouble(mulDouble(exponent, setDouble(6.93147180369123816490e-01)), addDouble(twoS, result));
+
+
+    // Special arguments
+
+    result = selectDouble(equalDouble(x, setDouble(__builtin_inf())), x, result);
+    result = selectDouble(equalDouble(x, setDouble(0.0)), setDouble(-__builtin_inf()), result);
+    result = selectDouble(lessDouble(x, setDouble(0.0)), setDouble(__builtin_nan("")), result);
+    result = selectDouble(isNaNDouble(x), x, result);
+
+    return result;
+}
+
+
+
+
+
+
+
+
+
+
+// Elementary functions for a vector of floats
+
+static inline VectorFloat exponentialFloat(VectorFloat x)
+{
+    x = minFloat(setFloat(88.73f), maxFloat(setFloat(-104.0f), x));
+
+    VectorFloat n = roundFloat(mulFloat(x, setFloat(1.44269504088896341f)));
+    VectorFloat r = fmaFloat(n, setFloat(-0.693359375f), x);
+    r = fmaFloat(n, setFloat(2.12194440e-4f), r);
+
+
+    // Taylor polynomial of degree 7 for exp(r), whose truncation error is below 8e-9 for |r| <= ln2/2
+
+    VectorFloat p = setFloat(1.98412698e-4f);
+    p = fmaFloat(p, r, setFloat(1.38888889e-3f));
+    p = fmaFloat(p, r, setFloat(8.33333333e-3f));
+    p = fmaFloat(p, r, setFloat(4.16666667e-2f));
+    p = fmaFloat(p, r, setFloat(1.66666667e-1f));
+    p = fmaFloat(p, r, setFloat(0.5f));
+    p = fmaFloat(p, r, setFloat(1.0f));
+    p = fmaFloat(p, r, setFloat(1.0f));
+
+    VectorFloat n1 = floorFloat(mulFloat(n, setFloat(0.5f)));
+    VectorFloat n2 = subFloat(n, n1);
+
+    return mulFloat(mulFloat(p, powerOfTwoFloat(n1)), powerOfTwoFloat(n2));
+}
+
+
+
+
+
+
+
+
+
+
+static inline VectorFloat logarithmFloat(VectorFloat x)
+{
+    MaskFloat isSubnormal = lessFloat(x, setFloat(1.17549435e-38f));
+    VectorFloat scaledX = selectFloat(isSubnormal, mulFloat(x, setFloat(33554432.0f)), x);
+    VectorFloat exponent = subFloat(exponentOfFloat(scaledX), selectFloat(isSubnormal, setFloat(152.0f), setFloat(127.0f)));
+
+    VectorFloat m = mantissaOfFloat(scaledX);
+    MaskFloat isLarge = lessFloat(setFloat(1.41421356f), m);
+    m = selectFloat(isLarge, mulFloat(m, setFloat(0.5f)), m);
+    exponent = selectFloat(isLarge, addFloat(exponent, setFloat(1.0f)), exponent);
+
+
+    // The series of 2 atanh(s) is truncated at s^11, with a truncation error below 2e-10
+
+    VectorFloat s = divFloat(subFloat(m, setFloat(1.0f)), addFloat(m, setFloat(1.0f)));
+    VectorFloat z = mulFloat(s, s);
+    VectorFloat q = setFloat(1.0f/11.0f);
+    q = fmaFloat(q, z, setFloat(1.0f/9.0f));
+    q = fmaFloat(q, z, setFloat(1.0f/7.0f));
+    q = fmaFloat(q, z, setFloat(1.0f/5.0f));
+    q = fmaFloat(q, z, setFloat(1.0f/3.0f));
+    q = mulFloat(q, z);
+
+    VectorFloat twoS = addFloat(s, s);
+    VectorFloat result = fmaFloat(twoS, q, mulFloat(exponent, setFloat(-2.12194440e-4f)));
+    result = addFloat(mulFloat(exponent, setFloat(0.693359375f)), addFloat(twoS, result));
+
+    result = selectFloat(equalFloat(x, setFloat(__builtin_inff())), x, result);
+    result = selectFloat(equalFloat(x, setFloat(0.0f)), setFloat(-__builtin_inff()), result);
+    result = selectFloat(lessFloat(x, setFloat(0.0f)), setFloat(__builtin_nanf("")), result);
+    result = selectFloat(isNaNFloat(x), x, result);
+
+    return result;
+}
+
+
+
+
+
+
+
+
+
+
+// Loops over the arrays. The last incomplete vector of each array is processed by copying
+// it into a buffer that is padded with neutral values.
+
+void exponential(double *values, const long Nvalues)
+{
+    long index = 0;
+
+    for (; index + NdoubleLanes <= Nvalues; index += NdoubleLanes)
+    {
+        storeDouble(values + index, exponentialDouble(loadDouble(values + index)));
+    }
+
+    if (index < Nvalues)
+    {
+        double buffer[NdoubleLanes];
+
+        for (int lane = 0; lane < NdoubleLanes; ++lane)
+        {
+            buffer[lane] = (index + lane < Nvalues) ? values[index + lane] : 0.0;
+        }
+
+        storeDouble(buffer, exponentialDouble(loadDouble(buffer)));
+
+        for (int lane = 0; index + lane < Nvalues; ++lane)
+        {
+            values[index + lane] = buffer[lane];
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+void exponential(float *values, const long Nvalues)
+{
+    long index = 0;
+
+    for (; index + NfloatLanes <= Nvalues; index += NfloatLanes)
+    {
+        storeFloat(values + index, exponentialFloat(loadFloat(values + index)));
+    }
+
+    if (index < Nvalues)
+    {
+        float buffer[NfloatLanes];
+
+        for (int lane = 0; lane < NfloatLanes; ++lane)
+        {
+            buffer[lane] = (index + lane < Nvalues) ? values[index + lane] : 0.0f;
+        }
+
+        storeFloat(buffer, exponentialFloat(loadFloat(buffer)));
+
+        for (int lane = 0; index + lane < Nvalues; ++lane)
+        {
+            values[index + lane] = buffer[lane];
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+void logarithm(double *values, const long Nvalues)
+{
+    long index = 0;
+
+    for (; index + NdoubleLanes <= Nvalues; index += NdoubleLanes)
+    {
+        storeDouble(values + index, logarithmDouble(loadDouble(values + index)));
+    }
+
+    if (index < Nvalues)
+    {
+        double buffer[NdoubleLanes];
+
+        for (int lane = 0; lane < NdoubleLanes; ++lane)
+        {
+            buffer[lane] = (index + lane < Nvalues) ? values[index + lane] : 1.0;
+        }
+
+        storeDouble(buffer, logarithmDouble(loadDouble(buffer)));
+
+        for (int lane = 0; index + lane < Nvalues; ++lane)
+        {
+            values[index + lane] = buffer[lane];
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+void logarithm(float *values, const long Nvalues)
+{
+    long index = 0;
+
+    for (; index + NfloatLanes <= Nvalues; index += NfloatLanes)
+    {
+        storeFloat(values + index, logarithmFloat(loadFloat(values + index)));
+    }
+
+    if (index < Nvalues)
+    {
+        float buffer[NfloatLanes];
+
+        for (int lane = 0; lane < NfloatLanes; ++lane)
+        {
+            buffer[lane] = (index + lane < Nvalues) ? values[index + lane] : 1.0f;
+        }
+
+        storeFloat(buffer, logarithmFloat(loadFloat(buffer)));
+
+        for (int lane = 0; index + lane < Nvalues; ++lane)
+        {
+            values[index + lane] = buffer[lane];
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+void power(double *values, const double exponent, const long Nvalues)
+{
+    long index = 0;
+    VectorDouble vectorExponent = setDouble(exponent);
+
+    for (; index + NdoubleLanes <= Nvalues; index += NdoubleLanes)
+    {
+        VectorDouble x = loadDouble(values + index);
+        storeDouble(values + index, exponentialDouble(mulDouble(vectorExponent, logarithmDouble(x))));
+    }
+
+    if (index < Nvalues)
+    {
+        double buffer[NdoubleLanes];
+
+        for (int lane = 0; lane < NdoubleLanes; ++lane)
+        {
+            buffer[lane] = (index + lane < Nvalues) ? values[index + lane] : 1.0;
+        }
+
+        VectorDouble x = loadDouble(buffer);
+        storeDouble(buffer, exponentialDouble(mulDouble(vectorExponent, logarithmDouble(x))));
+
+        for (int lane = 0; index + lane < Nvalues; ++lane)
+        {
+            values[index + lane] = buffer[lane];
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+void power(float *values, const double exponent, const long Nvalues)
+{
+    long index = 0;
+    VectorFloat vectorExponent = setFloat(static_cast<float>(exponent));
+
+    for (; index + NfloatLanes <= Nvalues; index += NfloatLanes)
+    {
+        VectorFloat x = loadFloat(values + index);
+        storeFloat(values + index, exponentialFloat(mulFloat(vectorExponent, logarithmFloat(x))));
+    }
+
+    if (index < Nvalues)
+    {
+        float buffer[NfloatLanes];
+
+        for (int lane = 0; lane < NfloatLanes; ++lane)
+        {
+            buffer[lane] = (index + lane < Nvalues) ? values[index + lane] : 1.0f;
+        }
+
+        VectorFloat x = loadFloat(buffer);
+        storeFloat(buffer, exponentialFloat(mulFloat(vectorExponent, logarithmFloat(x))));
+
+        for (int lane = 0; index + lane < Nvalues; ++lane)
+        {
+            values[index + lane] = buffer[lane];
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// Sum of the terms w*(P/m + log(m)) of the log-likelihood. Missing weights are taken equal to 1.
+// The padding of the last incomplete vector uses P = 0, m = 1 and w = 0, so that its terms vanish.
+
+double sumLogLikelihoodTerms(const double *observations, const double *predictions, const double *weights, const long Nvalues)
+{
+    long index = 0;
+    VectorDouble sum = setDouble(0.0);
+
+    for (; index + NdoubleLanes <= Nvalues; index += NdoubleLanes)
+    {
+        VectorDouble prediction = loadDouble(predictions + index);
+        VectorDouble term = addDouble(divDouble(loadDouble(observations + index), prediction), logarithmDouble(prediction));
+
+        if (weights != 0)
+        {
+            term = mulDouble(term, loadDouble(weights + index));
+        }
+
+        sum = addDouble(sum, term);
+    }
+
+    double observationBuffer[NdoubleLanes];
+    double predictionBuffer[NdoubleLanes];
+    double weightBuffer[NdoubleLanes];
+
+    if (index < Nvalues)
+    {
+        for (int lane = 0; lane < NdoubleLanes; ++lane)
+        {
+            bool isInside = (index + lane < Nvalues);
+            observationBuffer[lane] = isInside ? observations[index + lane] : 0.0;
+            predictionBuffer[lane] = isInside ? predictions[index + lane] : 1.0;
+            weightBuffer[lane] = isInside ? ((weights != 0) ? weights[index + lane] : 1.0) : 0.0;
+        }
+
+        VectorDouble prediction = loadDouble(predictionBuffer);
+        VectorDouble term = addDouble(divDouble(loadDouble(observationBuffer), prediction), logarithmDouble(prediction));
+        sum = addDouble(sum, mulDouble(term, loadDouble(weightBuffer)));
+    }
+
+    storeDouble(observationBuffer, sum);
+    double totalSum = 0.0;
+
+    for (int lane = 0; lane < NdoubleLanes; ++lane)
+    {
+        totalSum += observationBuffer[lane];
+    }
+
+    return totalSum;
+}
+
+
+
+
+
+
+
+
+
+
+// The terms are computed in single precision and accumulated in double precision
+
+double sumLogLikelihoodTerms(const float *observations, const float *predictions, const float *weights, const long Nvalues)
+{
+    long index = 0;
+    VectorDouble sum = setDouble(0.0);
+
+    for (; index + NfloatLanes <= Nvalues; index += NfloatLanes)
+    {
+        VectorFloat prediction = loadFloat(predictions + index);
+        VectorFloat term = addFloat(divFloat(loadFloat(observations + index), prediction), logarithmFloat(prediction));
+
+        if (weights != 0)
+        {
+            term = mulFloat(term, loadFloat(weights + index));
+        }
+
+        sum = accumulateFloatInDouble(sum, term);
+    }
+
+    if (index < Nvalues)
+    {
+        float observationBuffer[NfloatLanes];
+        float predictionBuffer[NfloatLanes];
+        float weightBuffer[NfloatLanes];
+
+        for (int lane = 0; lane < NfloatLanes; ++lane)
+        {
+            bool isInside = (index + lane < Nvalues);
+            observationBuffer[lane] = isInside ? observations[index + lane] : 0.0f;
+            predictionBuffer[lane] = isInside ? predictions[index + lane] : 1.0f;
+            weightBuffer[lane] = isInside ? ((weights != 0) ? weights[index + lane] : 1.0f) : 0.0f;
+        }
+
+        VectorFloat prediction = loadFloat(predictionBuffer);
+        VectorFloat term = addFloat(divFloat(loadFloat(observationBuffer), prediction), logarithmFloat(prediction));
+        sum = accumulateFloatInDouble(sum, mulFloat(term, loadFloat(weightBuffer)));
+    }
+
+    double sumBuffer[NdoubleLanes];
+    storeDouble(sumBuffer, sum);
+    double totalSum = 0.0;
+
+    for (int lane = 0; lane < NdoubleLanes; ++lane)
+    {
+        totalSum += sumBuffer[lane];
+    }
+
+    return totalSum;
+}
@@ -0,0 +1,77 @@
+// Derived class for warm-starting a run from the posterior sample of a previous run of the same star.
+// For each free parameter the prior is a mixture of a uniform distribution over an inner box, centered on
+// the posterior mean of the previous run and extending a given number of standard deviations on each side,
+// and of the original uniform prior, which keeps a small weight so that the whole original prior range
+// is still explored. The sampler draws from this prior, which is much narrower than the original one,
+// while the likelihood is corrected by the ratio of the original prior to this prior
+// (see ImportanceCorrectedLikelihood.h), so that the evidence remains that of the original prior.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Header file "WarmStartPrior.h"
+// Implementations contained in "WarmStartPrior.cpp"
+
+
+#ifndef WARMSTARTPRIOR_H
+#define WARMSTARTPRIOR_H
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include "Prior.h"
+#include "UniformPrior.h"
+#include "File.h"
+#include "BackgroundResults.h"
+#include "ArchivedRun.h"
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXXd> RefArrayXXd;
+
+
+class WarmStartPrior : public Prior
+{
+    public:
+
+        WarmStartPrior(const RefArrayXd minima, const RefArrayXd maxima, const RefArrayXd innerMinima,
+                       const RefArrayXd innerMaxima, const double priorWeight);
+        ~WarmStartPrior();
+
+        ArrayXd getInnerMinima();
+        ArrayXd getInnerMaxima();
+        double logDensityRatio(RefArrayXd const x);
+
+        virtual double logDensity(RefArrayXd const x, const bool includeConstantTerm = false) override;
+        virtual bool drawnPointIsAccepted(RefArrayXd const drawnPoint) override;
+        virtual void draw(RefArrayXXd drawnSample) override;
+        virtual void drawWithConstraint(RefArrayXd drawnPoint, Likelihood &likelihood) override;
+        virtual void writeHyperParametersToFile(string fullPath) override;
+
+        static void readPosteriorMoments(const string runPathPrefix, ArrayXd &mean, ArrayXd &standardDeviation);
+
+
+    protected:
+
+
+    private:
+
+        ArrayXd minima;
+        ArrayXd maxima;
+        ArrayXd innerMinima;
+        ArrayXd innerMaxima;
+        double priorWeight;
+        ArrayXd logInnerDensity;
+        ArrayXd logOuterDensity;
+        uniform_real_distribution<> uniform;
+
+};
+
+
+#endif
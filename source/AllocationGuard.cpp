@@ -0,0 +1,236 @@
+#include "AllocationGuard.h"
+
+
+// State of the calling thread: the number of allocations, the name of the innermost guarded region,
+// null outside any region, and the depth of the permission scopes. Allocations made within a permission
+// scope are not counted.
+
+#ifdef BACKGROUND_DEBUG_ALLOCATIONS
+
+namespace
+{
+    thread_local unsigned long Nallocations = 0;
+    thread_local const char *guardedRegionName = nullptr;
+    thread_local int permissionDepth = 0;
+
+
+    // Eigen checks its allocations only while its flag forbids them. Since the flag is shared by all
+    // the threads, it is cleared once and for all, and each allocation of Eigen is then checked against
+    // the state of the calling thread by checkEigenAssertion()
+
+    const bool initialEigenMallocAllowed = Eigen::internal::set_is_malloc_allowed(false);
+}
+
+
+// Replacement of the global allocation functions, which counts the allocations made through new,
+// e.g. by the containers of the standard library. Eigen allocates with malloc, and its allocations 
+// are counted by checkEigenAssertion().
+
+void * operator new(size_t size)
+{
+    if (permissionDepth == 0)
+    {
+        ++Nallocations;
+    }
+
+    void *pointer = malloc(size == 0 ? 1 : size);
+
+    if (pointer == 0)
+    {
+        throw bad_alloc();
+    }
+
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    free(pointer);
+}
+
+
+
+
+
+
+
+
+
+
+
+
+// checkEigenAssertion()
+//
+// PURPOSE: 
+//      Handles a failed assertion of Eigen (see EigenAllocationCheck.h). The failed check of a heap 
+//      allocation is counted like an allocation through new, and aborts the program at once if the calling 
+//      thread is within a guarded region. Any other failed assertion aborts the program, as in Eigen.
+//
+// INPUT:
+//      condition:      a C string with the condition of the assertion.
+//      fileName:       a C string with the name of the source file of the assertion.
+//      line:           the line of the assertion in the source file.
+//
+
+void checkEigenAssertion(const char *condition, const char *fileName, const int line)
+{
+    if (strstr(condition, "is_malloc_allowed()") != nullptr)
+    {
+        if (permissionDepth > 0)
+        {
+            return;
+        }
+
+        ++Nallocations;
+
+        if (guardedRegionName != nullptr)
+        {
+            cerr << "Heap allocation by Eigen detected in " << guardedRegionName << "." << endl;
+            abort();
+        }
+
+        return;
+    }
+
+    #ifndef NDEBUG
+        cerr << fileName << ":" << line << ": Eigen assertion failed: " << condition << endl;
+        abort();
+    #endif
+}
+
+#endif
+
+
+
+
+
+
+
+
+
+
+// AllocationGuard::AllocationGuard()
+//
+// PURPOSE: 
+//      Constructor. Starts a region of code where heap allocations are forbidden to the calling thread.
+//      Any allocation made by Eigen within the region aborts the program immediately.
+//
+// INPUT:
+//      regionName:     a C string with the name of the region, used in the error message.
+//                      A C string is adopted so that no allocation is needed.
+//
+
+AllocationGuard::AllocationGuard(const char *regionName)
+: regionName(regionName),
+  previousRegionName(nullptr),
+  initialNallocations(0)
+{
+    #ifdef BACKGROUND_DEBUG_ALLOCATIONS
+        initialNallocations = Nallocations;
+        previousRegionName = guardedRegionName;
+        guardedRegionName = regionName;
+    #endif
+}
+
+
+
+
+
+
+
+
+
+
+// AllocationGuard::~AllocationGuard()
+//
+// PURPOSE: 
+//      Destructor. Ends the region and aborts the program if any allocation through new
+//      has been made within it.
+//
+
+AllocationGuard::~AllocationGuard()
+{
+    #ifdef BACKGROUND_DEBUG_ALLOCATIONS
+        guardedRegionName = previousRegionName;
+
+        if (Nallocations != initialNallocations)
+        {
+            cerr << "Heap allocation detected in " << regionName << ": " 
+                 << Nallocations - initialNallocations << " allocations." << endl;
+            abort();
+        }
+    #endif
+}
+
+
+
+
+
+
+
+
+
+
+// AllocationGuard::getNallocations()
+//
+// PURPOSE:
+//      Gets the number of allocations made through new or by Eigen by the calling thread, 
+//      outside the permission scopes.
+//
+// OUTPUT:
+//      An unsigned long integer with the number of allocations. It is always 0 if the
+//      code is not compiled with the CMake option DEBUG_ALLOCATIONS.
+//
+
+unsigned long AllocationGuard::getNallocations()
+{
+    #ifdef BACKGROUND_DEBUG_ALLOCATIONS
+        return Nallocations;
+    #else
+        return 0;
+    #endif
+}
+
+
+
+
+
+
+
+
+
+
+// AllocationGuard::Permission::Permission()
+//
+// PURPOSE: 
+//      Constructor. Starts a scope where heap allocations are permitted to the calling thread.
+//
+
+AllocationGuard::Permission::Permission()
+{
+    #ifdef BACKGROUND_DEBUG_ALLOCATIONS
+        ++permissionDepth;
+    #endif
+}
+
+
+
+
+
+
+
+
+
+
+// AllocationGuard::Permission::~Permission()
+//
+// PURPOSE: 
+//      Destructor. Ends the scope and restores the previous permission.
+//
+
+AllocationGuard::Permission::~Permission()
+{
+    #ifdef BACKGROUND_DEBUG_ALLOCATIONS
+        --permissionDepth;
+    #endif
+}
@@ -0,0 +1,94 @@
+#include "ArchivedRun.h"
+
+
+// ArchivedRun::ArchivedRun()
+//
+// PURPOSE:
+//      Constructor. If the output files of the run are not found in its output folder, but the
+//      archive of its results is, i.e. the file named as the output path prefix followed by results.zip,
+//      the archive is extracted into a temporary directory within TMPDIR (or /tmp if not set).
+//
+// INPUT:
+//      runPathPrefix:      a string containing the output path prefix of the run.
+//
+
+ArchivedRun::ArchivedRun(const string runPathPrefix)
+: pathPrefix(runPathPrefix)
+{
+    string archiveFileName = runPathPrefix + "results.zip";
+
+    if (ifstream(runPathPrefix + "evidenceInformation.txt").good() || !ifstream(archiveFileName).good())
+    {
+        return;
+    }
+
+    const char *temporaryPath = getenv("TMPDIR");
+    string directoryTemplate = string((temporaryPath != nullptr) && (temporaryPath[0] != '\0') ? temporaryPath : "/tmp") 
+                               + "/backgroundRun_XXXXXX";
+    vector<char> directoryName(directoryTemplate.begin(), directoryTemplate.end());
+    directoryName.push_back('\0');
+
+    if (mkdtemp(directoryName.data()) == nullptr)
+    {
+        cerr << "Error creating a temporary directory for extracting " << archiveFileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    temporaryDirectoryName = directoryName.data();
+    extractedFileNames = ResultsArchive::extractArchive(archiveFileName, temporaryDirectoryName);
+    pathPrefix = temporaryDirectoryName + "/" + runPathPrefix.substr(runPathPrefix.find_last_of('/') + 1);
+}
+
+
+
+
+
+
+
+
+
+
+// ArchivedRun::~ArchivedRun()
+//
+// PURPOSE:
+//      Destructor. Removes the files extracted from the archive, if any, and their temporary directory.
+//
+
+ArchivedRun::~ArchivedRun()
+{
+    if (temporaryDirectoryName.empty())
+    {
+        return;
+    }
+
+    for (size_t file = 0; file < extractedFileNames.size(); ++file)
+    {
+        remove((temporaryDirectoryName + "/" + extractedFileNames[file]).c_str());
+    }
+
+    rmdir(temporaryDirectoryName.c_str());
+}
+
+
+
+
+
+
+
+
+
+
+// ArchivedRun::getPathPrefix()
+//
+// PURPOSE:
+//      Gets the path prefix of the output files of the run, either in the output folder of the run, 
+//      or in the temporary directory where its archive has been extracted.
+//
+// OUTPUT:
+//      A string containing the path prefix of the output files.
+//
+
+string ArchivedRun::getPathPrefix()
+{
+    return pathPrefix;
+}
@@ -9,7 +9,9 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <algorithm>
 #include <Eigen/Dense>
+#include <sys/resource.h>
 #include "Functions.h"
 #include "File.h"
 #include "MultiEllipsoidSampler.h"
@@ -17,26 +19,811 @@
 #include "KmeansClusterer.h"
 #include "EuclideanMetric.h"
 #include "MixedPriorMaker.h"
-#include "ExponentialLikelihood.h"
-#include "ThreeHarveyColorBackgroundModel.h"
-#include "ThreeHarveyColorNoGaussianBackgroundModel.h"
-#include "ThreeHarveyBackgroundModel.h"
-#include "ThreeHarveyNoGaussianBackgroundModel.h"
-#include "TwoHarveyColorBackgroundModel.h"
-#include "TwoHarveyBackgroundModel.h"
-#include "TwoHarveyNoGaussianBackgroundModel.h"
-#include "OneHarveyColorBackgroundModel.h"
-#include "OneHarveyBackgroundModel.h"
-#include "OneHarveyFreeSlopeBackgroundModel.h"
-#include "OneHarveyFreeSlopeNoGaussianBackgroundModel.h"
-#include "OneHarveyNoGaussianBackgroundModel.h"
-#include "OriginalBackgroundModel.h"
-#include "FlatBackgroundModel.h"
-#include "FlatNoGaussianBackgroundModel.h"
+#include "BackgroundModelRegistry.h"
+#include "SinglePrecisionLikelihood.h"
+#include "GammaLikelihood.h"
+#include "BinIntegratedModel.h"
+#include "SpectrumRebinner.h"
+#include "SpectrumTrimmer.h"
+#include "VectorKernels.h"
+#include "BackgroundOptions.h"
 #include "FerozReducer.h"
 #include "PowerlawReducer.h"
-#include "Results.h"
+#include "ResultsWriter.h"
+#include "ResultsDatabase.h"
+#include "SpectrumContainer.h"
+#include "SpectrumCache.h"
+#include "ResultsArchive.h"
 #include "PrincipalComponentProjector.h"
+#include "PredictiveBands.h"
+#include "BackgroundPriorMaker.h"
+#include "NuMaxEstimator.h"
+#include "LaplaceEvidence.h"
+#include "EvidenceRace.h"
+#include "RacingSampler.h"
+#include "WarmStartPrior.h"
+#include "ImportanceCorrectedLikelihood.h"
+#include "PreviousRun.h"
+#include "ThresholdReweighter.h"
+#include "TemperedRefitter.h"
+#include "FidelityLadder.h"
+#include "SurrogateLikelihood.h"
+#include "SurrogateSampler.h"
+
+
+// Settings of a run, namely the arguments of the command line, the paths of the working session 
+// and the configuring options of the run. The frequency thresholds and the guess of nuMax that are
+// set automatically are completed once the dataset is read (see readDataset).
+
+struct RunSettings
+{
+    // Arguments of the command line
+
+    string CatalogID;
+    string StarID;
+    string runNumber;
+    string backgroundModelName;
+    string inputPriorBaseName;
+    int PCAflag;
+    bool automaticLowFrequencyThreshold;
+    bool automaticHighFrequencyThreshold;
+    double lowFrequencyThreshold;
+    double highFrequencyThreshold;
+    bool estimatedNuMax;
+    bool automaticPriors;
+    double nuMaxGuess;
+
+    // Paths of the working session
+
+    string localPath;
+    string baseInputDirName;
+    string datasetFileName;
+    string outputDirName;
+    string outputPathPrefix;
+
+    // Configuring options of the run
+
+    string outputFormat;
+    int NwriterThreads;
+    string resultsDatabaseName;
+    string outputArchive;
+    int NpredictiveDraws;
+    int NpredictiveBins;
+    int NpredictiveThreads;
+    string memoryMode;
+    string evidenceMethod;
+    string evidenceRaceName;
+    double raceMargin;
+    int NiterationsPerRaceUpdate;
+    double raceRemainderRatio;
+    string warmStartRun;
+    string warmStartModelName;
+    double warmStartWidth;
+    double warmStartPriorWeight;
+    string reweightRun;
+    double minReweightingEfficiency;
+    string incrementalRun;
+    string previousDatasetName;
+    double maxPosteriorShift;
+    int NsmcParticles;
+    int NsmcMoves;
+    int maxNtemperingSteps;
+    string spectrumContainerName;
+    string spectrumCacheDirName;
+    string rebinningMode;
+    int rebinningParameter;
+    string binEvaluation;
+    int NnodesPerBin;
+    string frequencyGrid;
+    double gridTolerance;
+    string precision;
+    int multiFidelityLevels;
+    int multiFidelityFactor;
+    string surrogateName;
+    int NsurrogateTrainingPoints;
+    double surrogateSafetyFactor;
+    double surrogateAuditFraction;
+    double surrogateMaxFalseRejectionRate;
+};
+
+
+
+// Dataset of a run, trimmed in the frequency range of the run. The views of the frequencies and of the
+// power spectral density refer either to the input data, or to the pages of the spectrum cache. The 
+// boundaries of the automatic priors, if required, are built from the untrimmed dataset.
+
+struct RunDataset
+{
+    RunDataset()
+    : spectrumCache(nullptr),
+      cachedSpectrum(false),
+      NyquistFromDataset(false),
+      NyquistFrequency(0.0),
+      covariates(nullptr, 0),
+      observations(nullptr, 0),
+      minFrequency(0.0),
+      maxFrequency(0.0),
+      thresholdReweighter(nullptr)
+    {
+    }
+
+    ArrayXXd data;
+    SpectrumCache *spectrumCache;
+    bool cachedSpectrum;
+    bool NyquistFromDataset;
+    double NyquistFrequency;
+    Eigen::Map<const ArrayXd> covariates;
+    Eigen::Map<const ArrayXd> observations;
+    double minFrequency;
+    double maxFrequency;
+    ArrayXXd automaticBoundaries;
+    ThresholdReweighter *thresholdReweighter;
+};
+
+
+
+
+
+
+
+
+
+
+// readRunArguments()
+//
+// PURPOSE:
+//      Reads the arguments of the command line and the local path of the working session, 
+//      and sets up the paths used in the computation.
+//
+// INPUT:
+//      argv:           the arguments of the command line, whose number has been checked already
+//      settings:       the settings of the run, which are filled in
+//
+
+void readRunArguments(char *argv[], RunSettings &settings)
+{
+    unsigned long Nrows;
+    int Ncols;
+    settings.CatalogID = argv[1];
+    settings.StarID = argv[2];
+    settings.runNumber = argv[3];
+    settings.backgroundModelName = argv[4];
+    settings.inputPriorBaseName = argv[5]; 
+    string inputLowFrequencyThreshold(argv[6]);
+    string inputHighFrequencyThreshold(argv[7]);
+    string inputPCAflag(argv[8]);
+    settings.PCAflag = stoi(inputPCAflag);
+
+
+    // Frequency thresholds given as auto are set from the estimate of nuMax. Until then they are 
+    // marked by a negative value, which also keeps their entry in the spectrum cache separate.
+
+    settings.automaticLowFrequencyThreshold = (inputLowFrequencyThreshold == "auto");
+    settings.automaticHighFrequencyThreshold = (inputHighFrequencyThreshold == "auto");
+    settings.lowFrequencyThreshold = settings.automaticLowFrequencyThreshold ? -1.0 : stod(inputLowFrequencyThreshold);
+    settings.highFrequencyThreshold = settings.automaticHighFrequencyThreshold ? -1.0 : stod(inputHighFrequencyThreshold);
+
+
+    // The priors are built from a raw guess of nuMax if the input prior base filename is given as auto:<nuMax>,
+    // or from nuMax estimated from the power excess in the dataset if it is given as auto
+
+    settings.estimatedNuMax = (settings.inputPriorBaseName == "auto");
+    settings.automaticPriors = settings.estimatedNuMax || (settings.inputPriorBaseName.compare(0, 5, "auto:") == 0);
+    settings.nuMaxGuess = (settings.automaticPriors && !settings.estimatedNuMax) ? stod(settings.inputPriorBaseName.substr(5)) : 0.0;
+
+
+    // Read the local path for the working session from an input ASCII file
+
+    ifstream inputFile;
+    File::openInputFile(inputFile, "localPath.txt");
+    File::sniffFile(inputFile, Nrows, Ncols);
+    vector<string> myLocalPath;
+    myLocalPath = File::vectorStringFromFile(inputFile, Nrows);
+    inputFile.close();
+    settings.localPath = settings.localPath;
+
+    
+    // Set up some string paths used in the computation
+
+    settings.baseInputDirName = settings.localPath + "data/";
+    settings.datasetFileName = settings.baseInputDirName + settings.CatalogID + settings.StarID + ".txt";
+    settings.outputDirName = settings.localPath + "results/" + settings.CatalogID + settings.StarID + "/";
+    settings.outputPathPrefix = settings.outputDirName + settings.runNumber + "/background_";
+}
+
+
+
+
+
+
+
+
+
+
+// readRunOptions()
+//
+// PURPOSE:
+//      Reads the configuring options of the run and checks their values, exiting with an error 
+//      for a value that is not allowed. The instruction set of the vectorized kernels is selected here.
+//
+// INPUT:
+//      options:        the configuring options of the run
+//      settings:       the settings of the run, whose arguments of the command line have been 
+//                      read already, and whose configuring options are filled in
+//
+
+void readRunOptions(BackgroundOptions &options, RunSettings &settings)
+{
+    // Select the instruction set of the vectorized kernels used by the models and the likelihood.
+    // By default the widest instruction set supported by the CPU is used.
+
+    string instructionSet = options.getString("instructionSet", "auto");
+
+    if ((instructionSet != "auto") && (instructionSet != "scalar") && (instructionSet != "sse4.2") 
+        && (instructionSet != "avx2") && (instructionSet != "avx512"))
+    {
+        cerr << "Unknown instruction set " << instructionSet << ". Use auto, scalar, sse4.2, avx2 or avx512." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (!VectorKernels::selectInstructionSet(instructionSet))
+    {
+        cerr << "Instruction set " << instructionSet << " is not supported by this CPU. " 
+             << "The widest supported instruction set is used instead." << endl;
+        VectorKernels::selectInstructionSet("auto");
+    }
+
+    cout << " Vectorized kernels: " << VectorKernels::getInstructionSetName() << endl;
+    cout << endl;
+
+
+    // Select the format of the output files containing the posterior sample
+
+    settings.outputFormat = options.getString("outputFormat", "text");
+
+    if ((settings.outputFormat != "text") && (settings.outputFormat != "npy"))
+    {
+        cerr << "Unknown output format " << settings.outputFormat << ". Use text or npy." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Set the number of threads writing the output files while the main program completes the run.
+    // If 0, the output files are written one after another at the end of the run.
+
+    settings.NwriterThreads = options.getInt("NwriterThreads", 4);
+
+    if (settings.NwriterThreads < 0)
+    {
+        cerr << "The number of writer threads must be >= 0." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Set the database file where the results of the run are collected together with those of the other runs.
+    // If not set, no database is used.
+
+    settings.resultsDatabaseName = options.getString("resultsDatabase", "");
+
+
+    // Select whether the output files of the run are kept as they are (none), or collected
+    // into a single compressed archive at the end of the run (zip)
+
+    settings.outputArchive = options.getString("outputArchive", "none");
+
+    if ((settings.outputArchive != "none") && (settings.outputArchive != "zip"))
+    {
+        cerr << "Unknown output archive " << settings.outputArchive << ". Use none or zip." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Set the number of equally-weighted posterior draws used for computing the posterior-predictive bands 
+    // of the background model and of its components, on a logarithmic grid of frequencies. If 0, no band is computed.
+
+    settings.NpredictiveDraws = options.getInt("NpredictiveDraws", 0);
+    settings.NpredictiveBins = options.getInt("NpredictiveBins", 1000);
+    settings.NpredictiveThreads = options.getInt("NpredictiveThreads", max(static_cast<int>(thread::hardware_concurrency()), 1));
+
+    if ((settings.NpredictiveDraws < 0) || (settings.NpredictiveBins < 2) || (settings.NpredictiveThreads < 1))
+    {
+        cerr << "The number of predictive draws must be >= 0, the number of predictive bins >= 2 "
+             << "and the number of predictive threads >= 1." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Select the memory mode of the run. In the lean mode the memory used by the dataset is reduced
+    // as much as possible, which allows running more processes on the same machine with large datasets.
+
+    settings.memoryMode = options.getString("memoryMode", "standard");
+
+    if ((settings.memoryMode != "standard") && (settings.memoryMode != "lean"))
+    {
+        cerr << "Unknown memory mode " << settings.memoryMode << ". Use standard or lean." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Select the method for computing the evidence. The laplace method replaces the nested sampling 
+    // with the Laplace approximation around the MAP, which is much faster and is meant for pre-screening 
+    // the models, so that only the most promising ones are run with the nested sampling.
+
+    settings.evidenceMethod = options.getString("evidenceMethod", "nestedSampling");
+
+    if ((settings.evidenceMethod != "nestedSampling") && (settings.evidenceMethod != "laplace"))
+    {
+        cerr << "Unknown evidence method " << settings.evidenceMethod << ". Use nestedSampling or laplace." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Set the name of the evidence race of the run against the runs of the other models of the star, if any.
+    // Every NiterationsPerRaceUpdate nested iterations the bounds of the evidence are posted to the race board, 
+    // and the run is stopped if its upper bound is below the lower bound of the leader by more than raceMargin 
+    // in natural logarithm of the Bayes factor (see tools/raceModels.cpp). The upper bound is only tested once 
+    // the estimated remainder of the evidence is below raceRemainderRatio times the evidence accumulated so far.
+
+    settings.evidenceRaceName = options.getString("evidenceRace", "");
+    settings.raceMargin = options.getDouble("raceMargin", 5.0);
+    settings.NiterationsPerRaceUpdate = options.getInt("NiterationsPerRaceUpdate", 100);
+    settings.raceRemainderRatio = options.getDouble("raceRemainderRatio", 1.0);
+
+    if ((settings.raceMargin < 0.0) || (settings.NiterationsPerRaceUpdate < 1) || (settings.raceRemainderRatio <= 0.0))
+    {
+        cerr << "The race margin must be >= 0, the number of iterations per race update >= 1 " << endl;
+        cerr << "and the remainder ratio of the race > 0." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Warm-start the run from the posterior sample of a previous run of the star, if any. The sampler draws 
+    // from a prior narrowed around the previous posterior, namely a mixture of a uniform distribution over 
+    // warmStartWidth standard deviations on each side of the previous posterior mean, and of the original prior 
+    // with weight warmStartPriorWeight. The likelihood is corrected by the ratio of the two priors, so that the
+    // evidence is still that of the original prior. The previous run can adopt a different background model 
+    // (warmStartModel), whose parameters are matched to those of this run by their names (see BackgroundModelRegistry).
+
+    settings.warmStartRun = options.getString("warmStartRun", "");
+    settings.warmStartModelName = options.getString("warmStartModel", settings.backgroundModelName);
+    settings.warmStartWidth = options.getDouble("warmStartWidth", 6.0);
+    settings.warmStartPriorWeight = options.getDouble("warmStartPriorWeight", 0.01);
+
+    if (!settings.warmStartRun.empty() && ((settings.warmStartRun == settings.runNumber) || (settings.warmStartWidth <= 0.0) 
+        || (settings.warmStartPriorWeight <= 0.0) || (settings.warmStartPriorWeight > 1.0)))
+    {
+        cerr << "The warm-start run must differ from the current run, the warm-start width must be > 0 " << endl;
+        cerr << "and the weight of the original prior in (0, 1]." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Refit the model for new frequency thresholds by reweighting the posterior sample of a previous run of the 
+    // same model (reweightRun), instead of running a new nested sampling. A full run is performed if the effective 
+    // sample size of the reweighted posterior is below minReweightingEfficiency times that of the previous posterior, 
+    // or if the reweighting is not possible, i.e. for a different background model, for a rebinned dataset, 
+    // or for priors that are not uniform or that extend beyond those of the previous run.
+
+    settings.reweightRun = options.getString("reweightRun", "");
+    settings.minReweightingEfficiency = options.getDouble("minReweightingEfficiency", 0.5);
+
+    if (!settings.reweightRun.empty() && ((settings.reweightRun == settings.runNumber) || (settings.minReweightingEfficiency < 0.0) || (settings.minReweightingEfficiency > 1.0)))
+    {
+        cerr << "The reweighted run must differ from the current run, and the minimum reweighting efficiency must be in [0, 1]." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Refit the model on a new dataset of the star, e.g. extended by new observing sectors or quarters, starting 
+    // from the posterior sample of a previous run of the same model on the previous dataset (incrementalRun), 
+    // which is read from the file previousDataset in the data directory. The posterior sample is moved from the 
+    // previous likelihood to the new one by SMC tempering with NsmcParticles particles, each moved by NsmcMoves
+    // Metropolis steps after each resampling (see TemperedRefitter). A full run is performed if the tempering 
+    // does not end within maxNtemperingSteps steps, if the posterior mean of a free parameter shifts by more than 
+    // maxPosteriorShift previous posterior standard deviations, or if the refit is not possible, as for the reweighting.
+
+    settings.incrementalRun = options.getString("incrementalRun", "");
+    settings.previousDatasetName = options.getString("previousDataset", "");
+    settings.maxPosteriorShift = options.getDouble("maxPosteriorShift", 3.0);
+    settings.NsmcParticles = options.getInt("NsmcParticles", 1000);
+    settings.NsmcMoves = options.getInt("NsmcMoves", 5);
+    settings.maxNtemperingSteps = options.getInt("maxNtemperingSteps", 200);
+
+    if (!settings.incrementalRun.empty() && ((settings.incrementalRun == settings.runNumber) || settings.previousDatasetName.empty() || (settings.maxPosteriorShift <= 0.0) 
+        || (settings.NsmcParticles < 2) || (settings.NsmcMoves < 1) || (settings.maxNtemperingSteps < 1)))
+    {
+        cerr << "The incremental run must differ from the current run, the previous dataset must be set, the maximum " << endl;
+        cerr << "posterior shift must be > 0, and the numbers of particles, moves and tempering steps >= 2, 1 and 1." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (!settings.reweightRun.empty() && !settings.incrementalRun.empty())
+    {
+        cerr << "A run cannot be both reweighted and incremental." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read the input dataset either from the ASCII file of the star or from a container file packing the datasets 
+    // of many stars (spectrumContainer), and map the trimmed dataset from a node-local spectrum cache if a cache 
+    // directory is set (spectrumCache). See readDataset.
+
+    settings.spectrumContainerName = options.getString("spectrumContainer", "");
+    settings.spectrumCacheDirName = options.getString("spectrumCache", "");
+
+
+    // Rebin the trimmed dataset if required, either by a constant factor or logarithmically, and evaluate the 
+    // background model either at the center of each rebinned bin (midbin), or averaged over the bin width (integrated)
+
+    settings.rebinningMode = options.getString("rebinningMode", "none");
+    settings.rebinningParameter = 1;
+
+    if (settings.rebinningMode == "factor")
+    {
+        settings.rebinningParameter = options.getInt("rebinningFactor", 1);
+    }
+    else if (settings.rebinningMode == "logarithmic")
+    {
+        settings.rebinningParameter = options.getInt("NbinsPerDecade", 100);
+    }
+    else if (settings.rebinningMode != "none")
+    {
+        cerr << "Unknown rebinning mode " << settings.rebinningMode << ". Use none, factor or logarithmic." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    settings.binEvaluation = options.getString("binEvaluation", "midbin");
+    settings.NnodesPerBin = 1;
+
+    if ((settings.binEvaluation != "midbin") && (settings.binEvaluation != "integrated"))
+    {
+        cerr << "Unknown bin evaluation " << settings.binEvaluation << ". Use midbin or integrated." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if ((settings.rebinningMode != "none") && (settings.binEvaluation == "integrated"))
+    {
+        settings.NnodesPerBin = options.getInt("NnodesPerBin", 3);
+    }
+
+
+    // Generate the frequencies of the model on the fly from a uniform grid descriptor if required
+
+    settings.frequencyGrid = options.getString("frequencyGrid", "stored");
+    settings.gridTolerance = options.getDouble("gridTolerance", 1.e-6);
+
+    if ((settings.frequencyGrid != "stored") && (settings.frequencyGrid != "uniform"))
+    {
+        cerr << "Unknown frequency grid " << settings.frequencyGrid << ". Use stored or uniform." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Evaluate the model and the likelihood in mixed precision if required
+
+    settings.precision = options.getString("precision", "double");
+
+    if ((settings.precision != "single") && (settings.precision != "double"))
+    {
+        cerr << "Unknown precision " << settings.precision << ". Use double or single." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Set up the multi-fidelity schedule of the likelihood, which uses the particles, moves and maximum
+    // number of tempering steps of the incremental refit (see FidelityLadder)
+
+    settings.multiFidelityLevels = options.getInt("multiFidelityLevels", 1);
+    settings.multiFidelityFactor = options.getInt("multiFidelityFactor", 4);
+
+    if ((settings.multiFidelityLevels < 1) || (settings.multiFidelityFactor < 2) 
+        || ((settings.multiFidelityLevels > 1) && ((settings.NsmcParticles < 2) || (settings.NsmcMoves < 1) || (settings.maxNtemperingSteps < 1))))
+    {
+        cerr << "The number of multi-fidelity levels must be >= 1 and the multi-fidelity factor >= 2, with numbers " << endl;
+        cerr << "of particles, moves and tempering steps >= 2, 1 and 1." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Screen the points drawn by the nested sampler with a quadratic surrogate of the log-likelihood, if required
+    // (surrogate = quadratic), fitted to the last NsurrogateTrainingPoints exact evaluations. A drawn point is 
+    // rejected without evaluating the likelihood if its predicted log-likelihood lies below the constraint by more
+    // than surrogateSafetyFactor RMS prediction errors, while a fraction surrogateAuditFraction of the rejected
+    // points is evaluated anyway to verify the screening. If more than surrogateMaxFalseRejectionRate of the
+    // audited points would have been accepted, the safety factor is widened or the screening stopped (see SurrogateLikelihood).
+
+    settings.surrogateName = options.getString("surrogate", "none");
+    settings.NsurrogateTrainingPoints = options.getInt("NsurrogateTrainingPoints", 1000);
+    settings.surrogateSafetyFactor = options.getDouble("surrogateSafetyFactor", 4.0);
+    settings.surrogateAuditFraction = options.getDouble("surrogateAuditFraction", 0.05);
+    settings.surrogateMaxFalseRejectionRate = options.getDouble("surrogateMaxFalseRejectionRate", 0.01);
+
+    if ((settings.surrogateName != "none") && (settings.surrogateName != "quadratic"))
+    {
+        cerr << "Unknown surrogate " << settings.surrogateName << ". Use none or quadratic." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if ((settings.surrogateSafetyFactor < 0.0) || (settings.surrogateAuditFraction < 0.0) || (settings.surrogateAuditFraction > 1.0)
+        || (settings.surrogateMaxFalseRejectionRate < 0.0) || (settings.surrogateMaxFalseRejectionRate > 1.0))
+    {
+        cerr << "The surrogate safety factor must be >= 0, the audit fraction and the maximum rate of false rejections in [0, 1]." << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// readDataset()
+//
+// PURPOSE:
+//      Reads the dataset of the run, either from the ASCII file of the star, from a container
+//      file of many stars, or from the node-local spectrum cache, and trims it in the frequency 
+//      range of the run. The automatic frequency thresholds and the guess of nuMax are estimated
+//      from the dataset if required, and the trimmed dataset is stored in the spectrum cache.
+//      The boundaries of the automatic priors are built from the untrimmed dataset, if required.
+//
+// INPUT:
+//      settings:       the settings of the run. The automatic frequency thresholds and the 
+//                      guess of nuMax are updated with the values set from the dataset.
+//      previousRun:    the previous run to be reweighted for the new frequency thresholds, if any
+//      dataset:        the dataset of the run, which is filled in. The views of the trimmed 
+//                      dataset remain valid as long as the dataset and its spectrum cache are kept.
+//
+
+void readDataset(RunSettings &settings, PreviousRun *previousRun, RunDataset &dataset)
+{
+    unsigned long Nrows;
+    int Ncols;
+    ifstream inputFile;
+
+
+    // Read the input dataset, either from the ASCII file of the star or from a container file 
+    // packing the datasets of many stars, together with their Nyquist frequency (see tools/packSpectra.cpp)
+
+    SpectrumContainer *spectrumContainer = nullptr;
+    const SpectrumContainer::IndexEntry *spectrumEntry = nullptr;
+
+    if (!settings.spectrumContainerName.empty())
+    {
+        spectrumContainer = new SpectrumContainer(settings.spectrumContainerName);
+        spectrumEntry = spectrumContainer->findStar(settings.CatalogID + settings.StarID);
+
+        if (spectrumEntry == nullptr)
+        {
+            cerr << "Star " << settings.CatalogID + settings.StarID << " is not contained in " << settings.spectrumContainerName << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        dataset.NyquistFrequency = spectrumEntry->NyquistFrequency;
+    }
+
+
+    // With automatic priors and no file of the Nyquist frequency, the Nyquist frequency is set to the 
+    // largest frequency of the dataset, as done by the python routine set_background_priors. This is 
+    // decided before looking up the spectrum cache, because the Nyquist frequency identifies the entry.
+
+    dataset.NyquistFromDataset = settings.automaticPriors && settings.spectrumContainerName.empty() 
+                              && !ifstream(settings.outputDirName + "NyquistFrequency.txt").good();
+
+
+    // Look up the trimmed dataset in the node-local spectrum cache, if a cache directory is set.
+    // The entry of the cache is written by the first process fitting the same dataset with the same 
+    // thresholds and Nyquist frequency, and is then mapped read-only by all the following processes.
+    // A Nyquist frequency taken from the dataset is identified by 0, since it is determined by the 
+    // source file of the dataset, and its actual value is stored in the entry.
+
+    // For the reweighting the cache is not used, since the bins removed from the frequency range 
+    // are only available in the untrimmed dataset
+
+    if (!settings.spectrumCacheDirName.empty() && settings.reweightRun.empty())
+    {
+        if (settings.spectrumContainerName.empty() && !dataset.NyquistFromDataset)
+        {
+            File::openInputFile(inputFile, settings.outputDirName + "NyquistFrequency.txt");
+            File::sniffFile(inputFile, Nrows, Ncols);
+            dataset.NyquistFrequency = File::arrayXXdFromFile(inputFile, Nrows, Ncols)(0, 0);
+            inputFile.close();
+        }
+
+        string sourceFileName = settings.spectrumContainerName.empty() ? settings.datasetFileName : settings.spectrumContainerName;
+        dataset.spectrumCache = new SpectrumCache(settings.spectrumCacheDirName, settings.CatalogID + settings.StarID, sourceFileName, 
+                                                  settings.lowFrequencyThreshold, settings.highFrequencyThreshold, dataset.NyquistFrequency);
+        dataset.cachedSpectrum = dataset.spectrumCache->load();
+    }
+
+    if (dataset.cachedSpectrum)
+    {
+        settings.lowFrequencyThreshold = dataset.spectrumCache->getLowFrequencyThreshold();
+        settings.highFrequencyThreshold = dataset.spectrumCache->getHighFrequencyThreshold();
+        dataset.NyquistFrequency = dataset.spectrumCache->getNyquistFrequency();
+        
+        cout << " Trimmed dataset mapped from " << dataset.spectrumCache->getFileName() << endl;
+        cout << endl;
+    }
+    else if (settings.spectrumContainerName.empty())
+    {
+        File::openInputFile(inputFile, settings.datasetFileName);
+        File::sniffFile(inputFile, Nrows, Ncols);
+        dataset.data = File::arrayXXdFromFile(inputFile, Nrows, Ncols);
+        inputFile.close();
+    }
+    else
+    {
+        dataset.data = spectrumContainer->getSpectrum(*spectrumEntry);
+    }
+
+
+    // Read-only views of the frequencies and power spectral density of the dataset. For a dataset mapped from 
+    // the spectrum cache, they refer directly to the pages of the cache, which are mapped read-only, so that 
+    // no private copy is made. The dataset is never modified through the views.
+
+    long NinputBins = dataset.cachedSpectrum ? dataset.spectrumCache->getCovariates().size() : dataset.data.rows();
+    Eigen::Map<const ArrayXd> inputCovariates(dataset.cachedSpectrum ? dataset.spectrumCache->getCovariates().data() 
+                                                                     : dataset.data.col(0).data(), NinputBins);
+    Eigen::Map<const ArrayXd> inputObservations(dataset.cachedSpectrum ? dataset.spectrumCache->getObservations().data() 
+                                                                       : dataset.data.col(1).data(), NinputBins);
+
+
+    // The Nyquist frequency taken from the dataset is the largest frequency of the entire dataset, before
+    // trimming. For a dataset mapped from the spectrum cache, it has been read already from the entry.
+
+    if (dataset.NyquistFromDataset && !dataset.cachedSpectrum)
+    {
+        dataset.NyquistFrequency = inputCovariates.maxCoeff();
+    }
+
+
+    // Trim input dataset in the given frequency range, unless it has been read already trimmed from the 
+    // spectrum cache. The range is found by a binary search on the frequencies, and the trimmed dataset 
+    // is accessed through views of the input dataset, so that no copy is made.
+
+    SpectrumTrimmer trimmer(inputCovariates);
+
+    if (!dataset.cachedSpectrum)
+    {
+        trimmer.trim(settings.lowFrequencyThreshold, settings.highFrequencyThreshold);
+    }
+
+    new (&dataset.covariates) Eigen::Map<const ArrayXd>(trimmer.getTrimmedView(inputCovariates));
+    new (&dataset.observations) Eigen::Map<const ArrayXd>(trimmer.getTrimmedView(inputObservations));
+
+
+    // Estimate nuMax from the power excess in the dataset, if required by the priors or by the thresholds.
+    // The automatic thresholds are set at nuMax/100 and 10 nuMax, within the range of the dataset, and the 
+    // dataset is trimmed again accordingly, unless it has been read already trimmed from the cache. The final
+    // estimate is always made on the trimmed dataset, so that it does not depend on the use of the cache.
+
+    if (settings.estimatedNuMax || settings.automaticLowFrequencyThreshold || settings.automaticHighFrequencyThreshold)
+    {
+        NuMaxEstimator nuMaxEstimator(dataset.covariates, dataset.observations);
+
+        if (!dataset.cachedSpectrum && (settings.automaticLowFrequencyThreshold || settings.automaticHighFrequencyThreshold))
+        {
+            if (settings.automaticLowFrequencyThreshold)
+            {
+                settings.lowFrequencyThreshold = nuMaxEstimator.getNuMax() / 100.0;
+            }
+
+            if (settings.automaticHighFrequencyThreshold)
+            {
+                settings.highFrequencyThreshold = 10.0 * nuMaxEstimator.getNuMax();
+            }
+
+            trimmer.trim(settings.lowFrequencyThreshold, settings.highFrequencyThreshold);
+            new (&dataset.covariates) Eigen::Map<const ArrayXd>(trimmer.getTrimmedView(inputCovariates));
+            new (&dataset.observations) Eigen::Map<const ArrayXd>(trimmer.getTrimmedView(inputObservations));
+            nuMaxEstimator = NuMaxEstimator(dataset.covariates, dataset.observations);
+        }
+
+        nuMaxEstimator.writeToFile(settings.outputPathPrefix + "nuMaxEstimate.txt");
+
+        cout << " Estimated nuMax = " << setprecision(4) << nuMaxEstimator.getNuMax() << " muHz (significance " 
+             << nuMaxEstimator.getSignificance() << "), granulation level " << nuMaxEstimator.getGranulationLevel()
+             << ", white noise level " << nuMaxEstimator.getWhiteNoiseLevel() << endl;
+        cout << endl;
+
+        if (settings.estimatedNuMax)
+        {
+            settings.nuMaxGuess = nuMaxEstimator.getNuMax();
+        }
+    }
+
+    if ((dataset.spectrumCache != nullptr) && !dataset.cachedSpectrum)
+    {
+        dataset.spectrumCache->store(dataset.covariates, dataset.observations, settings.lowFrequencyThreshold, 
+                                     settings.highFrequencyThreshold, dataset.NyquistFrequency);
+    }
+
+
+    // Build the boundaries of the automatic priors from the untrimmed dataset, before any rebinning, as done by
+    // the python routine set_background_priors, which uses the entire spectrum of the star, e.g. for the white noise
+    // at the high-frequency end and for the lowest frequency of the rotation and colored noise. For a dataset 
+    // mapped from the spectrum cache, the untrimmed dataset is read again from its source and released right after.
+
+    if (settings.automaticPriors)
+    {
+        ArrayXXd untrimmedData;
+        Eigen::Map<const ArrayXd> untrimmedCovariates(inputCovariates);
+        Eigen::Map<const ArrayXd> untrimmedObservations(inputObservations);
+
+        if (dataset.cachedSpectrum)
+        {
+            if (spectrumContainer == nullptr)
+            {
+                File::openInputFile(inputFile, settings.datasetFileName);
+                File::sniffFile(inputFile, Nrows, Ncols);
+                untrimmedData = File::arrayXXdFromFile(inputFile, Nrows, Ncols);
+                inputFile.close();
+            }
+            else
+            {
+                untrimmedData = spectrumContainer->getSpectrum(*spectrumEntry);
+            }
+
+            new (&untrimmedCovariates) Eigen::Map<const ArrayXd>(untrimmedData.col(0).data(), untrimmedData.rows());
+            new (&untrimmedObservations) Eigen::Map<const ArrayXd>(untrimmedData.col(1).data(), untrimmedData.rows());
+        }
+
+        BackgroundPriorMaker priorMaker(untrimmedCovariates, untrimmedObservations, settings.nuMaxGuess);
+        dataset.automaticBoundaries = priorMaker.getBoundaries(settings.backgroundModelName);
+
+        cout << " Automatic priors of the " << settings.backgroundModelName << " model from nuMax = " 
+             << settings.nuMaxGuess << " muHz" << endl;
+        cout << endl;
+    }
+
+
+    // For the reweighting, select the bins of the dataset that are added to the frequency range of the 
+    // previous run, and those that are removed from it, while the untrimmed dataset is available
+
+    if (!settings.reweightRun.empty())
+    {
+        dataset.thresholdReweighter = new ThresholdReweighter(*previousRun);
+        dataset.thresholdReweighter->selectBins(dataset.data, trimmer.getFirstBin(), trimmer.getNbins());
+    }
+
+    delete spectrumContainer;
+
+
+    // In the lean memory mode, keep only the trimmed frequencies and power spectral density in a single
+    // buffer, and release the input data right away, including any additional column of the input file.
+    // A dataset mapped from the spectrum cache is already trimmed and held by the shared pages of the cache.
+
+    if ((settings.memoryMode == "lean") && !dataset.cachedSpectrum 
+        && ((dataset.covariates.size() != dataset.data.rows()) || (dataset.data.cols() != 2)))
+    {
+        ArrayXXd trimmedData(dataset.covariates.size(), 2);
+        trimmedData.col(0) = dataset.covariates;
+        trimmedData.col(1) = dataset.observations;
+        dataset.data.swap(trimmedData);
+        trimmedData.resize(0, 0);
+
+        new (&dataset.covariates) Eigen::Map<const ArrayXd>(dataset.data.col(0).data(), dataset.data.rows());
+        new (&dataset.observations) Eigen::Map<const ArrayXd>(dataset.data.col(1).data(), dataset.data.rows());
+    }
+
+    dataset.minFrequency = dataset.covariates.minCoeff();
+    dataset.maxFrequency = dataset.covariates.maxCoeff();
+
+    cout << "------------------------------------------------------- " << endl;
+    cout << " Frequency range: [" << setprecision(4) << dataset.minFrequency << ", " 
+        << dataset.maxFrequency << "] muHz" << endl;
+    cout << "------------------------------------------------------- " << endl;
+    cout << endl; 
+}
+
+
+
+
+
+
+
 
 
 int main(int argc, char *argv[])
@@ -47,6 +834,8 @@ int main(int argc, char *argv[])
     if (argc != 9)
     {
         cerr << "Usage: ./background <Catalog ID> <Star ID> <run number> <background model> <input prior base filename> <low-frequency threshold (uHz)> <high-frequency threshold (uHz)> <PCA flag> " << endl;
+        cerr << "The input prior base filename can be replaced by auto:<nuMax (uHz)> for building the priors from a guess of nuMax," << endl;
+        cerr << "or by auto for building them from nuMax estimated from the dataset. Thresholds given as auto are set from the same estimate." << endl;
         exit(EXIT_FAILURE);
     }
     
@@ -55,257 +844,421 @@ int main(int argc, char *argv[])
     // ----- Read input data -----
     // ---------------------------
 
-    unsigned long Nrows;
     int Ncols;
-    ArrayXXd data;
-    string CatalogID(argv[1]);
-    string StarID(argv[2]);
-    string runNumber(argv[3]);
-    string backgroundModelName(argv[4]);
-    string inputPriorBaseName(argv[5]); 
-    string inputLowFrequencyThreshold(argv[6]);
-    string inputHighFrequencyThreshold(argv[7]);
-    string inputPCAflag(argv[8]);
-    double lowFrequencyThreshold = stod(inputLowFrequencyThreshold);
-    double highFrequencyThreshold = stod(inputHighFrequencyThreshold);
-    int PCAflag = stoi(inputPCAflag);
-
-
-    // Read the local path for the working session from an input ASCII file
-
     ifstream inputFile;
-    File::openInputFile(inputFile, "localPath.txt");
-    File::sniffFile(inputFile, Nrows, Ncols);
-    vector<string> myLocalPath;
-    myLocalPath = File::vectorStringFromFile(inputFile, Nrows);
-    inputFile.close();
-
-    
-    // Set up some string paths used in the computation
-
-    string baseInputDirName = myLocalPath[0] + "data/";
-    string inputFileName = baseInputDirName + CatalogID + StarID + ".txt";
-    string outputDirName = myLocalPath[0] + "results/" + CatalogID + StarID + "/";
-    string outputPathPrefix = outputDirName + runNumber + "/background_";
+    string inputFileName;
+    RunSettings settings;
+    readRunArguments(argv, settings);
     
     cout << "------------------------------------------------ " << endl;
-    cout << " Background analysis of " + CatalogID + StarID << endl;
+    cout << " Background analysis of " + settings.CatalogID + settings.StarID << endl;
     cout << "------------------------------------------------ " << endl;
     cout << endl; 
 
 
-    // Read the input dataset
+    // Read the optional configuring options of the run, if any are provided
 
-    File::openInputFile(inputFile, inputFileName);
-    File::sniffFile(inputFile, Nrows, Ncols);
-    data = File::arrayXXdFromFile(inputFile, Nrows, Ncols);
-    inputFile.close();
+    BackgroundOptions options(settings.outputDirName + "background_configuringOptions_" + settings.runNumber + ".txt");
+    options.printOptions();
+    readRunOptions(options, settings);
 
-   
-    // Create arrays for each data type
 
-    ArrayXd covariates = data.col(0);
-    ArrayXd observations = data.col(1); 
- 
+    // Check whether the previous run to be refitted, if any, can be refitted by this run
 
-    // Trim input dataset in the given frequency range
+    string previousRunNumber = settings.reweightRun.empty() ? settings.incrementalRun : settings.reweightRun;
+    PreviousRun *previousRun = nullptr;
 
-    if ((lowFrequencyThreshold > covariates.minCoeff()) && (lowFrequencyThreshold != 0.0))
+    if (!previousRunNumber.empty())
     {
-        // Activate the trimming for the low-frequency part of the dataset only if a meaningful low-frequency threshold is supplied
+        previousRun = new PreviousRun(settings.outputDirName + previousRunNumber + "/background_");
 
-        double lowerFrequency = lowFrequencyThreshold;
-        double upperFrequency = covariates.maxCoeff();
-    
-        vector<int> trimIndices = Functions::findArrayIndicesWithinBoundaries(covariates, lowerFrequency, upperFrequency);
-        int Nbins = trimIndices.size();
-        ArrayXd trimmedArray(Nbins);
-            
-        trimmedArray = covariates.segment(trimIndices[0],Nbins);
-        covariates.resize(Nbins);
-        covariates = trimmedArray;
-        trimmedArray = observations.segment(trimIndices[0],Nbins);
-        observations.resize(Nbins);
-        observations = trimmedArray;
+        if ((previousRun->getBackgroundModelName() != settings.backgroundModelName) || (previousRun->getRebinningMode() != "none") 
+            || (!settings.reweightRun.empty() && (settings.rebinningMode != "none")))
+        {
+            cerr << "Run " << previousRunNumber << " cannot be refitted: a different background model or a rebinned dataset is used." << endl;
+            cerr << "A full run is performed." << endl;
+            delete previousRun;
+            previousRun = nullptr;
+            settings.reweightRun = "";
+            settings.incrementalRun = "";
+        }
     }
-    else
-    {
-        // Set input low-frequency threshold to 0 in case it is not larger than the minimum frequency of the dataset.
-        // This implies that it is not used within the computation.
 
-        lowFrequencyThreshold = 0.0;
-    }
 
-    if ((highFrequencyThreshold < covariates.maxCoeff() && highFrequencyThreshold != 0.0) && (highFrequencyThreshold > covariates.minCoeff()))
-    {
-        // Activate the trimming for the high-frequency part of the dataset only if a meaningful high-frequency threshold is supplied
+    // Read the input dataset and trim it in the frequency range of the run
 
-        double lowerFrequency = covariates.minCoeff();
-        double upperFrequency = highFrequencyThreshold;
-    
-        vector<int> trimIndices = Functions::findArrayIndicesWithinBoundaries(covariates, lowerFrequency, upperFrequency);
-        int Nbins = trimIndices.size();
-        ArrayXd trimmedArray(Nbins);
-            
-        trimmedArray = covariates.segment(trimIndices[0],Nbins);
-        covariates.resize(Nbins);
-        covariates = trimmedArray;
-        trimmedArray = observations.segment(trimIndices[0],Nbins);
-        observations.resize(Nbins);
-        observations = trimmedArray;
-    }
-    else
+    RunDataset dataset;
+    readDataset(settings, previousRun, dataset);
+
+
+    // Rebin the trimmed dataset if required. Each rebinned bin stores the average of the original bins 
+    // and its weight, i.e. the number of bins averaged, which is used in the likelihood.
+
+    ArrayXd binWeights;
+    ArrayXd binWidths;
+    ArrayXd rebinnedCovariates;
+    ArrayXd rebinnedObservations;
+
+    if (settings.rebinningMode != "none")
     {
-        // Set input high-frequency threshold to 0 in case it is not larger than the minimum frequency of the dataset and smaller
-        // than the maximum frequency of the dataset.
-        // This implies that it is not used within the computation.
+        SpectrumRebinner rebinner(dataset.covariates, dataset.observations);
 
-        highFrequencyThreshold = 0.0;
+        if (settings.rebinningMode == "factor")
+        {
+            rebinner.rebinByFactor(settings.rebinningParameter);
+        }
+        else
+        {
+            rebinner.rebinLogarithmically(settings.rebinningParameter);
+        }
+
+        cout << "------------------------------------------------------- " << endl;
+        cout << " Rebinning (" << settings.rebinningMode << "): " << dataset.covariates.size() << " -> " 
+            << rebinner.getNbins() << " bins" << endl;
+        cout << "------------------------------------------------------- " << endl;
+        cout << endl; 
+
+        // The views of the dataset now refer to the rebinned arrays
+
+        rebinnedCovariates = rebinner.getCovariates();
+        rebinnedObservations = rebinner.getObservations();
+        new (&dataset.covariates) Eigen::Map<const ArrayXd>(rebinnedCovariates.data(), rebinnedCovariates.size());
+        new (&dataset.observations) Eigen::Map<const ArrayXd>(rebinnedObservations.data(), rebinnedObservations.size());
+        binWeights = rebinner.getBinWeights();
+        binWidths = rebinner.getBinWidths();
     }
 
-    cout << "------------------------------------------------------- " << endl;
-    cout << " Frequency range: [" << setprecision(4) << covariates.minCoeff() << ", " 
-        << covariates.maxCoeff() << "] muHz" << endl;
-    cout << "------------------------------------------------------- " << endl;
-    cout << endl; 
+    
+    // The background model can be evaluated either at the center of each rebinned bin (midbin), or 
+    // averaged over the bin width (integrated), in which case the model is built on the quadrature nodes.
+
+    BinIntegratedModel *binIntegratedModel = nullptr;
+    ArrayXd modelCovariates = dataset.covariates;
+
+    if ((settings.rebinningMode != "none") && (settings.binEvaluation == "integrated"))
+    {
+        binIntegratedModel = new BinIntegratedModel(rebinnedCovariates, binWidths, settings.NnodesPerBin);
+        modelCovariates = binIntegratedModel->getNodeCovariates();
+    }
 
     
     // -------------------------------------------------------
     // ----- First step. Set up all prior distributions -----
     // -------------------------------------------------------
     
-    inputFileName = outputDirName + inputPriorBaseName + "_" + runNumber + ".txt";
-    
     bool writeHyperParametersToFile = true;
     unsigned long Ndimensions;              // Number of parameters for which prior distributions are defined
     vector<Prior*> ptrPriors;
-    ptrPriors = MixedPriorMaker::prepareDistributions(inputFileName, outputPathPrefix, Ndimensions, writeHyperParametersToFile); 
+
+    if (settings.automaticPriors)
+    {
+        ArrayXd minima = dataset.automaticBoundaries.col(0);
+        ArrayXd maxima = dataset.automaticBoundaries.col(1);
+        Ndimensions = minima.size();
+        ptrPriors.push_back(new UniformPrior(minima, maxima));
+
+        if (writeHyperParametersToFile)
+        {
+            ptrPriors[0]->writeHyperParametersToFile(settings.outputPathPrefix);
+        }
+    }
+    else
+    {
+        inputFileName = settings.outputDirName + settings.inputPriorBaseName + "_" + settings.runNumber + ".txt";
+        ptrPriors = MixedPriorMaker::prepareDistributions(inputFileName, settings.outputPathPrefix, Ndimensions, writeHyperParametersToFile); 
+    }
 
 
     // -------------------------------------------------------------------
     // ---- Second step. Set up the models for the inference problem ----- 
     // -------------------------------------------------------------------
     
-    inputFileName = outputDirName + "NyquistFrequency.txt";
-    BackgroundModel *model = nullptr;
+    // The Nyquist frequency is read from its ASCII file, unless it is provided by the spectrum container
+    // or taken from the dataset
 
-    // Long-trend, meso-granulation, and granulation component included, with colored noise
-    if (backgroundModelName == "ThreeHarveyColor")
-    {
-        model = new ThreeHarveyColorBackgroundModel(covariates, inputFileName); 
-    }
+    inputFileName = (settings.spectrumContainerName.empty() && !dataset.NyquistFromDataset) ? settings.outputDirName + "NyquistFrequency.txt" : "";
+    BackgroundModel *model = BackgroundModelRegistry::createModel(settings.backgroundModelName, modelCovariates, inputFileName);
     
-    // Long-trend, meso-granulation, and granulation component included, with colored noise but no Gaussian envelope
-    if (backgroundModelName == "ThreeHarveyColorNoGaussian")
+    if (model == nullptr)
     {
-        model = new ThreeHarveyColorNoGaussianBackgroundModel(covariates, inputFileName); 
+        cerr << "Background model " << settings.backgroundModelName << " is not implemented." << endl;
+        exit(EXIT_FAILURE);
     }
-    
-    // Long-trend, meso-granulation, and granulation component included, but no colored noise
-    if (backgroundModelName == "ThreeHarvey")
+
+    if (!settings.spectrumContainerName.empty() || dataset.NyquistFromDataset)
     {
-        model = new ThreeHarveyBackgroundModel(covariates, inputFileName);
+        model->setNyquistFrequency(dataset.NyquistFrequency);
     }
-    
-    // Long-trend, meso-granulation, and granulation component included, but no colored noise and no Gaussian envelope
-    if (backgroundModelName == "ThreeHarveyNoGaussian")
+
+
+    // Share the response function mapped from the spectrum cache among the processes,
+    // if the model is evaluated on the trimmed frequencies of the dataset. In single precision
+    // the model compresses it into its own copy, which then replaces the shared one.
+
+    if ((dataset.spectrumCache != nullptr) && (settings.rebinningMode == "none"))
     {
-        model = new ThreeHarveyNoGaussianBackgroundModel(covariates, inputFileName); 
+        model->shareResponseFunction(dataset.spectrumCache->getResponseFunction());
     }
 
-    // Meso-granulation and granulation components included, with colored noise
-    if (backgroundModelName == "TwoHarveyColor")
+
+    // Generate the frequencies of the model on the fly from a uniform grid descriptor if required.
+    // This is possible only if the frequencies of the dataset are uniformly spaced.
+
+    if ((settings.frequencyGrid == "uniform") && !model->activateUniformGrid(settings.gridTolerance))
     {
-        model = new TwoHarveyColorBackgroundModel(covariates, inputFileName);   
+        cerr << "Frequencies are not uniformly spaced. Stored frequencies are used instead of a uniform grid." << endl;
+        settings.frequencyGrid = "stored";
     }
-    
-    // Meso-granulation and granulation components included, but no colored noise
-    if (backgroundModelName == "TwoHarvey")
+
+
+    // In the lean memory mode the uniform grid is activated whenever the frequencies are uniformly spaced,
+    // so that the frequencies are not stored
+
+    if ((settings.memoryMode == "lean") && (settings.frequencyGrid == "stored") && model->activateUniformGrid(settings.gridTolerance))
     {
-        model = new TwoHarveyBackgroundModel(covariates, inputFileName);   
+        settings.frequencyGrid = "uniform";
+        cout << " Lean memory mode: frequencies generated from a uniform grid." << endl;
+        cout << endl;
     }
 
-    // Meso-granulation and granulation components included, but no colored noise and no Gaussian envelope
-    if (backgroundModelName == "TwoHarveyNoGaussian")
+    Model *likelihoodModel = model;
+
+    if (binIntegratedModel != nullptr)
     {
-        model = new TwoHarveyNoGaussianBackgroundModel(covariates, inputFileName);   
+        binIntegratedModel->setIntegrandModel(model);
+        likelihoodModel = binIntegratedModel;
     }
+    
 
-    // Only meso-granulation component included, with colored noise
-    if (backgroundModelName == "OneHarveyColor")
-    {    
-        model = new OneHarveyColorBackgroundModel(covariates, inputFileName); 
-    }
+    // -----------------------------------------------------------------
+    // ----- Third step. Set up the likelihood function to be used -----
+    // -----------------------------------------------------------------
     
-    // Only meso-granulation component included, but no colored noise
-    if (backgroundModelName == "OneHarvey")
-    {    
-        model = new OneHarveyBackgroundModel(covariates, inputFileName); 
+    // Evaluate the model and the likelihood in mixed precision if required, namely by storing the dataset and 
+    // computing the model in single precision, while accumulating the log-likelihood in double precision.
+    // This is not available when the model is integrated over each rebinned bin.
+
+    if ((settings.precision == "single") && (binIntegratedModel != nullptr))
+    {
+        cerr << "Single precision is not available for bin-integrated models. Double precision is used instead." << endl;
+        settings.precision = "double";
     }
-   
-    // Only meso-granulation component included, but no colored noise
-    if (backgroundModelName == "OneHarveyFreeSlope")
-    {    
-        model = new OneHarveyFreeSlopeBackgroundModel(covariates, inputFileName); 
+
+    // The likelihood keeps its own copy of the observations, and takes them as a writable array. 
+    // The read-only views of the dataset are therefore copied once, and the copy is released 
+    // as soon as the likelihood has been set up.
+
+    Likelihood *likelihood = nullptr;
+    ArrayXd likelihoodObservations = dataset.observations;
+
+    if (settings.precision == "single")
+    {
+        model->activateSinglePrecision();
+        likelihood = new SinglePrecisionLikelihood(likelihoodObservations, binWeights, *model);
     }
+    else
+    {
+        // Without rebinning the bin weights are empty and the likelihood reduces to the exponential one
 
-    // Only meso-granulation component included, but no colored noise and no Gaussian envelope
-    if (backgroundModelName == "OneHarveyFreeSlopeNoGaussian")
-    {    
-        model = new OneHarveyFreeSlopeNoGaussianBackgroundModel(covariates, inputFileName); 
+        likelihood = new GammaLikelihood(likelihoodObservations, binWeights, *likelihoodModel);
     }
 
- 
-    // Only meso-granulation component included, but no colored noise and no Gaussian envelope
-    if (backgroundModelName == "OneHarveyNoGaussian")
-    {    
-        model = new OneHarveyNoGaussianBackgroundModel(covariates, inputFileName); 
+    likelihoodObservations.resize(0);
+
+
+    // Set up the multi-fidelity schedule of the likelihood, if required. The nested sampling uses the dataset 
+    // rebinned by multiFidelityFactor^(multiFidelityLevels - 1), and its results are then refined up to the full
+    // dataset, dividing the rebinning factor by multiFidelityFactor at each level, by SMC tempering with the 
+    // particles, moves and maximum number of steps of the incremental refit (see FidelityLadder). The schedule is
+    // available for uniform priors and a dataset that is not rebinned, and not in an evidence race, since the 
+    // evidence of the coarse levels is not that of the full dataset.
+
+    FidelityLadder *fidelityLadder = nullptr;
+
+    if (settings.multiFidelityLevels > 1)
+    {
+        ArrayXd minima;
+        ArrayXd maxima;
+
+        if ((settings.rebinningMode != "none") || !settings.evidenceRaceName.empty() || !PreviousRun::getUniformPriorRanges(ptrPriors, minima, maxima))
+        {
+            cerr << "The multi-fidelity schedule is only available for uniform priors, without rebinning and evidence race." << endl;
+            cerr << "The full dataset is used." << endl;
+        }
+        else
+        {
+            fidelityLadder = new FidelityLadder(settings.backgroundModelName, dataset.covariates, dataset.observations, model->getNyquistFrequency(), 
+                                                settings.multiFidelityLevels, settings.multiFidelityFactor, (settings.precision == "single"), 
+                                                *likelihood, *likelihoodModel);
+
+            cout << " Multi-fidelity schedule: " << settings.multiFidelityLevels << " levels, nested sampling on the dataset rebinned by " 
+                 << static_cast<int>(pow(settings.multiFidelityFactor, settings.multiFidelityLevels - 1)) << endl;
+            cout << endl;
+        }
     }
 
-    // Only meso-granulation component included, but no colored noise and using the original Harvey law (exponent = 2)
-    if (backgroundModelName == "Original")
-    {    
-        model = new OriginalBackgroundModel(covariates, inputFileName); 
+
+    // In the lean memory mode, release the dataset held by the main program, since 
+    // the model and the likelihood store their own copy of the arrays they use
+
+    if (settings.memoryMode == "lean")
+    {
+        new (&dataset.covariates) Eigen::Map<const ArrayXd>(nullptr, 0);
+        new (&dataset.observations) Eigen::Map<const ArrayXd>(nullptr, 0);
+        dataset.data.resize(0, 0);
+        rebinnedCovariates.resize(0);
+        rebinnedObservations.resize(0);
+        modelCovariates.resize(0);
+        binWeights.resize(0);
+        binWidths.resize(0);
     }
 
-    // Only Gaussian envelope and white noise
-    if (backgroundModelName == "Flat")
-    {    
-        model = new FlatBackgroundModel(covariates, inputFileName); 
+
+    // With the Laplace approximation, the evidence is written in a file with the same columns of a nested sampling run,
+    // together with the MAP of the free parameters and the computation parameters of the run, and the run ends here
+
+    if (settings.evidenceMethod == "laplace")
+    {
+        LaplaceEvidence laplaceEvidence(ptrPriors, *likelihood);
+        laplaceEvidence.compute(50 * Ndimensions, 1000 * Ndimensions, 100 * Ndimensions);
+        laplaceEvidence.writeEvidenceInformationToFile(settings.outputPathPrefix + "evidenceInformation.txt");
+        laplaceEvidence.writeParametersToFile(settings.outputPathPrefix + "laplaceParameters.txt");
+
+        ResultsWriter::RunInformation runInformation;
+        runInformation.rebinningMode = settings.rebinningMode;
+        runInformation.rebinningParameter = settings.rebinningParameter;
+        runInformation.NnodesPerBin = settings.NnodesPerBin;
+        runInformation.lowFrequencyThreshold = settings.lowFrequencyThreshold;
+        runInformation.highFrequencyThreshold = settings.highFrequencyThreshold;
+        runInformation.localPath = settings.localPath;
+        runInformation.starID = settings.CatalogID + settings.StarID;
+        runInformation.runNumber = settings.runNumber;
+        runInformation.backgroundModelName = settings.backgroundModelName;
+        runInformation.featureProjectionActivated = false;
+
+        ofstream computationParametersFile;
+        File::openOutputFile(computationParametersFile, settings.outputPathPrefix + "computationParameters.txt");
+        laplaceEvidence.writeComputationInformation(computationParametersFile);
+        ResultsWriter::writeRunInformation(computationParametersFile, runInformation);
+        computationParametersFile.close();
+
+        cout << " Laplace approximation: log(Evidence) = " << setprecision(8) << laplaceEvidence.getLogEvidence() 
+             << " +/- " << laplaceEvidence.getLogEvidenceError()
+             << ", Information Gain = " << laplaceEvidence.getInformationGain() << " (" 
+             << laplaceEvidence.getNevaluations() << " likelihood evaluations)" << endl;
+
+        if (laplaceEvidence.isMaximumOnBoundary())
+        {
+            cout << " The MAP lies close to a prior boundary: the evidence is less accurate." << endl;
+        }
+
+        cout << "Process # " << settings.runNumber << " has been completed." << endl;
+
+        return EXIT_SUCCESS;
     }
     
-    // Only white noise, without Gaussian envelope
-    if (backgroundModelName == "FlatNoGaussian")
-    {    
-        model = new FlatNoGaussianBackgroundModel(covariates, inputFileName); 
+
+    // Set up the warm-start prior used by the sampler, if required. The warm start is available for uniform priors only.
+
+    vector<Prior*> ptrSamplingPriors = ptrPriors;
+    WarmStartPrior *warmStartPrior = nullptr;
+    int NwarmStartedParameters = 0;
+
+    if (!settings.warmStartRun.empty())
+    {
+        ArrayXd minima(Ndimensions);
+        ArrayXd maxima(Ndimensions);
+        int firstDimension = 0;
+
+        for (size_t prior = 0; prior < ptrPriors.size(); ++prior)
+        {
+            UniformPrior *uniformPrior = dynamic_cast<UniformPrior*>(ptrPriors[prior]);
+
+            if (uniformPrior == nullptr)
+            {
+                cerr << "The warm start is only available for uniform priors." << endl;
+                exit(EXIT_FAILURE);
+            }
+
+            int NpriorDimensions = uniformPrior->getNdimensions();
+            minima.segment(firstDimension, NpriorDimensions) = uniformPrior->getMinima();
+            maxima.segment(firstDimension, NpriorDimensions) = uniformPrior->getMaxima();
+            firstDimension += NpriorDimensions;
+        }
+
+        vector<string> parameterNames = BackgroundModelRegistry::getParameterNames(settings.backgroundModelName);
+        vector<string> warmStartParameterNames = BackgroundModelRegistry::getParameterNames(settings.warmStartModelName);
+        ArrayXd warmStartMean;
+        ArrayXd warmStartStandardDeviation;
+        WarmStartPrior::readPosteriorMoments(settings.outputDirName + settings.warmStartRun + "/background_", warmStartMean, warmStartStandardDeviation);
+
+        if ((parameterNames.size() != Ndimensions) || (warmStartParameterNames.size() != static_cast<size_t>(warmStartMean.size())))
+        {
+            cerr << "The posterior sample of run " << settings.warmStartRun << " does not match the parameters of the " 
+                 << settings.warmStartModelName << " model. Set the warmStartModel of the previous run." << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        // Parameters not found in the previous model, or with a degenerate posterior, keep their original prior
+
+        ArrayXd innerMinima = minima;
+        ArrayXd innerMaxima = maxima;
+
+        for (size_t parameter = 0; parameter < parameterNames.size(); ++parameter)
+        {
+            auto match = find(warmStartParameterNames.begin(), warmStartParameterNames.end(), parameterNames[parameter]);
+
+            if (match != warmStartParameterNames.end())
+            {
+                int warmStartParameter = match - warmStartParameterNames.begin();
+
+                if (warmStartStandardDeviation(warmStartParameter) > 0.0)
+                {
+                    innerMinima(parameter) = warmStartMean(warmStartParameter) - settings.warmStartWidth*warmStartStandardDeviation(warmStartParameter);
+                    innerMaxima(parameter) = warmStartMean(warmStartParameter) + settings.warmStartWidth*warmStartStandardDeviation(warmStartParameter);
+                    ++NwarmStartedParameters;
+                }
+            }
+        }
+
+        warmStartPrior = new WarmStartPrior(minima, maxima, innerMinima, innerMaxima, settings.warmStartPriorWeight);
+        warmStartPrior->writeHyperParametersToFile(settings.outputPathPrefix);
+        ptrSamplingPriors = vector<Prior*>(1, warmStartPrior);
+
+        cout << " Warm start from run " << settings.warmStartRun << " (" << settings.warmStartModelName << "): " << NwarmStartedParameters 
+             << " of " << Ndimensions << " parameters narrowed." << endl;
     }
-    
 
-    // -----------------------------------------------------------------
-    // ----- Third step. Set up the likelihood function to be used -----
-    // -----------------------------------------------------------------
-    
-    ExponentialLikelihood likelihood(observations, *model);
-    
 
     // -------------------------------------------------------------------------------
     // ----- Fourth step. Set up the K-means clusterer using an Euclidean metric -----
     // -------------------------------------------------------------------------------
 
+    // With automatic priors, the default configuring parameters are used if their file is not provided
+
     unsigned long Nparameters;
-    inputFileName = outputDirName + "Xmeans_configuringParameters.txt";
-    File::openInputFile(inputFile, inputFileName);
-    File::sniffFile(inputFile, Nparameters, Ncols);
+    ArrayXd configuringParameters;
+    inputFileName = settings.outputDirName + "Xmeans_configuringParameters.txt";
 
-    if (Nparameters != 2)
+    if (settings.automaticPriors && !ifstream(inputFileName).good())
     {
-        cerr << "Wrong number of input parameters for clustering algorithm." << endl;
-        exit(EXIT_FAILURE);
+        configuringParameters = BackgroundPriorMaker::getXmeansConfiguringParameters();
+        Nparameters = configuringParameters.size();
     }
+    else
+    {
+        File::openInputFile(inputFile, inputFileName);
+        File::sniffFile(inputFile, Nparameters, Ncols);
 
-    ArrayXd configuringParameters;
-    configuringParameters = File::arrayXXdFromFile(inputFile, Nparameters, Ncols);
-    inputFile.close();
+        if (Nparameters != 2)
+        {
+            cerr << "Wrong number of input parameters for clustering algorithm." << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        configuringParameters = File::arrayXXdFromFile(inputFile, Nparameters, Ncols);
+        inputFile.close();
+    }
     
     int minNclusters = configuringParameters(0);
     int maxNclusters = configuringParameters(1);
@@ -324,7 +1277,7 @@ int main(int argc, char *argv[])
     PrincipalComponentProjector projector(printNdimensions);
     bool featureProjectionActivated = false;
     
-    if (PCAflag == 1)
+    if (settings.PCAflag == 1)
     {
         featureProjectionActivated = true;
     }
@@ -338,12 +1291,21 @@ int main(int argc, char *argv[])
     // ----- Sixth step. Configure and start nested sampling inference -----
     // ---------------------------------------------------------------------
     
-    inputFileName = outputDirName + "NSMC_configuringParameters.txt";
-    File::openInputFile(inputFile, inputFileName);
-    File::sniffFile(inputFile, Nparameters, Ncols);
-    configuringParameters.setZero();
-    configuringParameters = File::arrayXXdFromFile(inputFile, Nparameters, Ncols);
-    inputFile.close();
+    inputFileName = settings.outputDirName + "NSMC_configuringParameters.txt";
+
+    if (settings.automaticPriors && !ifstream(inputFileName).good())
+    {
+        configuringParameters = BackgroundPriorMaker::getNSMCconfiguringParameters();
+        Nparameters = configuringParameters.size();
+    }
+    else
+    {
+        File::openInputFile(inputFile, inputFileName);
+        File::sniffFile(inputFile, Nparameters, Ncols);
+        configuringParameters.setZero();
+        configuringParameters = File::arrayXXdFromFile(inputFile, Nparameters, Ncols);
+        inputFile.close();
+    }
 
     if ((Nparameters < 8) && (Nparameters > 9))
     {
@@ -423,59 +1385,340 @@ int main(int argc, char *argv[])
     }
 
 
-    MultiEllipsoidSampler nestedSampler(printOnTheScreen, ptrPriors, likelihood, myMetric, clusterer, 
-                                        initialNlivePoints, minNlivePoints, initialEnlargementFraction, shrinkingRate);
-    
+
+    // The likelihood used by the sampler is built on the likelihood of a dataset, by correcting it for the warm-start 
+    // prior and by screening the drawn points with the surrogate, if required. The same construction is used for the 
+    // nested sampling of the full dataset, if the refinement of the multi-fidelity schedule fails.
+
+    auto buildSamplingLikelihood = [&](Likelihood &datasetLikelihood, ImportanceCorrectedLikelihood *&correctedLikelihood,
+                                       SurrogateLikelihood *&surrogateLikelihood) -> Likelihood*
+    {
+        Likelihood *samplingLikelihood = &datasetLikelihood;
+        correctedLikelihood = nullptr;
+        surrogateLikelihood = nullptr;
+
+        if (warmStartPrior != nullptr)
+        {
+            correctedLikelihood = new ImportanceCorrectedLikelihood(*samplingLikelihood, *warmStartPrior, *likelihoodModel);
+            samplingLikelihood = correctedLikelihood;
+        }
+
+        if (settings.surrogateName == "quadratic")
+        {
+            surrogateLikelihood = new SurrogateLikelihood(*samplingLikelihood, *likelihoodModel, Ndimensions, settings.NsurrogateTrainingPoints, 
+                                                          settings.surrogateSafetyFactor, settings.surrogateAuditFraction, settings.surrogateMaxFalseRejectionRate);
+            samplingLikelihood = surrogateLikelihood;
+        }
+
+        return samplingLikelihood;
+    };
+
+    ImportanceCorrectedLikelihood *correctedLikelihood = nullptr;
+    SurrogateLikelihood *surrogateLikelihood = nullptr;
+    Likelihood *samplingLikelihood = buildSamplingLikelihood((fidelityLadder != nullptr) ? fidelityLadder->getCoarsestLikelihood() : *likelihood,
+                                                             correctedLikelihood, surrogateLikelihood);
+
+    SurrogateSampler nestedSampler(printOnTheScreen, ptrSamplingPriors, *samplingLikelihood, myMetric, clusterer, 
+                                   initialNlivePoints, minNlivePoints, initialEnlargementFraction, shrinkingRate,
+                                   nullptr, settings.NiterationsPerRaceUpdate, surrogateLikelihood);
+
+
+    // Refit the model from the previous run, if required, either by reweighting its posterior sample for the 
+    // new frequency thresholds (see ThresholdReweighter), or by tempering it to the new dataset (see TemperedRefitter).
+    // An adopted refit sets its results into the nested sampler, which is then not run, and they are written 
+    // in the same output files of a nested sampling run, so that the refit can in turn be the previous run of
+    // a later refit. A refit takes no part in an evidence race, and it produces neither the posterior-predictive 
+    // bands nor an entry of the results database.
+
+    bool refitted = false;
+
+    if (dataset.thresholdReweighter != nullptr)
+    {
+        refitted = dataset.thresholdReweighter->refit(nestedSampler, ptrPriors, settings.backgroundModelName, model->getNyquistFrequency(), 
+                                              settings.minReweightingEfficiency, settings.outputPathPrefix);
+        delete dataset.thresholdReweighter;
+    }
+    else if (!settings.incrementalRun.empty())
+    {
+        refitted = TemperedRefitter::refitDataset(nestedSampler, *previousRun, ptrPriors, *likelihood, 
+                                                  settings.baseInputDirName + settings.previousDatasetName, settings.backgroundModelName, 
+                                                  model->getNyquistFrequency(), settings.NsmcParticles, settings.NsmcMoves, 
+                                                  settings.maxNtemperingSteps, settings.maxPosteriorShift, settings.outputPathPrefix);
+    }
+
+    delete previousRun;
+
+    EvidenceRace *evidenceRace = nullptr;
+
+    if (!refitted && !settings.evidenceRaceName.empty())
+    {
+        evidenceRace = new EvidenceRace(settings.outputDirName + "background_evidenceRace_" + settings.evidenceRaceName + ".txt", 
+                                        settings.runNumber, settings.backgroundModelName, settings.raceMargin, settings.raceRemainderRatio);
+        nestedSampler.setEvidenceRace(evidenceRace);
+    }
+
     double tolerance = 1.e2;
     double exponent = 0.4;
-    PowerlawReducer livePointsReducer(nestedSampler, tolerance, exponent, terminationFactor);
- 
-    nestedSampler.run(livePointsReducer, NinitialIterationsWithoutClustering, NiterationsWithSameClustering, 
-                      maxNdrawAttempts, terminationFactor, maxNiterations, outputPathPrefix);
-
-    nestedSampler.outputFile << "# List of configuring parameters used for the ellipsoidal sampler and cluster algorithm" << endl;
-    nestedSampler.outputFile << "# Row #1: Minimum Nclusters" << endl;
-    nestedSampler.outputFile << "# Row #2: Maximum Nclusters" << endl;
-    nestedSampler.outputFile << "# Row #3: Initial Enlargement Fraction" << endl;
-    nestedSampler.outputFile << "# Row #4: Shrinking Rate" << endl;
-    nestedSampler.outputFile << minNclusters << endl;
-    nestedSampler.outputFile << maxNclusters << endl;
-    nestedSampler.outputFile << initialEnlargementFraction << endl;
-    nestedSampler.outputFile << shrinkingRate << endl;
-    nestedSampler.outputFile << "# Other information on the run" << endl;
-    nestedSampler.outputFile << "# Row #1: Low-Frequency threshold (0 if not used)" << endl;
-    nestedSampler.outputFile << "# Row #2: High-Frequency threshold (0 if not used)" << endl;
-    nestedSampler.outputFile << "# Row #3: Local working path used" << endl;
-    nestedSampler.outputFile << "# Row #4: Catalog and Star ID" << endl;
-    nestedSampler.outputFile << "# Row #5: Run Number" << endl;
-    nestedSampler.outputFile << "# Row #6: Background model adopted" << endl;
-    nestedSampler.outputFile << "# Row #7: PCA activated (1 = yes / 0 = no)" << endl;
-    nestedSampler.outputFile << lowFrequencyThreshold << endl;
-    nestedSampler.outputFile << highFrequencyThreshold << endl;
-    nestedSampler.outputFile << myLocalPath[0] << endl;
-    nestedSampler.outputFile << CatalogID + StarID << endl;
-    nestedSampler.outputFile << runNumber << endl;
-    nestedSampler.outputFile << backgroundModelName << endl;
-    nestedSampler.outputFile << featureProjectionActivated << endl;
+
+    if (refitted)
+    {
+        nestedSampler.setOutputPathPrefix(settings.outputPathPrefix);
+        File::openOutputFile(nestedSampler.outputFile, settings.outputPathPrefix + "computationParameters.txt");
+    }
+    else
+    {
+        PowerlawReducer livePointsReducer(nestedSampler, tolerance, exponent, terminationFactor);
+        nestedSampler.run(livePointsReducer, NinitialIterationsWithoutClustering, NiterationsWithSameClustering, 
+                          maxNdrawAttempts, terminationFactor, maxNiterations, settings.outputPathPrefix);
+    }
+
+
+    if (!refitted && (surrogateLikelihood != nullptr))
+    {
+        surrogateLikelihood->writeToFile(settings.outputPathPrefix + "surrogate.txt");
+
+        cout << " Surrogate screening: " << surrogateLikelihood->getNscreenedPoints() << " drawn points rejected, " 
+             << surrogateLikelihood->getNevaluations() << " exact evaluations, " << surrogateLikelihood->getNfalseRejections() 
+             << " false rejections out of " << surrogateLikelihood->getNauditedPoints() << " audited points, final safety factor "
+             << surrogateLikelihood->getSafetyFactor() << (surrogateLikelihood->isScreening() ? "" : ", screening stopped") << endl;
+    }
+
+
+    // For a warm-started run, replace the corrected log-likelihood of the posterior sample with that of the
+    // background model, and express the information gain relative to the original prior (see ImportanceCorrectedLikelihood).
+
+    if (!refitted && (correctedLikelihood != nullptr))
+    {
+        correctedLikelihood->correctResults(nestedSampler);
+    }
+
+
+    // Refine the results of the multi-fidelity schedule up to the full dataset. If the refinement fails, 
+    // a nested sampling on the full dataset is performed instead, with the same priors and sampling likelihood 
+    // of the main sampler. Its results replace those of the coarsest level, and its computation parameters are 
+    // completed as for the main sampler. The schedule takes no part in an evidence race.
+
+    if (!refitted && (fidelityLadder != nullptr))
+    {
+        if (!fidelityLadder->refine(nestedSampler, ptrPriors, settings.NsmcParticles, settings.NsmcMoves, settings.maxNtemperingSteps))
+        {
+            nestedSampler.outputFile.close();
+            ImportanceCorrectedLikelihood *fullCorrectedLikelihood = nullptr;
+            SurrogateLikelihood *fullSurrogateLikelihood = nullptr;
+            Likelihood *fullSamplingLikelihood = buildSamplingLikelihood(fidelityLadder->getFullLikelihood(), 
+                                                                         fullCorrectedLikelihood, fullSurrogateLikelihood);
+            SurrogateSampler fullSampler(printOnTheScreen, ptrSamplingPriors, *fullSamplingLikelihood, myMetric, clusterer, 
+                                         initialNlivePoints, minNlivePoints, initialEnlargementFraction, shrinkingRate,
+                                         nullptr, settings.NiterationsPerRaceUpdate, fullSurrogateLikelihood);
+            PowerlawReducer fullLivePointsReducer(fullSampler, tolerance, exponent, terminationFactor);
+            fullSampler.run(fullLivePointsReducer, NinitialIterationsWithoutClustering, NiterationsWithSameClustering, 
+                            maxNdrawAttempts, terminationFactor, maxNiterations, settings.outputPathPrefix);
+            fullSampler.outputFile.close();
+            nestedSampler.outputFile.open((settings.outputPathPrefix + "computationParameters.txt").c_str(), ios::app);
+
+            if (fullCorrectedLikelihood != nullptr)
+            {
+                fullCorrectedLikelihood->correctResults(fullSampler);
+            }
+
+            if (fullSurrogateLikelihood != nullptr)
+            {
+                fullSurrogateLikelihood->writeToFile(settings.outputPathPrefix + "surrogate.txt");
+            }
+
+            ResultsWriter::setResults(nestedSampler, fullSampler.getPosteriorSample(), fullSampler.getLogLikelihoodOfPosteriorSample(),
+                                      fullSampler.getLogWeightOfPosteriorSample(), fullSampler.getLogEvidence(),
+                                      fullSampler.getLogEvidenceError(), fullSampler.getInformationGain());
+        }
+
+        fidelityLadder->writeToFile(settings.outputPathPrefix + "multiFidelity.txt");
+    }
+
+
+    // The output files of the run are written by the pool of writer threads,
+    // while the main program saves the configuring parameters of the run.
+
+    ResultsWriter resultsWriter(settings.NwriterThreads);
+    double credibleLevel = 68.3;
+    bool writeMarginalDistributionToFile = true;
+    resultsWriter.writeResults(nestedSampler, settings.outputFormat, credibleLevel, writeMarginalDistributionToFile);
+
+
+    // The configuring parameters of the sampler are only saved for a nested sampling run, while the 
+    // settings of the dataset and the identification of the run are saved in any case
+
+    if (!refitted)
+    {
+        nestedSampler.outputFile << "# List of configuring parameters used for the ellipsoidal sampler and cluster algorithm" << endl;
+        nestedSampler.outputFile << "# Row #1: Minimum Nclusters" << endl;
+        nestedSampler.outputFile << "# Row #2: Maximum Nclusters" << endl;
+        nestedSampler.outputFile << "# Row #3: Initial Enlargement Fraction" << endl;
+        nestedSampler.outputFile << "# Row #4: Shrinking Rate" << endl;
+        nestedSampler.outputFile << minNclusters << endl;
+        nestedSampler.outputFile << maxNclusters << endl;
+        nestedSampler.outputFile << initialEnlargementFraction << endl;
+        nestedSampler.outputFile << shrinkingRate << endl;
+    }
+
+    ResultsWriter::RunInformation runInformation;
+    runInformation.rebinningMode = settings.rebinningMode;
+    runInformation.rebinningParameter = settings.rebinningParameter;
+    runInformation.NnodesPerBin = settings.NnodesPerBin;
+    runInformation.lowFrequencyThreshold = settings.lowFrequencyThreshold;
+    runInformation.highFrequencyThreshold = settings.highFrequencyThreshold;
+    runInformation.localPath = settings.localPath;
+    runInformation.starID = settings.CatalogID + settings.StarID;
+    runInformation.runNumber = settings.runNumber;
+    runInformation.backgroundModelName = settings.backgroundModelName;
+    runInformation.featureProjectionActivated = featureProjectionActivated;
+    ResultsWriter::writeRunInformation(nestedSampler.outputFile, runInformation);
+
+    if (evidenceRace != nullptr)
+    {
+        evidenceRace->finish(nestedSampler.getLogEvidence(), nestedSampler.getNiterations(), nestedSampler.isAborted());
+        EvidenceRace::Entry leader = evidenceRace->getLeader();
+
+        nestedSampler.outputFile << "# Evidence race" << endl;
+        nestedSampler.outputFile << "# Row #1: Race name" << endl;
+        nestedSampler.outputFile << "# Row #2: Margin in ln(Bayes factor)" << endl;
+        nestedSampler.outputFile << "# Row #3: Outcome (finished / aborted)" << endl;
+        nestedSampler.outputFile << "# Row #4: Run Number of the leader when the run ended" << endl;
+        nestedSampler.outputFile << "# Row #5: Background model of the leader" << endl;
+        nestedSampler.outputFile << "# Row #6: Lower bound of log(Evidence) of the leader" << endl;
+        nestedSampler.outputFile << settings.evidenceRaceName << endl;
+        nestedSampler.outputFile << settings.raceMargin << endl;
+        nestedSampler.outputFile << (nestedSampler.isAborted() ? "aborted" : "finished") << endl;
+        nestedSampler.outputFile << leader.runNumber << endl;
+        nestedSampler.outputFile << leader.backgroundModelName << endl;
+        nestedSampler.outputFile << leader.lowerLogEvidence << endl;
+        delete evidenceRace;
+    }
+
+    if (!refitted && !settings.warmStartRun.empty())
+    {
+        nestedSampler.outputFile << "# Warm start" << endl;
+        nestedSampler.outputFile << "# Row #1: Run Number of the previous run" << endl;
+        nestedSampler.outputFile << "# Row #2: Background model of the previous run" << endl;
+        nestedSampler.outputFile << "# Row #3: Half-width of the inner box in posterior standard deviations" << endl;
+        nestedSampler.outputFile << "# Row #4: Weight of the original prior" << endl;
+        nestedSampler.outputFile << "# Row #5: Number of parameters narrowed" << endl;
+        nestedSampler.outputFile << settings.warmStartRun << endl;
+        nestedSampler.outputFile << settings.warmStartModelName << endl;
+        nestedSampler.outputFile << settings.warmStartWidth << endl;
+        nestedSampler.outputFile << settings.warmStartPriorWeight << endl;
+        nestedSampler.outputFile << NwarmStartedParameters << endl;
+    }
+
+    if (!refitted && (surrogateLikelihood != nullptr))
+    {
+        nestedSampler.outputFile << "# Surrogate screening" << endl;
+        nestedSampler.outputFile << "# Row #1: Surrogate of the log-likelihood" << endl;
+        nestedSampler.outputFile << "# Row #2: Number of exact evaluations" << endl;
+        nestedSampler.outputFile << "# Row #3: Number of drawn points rejected by the surrogate" << endl;
+        nestedSampler.outputFile << "# Row #4: Number of false rejections among the audited points" << endl;
+        nestedSampler.outputFile << "# Row #5: Final safety factor in RMS prediction errors" << endl;
+        nestedSampler.outputFile << "# Row #6: Screening active at the end of the run (1) or stopped (0)" << endl;
+        nestedSampler.outputFile << settings.surrogateName << endl;
+        nestedSampler.outputFile << surrogateLikelihood->getNevaluations() << endl;
+        nestedSampler.outputFile << surrogateLikelihood->getNscreenedPoints() << endl;
+        nestedSampler.outputFile << surrogateLikelihood->getNfalseRejections() << endl;
+        nestedSampler.outputFile << surrogateLikelihood->getSafetyFactor() << endl;
+        nestedSampler.outputFile << surrogateLikelihood->isScreening() << endl;
+    }
+
+    if (!refitted && (fidelityLadder != nullptr))
+    {
+        fidelityLadder->writeScheduleInformation(nestedSampler.outputFile);
+    }
+
     nestedSampler.outputFile.close();
 
 
+    // Compute the posterior-predictive bands of the background model while the writer threads
+    // write the other output files
+
+    if (!refitted && (settings.NpredictiveDraws > 0))
+    {
+        ArrayXd bandFrequencies = Eigen::pow(10.0, ArrayXd::LinSpaced(settings.NpredictiveBins, log10(dataset.minFrequency), log10(dataset.maxFrequency)));
+        PredictiveBands predictiveBands(settings.backgroundModelName, bandFrequencies, model->getNyquistFrequency(), settings.NpredictiveThreads);
+        predictiveBands.compute(nestedSampler.getPosteriorSample(), nestedSampler.getLogWeightOfPosteriorSample(), 
+                                settings.NpredictiveDraws, credibleLevel);
+        predictiveBands.writeToFile(settings.outputPathPrefix + "predictiveBands.npz");
+    }
+
+
     // -------------------------------------------------------
     // ----- Last step. Save the results in output files -----
     // -------------------------------------------------------
    
-    Results results(nestedSampler);
-    results.writeParametersToFile("parameter");
-    results.writeLogLikelihoodToFile("logLikelihood.txt");
-    results.writeLogWeightsToFile("logWeights.txt");
-    results.writeEvidenceInformationToFile("evidenceInformation.txt");
-    results.writePosteriorProbabilityToFile("posteriorDistribution.txt");
+    // The quantities defined for each sampling point are written either as one ASCII file per quantity (text), 
+    // or all together as the columns of a single binary file in the numpy format (npy). 
+    // Wait for the writer threads to complete all the output files.
 
-    double credibleLevel = 68.3;
-    bool writeMarginalDistributionToFile = true;
-    results.writeParametersSummaryToFile("parameterSummary.txt", credibleLevel, writeMarginalDistributionToFile);
+    resultsWriter.waitForCompletion();
+
+
+    // Insert the results and the configuration of the run into the database, if any
 
-    cout << "Process # " << runNumber << " has been completed." << endl;
+    if (!refitted && !settings.resultsDatabaseName.empty())
+    {
+        ResultsDatabase resultsDatabase(settings.resultsDatabaseName);
+        resultsDatabase.addConfiguration("initialNlivePoints", initialNlivePoints);
+        resultsDatabase.addConfiguration("minNlivePoints", minNlivePoints);
+        resultsDatabase.addConfiguration("maxNdrawAttempts", maxNdrawAttempts);
+        resultsDatabase.addConfiguration("NinitialIterationsWithoutClustering", NinitialIterationsWithoutClustering);
+        resultsDatabase.addConfiguration("NiterationsWithSameClustering", NiterationsWithSameClustering);
+        resultsDatabase.addConfiguration("initialEnlargementFraction", initialEnlargementFraction);
+        resultsDatabase.addConfiguration("shrinkingRate", shrinkingRate);
+        resultsDatabase.addConfiguration("terminationFactor", terminationFactor);
+        resultsDatabase.addConfiguration("maxNiterations", maxNiterations);
+        resultsDatabase.addConfiguration("minNclusters", minNclusters);
+        resultsDatabase.addConfiguration("maxNclusters", maxNclusters);
+        resultsDatabase.addConfiguration("PCAactivated", featureProjectionActivated);
+        resultsDatabase.addConfiguration("rebinningMode", settings.rebinningMode);
+        resultsDatabase.addConfiguration("rebinningParameter", settings.rebinningParameter);
+        resultsDatabase.addConfiguration("NnodesPerBin", settings.NnodesPerBin);
+        resultsDatabase.addConfiguration("precision", settings.precision);
+
+        if (!settings.evidenceRaceName.empty())
+        {
+            resultsDatabase.addConfiguration("evidenceRace", settings.evidenceRaceName);
+            resultsDatabase.addConfiguration("evidenceRaceOutcome", string(nestedSampler.isAborted() ? "aborted" : "finished"));
+        }
+
+        if (!settings.warmStartRun.empty())
+        {
+            resultsDatabase.addConfiguration("warmStartRun", settings.warmStartRun);
+            resultsDatabase.addConfiguration("warmStartModel", settings.warmStartModelName);
+        }
+
+        resultsDatabase.insertRun(settings.CatalogID + settings.StarID, settings.backgroundModelName, settings.runNumber, nestedSampler, 
+                                  settings.lowFrequencyThreshold, settings.highFrequencyThreshold);
+    }
+
+
+    // Replace all the output files of the run with a single archive, if required
+
+    if (settings.outputArchive == "zip")
+    {
+        ResultsArchive::writeArchive(settings.outputDirName + settings.runNumber, "background_", "background_results.zip");
+    }
+
+    // Report the peak memory used by the process, which is the limiting factor for the number
+    // of processes that can run at the same time on the same machine
+
+    struct rusage resourceUsage;
+    getrusage(RUSAGE_SELF, &resourceUsage);
+
+    #ifdef __APPLE__
+        double peakMemory = resourceUsage.ru_maxrss / (1024.0 * 1024.0);       // bytes on OS X
+    #else
+        double peakMemory = resourceUsage.ru_maxrss / 1024.0;                  // kilobytes on Linux
+    #endif
+
+    cout << " Peak resident memory: " << fixed << setprecision(1) << peakMemory << " MB" << endl;
+
+    cout << "Process # " << settings.runNumber << " has been completed." << endl;
 
     return EXIT_SUCCESS;
-}
+}
\ No newline at end of file
@@ -12,7 +12,14 @@
 //
 
 BackgroundModel::BackgroundModel(const RefArrayXd covariates)
-: Model(covariates)
+: Model(covariates),
+  NyquistFrequency(numeric_limits<double>::max()),
+  responseFunction(nullptr, 0),
+  uniformGrid(false),
+  gridStartingFrequency(0.0),
+  gridFrequencyResolution(0.0),
+  gridNbins(0),
+  singlePrecision(false)
 {
 }
 
@@ -46,6 +53,40 @@ BackgroundModel::~BackgroundModel()
 
 
 
+// BackgroundModel::getCovariates()
+//
+// PURPOSE:
+//      Gets the frequencies of the dataset, either from the stored covariates
+//      or from the implicit uniform frequency grid, if activated.
+//
+// OUTPUT:
+//      An eigen array containing the frequency of each bin of the input data
+//
+
+ArrayXd BackgroundModel::getCovariates()
+{
+    if (uniformGrid)
+    {
+        return gridCovariates();
+    }
+
+    if (singlePrecision)
+    {
+        return singlePrecisionCovariates.cast<double>();
+    }
+
+    return covariates;
+}
+
+
+
+
+
+
+
+
+
+
 // BackgroundModel::getResponseFunction()
 //
 // PURPOSE:
@@ -57,6 +98,11 @@ BackgroundModel::~BackgroundModel()
 
 ArrayXd BackgroundModel::getResponseFunction()
 {
+    if (singlePrecision)
+    {
+        return compressedResponseFunction.cast<double>();
+    }
+
     return responseFunction;
 }
 
@@ -98,6 +144,8 @@ double BackgroundModel::getNyquistFrequency()
 //
 // INPUT:
 //      inputFileName:      a string specifying the full path (filename included) of the input file to read.
+//                          If empty, no file is read and the Nyquist frequency is left to its initial,
+//                          infinitely large value, so that it has to be set by means of setNyquistFrequency().
 //
 // OUTPUT:
 //      void
@@ -105,6 +153,11 @@ double BackgroundModel::getNyquistFrequency()
 
 void BackgroundModel::readNyquistFrequencyFromFile(const string inputFileName)
 {
+    if (inputFileName.empty())
+    {
+        return;
+    }
+
     ifstream inputFile;
     File::openInputFile(inputFile, inputFileName);
 
@@ -120,3 +173,512 @@ void BackgroundModel::readNyquistFrequencyFromFile(const string inputFileName)
 
     inputFile.close();
 }
+
+
+
+
+
+
+
+
+
+
+// BackgroundModel::setNyquistFrequency()
+//
+// PURPOSE:
+//      Sets the Nyquist frequency of the dataset and computes the response function accordingly,
+//      replacing the one computed from the Nyquist frequency read by the constructor of the model.
+//
+// INPUT:
+//      inputNyquistFrequency:      the Nyquist frequency of the dataset (muHz).
+//
+// OUTPUT:
+//      void
+//
+// NOTE:
+//      It has to be called before activating the uniform grid or the single-precision mode,
+//      since both of them release the double-precision frequencies of the dataset.
+//
+
+void BackgroundModel::setNyquistFrequency(const double inputNyquistFrequency)
+{
+    if (uniformGrid || singlePrecision)
+    {
+        cerr << "The Nyquist frequency cannot be set after activating the uniform grid or the single precision." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    NyquistFrequency = inputNyquistFrequency;
+    updateResponseFunction();
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundModel::shareResponseFunction()
+//
+// PURPOSE:
+//      Replaces the response function computed by the model with a read-only array stored
+//      elsewhere, typically in the pages of a spectrum cache that are shared by all the processes
+//      fitting the same dataset, and releases the array owned by the model.
+//
+// INPUT:
+//      sharedResponseFunction:     a map of the response function, computed on the same
+//                                  frequencies and Nyquist frequency of the model.
+//
+// OUTPUT:
+//      void
+//
+// NOTE:
+//      The memory referred to by the map has to remain valid for the entire lifetime of the model.
+//      As for setNyquistFrequency(), it has to be called before activating the uniform grid or
+//      the single-precision mode.
+//
+
+void BackgroundModel::shareResponseFunction(const Eigen::Map<const ArrayXd> &sharedResponseFunction)
+{
+    if (uniformGrid || singlePrecision)
+    {
+        cerr << "The response function cannot be shared after activating the uniform grid or the single precision." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (sharedResponseFunction.size() != covariates.size())
+    {
+        cerr << "The shared response function has " << sharedResponseFunction.size() << " bins, "
+             << "while the model has " << covariates.size() << " bins." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    ownedResponseFunction.resize(0);
+    new (&responseFunction) Eigen::Map<const ArrayXd>(sharedResponseFunction.data(), sharedResponseFunction.size());
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundModel::computeResponseFunction()
+//
+// PURPOSE:
+//      Computes the response function that modulates the signal of a dataset, given 
+//      the sampling rate of its observations, namely the sinc^2 function of the frequency 
+//      in units of twice the Nyquist frequency.
+//
+// INPUT:
+//      frequencies:            one-dimensional array containing the frequencies of the dataset (muHz).
+//      NyquistFrequency:       the Nyquist frequency of the dataset (muHz).
+//
+// OUTPUT:
+//      An eigen array containing the response function at each frequency.
+//
+
+ArrayXd BackgroundModel::computeResponseFunction(const ConstRefArrayXd frequencies, const double NyquistFrequency)
+{
+    ArrayXd sincFunctionArgument = (Functions::PI / 2.0) * frequencies / NyquistFrequency;
+    
+    return (sincFunctionArgument.sin() / sincFunctionArgument).square();
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundModel::updateResponseFunction()
+//
+// PURPOSE:
+//      Computes the response function on the covariates of the model, using the current
+//      Nyquist frequency, and stores it in the array owned by the model.
+//
+// OUTPUT:
+//      void
+//
+
+void BackgroundModel::updateResponseFunction()
+{
+    ownedResponseFunction = computeResponseFunction(covariates, NyquistFrequency);
+    new (&responseFunction) Eigen::Map<const ArrayXd>(ownedResponseFunction.data(), ownedResponseFunction.size());
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundModel::releaseResponseFunction()
+//
+// PURPOSE:
+//      Releases the double-precision response function, either owned by the model or shared,
+//      once it has been compressed in single precision.
+//
+// OUTPUT:
+//      void
+//
+
+void BackgroundModel::releaseResponseFunction()
+{
+    ownedResponseFunction.resize(0);
+    new (&responseFunction) Eigen::Map<const ArrayXd>(nullptr, 0);
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundModel::getComponentNames()
+//
+// PURPOSE:
+//      Gets the names of the additive components of the model, e.g. the Harvey-like profiles,
+//      the Gaussian envelope and the flat noise, in the order in which they are predicted
+//      by predictComponents().
+//
+// OUTPUT:
+//      A vector of strings containing the names of the components.
+//
+
+vector<string> BackgroundModel::getComponentNames()
+{
+    return componentNames;
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundModel::predictComponents()
+//
+// PURPOSE:
+//      Builds the predictions of the model together with those of each of its additive components.
+//      Each component is obtained from the predictions of the model where the parameters scaling 
+//      all the other components are set to zero, so that the components are computed by means of
+//      the same implementation of predict() used in the fit, and without any loss of precision.
+//
+// INPUT:
+//      predictions:            one-dimensional array to contain the predictions from the model.
+//      componentPredictions:   two-dimensional array to contain the predictions of each component,
+//                              with one column for each component, in the order of getComponentNames().
+//      modelParameters:        one-dimensional array where each element contains the value 
+//                              of a free parameter of the model.
+//
+// OUTPUT:
+//      void
+//
+
+void BackgroundModel::predictComponents(RefArrayXd predictions, RefArrayXXd componentPredictions, RefArrayXd const modelParameters)
+{
+    predict(predictions, modelParameters);
+
+    ArrayXd parameters = modelParameters;
+
+    for (size_t component = 0; component < componentNames.size(); ++component)
+    {
+        for (size_t otherComponent = 0; otherComponent < componentNames.size(); ++otherComponent)
+        {
+            int parameterIndex = componentScaleParameters[otherComponent];
+            parameters(parameterIndex) = (otherComponent == component) ? modelParameters(parameterIndex) : 0.0;
+        }
+
+        predict(componentPredictions.col(component), parameters);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundModel::addComponent()
+//
+// PURPOSE:
+//      Declares an additive component of the model. It is called by the constructors of the
+//      derived classes, in the order of the free parameters of the model.
+//
+// INPUT:
+//      componentName:          the name of the component, e.g. harvey1 or envelope.
+//      scaleParameterIndex:    the position of the free parameter that scales the component,
+//                              e.g. the amplitude of a Harvey-like profile or the height of the envelope.
+//
+// OUTPUT:
+//      void
+//
+
+void BackgroundModel::addComponent(const string componentName, const int scaleParameterIndex)
+{
+    componentNames.push_back(componentName);
+    componentScaleParameters.push_back(scaleParameterIndex);
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundModel::isUniformGridActive()
+//
+// PURPOSE:
+//      Checks whether the model is evaluated on the implicit uniform frequency grid.
+//
+// OUTPUT:
+//      True if the uniform grid is active, false otherwise.
+//
+
+bool BackgroundModel::isUniformGridActive()
+{
+    return uniformGrid;
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundModel::activateUniformGrid()
+//
+// PURPOSE:
+//      Replaces the stored covariates with an implicit uniform frequency grid, described only
+//      by its starting frequency, frequency resolution and number of bins, so that the frequencies
+//      are generated on the fly when the model is evaluated. The response function is kept in double
+//      precision, and is compressed only if the single-precision mode is activated afterwards. This reduces 
+//      the amount of memory that has to be read at each model evaluation, which is relevant for large datasets.
+//      The grid is activated only if the covariates are uniformly spaced.
+//
+// INPUT:
+//      relativeTolerance:      the maximum deviation of each covariate from the uniform grid,
+//                              in units of the frequency resolution.
+//
+// OUTPUT:
+//      True if the uniform grid has been activated, false if the covariates are not uniformly spaced.
+//
+// NOTE:
+//      This function has to be called after the response function has been computed,
+//      and before activating the single-precision mode.
+//
+
+bool BackgroundModel::activateUniformGrid(const double relativeTolerance)
+{
+    unsigned long Nbins = covariates.size();
+
+    if (uniformGrid)
+    {
+        return true;
+    }
+
+    if (singlePrecision || (Nbins < 2))
+    {
+        return false;
+    }
+
+    double startingFrequency = covariates(0);
+    double frequencyResolution = (covariates(Nbins-1) - startingFrequency) / (Nbins - 1);
+    ArrayXd uniformCovariates = ArrayXd::LinSpaced(Nbins, startingFrequency, covariates(Nbins-1));
+    double maxDeviation = (covariates - uniformCovariates).abs().maxCoeff();
+
+    if ((frequencyResolution <= 0.0) || (maxDeviation > relativeTolerance * frequencyResolution))
+    {
+        return false;
+    }
+
+    gridStartingFrequency = startingFrequency;
+    gridFrequencyResolution = frequencyResolution;
+    gridNbins = Nbins;
+    uniformGrid = true;
+
+
+    // Release the memory of the covariates, which are no longer used
+
+    covariates.resize(0);
+
+    return true;
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundModel::gridCovariates()
+//
+// PURPOSE:
+//      Generates the frequencies of the implicit uniform grid as an Eigen expression, 
+//      which is evaluated on the fly without being stored in memory.
+//
+// OUTPUT:
+//      An Eigen expression containing the frequency of each bin of the uniform grid.
+//
+
+ArrayXd::RandomAccessLinSpacedReturnType BackgroundModel::gridCovariates()
+{
+    return ArrayXd::LinSpaced(gridNbins, gridStartingFrequency, gridStartingFrequency + (gridNbins - 1) * gridFrequencyResolution);
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundModel::singlePrecisionGridCovariates()
+//
+// PURPOSE:
+//      Generates the frequencies of the implicit uniform grid in single precision,
+//      as an Eigen expression that is evaluated on the fly without being stored in memory.
+//
+// OUTPUT:
+//      An Eigen expression containing the frequency of each bin of the uniform grid.
+//
+
+ArrayXf::RandomAccessLinSpacedReturnType BackgroundModel::singlePrecisionGridCovariates()
+{
+    return ArrayXf::LinSpaced(gridNbins, gridStartingFrequency, gridStartingFrequency + (gridNbins - 1) * gridFrequencyResolution);
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundModel::isSinglePrecisionActive()
+//
+// PURPOSE:
+//      Checks whether the covariates and the response function are stored in single precision.
+//
+// OUTPUT:
+//      True if the single-precision mode is active, false otherwise.
+//
+
+bool BackgroundModel::isSinglePrecisionActive()
+{
+    return singlePrecision;
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundModel::activateSinglePrecision()
+//
+// PURPOSE:
+//      Stores the covariates and the response function in single precision and releases
+//      their double-precision copies. This halves the memory read at each model evaluation
+//      and doubles the number of bins processed by each vector instruction when the model
+//      is evaluated through predictSinglePrecision(). The double-precision predict() remains
+//      available and uses the single-precision arrays converted on the fly.
+//
+// OUTPUT:
+//      void
+//
+// NOTE:
+//      This function has to be called after the response function has been computed.
+//
+
+void BackgroundModel::activateSinglePrecision()
+{
+    if (singlePrecision)
+    {
+        return;
+    }
+
+    if (!uniformGrid)
+    {
+        singlePrecisionCovariates = covariates.cast<float>();
+        covariates.resize(0);
+    }
+
+    compressedResponseFunction = responseFunction.cast<float>();
+    releaseResponseFunction();
+    singlePrecision = true;
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundModel::getWorkspace()
+//
+// PURPOSE:
+//      Provides a workspace array, in either double or single precision, where the models
+//      can store the terms computed by the vectorized kernels. The workspace belongs to the 
+//      scratch arena of the calling thread, so that no allocation is made after the first evaluation
+//      and different threads can evaluate the same model at the same time.
+//
+// INPUT:
+//      Nbins:          the number of elements of the workspace.
+//
+// OUTPUT:
+//      An Eigen map of the workspace array.
+//
+
+template <>
+Eigen::Map<ArrayXd> BackgroundModel::getWorkspace<double>(const long Nbins)
+{
+    return ScratchArena::getThreadArena().getDoubleBuffer(ScratchArena::modelWorkspace, Nbins);
+}
+
+template <>
+Eigen::Map<ArrayXf> BackgroundModel::getWorkspace<float>(const long Nbins)
+{
+    return ScratchArena::getThreadArena().getFloatBuffer(ScratchArena::modelWorkspace, Nbins);
+}
@@ -0,0 +1,199 @@
+#include "BackgroundModelRegistry.h"
+
+
+// BackgroundModelRegistry::createModel()
+//
+// PURPOSE: 
+//      Creates a background model from its reference name.
+//
+// INPUT:
+//      backgroundModelName:                the string containing the reference name of the background model.
+//      covariates:                         one-dimensional array containing the values
+//                                          of the independent variable.
+//      inputNyquestFrequencyFileName:      the string containing the file name of the input ASCII file with the
+//                                          value of the Nyquist frequency to be adopted in the response function.
+//
+// OUTPUT:
+//      A pointer to the new background model, or a null pointer if the reference name
+//      does not correspond to any of the implemented background models.
+//
+
+BackgroundModel * BackgroundModelRegistry::createModel(const string backgroundModelName, const RefArrayXd covariates, 
+                                                       const string inputNyquistFrequencyFileName)
+{
+    BackgroundModel *model = nullptr;
+
+    // Long-trend, meso-granulation, and granulation component included, with colored noise
+    if (backgroundModelName == "ThreeHarveyColor")
+    {
+        model = new ThreeHarveyColorBackgroundModel(covariates, inputNyquistFrequencyFileName); 
+    }
+
+    // Long-trend, meso-granulation, and granulation component included, with colored noise but no Gaussian envelope
+    if (backgroundModelName == "ThreeHarveyColorNoGaussian")
+    {
+        model = new ThreeHarveyColorNoGaussianBackgroundModel(covariates, inputNyquistFrequencyFileName); 
+    }
+
+    // Long-trend, meso-granulation, and granulation component included, but no colored noise
+    if (backgroundModelName == "ThreeHarvey")
+    {
+        model = new ThreeHarveyBackgroundModel(covariates, inputNyquistFrequencyFileName);
+    }
+
+    // Long-trend, meso-granulation, and granulation component included, but no colored noise and no Gaussian envelope
+    if (backgroundModelName == "ThreeHarveyNoGaussian")
+    {
+        model = new ThreeHarveyNoGaussianBackgroundModel(covariates, inputNyquistFrequencyFileName); 
+    }
+
+    // Meso-granulation and granulation components included, with colored noise
+    if (backgroundModelName == "TwoHarveyColor")
+    {
+        model = new TwoHarveyColorBackgroundModel(covariates, inputNyquistFrequencyFileName);   
+    }
+
+    // Meso-granulation and granulation components included, but no colored noise
+    if (backgroundModelName == "TwoHarvey")
+    {
+        model = new TwoHarveyBackgroundModel(covariates, inputNyquistFrequencyFileName);   
+    }
+
+    // Meso-granulation and granulation components included, but no colored noise and no Gaussian envelope
+    if (backgroundModelName == "TwoHarveyNoGaussian")
+    {
+        model = new TwoHarveyNoGaussianBackgroundModel(covariates, inputNyquistFrequencyFileName);   
+    }
+
+    // Only meso-granulation component included, with colored noise
+    if (backgroundModelName == "OneHarveyColor")
+    {    
+        model = new OneHarveyColorBackgroundModel(covariates, inputNyquistFrequencyFileName); 
+    }
+
+    // Only meso-granulation component included, but no colored noise
+    if (backgroundModelName == "OneHarvey")
+    {    
+        model = new OneHarveyBackgroundModel(covariates, inputNyquistFrequencyFileName); 
+    }
+   
+    // Only meso-granulation component included, but no colored noise
+    if (backgroundModelName == "OneHarveyFreeSlope")
+    {    
+        model = new OneHarveyFreeSlopeBackgroundModel(covariates, inputNyquistFrequencyFileName); 
+    }
+
+    // Only meso-granulation component included, but no colored noise and no Gaussian envelope
+    if (backgroundModelName == "OneHarveyFreeSlopeNoGaussian")
+    {    
+        model = new OneHarveyFreeSlopeNoGaussianBackgroundModel(covariates, inputNyquistFrequencyFileName); 
+    }
+
+ 
+    // Only meso-granulation component included, but no colored noise and no Gaussian envelope
+    if (backgroundModelName == "OneHarveyNoGaussian")
+    {    
+        model = new OneHarveyNoGaussianBackgroundModel(covariates, inputNyquistFrequencyFileName); 
+    }
+
+    // Only meso-granulation component included, but no colored noise and using the original Harvey law (exponent = 2)
+    if (backgroundModelName == "Original")
+    {    
+        model = new OriginalBackgroundModel(covariates, inputNyquistFrequencyFileName); 
+    }
+
+    // Only Gaussian envelope and white noise
+    if (backgroundModelName == "Flat")
+    {    
+        model = new FlatBackgroundModel(covariates, inputNyquistFrequencyFileName); 
+    }
+
+    // Only white noise, without Gaussian envelope
+    if (backgroundModelName == "FlatNoGaussian")
+    {    
+        model = new FlatNoGaussianBackgroundModel(covariates, inputNyquistFrequencyFileName); 
+    }
+
+    return model;
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundModelRegistry::getParameterNames()
+//
+// PURPOSE: 
+//      Gets the names of the free parameters of a background model, in their order. The Harvey-like
+//      components are named after the physical component they describe, so that the same name refers
+//      to the same quantity in all the models, e.g. the granulation is the first Harvey-like component
+//      of the OneHarvey model, but the third one of the ThreeHarvey model.
+//
+// INPUT:
+//      backgroundModelName:    the string containing the reference name of the background model.
+//
+// OUTPUT:
+//      A vector of strings containing the names of the free parameters, empty if the reference name
+//      does not correspond to any of the implemented background models.
+//
+
+vector<string> BackgroundModelRegistry::getParameterNames(const string backgroundModelName)
+{
+    vector<string> parameterNames(1, "flatNoiseLevel");
+    vector<string> envelope = {"heightOscillation", "nuMax", "sigma"};
+    vector<string> coloredNoise = {"amplitudeNoise", "frequencyNoise"};
+    vector<string> longTrend = {"amplitudeLongTrend", "frequencyLongTrend"};
+    vector<string> mesoGranulation = {"amplitudeMesoGranulation", "frequencyMesoGranulation"};
+    vector<string> granulation = {"amplitudeGranulation", "frequencyGranulation"};
+
+    bool hasEnvelope = (backgroundModelName.find("NoGaussian") == string::npos);
+    string baseModelName = backgroundModelName.substr(0, backgroundModelName.find("NoGaussian"));
+
+    if ((baseModelName.size() > 5) && (baseModelName.compare(baseModelName.size() - 5, 5, "Color") == 0))
+    {
+        parameterNames.insert(parameterNames.end(), coloredNoise.begin(), coloredNoise.end());
+        baseModelName = baseModelName.substr(0, baseModelName.size() - 5);
+    }
+
+    if (baseModelName == "ThreeHarvey")
+    {
+        parameterNames.insert(parameterNames.end(), longTrend.begin(), longTrend.end());
+        parameterNames.insert(parameterNames.end(), mesoGranulation.begin(), mesoGranulation.end());
+        parameterNames.insert(parameterNames.end(), granulation.begin(), granulation.end());
+    }
+    else if (baseModelName == "TwoHarvey")
+    {
+        parameterNames.insert(parameterNames.end(), mesoGranulation.begin(), mesoGranulation.end());
+        parameterNames.insert(parameterNames.end(), granulation.begin(), granulation.end());
+    }
+    else if ((baseModelName == "OneHarvey") || (baseModelName == "OneHarveyFreeSlope"))
+    {
+        parameterNames.insert(parameterNames.end(), granulation.begin(), granulation.end());
+
+        if (baseModelName == "OneHarveyFreeSlope")
+        {
+            parameterNames.push_back("exponentGranulation");
+        }
+    }
+    else if (baseModelName == "Original")
+    {
+        parameterNames.push_back("amplitudeOriginalGranulation");
+        parameterNames.push_back("frequencyOriginalGranulation");
+    }
+    else if (baseModelName != "Flat")
+    {
+        return vector<string>();
+    }
+
+    if (hasEnvelope)
+    {
+        parameterNames.insert(parameterNames.end(), envelope.begin(), envelope.end());
+    }
+
+    return parameterNames;
+}
@@ -0,0 +1,256 @@
+#include "BackgroundOptions.h"
+
+
+// BackgroundOptions::BackgroundOptions()
+//
+// PURPOSE: 
+//      Constructor. Reads the optional configuring options of the run from an input ASCII file.
+//      Each non-commented line of the file contains the name of an option followed by its value.
+//      If the file does not exist, all the options will take their default values.
+//
+// INPUT:
+//      inputFileName:      a string specifying the full path (filename included) of the input file to read.
+//
+
+BackgroundOptions::BackgroundOptions(const string inputFileName)
+: optionsFileIsAvailable(false)
+{
+    ifstream inputFile(inputFileName.c_str());
+
+    if (!inputFile.good())
+    {
+        return;
+    }
+
+    optionsFileIsAvailable = true;
+    string line;
+
+    while (getline(inputFile, line))
+    {
+        // Skip empty and commented lines
+
+        size_t firstCharacter = line.find_first_not_of(" \t");
+        
+        if ((firstCharacter == string::npos) || (line[firstCharacter] == '#'))
+        {
+            continue;
+        }
+
+        istringstream lineStream(line);
+        string optionName;
+        string optionValue;
+        lineStream >> optionName >> optionValue;
+
+        if (optionValue.empty())
+        {
+            cerr << "Option " << optionName << " in file " << inputFileName << " has no value." << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        options[optionName] = optionValue;
+    }
+
+    inputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundOptions::~BackgroundOptions()
+//
+// PURPOSE: 
+//      Destructor.
+//
+
+BackgroundOptions::~BackgroundOptions()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundOptions::isAvailable()
+//
+// PURPOSE:
+//      Checks whether an input file of configuring options was found.
+//
+// OUTPUT:
+//      True if the options file exists, false otherwise.
+//
+
+bool BackgroundOptions::isAvailable()
+{
+    return optionsFileIsAvailable;
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundOptions::isDefined()
+//
+// PURPOSE:
+//      Checks whether an option was specified in the input file.
+//
+// INPUT:
+//      optionName:     a string containing the name of the option.
+//
+// OUTPUT:
+//      True if the option is specified, false otherwise.
+//
+
+bool BackgroundOptions::isDefined(const string optionName)
+{
+    return (options.find(optionName) != options.end());
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundOptions::getString()
+//
+// PURPOSE:
+//      Gets the value of an option as a string.
+//
+// INPUT:
+//      optionName:     a string containing the name of the option.
+//      defaultValue:   the value to return if the option is not specified.
+//
+// OUTPUT:
+//      A string containing the value of the option.
+//
+
+string BackgroundOptions::getString(const string optionName, const string defaultValue)
+{
+    if (!isDefined(optionName))
+    {
+        return defaultValue;
+    }
+
+    return options[optionName];
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundOptions::getDouble()
+//
+// PURPOSE:
+//      Gets the value of an option as a double.
+//
+// INPUT:
+//      optionName:     a string containing the name of the option.
+//      defaultValue:   the value to return if the option is not specified.
+//
+// OUTPUT:
+//      A double containing the value of the option.
+//
+
+double BackgroundOptions::getDouble(const string optionName, const double defaultValue)
+{
+    if (!isDefined(optionName))
+    {
+        return defaultValue;
+    }
+
+    return stod(options[optionName]);
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundOptions::getInt()
+//
+// PURPOSE:
+//      Gets the value of an option as an integer.
+//
+// INPUT:
+//      optionName:     a string containing the name of the option.
+//      defaultValue:   the value to return if the option is not specified.
+//
+// OUTPUT:
+//      An integer containing the value of the option.
+//
+
+int BackgroundOptions::getInt(const string optionName, const int defaultValue)
+{
+    if (!isDefined(optionName))
+    {
+        return defaultValue;
+    }
+
+    return stoi(options[optionName]);
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundOptions::printOptions()
+//
+// PURPOSE:
+//      Prints on the screen the list of options specified in the input file.
+//
+// OUTPUT:
+//      void
+//
+
+void BackgroundOptions::printOptions()
+{
+    if (options.empty())
+    {
+        return;
+    }
+
+    cout << "------------------------------------------------------- " << endl;
+    cout << " Configuring options of the run " << endl;
+    
+    for (map<string, string>::iterator option = options.begin(); option != options.end(); ++option)
+    {
+        cout << " " << option->first << " = " << option->second << endl;
+    }
+
+    cout << "------------------------------------------------------- " << endl;
+    cout << endl; 
+}
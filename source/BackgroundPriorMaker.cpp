@@ -0,0 +1,660 @@
+#include "BackgroundPriorMaker.h"
+
+
+// BackgroundPriorMaker::BackgroundPriorMaker()
+//
+// PURPOSE:
+//      Constructor. Computes the prior ranges of all the components of the background models
+//      from a raw guess of nuMax, by means of the scaling relations with nuMax and of the power
+//      spectral density of the dataset, as in set_background_priors of tutorials/background.py.
+//
+// INPUT:
+//      frequencies:        one-dimensional array containing the frequencies of the dataset (muHz),
+//                          sorted in increasing order.
+//      spectralDensity:    one-dimensional array containing the power spectral density of the dataset.
+//      nuMax:              a raw guess of the frequency of maximum oscillation power (muHz).
+//
+
+BackgroundPriorMaker::BackgroundPriorMaker(const ConstRefArrayXd frequencies, const ConstRefArrayXd spectralDensity, const double nuMax)
+{
+    if ((nuMax <= 0.0) || (frequencies.size() < 2) || (frequencies.size() != spectralDensity.size()))
+    {
+        cerr << "Automatic priors require nuMax > 0 and a dataset with at least two frequencies." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    double minFrequency = frequencies(0);
+
+
+    // Gaussian envelope, from the scaling of the large frequency separation and of the envelope width with nuMax
+
+    double largeSeparation = 0.267 * pow(nuMax, 0.760);
+    double sigma = exp(-1.46182 + 0.877656 * log(nuMax));
+    int windowLength = static_cast<int>(largeSeparation / (frequencies(1) - frequencies(0)));
+    double height = smoothedMaximum(frequencies, spectralDensity, windowLength,
+                                    nuMax - 3 * largeSeparation, nuMax + 3 * largeSeparation);
+
+    ranges["nuMax"] = make_pair(nuMax - largeSeparation * 1.5, nuMax + largeSeparation * 1.5);
+    ranges["sigma"] = make_pair(sigma * 0.6, sigma * 1.3);
+    ranges["height"] = make_pair(0.1 * height, 1.40 * height);
+
+
+    // White noise, from the average power spectral density at the two ends of the region above the envelope
+
+    const double *firstFrequency = frequencies.data();
+    const double *lastFrequency = frequencies.data() + frequencies.size();
+    long firstWhiteNoiseBin = upper_bound(firstFrequency, lastFrequency, nuMax + 2 * sigma) - firstFrequency;
+
+    if (firstWhiteNoiseBin == frequencies.size())
+    {
+        firstWhiteNoiseBin = upper_bound(firstFrequency, lastFrequency, nuMax) - firstFrequency;
+    }
+
+    long NwhiteNoiseBins = frequencies.size() - firstWhiteNoiseBin;
+    long NchunkBins = static_cast<long>(NwhiteNoiseBins / 10.0);
+
+    if (NchunkBins == 0)
+    {
+        cerr << "Too few frequency bins above nuMax = " << nuMax << " muHz for estimating the white noise." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    double startWhiteNoise = spectralDensity.segment(firstWhiteNoiseBin, NchunkBins).mean();
+    double endWhiteNoise = spectralDensity.tail(NchunkBins).mean();
+    double deltaWhiteNoise = fabs(startWhiteNoise - endWhiteNoise);
+    double whiteNoise = endWhiteNoise;
+    double gradientWhiteNoise = deltaWhiteNoise / endWhiteNoise;
+
+    if (gradientWhiteNoise * 100 >= 50.)
+    {
+        ranges["whiteNoise"] = make_pair(whiteNoise - 0.5 * whiteNoise, whiteNoise + 0.5 * whiteNoise);
+    }
+    else
+    {
+        ranges["whiteNoise"] = make_pair(whiteNoise - deltaWhiteNoise, whiteNoise + deltaWhiteNoise);
+    }
+
+
+    // Meso-granulation. The amplitude from the scaling relation is replaced by that
+    // estimated from the dataset, if larger.
+
+    double frequencyMesoGranulation = 0.317 * pow(nuMax, 0.970);
+    double lowerFrequencyMesoGranulation = 0.6 * frequencyMesoGranulation;
+    double upperFrequencyMesoGranulation = 1.5 * frequencyMesoGranulation;
+    double amplitudeMesoGranulation = 3383 * pow(nuMax, -0.609);
+    double psdMesoGranulation = maximumInRange(frequencies, spectralDensity, 0.9 * frequencyMesoGranulation,
+                                               1.1 * frequencyMesoGranulation);
+    double dataAmplitudeMesoGranulation = sqrt(psdMesoGranulation * frequencyMesoGranulation) / (2 * sqrt(2.)) * M_PI;
+
+    if (dataAmplitudeMesoGranulation > amplitudeMesoGranulation)
+    {
+        amplitudeMesoGranulation = dataAmplitudeMesoGranulation;
+    }
+
+    ranges["amplitudeMesoGranulation"] = make_pair(0.2 * amplitudeMesoGranulation, 1.5 * amplitudeMesoGranulation);
+
+
+    // Granulation. The amplitude range is the same of the meso-granulation, as in the python routine.
+
+    double frequencyGranulation = 0.948 * pow(nuMax, 0.992);
+    double lowerFrequencyGranulation = 0.6 * frequencyGranulation;
+    double upperFrequencyGranulation = 1.5 * frequencyGranulation;
+    double amplitudeGranulation = 3383 * pow(nuMax, -0.609);
+
+    ranges["amplitudeGranulation"] = ranges["amplitudeMesoGranulation"];
+
+
+    // Granulation in the original formulation, with the exponent of the Harvey profile set to 2
+
+    ranges["frequencyOriginal"] = make_pair(0.4 * frequencyGranulation, 1.7 * frequencyGranulation);
+    ranges["amplitudeOriginal"] = make_pair(0.2 * amplitudeGranulation, 1.7 * amplitudeGranulation);
+
+
+    // Rotation, below the meso-granulation
+
+    double frequencyRotation = frequencyMesoGranulation / 2.;
+    double lowerFrequencyRotation = minFrequency;
+    double upperFrequencyRotation = 0.99 * frequencyMesoGranulation;
+    double psdRotation = maximumInRange(frequencies, spectralDensity, 0.9 * frequencyRotation, 1.1 * frequencyRotation);
+    double amplitudeRotation = sqrt(psdRotation * frequencyRotation) / (2 * sqrt(2.)) * M_PI;
+
+    ranges["amplitudeRotation"] = make_pair(0.0, 1.5 * amplitudeRotation);
+
+
+    // Colored noise
+
+    double frequencyColor = frequencyRotation * 1.5;
+
+    ranges["frequencyColor"] = make_pair(minFrequency, frequencyColor * 1.5);
+    ranges["amplitudeColor"] = make_pair(0.0, 2.0 * amplitudeRotation);
+
+
+    // Make the frequency ranges of rotation, meso-granulation and granulation contiguous,
+    // or reduce their overlap if it is too large
+
+    if (upperFrequencyMesoGranulation > lowerFrequencyGranulation * 1.2)
+    {
+        double difference = upperFrequencyMesoGranulation - lowerFrequencyGranulation;
+        upperFrequencyMesoGranulation -= 0.5 * difference;
+        lowerFrequencyGranulation += 0.5 * difference;
+    }
+    else if (upperFrequencyMesoGranulation < lowerFrequencyGranulation)
+    {
+        upperFrequencyMesoGranulation = (upperFrequencyMesoGranulation + lowerFrequencyGranulation) / 2.0;
+        lowerFrequencyGranulation = upperFrequencyMesoGranulation;
+    }
+
+    if (upperFrequencyRotation > lowerFrequencyMesoGranulation * 1.3)
+    {
+        double difference = upperFrequencyRotation - lowerFrequencyMesoGranulation;
+        upperFrequencyRotation -= 0.5 * difference;
+        lowerFrequencyMesoGranulation += 0.5 * difference;
+    }
+    else if (upperFrequencyRotation < lowerFrequencyMesoGranulation)
+    {
+        upperFrequencyRotation = (upperFrequencyRotation + lowerFrequencyMesoGranulation) / 2.0;
+        lowerFrequencyMesoGranulation = upperFrequencyRotation;
+    }
+
+    ranges["frequencyRotation"] = make_pair(lowerFrequencyRotation, upperFrequencyRotation);
+    ranges["frequencyMesoGranulation"] = make_pair(lowerFrequencyMesoGranulation, upperFrequencyMesoGranulation);
+    ranges["frequencyGranulation"] = make_pair(lowerFrequencyGranulation, upperFrequencyGranulation);
+
+
+    // Without a rotation component, the meso-granulation extends down to the lowest frequency
+
+    ranges["frequencyMesoGranulationNoRotation"] = make_pair(minFrequency, upperFrequencyMesoGranulation);
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundPriorMaker::~BackgroundPriorMaker()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+BackgroundPriorMaker::~BackgroundPriorMaker()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundPriorMaker::getBoundaries()
+//
+// PURPOSE:
+//      Gets the boundaries of the uniform priors of a background model, in the order of its free parameters.
+//
+// INPUT:
+//      backgroundModelName:    the string containing the reference name of the background model.
+//
+// OUTPUT:
+//      A two-dimensional array with one row for each free parameter, containing the minimum and
+//      the maximum of its uniform prior, rounded to four significant digits.
+//
+
+ArrayXXd BackgroundPriorMaker::getBoundaries(const string backgroundModelName)
+{
+    vector<string> components = getComponents(backgroundModelName);
+    ArrayXXd boundaries(components.size(), 2);
+
+    for (size_t parameter = 0; parameter < components.size(); ++parameter)
+    {
+        boundaries(parameter, 0) = roundToFileDigits(ranges[components[parameter]].first);
+        boundaries(parameter, 1) = roundToFileDigits(ranges[components[parameter]].second);
+    }
+
+    return boundaries;
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundPriorMaker::writeBoundariesToFile()
+//
+// PURPOSE:
+//      Writes the boundaries of the uniform priors of a background model into an ASCII file,
+//      with the same format of the file background_hyperParameters_NN.txt written by the python routine.
+//
+// INPUT:
+//      fileName:               a string specifying the full path (filename included) of the output file.
+//      backgroundModelName:    the string containing the reference name of the background model.
+//
+// OUTPUT:
+//      void
+//
+
+void BackgroundPriorMaker::writeBoundariesToFile(const string fileName, const string backgroundModelName)
+{
+    ArrayXXd boundaries = getBoundaries(backgroundModelName);
+    FILE *outputFile = fopen(fileName.c_str(), "w");
+
+    if (outputFile == nullptr)
+    {
+        cerr << "Error opening output file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    fprintf(outputFile, "# \n");
+    fprintf(outputFile, "#     Hyper parameters used for setting up uniform priors.\n");
+    fprintf(outputFile, "#     Each line corresponds to a different free parameter (coordinate).\n");
+    fprintf(outputFile, "#     Column #1: Minima (lower boundaries)\n");
+    fprintf(outputFile, "#     Column #2: Maxima (upper boundaries)\n");
+    fprintf(outputFile, "#     \n");
+
+    for (int parameter = 0; parameter < boundaries.rows(); ++parameter)
+    {
+        fprintf(outputFile, "%.3e %.3e\n", boundaries(parameter, 0), boundaries(parameter, 1));
+    }
+
+    fclose(outputFile);
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundPriorMaker::getNSMCconfiguringParameters()
+//
+// PURPOSE:
+//      Gets the default configuring parameters of the nested sampler, as written into the file
+//      NSMC_configuringParameters.txt by the python routine.
+//
+// OUTPUT:
+//      A one-dimensional array containing the initial and minimum number of live points, the maximum
+//      number of drawing attempts, the number of initial iterations without clustering, the number of
+//      iterations with the same clustering, the initial enlargement fraction, the shrinking rate
+//      and the termination factor.
+//
+
+ArrayXd BackgroundPriorMaker::getNSMCconfiguringParameters()
+{
+    ArrayXd configuringParameters(8);
+    configuringParameters << 500, 500, 50000, 1000, 50, 1.5, 0.0, 1.0;
+
+    return configuringParameters;
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundPriorMaker::getXmeansConfiguringParameters()
+//
+// PURPOSE:
+//      Gets the default configuring parameters of the clustering algorithm, as written into
+//      the file Xmeans_configuringParameters.txt by the python routine.
+//
+// OUTPUT:
+//      A one-dimensional array containing the minimum and maximum number of clusters.
+//
+
+ArrayXd BackgroundPriorMaker::getXmeansConfiguringParameters()
+{
+    ArrayXd configuringParameters(2);
+    configuringParameters << 3, 6;
+
+    return configuringParameters;
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundPriorMaker::writeConfiguringParametersToFile()
+//
+// PURPOSE:
+//      Writes a set of configuring parameters into an ASCII file, one for each row.
+//
+// INPUT:
+//      fileName:               a string specifying the full path (filename included) of the output file.
+//      configuringParameters:  one-dimensional array containing the configuring parameters.
+//      Ndecimals:              the number of decimal digits of each value.
+//
+// OUTPUT:
+//      void
+//
+
+void BackgroundPriorMaker::writeConfiguringParametersToFile(const string fileName, const ArrayXd &configuringParameters,
+                                                            const int Ndecimals)
+{
+    FILE *outputFile = fopen(fileName.c_str(), "w");
+
+    if (outputFile == nullptr)
+    {
+        cerr << "Error opening output file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < configuringParameters.size(); ++i)
+    {
+        fprintf(outputFile, "%.*f\n", Ndecimals, configuringParameters(i));
+    }
+
+    fclose(outputFile);
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundPriorMaker::formatShortest()
+//
+// PURPOSE:
+//      Formats a value with the shortest string that reads back to the same value,
+//      as done by python for a floating-point number, e.g. for the Nyquist frequency.
+//
+// INPUT:
+//      value:      the value to be formatted.
+//
+// OUTPUT:
+//      A string containing the formatted value.
+//
+
+string BackgroundPriorMaker::formatShortest(const double value)
+{
+    char text[32];
+
+    for (int precision = 1; precision <= 17; ++precision)
+    {
+        snprintf(text, sizeof(text), "%.*g", precision, value);
+
+        if (strtod(text, nullptr) == value)
+        {
+            break;
+        }
+    }
+
+    string formattedValue(text);
+
+    if (formattedValue.find_first_of(".en") == string::npos)
+    {
+        formattedValue += ".0";
+    }
+
+    return formattedValue;
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundPriorMaker::smoothedMaximum()
+//
+// PURPOSE:
+//      Finds the maximum of the power spectral density smoothed by a moving average, within an open
+//      range of frequencies. The dataset is extended at both ends by its reflected copies, as in the
+//      function smooth of tutorials/background.py, and the moving average is updated bin by bin.
+//
+// INPUT:
+//      frequencies:        one-dimensional array containing the frequencies of the dataset (muHz).
+//      spectralDensity:    one-dimensional array containing the power spectral density of the dataset.
+//      windowLength:       the number of bins of the moving average. No smoothing is done if lower than 3.
+//      lowerFrequency:     the lower limit of the range (muHz), excluded.
+//      upperFrequency:     the upper limit of the range (muHz), excluded.
+//
+// OUTPUT:
+//      The maximum of the smoothed power spectral density within the range.
+//
+
+double BackgroundPriorMaker::smoothedMaximum(const ConstRefArrayXd frequencies, const ConstRefArrayXd spectralDensity, const int windowLength,
+                                             const double lowerFrequency, const double upperFrequency)
+{
+    const double *firstFrequency = frequencies.data();
+    const double *lastFrequency = frequencies.data() + frequencies.size();
+    long Nbins = frequencies.size();
+    long firstBin = upper_bound(firstFrequency, lastFrequency, lowerFrequency) - firstFrequency;
+    long lastBin = lower_bound(firstFrequency, lastFrequency, upperFrequency) - firstFrequency;
+
+    if (firstBin >= lastBin)
+    {
+        cerr << "No frequency bins within 3 large frequency separations from nuMax." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (windowLength < 3)
+    {
+        return spectralDensity.segment(firstBin, lastBin - firstBin).maxCoeff();
+    }
+
+    if (Nbins < windowLength)
+    {
+        cerr << "The dataset is shorter than the smoothing window of the envelope height." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    auto reflectedValue = [&](long bin)
+    {
+        if (bin < 0)
+        {
+            return spectralDensity(-bin);
+        }
+        else if (bin >= Nbins)
+        {
+            return spectralDensity(2 * Nbins - 2 - bin);
+        }
+
+        return spectralDensity(bin);
+    };
+
+    long offset = windowLength / 2 - (windowLength - 1);
+    double windowSum = 0.0;
+
+    for (long k = 0; k < windowLength; ++k)
+    {
+        windowSum += reflectedValue(firstBin + offset + k);
+    }
+
+    double maxSmoothedValue = windowSum / windowLength;
+
+    for (long bin = firstBin + 1; bin < lastBin; ++bin)
+    {
+        windowSum += reflectedValue(bin + offset + windowLength - 1) - reflectedValue(bin + offset - 1);
+        maxSmoothedValue = max(maxSmoothedValue, windowSum / windowLength);
+    }
+
+    return maxSmoothedValue;
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundPriorMaker::maximumInRange()
+//
+// PURPOSE:
+//      Finds the maximum of the power spectral density within a closed range of frequencies.
+//
+// INPUT:
+//      frequencies:        one-dimensional array containing the frequencies of the dataset (muHz).
+//      spectralDensity:    one-dimensional array containing the power spectral density of the dataset.
+//      lowerFrequency:     the lower limit of the range (muHz), included.
+//      upperFrequency:     the upper limit of the range (muHz), included.
+//
+// OUTPUT:
+//      The maximum of the power spectral density within the range.
+//
+
+double BackgroundPriorMaker::maximumInRange(const ConstRefArrayXd frequencies, const ConstRefArrayXd spectralDensity,
+                                            const double lowerFrequency, const double upperFrequency)
+{
+    const double *firstFrequency = frequencies.data();
+    const double *lastFrequency = frequencies.data() + frequencies.size();
+    long firstBin = lower_bound(firstFrequency, lastFrequency, lowerFrequency) - firstFrequency;
+    long lastBin = upper_bound(firstFrequency, lastFrequency, upperFrequency) - firstFrequency;
+
+    if (firstBin >= lastBin)
+    {
+        cerr << "No frequency bins in [" << lowerFrequency << ", " << upperFrequency
+             << "] muHz for estimating the amplitude of a Harvey profile." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    return spectralDensity.segment(firstBin, lastBin - firstBin).maxCoeff();
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundPriorMaker::getComponents()
+//
+// PURPOSE:
+//      Gets the names of the prior ranges of the free parameters of a background model.
+//
+// INPUT:
+//      backgroundModelName:    the string containing the reference name of the background model.
+//
+// OUTPUT:
+//      A vector of strings containing the name of the prior range of each free parameter,
+//      in the order of the free parameters of the model.
+//
+
+vector<string> BackgroundPriorMaker::getComponents(const string backgroundModelName)
+{
+    vector<string> components(1, "whiteNoise");
+    vector<string> envelope = {"height", "nuMax", "sigma"};
+    vector<string> color = {"amplitudeColor", "frequencyColor"};
+    vector<string> rotation = {"amplitudeRotation", "frequencyRotation"};
+    vector<string> mesoGranulation = {"amplitudeMesoGranulation", "frequencyMesoGranulation"};
+    vector<string> mesoGranulationNoRotation = {"amplitudeMesoGranulation", "frequencyMesoGranulationNoRotation"};
+    vector<string> granulation = {"amplitudeGranulation", "frequencyGranulation"};
+    vector<string> original = {"amplitudeOriginal", "frequencyOriginal"};
+
+    if (backgroundModelName == "FlatNoGaussian")
+    {
+        return components;
+    }
+
+    if (backgroundModelName == "Flat")
+    {
+        components.insert(components.end(), envelope.begin(), envelope.end());
+        return components;
+    }
+
+    if (backgroundModelName == "Original")
+    {
+        components.insert(components.end(), original.begin(), original.end());
+        components.insert(components.end(), envelope.begin(), envelope.end());
+        return components;
+    }
+
+    bool hasEnvelope = (backgroundModelName.find("NoGaussian") == string::npos);
+    string baseModelName = backgroundModelName.substr(0, backgroundModelName.find("NoGaussian"));
+
+    if (baseModelName == "OneHarveyColor" || baseModelName == "TwoHarveyColor" || baseModelName == "ThreeHarveyColor")
+    {
+        components.insert(components.end(), color.begin(), color.end());
+        baseModelName = baseModelName.substr(0, baseModelName.size() - 5);
+    }
+
+    if (baseModelName == "ThreeHarvey")
+    {
+        components.insert(components.end(), rotation.begin(), rotation.end());
+        components.insert(components.end(), mesoGranulation.begin(), mesoGranulation.end());
+    }
+    else if (baseModelName == "TwoHarvey")
+    {
+        components.insert(components.end(), mesoGranulationNoRotation.begin(), mesoGranulationNoRotation.end());
+    }
+    else if (baseModelName != "OneHarvey")
+    {
+        cerr << "Automatic priors are not available for background model " << backgroundModelName << "." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    components.insert(components.end(), granulation.begin(), granulation.end());
+
+    if (hasEnvelope)
+    {
+        components.insert(components.end(), envelope.begin(), envelope.end());
+    }
+
+    return components;
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundPriorMaker::roundToFileDigits()
+//
+// PURPOSE:
+//      Rounds a value to four significant digits, as written into the file of the prior boundaries,
+//      so that a fit with automatic priors is identical to one reading the file.
+//
+// INPUT:
+//      value:      the value to be rounded.
+//
+// OUTPUT:
+//      The rounded value.
+//
+
+double BackgroundPriorMaker::roundToFileDigits(const double value)
+{
+    char text[32];
+    snprintf(text, sizeof(text), "%.3e", value);
+
+    return strtod(text, nullptr);
+}
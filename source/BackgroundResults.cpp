@@ -0,0 +1,381 @@
+#include "BackgroundResults.h"
+
+
+// BackgroundResults::BackgroundResults()
+//
+// PURPOSE:
+//      Constructor.
+//
+// INPUT:
+//      nestedSampler:      an object of class NestedSampler containing the results of the run.
+//
+
+BackgroundResults::BackgroundResults(NestedSampler &nestedSampler)
+: Results(nestedSampler),
+  backgroundNestedSampler(nestedSampler)
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundResults::~BackgroundResults()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+BackgroundResults::~BackgroundResults()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundResults::getSampleColumns()
+//
+// PURPOSE:
+//      Collects all the quantities defined for each point of the posterior sample
+//      as the columns of a single array.
+//
+// OUTPUT:
+//      A two-dimensional Eigen array with one row for each sampling point and the columns:
+//      (1) to (Ndimensions) the values of the free parameters, in the order of the parameterNNN.txt files;
+//      (Ndimensions + 1) the natural logarithm of the likelihood, as in logLikelihood.txt;
+//      (Ndimensions + 2) the natural logarithm of the weight, as in logWeights.txt;
+//      (Ndimensions + 3) the posterior probability, as in posteriorDistribution.txt.
+//
+
+ArrayXXd BackgroundResults::getSampleColumns()
+{
+    ArrayXXd posteriorSample = backgroundNestedSampler.getPosteriorSample();
+    int Ndimensions = posteriorSample.rows();
+    int Nsamples = posteriorSample.cols();
+
+    ArrayXXd sampleColumns(Nsamples, Ndimensions + 3);
+    sampleColumns.leftCols(Ndimensions) = posteriorSample.transpose();
+    sampleColumns.col(Ndimensions) = backgroundNestedSampler.getLogLikelihoodOfPosteriorSample();
+    sampleColumns.col(Ndimensions + 1) = backgroundNestedSampler.getLogWeightOfPosteriorSample();
+    sampleColumns.col(Ndimensions + 2) = posteriorProbability();
+
+    return sampleColumns;
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundResults::writeSamplesToNpyFile()
+//
+// PURPOSE:
+//      Writes all the quantities defined for each point of the posterior sample into a single
+//      binary file in the .npy format, with one column for each quantity (see getSampleColumns()).
+//      This replaces the ASCII files written by writeParametersToFile(), writeLogLikelihoodToFile(),
+//      writeLogWeightsToFile() and writePosteriorProbabilityToFile().
+//
+// INPUT:
+//      fileName:       a string specifying the name of the output file, which is prefixed
+//                      by the output path of the run.
+//
+// OUTPUT:
+//      void
+//
+
+void BackgroundResults::writeSamplesToNpyFile(string fileName)
+{
+    NpyFile::arrayXXdToFile(backgroundNestedSampler.getOutputPathPrefix() + fileName, getSampleColumns());
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundResults::writeParametersToFile()
+//
+// PURPOSE:
+//      Writes the posterior sample of each free parameter into a separate ASCII file,
+//      with the same content and file names of Results::writeParametersToFile().
+//
+// INPUT:
+//      fileName:               a string specifying the root of the name of the output files,
+//                              which is followed by the three-digit number of the parameter.
+//      outputFileExtension:    a string specifying the extension of the output files.
+//
+// OUTPUT:
+//      void
+//
+
+void BackgroundResults::writeParametersToFile(string fileName, string outputFileExtension)
+{
+    ArrayXXd posteriorSample = backgroundNestedSampler.getPosteriorSample();
+
+    for (int parameter = 0; parameter < posteriorSample.rows(); ++parameter)
+    {
+        ostringstream parameterFileName;
+        parameterFileName << backgroundNestedSampler.getOutputPathPrefix() << fileName 
+                          << setfill('0') << setw(3) << parameter << outputFileExtension;
+        
+        TextFileWriter outputFile(parameterFileName.str());
+        outputFile.writeArrayXd(posteriorSample.row(parameter).transpose());
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundResults::writeLogLikelihoodToFile()
+//
+// PURPOSE:
+//      Writes the natural logarithm of the likelihood of each sampling point into an ASCII file,
+//      with the same content of Results::writeLogLikelihoodToFile().
+//
+// INPUT:
+//      fileName:       a string specifying the name of the output file, which is prefixed
+//                      by the output path of the run.
+//
+// OUTPUT:
+//      void
+//
+
+void BackgroundResults::writeLogLikelihoodToFile(string fileName)
+{
+    TextFileWriter outputFile(backgroundNestedSampler.getOutputPathPrefix() + fileName);
+    outputFile.writeArrayXd(backgroundNestedSampler.getLogLikelihoodOfPosteriorSample());
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundResults::writeLogWeightsToFile()
+//
+// PURPOSE:
+//      Writes the natural logarithm of the weight of each sampling point into an ASCII file,
+//      with the same content of Results::writeLogWeightsToFile().
+//
+// INPUT:
+//      fileName:       a string specifying the name of the output file, which is prefixed
+//                      by the output path of the run.
+//
+// OUTPUT:
+//      void
+//
+
+void BackgroundResults::writeLogWeightsToFile(string fileName)
+{
+    TextFileWriter outputFile(backgroundNestedSampler.getOutputPathPrefix() + fileName);
+    outputFile.writeArrayXd(backgroundNestedSampler.getLogWeightOfPosteriorSample());
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundResults::writePosteriorProbabilityToFile()
+//
+// PURPOSE:
+//      Writes the posterior probability of each sampling point into an ASCII file,
+//      with the same content of Results::writePosteriorProbabilityToFile().
+//
+// INPUT:
+//      fileName:       a string specifying the name of the output file, which is prefixed
+//                      by the output path of the run.
+//
+// OUTPUT:
+//      void
+//
+
+void BackgroundResults::writePosteriorProbabilityToFile(string fileName)
+{
+    TextFileWriter outputFile(backgroundNestedSampler.getOutputPathPrefix() + fileName);
+    outputFile.writeArrayXd(posteriorProbability());
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundResults::writeParametersSummaryToFile()
+//
+// PURPOSE:
+//      Writes the summary statistics of each free parameter into an ASCII file, with the same
+//      format of Results::writeParametersSummaryToFile(), and optionally the marginal distribution
+//      of each free parameter into a separate ASCII file, named marginalDistribution followed by
+//      the three-digit number of the parameter. The summary of all the parameters is computed 
+//      in parallel by means of the class ParameterSummary.
+//
+// INPUT:
+//      fileName:                           a string specifying the name of the output file, which is prefixed
+//                                          by the output path of the run.
+//      credibleLevel:                      the credible level (in percent) of the credible limits.
+//      writeMarginalDistributionToFile:    a boolean specifying whether the marginal distributions are written.
+//      Nthreads:                           the largest number of threads computing the summary.
+//
+// OUTPUT:
+//      void
+//
+
+void BackgroundResults::writeParametersSummaryToFile(string fileName, const double credibleLevel, 
+                                                     const bool writeMarginalDistributionToFile, const int Nthreads)
+{
+    ParameterSummary parameterSummary(Nthreads);
+    parameterSummary.compute(backgroundNestedSampler.getPosteriorSample(), posteriorProbability(), credibleLevel);
+    ArrayXXd summary = parameterSummary.getSummary();
+
+    TextFileWriter outputFile(backgroundNestedSampler.getOutputPathPrefix() + fileName);
+    ostringstream credibleLevelText;
+    credibleLevelText << fixed << setprecision(2) << credibleLevel;
+
+    outputFile.writeText("# Summary of Parameter Estimation from nested sampling\n");
+    outputFile.writeText("# Credible intervals are the shortest credible intervals\n");
+    outputFile.writeText("# according to the usual definition\n");
+    outputFile.writeText("# Credible level: " + credibleLevelText.str() + " %\n");
+    outputFile.writeText("# Column #1: I Moment (Mean)\n");
+    outputFile.writeText("# Column #2: Median\n");
+    outputFile.writeText("# Column #3: Mode\n");
+    outputFile.writeText("# Column #4: II Moment (Variance if Normal distribution)\n");
+    outputFile.writeText("# Column #5: Lower Credible Limit\n");
+    outputFile.writeText("# Column #6: Upper Credible Limit\n");
+    outputFile.writeText("# Column #7: Skewness (Asymmetry of the distribution, -1 to the left, +1 to the right, 0 if symmetric)\n");
+    outputFile.writeArrayXXd(summary);
+
+    if (writeMarginalDistributionToFile)
+    {
+        for (int parameter = 0; parameter < summary.rows(); ++parameter)
+        {
+            ostringstream marginalFileName;
+            marginalFileName << backgroundNestedSampler.getOutputPathPrefix() << "marginalDistribution" 
+                             << setfill('0') << setw(3) << parameter << ".txt";
+
+            TextFileWriter marginalFile(marginalFileName.str());
+            marginalFile.writeArrayXXd(parameterSummary.getMarginalDistribution(parameter));
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// BackgroundResults::readSampleColumns()
+//
+// PURPOSE:
+//      Reads the posterior sample of a completed run, either from the single binary file of the sample
+//      or from the ASCII files of each quantity, whichever was written by the run.
+//
+// INPUT:
+//      runPathPrefix:      a string containing the output path prefix of the run.
+//
+// OUTPUT:
+//      A two-dimensional Eigen array with the same columns of getSampleColumns(). The program
+//      is stopped if the posterior sample is not found, e.g. because the run is archived.
+//
+
+ArrayXXd BackgroundResults::readSampleColumns(const string runPathPrefix)
+{
+    if (ifstream(runPathPrefix + "samples.npy").good())
+    {
+        return NpyFile::arrayXXdFromFile(runPathPrefix + "samples.npy");
+    }
+
+    if (!ifstream(runPathPrefix + "posteriorDistribution.txt").good())
+    {
+        cerr << "No posterior sample found with prefix " << runPathPrefix << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    vector<string> fileNames;
+
+    while (true)
+    {
+        ostringstream parameterFileName;
+        parameterFileName << runPathPrefix << "parameter" << setfill('0') << setw(3) << fileNames.size() << ".txt";
+
+        if (!ifstream(parameterFileName.str()).good())
+        {
+            break;
+        }
+
+        fileNames.push_back(parameterFileName.str());
+    }
+
+    fileNames.push_back(runPathPrefix + "logLikelihood.txt");
+    fileNames.push_back(runPathPrefix + "logWeights.txt");
+    fileNames.push_back(runPathPrefix + "posteriorDistribution.txt");
+
+    ArrayXXd sampleColumns;
+    ifstream inputFile;
+    unsigned long Nrows;
+    int Ncols;
+
+    for (size_t column = 0; column < fileNames.size(); ++column)
+    {
+        File::openInputFile(inputFile, fileNames[column]);
+        File::sniffFile(inputFile, Nrows, Ncols);
+
+        if (column == 0)
+        {
+            sampleColumns.resize(Nrows, fileNames.size());
+        }
+        else if (Nrows != static_cast<unsigned long>(sampleColumns.rows()))
+        {
+            cerr << "The sample of " << fileNames[column] << " does not match that of " << fileNames[0] << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        sampleColumns.col(column) = File::arrayXXdFromFile(inputFile, Nrows, 1);
+        inputFile.close();
+    }
+
+    return sampleColumns;
+}
@@ -0,0 +1,175 @@
+#include "BinIntegratedModel.h"
+
+
+// BinIntegratedModel::BinIntegratedModel()
+//
+// PURPOSE: 
+//      Constructor. Sets up the Gauss-Legendre nodes and weights within each bin.
+//
+// INPUT:
+//      covariates:             one-dimensional array containing the central frequency of each bin.
+//      binWidths:              one-dimensional array containing the frequency width of each bin.
+//      NnodesPerBin:           an integer from 1 to 5 specifying the number of quadrature nodes 
+//                              used within each bin. A value of 1 corresponds to a mid-bin evaluation.
+//
+// NOTE:
+//      The integrand model has to be built on the covariates returned by getNodeCovariates()
+//      and assigned by means of setIntegrandModel() before calling predict().
+//
+
+BinIntegratedModel::BinIntegratedModel(const RefArrayXd covariates, const RefArrayXd binWidths, const int NnodesPerBin)
+: Model(covariates),
+  NnodesPerBin(NnodesPerBin),
+  integrandModel(nullptr)
+{
+    // Gauss-Legendre abscissae and weights on [-1, 1]
+
+    ArrayXd abscissae(NnodesPerBin);
+    ArrayXd weights(NnodesPerBin);
+
+    switch (NnodesPerBin)
+    {
+        case 1:
+            abscissae << 0.0;
+            weights << 2.0;
+            break;
+        case 2:
+            abscissae << -0.5773502691896257, 0.5773502691896257;
+            weights << 1.0, 1.0;
+            break;
+        case 3:
+            abscissae << -0.7745966692414834, 0.0, 0.7745966692414834;
+            weights << 0.5555555555555556, 0.8888888888888888, 0.5555555555555556;
+            break;
+        case 4:
+            abscissae << -0.8611363115940526, -0.3399810435848563, 0.3399810435848563, 0.8611363115940526;
+            weights << 0.3478548451374538, 0.6521451548625461, 0.6521451548625461, 0.3478548451374538;
+            break;
+        case 5:
+            abscissae << -0.9061798459386640, -0.5384693101056831, 0.0, 0.5384693101056831, 0.9061798459386640;
+            weights << 0.2369268850561891, 0.4786286704993665, 0.5688888888888889, 0.4786286704993665, 0.2369268850561891;
+            break;
+        default:
+            cerr << "Number of quadrature nodes per bin has to be between 1 and 5." << endl;
+            exit(EXIT_FAILURE);
+    }
+
+
+    // Nodes are stored bin by bin, so that the nodes of each bin are contiguous in memory.
+    // Weights are normalized to return the average of the integrand over the bin.
+
+    int Nbins = covariates.size();
+    nodeCovariates.resize(Nbins*NnodesPerBin);
+    nodeWeights = weights / 2.0;
+
+    for (int bin = 0; bin < Nbins; ++bin)
+    {
+        nodeCovariates.segment(bin*NnodesPerBin, NnodesPerBin) = covariates(bin) + abscissae * binWidths(bin) / 2.0;
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// BinIntegratedModel::~BinIntegratedModel()
+//
+// PURPOSE: 
+//      Destructor.
+//
+
+BinIntegratedModel::~BinIntegratedModel()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// BinIntegratedModel::getNodeCovariates()
+//
+// PURPOSE:
+//      Gets the protected data member nodeCovariates.
+//
+// OUTPUT:
+//      An eigen array containing the frequencies of the quadrature nodes of all the bins.
+//
+
+ArrayXd BinIntegratedModel::getNodeCovariates()
+{
+    return nodeCovariates;
+}
+
+
+
+
+
+
+
+
+
+
+// BinIntegratedModel::setIntegrandModel()
+//
+// PURPOSE:
+//      Sets the model to be averaged over each bin.
+//
+// INPUT:
+//      newIntegrandModel:      a pointer to an object of class Model built on the node covariates.
+//
+// OUTPUT:
+//      void
+//
+
+void BinIntegratedModel::setIntegrandModel(Model *newIntegrandModel)
+{
+    integrandModel = newIntegrandModel;
+}
+
+
+
+
+
+
+
+
+
+
+// BinIntegratedModel::predict()
+//
+// PURPOSE:
+//      Builds the predictions of the integrand model averaged over the width of each bin.
+//
+// INPUT:
+//      predictions:        one-dimensional array to contain the predictions
+//                          from the model
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model
+//
+// OUTPUT:
+//      void
+//
+
+void BinIntegratedModel::predict(RefArrayXd predictions, RefArrayXd const modelParameters)
+{
+    // The predictions on the nodes are stored in the scratch arena of the calling thread
+
+    Eigen::Map<ArrayXd> nodePredictions = ScratchArena::getThreadArena().getDoubleBuffer(ScratchArena::integrationNodePredictions, 
+                                                                                          nodeCovariates.size());
+    nodePredictions.setZero();
+    integrandModel->predict(nodePredictions, modelParameters);
+
+    Eigen::Map<ArrayXXd> nodePredictionsPerBin(nodePredictions.data(), NnodesPerBin, covariates.size());
+    predictions = (nodePredictionsPerBin.colwise() * nodeWeights).colwise().sum().transpose();
+}
@@ -0,0 +1,94 @@
+#include "CountingLikelihood.h"
+
+
+ArrayXd CountingLikelihood::noObservations;
+
+
+// CountingLikelihood::CountingLikelihood()
+//
+// PURPOSE: 
+//      Constructor.
+//
+// INPUT:
+//      likelihood:         the likelihood whose evaluations are counted.
+//      model:              an object of class Model specifying the model of the wrapped likelihood.
+//
+
+CountingLikelihood::CountingLikelihood(Likelihood &likelihood, Model &model)
+: Likelihood(noObservations, model),
+  likelihood(likelihood),
+  Nevaluations(0)
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// CountingLikelihood::~CountingLikelihood()
+//
+// PURPOSE: 
+//      Destructor.
+//
+
+CountingLikelihood::~CountingLikelihood()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// CountingLikelihood::logValue()
+//
+// PURPOSE:
+//      Computes the natural logarithm of the wrapped likelihood, and counts the evaluation.
+//
+// INPUT:
+//      modelParameters:    one-dimensional array containing the free parameters of the model.
+//
+// OUTPUT:
+//      The natural logarithm of the likelihood.
+//
+
+double CountingLikelihood::logValue(RefArrayXd const modelParameters)
+{
+    ++Nevaluations;
+
+    return likelihood.logValue(modelParameters);
+}
+
+
+
+
+
+
+
+
+
+
+// CountingLikelihood::getNevaluations()
+//
+// PURPOSE:
+//      Gets the number of evaluations of the likelihood made so far.
+//
+// OUTPUT:
+//      The number of evaluations.
+//
+
+long CountingLikelihood::getNevaluations()
+{
+    return Nevaluations;
+}
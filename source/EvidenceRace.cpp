@@ -0,0 +1,399 @@
+#include "EvidenceRace.h"
+
+
+// EvidenceRace::EvidenceRace()
+//
+// PURPOSE:
+//      Constructor. Enters the run into the race board, which is created if it does not exist.
+//
+// INPUT:
+//      fileName:               a string containing the full path of the race board.
+//      runNumber:              the run number, which identifies the run on the race board.
+//      backgroundModelName:    the name of the background model of the run.
+//      margin:                 the margin in natural logarithm of the Bayes factor, by which the upper bound
+//                              of the log-evidence of a run must be below the lower bound of the leader
+//                              for the run to be dominated.
+//      maxRemainderRatio:      the largest ratio of the estimated remainder of the evidence to the evidence
+//                              accumulated so far, for which the run is tested for domination.
+//
+
+EvidenceRace::EvidenceRace(const string fileName, const string runNumber, const string backgroundModelName, const double margin,
+                           const double maxRemainderRatio)
+: fileName(fileName),
+  margin(margin),
+  maxRemainderRatio(maxRemainderRatio)
+{
+    ownEntry.runNumber = runNumber;
+    ownEntry.backgroundModelName = backgroundModelName;
+    ownEntry.status = "running";
+    ownEntry.lowerLogEvidence = -numeric_limits<double>::infinity();
+    ownEntry.upperLogEvidence = numeric_limits<double>::infinity();
+    ownEntry.Niterations = 0;
+    leader = ownEntry;
+
+    updateBoard();
+}
+
+
+
+
+
+
+
+
+
+
+// EvidenceRace::~EvidenceRace()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+EvidenceRace::~EvidenceRace()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// EvidenceRace::isDominated()
+//
+// PURPOSE:
+//      Posts the current bounds on the log-evidence of the run to the race board, and checks whether
+//      the run is dominated by the leader of the race, i.e. the other run with the largest lower bound.
+//      If so, the run is marked as aborted on the race board. Since the upper bound of the run is only
+//      reliable close to termination, the check is made only once the ratio of the remainder to the 
+//      accumulated evidence, namely exp(upper - lower) - 1, is below maxRemainderRatio. Before then, 
+//      a model that fits better but converges more slowly than the leader could be wrongly stopped.
+//
+// INPUT:
+//      lowerLogEvidence:       the lower bound of the log-evidence of the run.
+//      upperLogEvidence:       the upper bound of the log-evidence of the run.
+//      Niterations:            the number of nested iterations completed by the run.
+//
+// OUTPUT:
+//      True if the run is dominated and should be stopped, false otherwise.
+//
+
+bool EvidenceRace::isDominated(const double lowerLogEvidence, const double upperLogEvidence, const int Niterations)
+{
+    ownEntry.lowerLogEvidence = lowerLogEvidence;
+    ownEntry.upperLogEvidence = upperLogEvidence;
+    ownEntry.Niterations = Niterations;
+    updateBoard();
+
+    bool nearTermination = (upperLogEvidence - lowerLogEvidence <= log1p(maxRemainderRatio));
+
+    if (nearTermination && (leader.runNumber != ownEntry.runNumber) && (upperLogEvidence < leader.lowerLogEvidence - margin))
+    {
+        ownEntry.status = "aborted";
+        updateBoard();
+
+        return true;
+    }
+
+    return false;
+}
+
+
+
+
+
+
+
+
+
+
+// EvidenceRace::finish()
+//
+// PURPOSE:
+//      Posts the final log-evidence of the run to the race board, as both its lower and upper bound,
+//      unless the run was aborted.
+//
+// INPUT:
+//      logEvidence:        the final log-evidence of the run.
+//      Niterations:        the total number of nested iterations of the run.
+//      aborted:            true if the run was stopped because dominated, false if completed.
+//
+// OUTPUT:
+//      void
+//
+
+void EvidenceRace::finish(const double logEvidence, const int Niterations, const bool aborted)
+{
+    // The evidence of an aborted run is not that of a completed run, hence the bounds 
+    // posted when the run was found dominated are kept
+
+    if (!aborted)
+    {
+        ownEntry.status = "finished";
+        ownEntry.lowerLogEvidence = logEvidence;
+        ownEntry.upperLogEvidence = logEvidence;
+    }
+
+    ownEntry.Niterations = Niterations;
+    updateBoard();
+}
+
+
+
+
+
+
+
+
+
+
+// EvidenceRace::getMargin()
+//
+// PURPOSE:
+//      Gets the margin of the race, in natural logarithm of the Bayes factor.
+//
+// OUTPUT:
+//      The margin of the race.
+//
+
+double EvidenceRace::getMargin()
+{
+    return margin;
+}
+
+
+
+
+
+
+
+
+
+
+// EvidenceRace::getLeader()
+//
+// PURPOSE:
+//      Gets the leader of the race at the last update of the race board, namely the run other
+//      than this one with the largest lower bound of the log-evidence.
+//
+// OUTPUT:
+//      The entry of the race board of the leader, or that of this run if no other run has a finite lower bound.
+//
+
+EvidenceRace::Entry EvidenceRace::getLeader()
+{
+    return leader;
+}
+
+
+
+
+
+
+
+
+
+
+// EvidenceRace::readBoard()
+//
+// PURPOSE:
+//      Reads the entries of a race board.
+//
+// INPUT:
+//      fileName:       a string containing the full path of the race board.
+//
+// OUTPUT:
+//      A vector containing the entries of the race board, empty if the board does not exist.
+//
+
+vector<EvidenceRace::Entry> EvidenceRace::readBoard(const string fileName)
+{
+    int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+
+    if (fileDescriptor < 0)
+    {
+        return vector<Entry>();
+    }
+
+    flock(fileDescriptor, LOCK_SH);
+    string content = readContent(fileDescriptor);
+    flock(fileDescriptor, LOCK_UN);
+    close(fileDescriptor);
+
+    return parseBoard(content);
+}
+
+
+
+
+
+
+
+
+
+
+// EvidenceRace::updateBoard()
+//
+// PURPOSE:
+//      Replaces the entry of this run on the race board, and finds the leader among the other runs.
+//      The race board is locked for the whole update, so that the concurrent runs update it one at a time.
+//
+// OUTPUT:
+//      A vector containing the updated entries of the race board.
+//
+
+vector<EvidenceRace::Entry> EvidenceRace::updateBoard()
+{
+    int fileDescriptor = open(fileName.c_str(), O_RDWR | O_CREAT, 0666);
+
+    if (fileDescriptor < 0)
+    {
+        cerr << "Error opening the race board " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    flock(fileDescriptor, LOCK_EX);
+
+    vector<Entry> board = parseBoard(readContent(fileDescriptor));
+    bool entryFound = false;
+    leader = ownEntry;
+
+    for (size_t entry = 0; entry < board.size(); ++entry)
+    {
+        if (board[entry].runNumber == ownEntry.runNumber)
+        {
+            board[entry] = ownEntry;
+            entryFound = true;
+        }
+        else if ((leader.runNumber == ownEntry.runNumber) || (board[entry].lowerLogEvidence > leader.lowerLogEvidence))
+        {
+            leader = board[entry];
+        }
+    }
+
+    if (!entryFound)
+    {
+        board.push_back(ownEntry);
+    }
+
+    ostringstream output;
+    output << "# Evidence race. Runs are aborted when their upper bound is below the lower bound of the leader minus the margin." << endl;
+    output << "# Column #1: Run Number" << endl;
+    output << "# Column #2: Background model" << endl;
+    output << "# Column #3: Status (running / finished / aborted)" << endl;
+    output << "# Column #4: Lower bound of log(Evidence)" << endl;
+    output << "# Column #5: Upper bound of log(Evidence)" << endl;
+    output << "# Column #6: Number of nested iterations" << endl;
+    output << setprecision(12);
+
+    for (size_t entry = 0; entry < board.size(); ++entry)
+    {
+        output << board[entry].runNumber << "  " << board[entry].backgroundModelName << "  " << board[entry].status << "  "
+               << board[entry].lowerLogEvidence << "  " << board[entry].upperLogEvidence << "  " << board[entry].Niterations << endl;
+    }
+
+    string newContent = output.str();
+
+    if ((ftruncate(fileDescriptor, 0) != 0) || (pwrite(fileDescriptor, newContent.c_str(), newContent.size(), 0)
+                                                 != static_cast<ssize_t>(newContent.size())))
+    {
+        cerr << "Error writing the race board " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    flock(fileDescriptor, LOCK_UN);
+    close(fileDescriptor);
+
+    return board;
+}
+
+
+
+
+
+
+
+
+
+
+// EvidenceRace::parseBoard()
+//
+// PURPOSE:
+//      Parses the content of a race board, skipping the comment lines.
+//
+// INPUT:
+//      content:        a string containing the whole content of the race board.
+//
+// OUTPUT:
+//      A vector containing the entries of the race board.
+//
+
+vector<EvidenceRace::Entry> EvidenceRace::parseBoard(const string &content)
+{
+    vector<Entry> board;
+    istringstream input(content);
+    string line;
+
+    while (getline(input, line))
+    {
+        if (line.empty() || (line[0] == '#'))
+        {
+            continue;
+        }
+
+        istringstream fields(line);
+        string lowerLogEvidence, upperLogEvidence;
+        Entry entry;
+
+        if (fields >> entry.runNumber >> entry.backgroundModelName >> entry.status >> lowerLogEvidence
+                   >> upperLogEvidence >> entry.Niterations)
+        {
+            // The bounds are converted with stod, which also reads the infinite values
+
+            entry.lowerLogEvidence = stod(lowerLogEvidence);
+            entry.upperLogEvidence = stod(upperLogEvidence);
+            board.push_back(entry);
+        }
+    }
+
+    return board;
+}
+
+
+
+
+
+
+
+
+
+
+// EvidenceRace::readContent()
+//
+// PURPOSE:
+//      Reads the whole content of an open race board.
+//
+// INPUT:
+//      fileDescriptor:     the file descriptor of the race board, positioned at its beginning.
+//
+// OUTPUT:
+//      A string containing the content of the race board.
+//
+
+string EvidenceRace::readContent(const int fileDescriptor)
+{
+    string content;
+    char buffer[4096];
+    ssize_t Nbytes;
+
+    while ((Nbytes = read(fileDescriptor, buffer, sizeof(buffer))) > 0)
+    {
+        content.append(buffer, Nbytes);
+    }
+
+    return content;
+}
@@ -0,0 +1,566 @@
+#include "FidelityLadder.h"
+
+
+// FidelityLadder::FidelityLadder()
+//
+// PURPOSE:
+//      Constructor. Builds the rebinned dataset, the background model and the likelihood of each
+//      coarse level. The last level is the likelihood of the full dataset. The coarse levels are 
+//      evaluated in the same precision of the full dataset, so that all the levels share the same likelihood.
+//
+// INPUT:
+//      backgroundModelName:    a string containing the name of the background model.
+//      covariates:             one-dimensional array containing the frequencies of the full dataset.
+//      observations:           one-dimensional array containing the power spectral density of the full dataset.
+//      NyquistFrequency:       the Nyquist frequency of the dataset, in muHz.
+//      Nlevels:                the number of levels, including the full dataset.
+//      rebinningFactor:        the factor between the rebinning factors of two consecutive levels,
+//                              so that the coarsest level is rebinned by rebinningFactor^(Nlevels - 1).
+//      singlePrecision:        true if the likelihood of the full dataset is evaluated in single precision
+//                              (see SinglePrecisionLikelihood.h), false if in double precision.
+//      likelihood:             the likelihood of the full dataset.
+//      model:                  the background model of the full dataset.
+//
+
+FidelityLadder::FidelityLadder(const string backgroundModelName, const ConstRefArrayXd covariates, const ConstRefArrayXd observations, 
+                               const double NyquistFrequency, const int Nlevels, const int rebinningFactor, 
+                               const bool singlePrecision, Likelihood &likelihood, Model &model)
+: rebinningFactorPerLevel(rebinningFactor),
+  refined(false),
+  logEvidence(0.0),
+  logEvidenceError(0.0),
+  informationGain(0.0)
+{
+    levelLikelihoods.reserve(Nlevels);
+    singlePrecisionLevelLikelihoods.reserve(Nlevels);
+    countingLikelihoods.reserve(Nlevels);
+    int levelRebinningFactor = static_cast<int>(pow(rebinningFactor, Nlevels - 1));
+
+    for (int level = 0; level < Nlevels - 1; ++level)
+    {
+        SpectrumRebinner rebinner(covariates, observations);
+        rebinner.rebinByFactor(levelRebinningFactor);
+        ArrayXd levelCovariates = rebinner.getCovariates();
+        ArrayXd levelObservations = rebinner.getObservations();
+        ArrayXd levelBinWeights = rebinner.getBinWeights();
+
+        BackgroundModel *levelModel = BackgroundModelRegistry::createModel(backgroundModelName, levelCovariates, "");
+        levelModel->setNyquistFrequency(NyquistFrequency);
+        levelModels.push_back(levelModel);
+
+        if (singlePrecision)
+        {
+            levelModel->activateSinglePrecision();
+            singlePrecisionLevelLikelihoods.emplace_back(levelObservations, levelBinWeights, *levelModel);
+            countingLikelihoods.emplace_back(singlePrecisionLevelLikelihoods.back(), *levelModel);
+        }
+        else
+        {
+            levelLikelihoods.emplace_back(levelObservations, levelBinWeights, *levelModel);
+            countingLikelihoods.emplace_back(levelLikelihoods.back(), *levelModel);
+        }
+
+        rebinningFactors.push_back(levelRebinningFactor);
+        Nbins.push_back(rebinner.getNbins());
+
+        levelRebinningFactor /= rebinningFactor;
+    }
+
+    countingLikelihoods.emplace_back(likelihood, model);
+    rebinningFactors.push_back(1);
+    Nbins.push_back(observations.size());
+}
+
+
+
+
+
+
+
+
+
+
+// FidelityLadder::~FidelityLadder()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+FidelityLadder::~FidelityLadder()
+{
+    countingLikelihoods.clear();
+    levelLikelihoods.clear();
+    singlePrecisionLevelLikelihoods.clear();
+
+    for (size_t level = 0; level < levelModels.size(); ++level)
+    {
+        delete levelModels[level];
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// FidelityLadder::getCoarsestLikelihood()
+//
+// PURPOSE:
+//      Gets the likelihood of the coarsest level, which is used by the nested sampling.
+//
+// OUTPUT:
+//      A reference to the likelihood of the coarsest level.
+//
+
+Likelihood &FidelityLadder::getCoarsestLikelihood()
+{
+    return countingLikelihoods[0];
+}
+
+
+
+
+
+
+
+
+
+
+// FidelityLadder::getFullLikelihood()
+//
+// PURPOSE:
+//      Gets the likelihood of the full dataset, whose evaluations are counted as for the other levels.
+//
+// OUTPUT:
+//      A reference to the likelihood of the full dataset.
+//
+
+Likelihood &FidelityLadder::getFullLikelihood()
+{
+    return countingLikelihoods.back();
+}
+
+
+
+
+
+
+
+
+
+
+// FidelityLadder::refine()
+//
+// PURPOSE:
+//      Refines the results of the nested sampling on the coarsest level up to the full dataset, by tempering
+//      the posterior sample from the likelihood of each level to that of the next one.
+//
+// INPUT:
+//      ptrPriors:                          vector of pointers to the uniform priors of the run.
+//      posteriorSample:                    two-dimensional array of size (Ndimensions, Nsamples) containing the
+//                                          posterior sample of the coarsest level.
+//      logLikelihoodOfPosteriorSample:     one-dimensional array containing the log-likelihood of the coarsest
+//                                          level of each sampling point.
+//      logWeightOfPosteriorSample:         one-dimensional array containing the log-weight of each sampling point.
+//      logEvidence:                        the natural logarithm of the evidence of the coarsest level.
+//      logEvidenceError:                   the error on the log-evidence of the coarsest level.
+//      informationGain:                    the information gain of the coarsest level.
+//      Nparticles:                         the number of particles of the tempering.
+//      NmovesPerStep:                      the number of Metropolis steps of each particle after each resampling.
+//      maxNsteps:                          the maximum number of tempering steps of each level.
+//
+// OUTPUT:
+//      True if the full dataset is reached, false otherwise (see getFailureReason()).
+//
+
+bool FidelityLadder::refine(vector<Prior*> ptrPriors, const ArrayXXd &posteriorSample, const ArrayXd &logLikelihoodOfPosteriorSample,
+                            const ArrayXd &logWeightOfPosteriorSample, const double logEvidence, const double logEvidenceError, 
+                            const double informationGain, const int Nparticles, const int NmovesPerStep, const int maxNsteps)
+{
+    PreviousRun levelRun(ptrPriors, posteriorSample, logLikelihoodOfPosteriorSample, logWeightOfPosteriorSample, 
+                         logEvidence, logEvidenceError, informationGain);
+    NtemperingSteps.assign(1, 0);
+    levelLogEvidences.assign(1, logEvidence);
+
+    for (size_t level = 1; level < countingLikelihoods.size(); ++level)
+    {
+        TemperedRefitter temperedRefitter(levelRun, ptrPriors, countingLikelihoods[level - 1], countingLikelihoods[level]);
+
+        if (!temperedRefitter.refit(Nparticles, NmovesPerStep, maxNsteps))
+        {
+            failureReason = temperedRefitter.getFailureReason();
+            return false;
+        }
+
+        NtemperingSteps.push_back(temperedRefitter.getNsteps());
+        levelLogEvidences.push_back(temperedRefitter.getLogEvidence());
+        levelRun = PreviousRun(ptrPriors, temperedRefitter.getPosteriorSample(), temperedRefitter.getLogLikelihoodOfPosteriorSample(),
+                               temperedRefitter.getLogWeightOfPosteriorSample(), temperedRefitter.getLogEvidence(), 
+                               temperedRefitter.getLogEvidenceError(), temperedRefitter.getInformationGain());
+    }
+
+    this->posteriorSample = levelRun.getPosteriorSample();
+    this->logLikelihoodOfPosteriorSample = levelRun.getLogLikelihoodOfPosteriorSample();
+    this->logWeightOfPosteriorSample = levelRun.getLogWeightOfPosteriorSample();
+    this->logEvidence = levelRun.getLogEvidence();
+    this->logEvidenceError = levelRun.getLogEvidenceError();
+    this->informationGain = levelRun.getInformationGain();
+    refined = true;
+
+    return true;
+}
+
+
+
+
+
+
+
+
+
+
+// FidelityLadder::refine()
+//
+// PURPOSE:
+//      Refines the results of the nested sampling on the coarsest level up to the full dataset, as above, 
+//      taking them from the nested sampler of the run. If the full dataset is reached, the results of the 
+//      full dataset are set into the nested sampler, so that they are written in its output files.
+//
+// INPUT:
+//      nestedSampler:      the nested sampler of the run, which has sampled the coarsest level.
+//      ptrPriors:          vector of pointers to the uniform priors of the run.
+//      Nparticles:         the number of particles of the tempering.
+//      NmovesPerStep:      the number of Metropolis steps of each particle after each resampling.
+//      maxNsteps:          the maximum number of tempering steps of each level.
+//
+// OUTPUT:
+//      True if the full dataset is reached, false if a nested sampling on the full dataset is needed instead.
+//
+
+bool FidelityLadder::refine(NestedSampler &nestedSampler, vector<Prior*> ptrPriors, const int Nparticles, 
+                            const int NmovesPerStep, const int maxNsteps)
+{
+    if (!refine(ptrPriors, nestedSampler.getPosteriorSample(), nestedSampler.getLogLikelihoodOfPosteriorSample(),
+                nestedSampler.getLogWeightOfPosteriorSample(), nestedSampler.getLogEvidence(), 
+                nestedSampler.getLogEvidenceError(), nestedSampler.getInformationGain(), Nparticles, NmovesPerStep, maxNsteps))
+    {
+        cout << " Multi-fidelity refinement failed, since " << failureReason 
+             << ": a nested sampling on the full dataset is performed." << endl;
+
+        return false;
+    }
+
+    ResultsWriter::setResults(nestedSampler, posteriorSample, logLikelihoodOfPosteriorSample, logWeightOfPosteriorSample, 
+                              logEvidence, logEvidenceError, informationGain);
+
+    cout << " Multi-fidelity schedule: log(Evidence) = " << setprecision(10) << logEvidence 
+         << " with " << getNbinEvaluations() << " bin evaluations" << endl;
+
+    return true;
+}
+
+
+
+
+
+
+
+
+
+
+// FidelityLadder::getPosteriorSample()
+//
+// PURPOSE:
+//      Gets the posterior sample of the full dataset.
+//
+// OUTPUT:
+//      A two-dimensional array of size (Ndimensions, Nparticles) containing the posterior sample.
+//
+
+ArrayXXd FidelityLadder::getPosteriorSample()
+{
+    return posteriorSample;
+}
+
+
+
+
+
+
+
+
+
+
+// FidelityLadder::getLogLikelihoodOfPosteriorSample()
+//
+// PURPOSE:
+//      Gets the log-likelihood of the full dataset for the posterior sample.
+//
+// OUTPUT:
+//      A one-dimensional array containing the log-likelihood of each sampling point.
+//
+
+ArrayXd FidelityLadder::getLogLikelihoodOfPosteriorSample()
+{
+    return logLikelihoodOfPosteriorSample;
+}
+
+
+
+
+
+
+
+
+
+
+// FidelityLadder::getLogWeightOfPosteriorSample()
+//
+// PURPOSE:
+//      Gets the log-weights of the posterior sample of the full dataset.
+//
+// OUTPUT:
+//      A one-dimensional array containing the log-weight of each sampling point.
+//
+
+ArrayXd FidelityLadder::getLogWeightOfPosteriorSample()
+{
+    return logWeightOfPosteriorSample;
+}
+
+
+
+
+
+
+
+
+
+
+// FidelityLadder::getLogEvidence()
+//
+// PURPOSE:
+//      Gets the natural logarithm of the evidence of the full dataset.
+//
+// OUTPUT:
+//      The log-evidence.
+//
+
+double FidelityLadder::getLogEvidence()
+{
+    return logEvidence;
+}
+
+
+
+
+
+
+
+
+
+
+// FidelityLadder::getLogEvidenceError()
+//
+// PURPOSE:
+//      Gets the error on the natural logarithm of the evidence of the full dataset, combining that
+//      of the nested sampling with those of all the tempering steps.
+//
+// OUTPUT:
+//      The error on the log-evidence.
+//
+
+double FidelityLadder::getLogEvidenceError()
+{
+    return logEvidenceError;
+}
+
+
+
+
+
+
+
+
+
+
+// FidelityLadder::getInformationGain()
+//
+// PURPOSE:
+//      Gets the information gain of the posterior of the full dataset relative to the priors.
+//
+// OUTPUT:
+//      The information gain in natural units.
+//
+
+double FidelityLadder::getInformationGain()
+{
+    return informationGain;
+}
+
+
+
+
+
+
+
+
+
+
+// FidelityLadder::getFailureReason()
+//
+// PURPOSE:
+//      Gets the reason why the full dataset could not be reached.
+//
+// OUTPUT:
+//      A string describing the reason, empty if the refinement was completed.
+//
+
+string FidelityLadder::getFailureReason()
+{
+    return failureReason;
+}
+
+
+
+
+
+
+
+
+
+
+// FidelityLadder::getNlevels()
+//
+// PURPOSE:
+//      Gets the number of levels, including the full dataset.
+//
+// OUTPUT:
+//      The number of levels.
+//
+
+int FidelityLadder::getNlevels()
+{
+    return countingLikelihoods.size();
+}
+
+
+
+
+
+
+
+
+
+
+// FidelityLadder::getNbinEvaluations()
+//
+// PURPOSE:
+//      Gets the total number of bins over which the likelihood of any level has been evaluated so far,
+//      which measures the cost of the run independently of the rebinning.
+//
+// OUTPUT:
+//      The number of bin evaluations.
+//
+
+long FidelityLadder::getNbinEvaluations()
+{
+    long NbinEvaluations = 0;
+
+    for (size_t level = 0; level < countingLikelihoods.size(); ++level)
+    {
+        NbinEvaluations += countingLikelihoods[level].getNevaluations() * Nbins[level];
+    }
+
+    return NbinEvaluations;
+}
+
+
+
+
+
+
+
+
+
+
+// FidelityLadder::writeToFile()
+//
+// PURPOSE:
+//      Writes the cost and the evidence of each level into an ASCII file, one row for each level
+//      from the coarsest one to the full dataset.
+//
+// INPUT:
+//      fileName:       a string containing the full path of the output file.
+//
+// OUTPUT:
+//      void
+//
+
+void FidelityLadder::writeToFile(const string fileName)
+{
+    ofstream outputFile;
+    File::openOutputFile(outputFile, fileName);
+
+    outputFile << "# Multi-fidelity schedule of the likelihood, from the coarsest level to the full dataset" << endl;
+    outputFile << "# Column #1: Rebinning factor" << endl;
+    outputFile << "# Column #2: Number of bins" << endl;
+    outputFile << "# Column #3: Number of likelihood evaluations" << endl;
+    outputFile << "# Column #4: Number of tempering steps from the previous level (0 for the nested sampling level)" << endl;
+    outputFile << "# Column #5: log(Evidence) of the level" << endl;
+
+    for (size_t level = 0; level < countingLikelihoods.size(); ++level)
+    {
+        outputFile << rebinningFactors[level] << "  " << Nbins[level] << "  " << countingLikelihoods[level].getNevaluations() << "  ";
+
+        if (level < levelLogEvidences.size())
+        {
+            outputFile << NtemperingSteps[level] << "  " << setprecision(12) << levelLogEvidences[level] << endl;
+        }
+        else
+        {
+            outputFile << "0  nan" << endl;
+        }
+    }
+
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+// FidelityLadder::writeScheduleInformation()
+//
+// PURPOSE:
+//      Writes the settings and the outcome of the schedule in the file of computation parameters of the run.
+//      It is called after the refinement, or after the nested sampling on the full dataset that replaces it.
+//
+// INPUT:
+//      outputFile:     the open file of computation parameters of the run.
+//
+// OUTPUT:
+//      void
+//
+
+void FidelityLadder::writeScheduleInformation(ofstream &outputFile)
+{
+    outputFile << "# Multi-fidelity schedule" << endl;
+    outputFile << "# Row #1: Number of levels" << endl;
+    outputFile << "# Row #2: Factor between the rebinning factors of two consecutive levels" << endl;
+    outputFile << "# Row #3: Outcome (refined / full run)" << endl;
+    outputFile << "# Row #4: Number of bin evaluations of the likelihood" << endl;
+    outputFile << getNlevels() << endl;
+    outputFile << rebinningFactorPerLevel << endl;
+    outputFile << (refined ? "refined" : "full run") << endl;
+    outputFile << getNbinEvaluations() << endl;
+}
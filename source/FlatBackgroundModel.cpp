@@ -23,8 +23,12 @@ FlatBackgroundModel::FlatBackgroundModel(const RefArrayXd covariates, const stri
 
     readNyquistFrequencyFromFile(inputNyquistFrequencyFileName);
 
-    ArrayXd sincFunctionArgument = (Functions::PI / 2.0) * covariates / NyquistFrequency;
-    responseFunction = (sincFunctionArgument.sin() / sincFunctionArgument).square();
+    updateResponseFunction();
+
+    // Additive components of the model, each one scaled by one of the free parameters
+
+    addComponent("flatNoise", 0);
+    addComponent("envelope", 1);
 }
 
 
@@ -63,6 +67,9 @@ FlatBackgroundModel::~FlatBackgroundModel()
 //      The model consists of one constant component, two Harvey-like profiles
 //      and a Gaussian for modeling the oscillation envelope.
 //
+//      The model is evaluated either on the stored covariates or on the implicit
+//      uniform frequency grid, if the latter has been activated.
+//
 // INPUT:
 //      predictions:        one-dimensional array to contain the predictions
 //                          from the model
@@ -82,26 +89,127 @@ FlatBackgroundModel::~FlatBackgroundModel()
 
 void FlatBackgroundModel::predict(RefArrayXd predictions, RefArrayXd const modelParameters)
 {
-    // Initialize global parameters
+    if (uniformGrid && !singlePrecision)
+    {
+        predictOnFrequencies(predictions, gridCovariates(), responseFunction, modelParameters);
+    }
+    else if (uniformGrid)
+    {
+        predictOnFrequencies(predictions, gridCovariates(), compressedResponseFunction.cast<double>(), modelParameters);
+    }
+    else if (singlePrecision)
+    {
+        predictOnFrequencies(predictions, singlePrecisionCovariates.cast<double>(), compressedResponseFunction.cast<double>(), modelParameters);
+    }
+    else
+    {
+        predictOnFrequencies(predictions, covariates, responseFunction, modelParameters);
+    }
+}
+
+
+
 
-    double flatNoiseLevel = modelParameters(0);
-    double heightOscillation = modelParameters(1);
-    double nuMax = modelParameters(2);
-    double sigma = modelParameters(3);
 
 
-    // Compute Gaussian envelope for RGB Oscillations and add it to the predictions
 
-    predictions += heightOscillation * exp(-1.0*(nuMax - covariates)*(nuMax - covariates)/(2.0 * sigma * sigma));
 
-    
-    // Modulate the model by the response function (apodization)
-    
-    predictions *= responseFunction;           
 
 
-    // Add flat noise level component
 
-    predictions += flatNoiseLevel;
+// FlatBackgroundModel::predictSinglePrecision()
+//
+// PURPOSE:
+//      Builds the predictions of the model in single precision, by using the
+//      single-precision frequencies and response function.
+//
+// INPUT:
+//      predictions:        one-dimensional single-precision array to contain the 
+//                          predictions from the model
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model
+//
+// OUTPUT:
+//      void
+//
+// NOTE:
+//      The free parameters are to be given in the same order of predict().
+//
+
+void FlatBackgroundModel::predictSinglePrecision(RefArrayXf predictions, RefArrayXd const modelParameters)
+{
+    if (uniformGrid && !singlePrecision)
+    {
+        predictOnFrequencies(predictions, singlePrecisionGridCovariates(), responseFunction.cast<float>(), modelParameters);
+    }
+    else if (uniformGrid)
+    {
+        predictOnFrequencies(predictions, singlePrecisionGridCovariates(), compressedResponseFunction, modelParameters);
+    }
+    else if (singlePrecision)
+    {
+        predictOnFrequencies(predictions, singlePrecisionCovariates, compressedResponseFunction, modelParameters);
+    }
+    else
+    {
+        predictOnFrequencies(predictions, covariates.cast<float>(), responseFunction.cast<float>(), modelParameters);
+    }
 }
 
+
+
+
+
+
+
+
+
+
+// FlatBackgroundModel::predictOnFrequencies()
+//
+// PURPOSE:
+//      Computes the predictions of the model for a given array of frequencies and
+//      response function, which can be either stored arrays or Eigen expressions
+//      generated on the fly.
+//
+// INPUT:
+//      predictions:        one-dimensional array, in either double or single precision,
+//                          to contain the predictions from the model
+//      frequencies:        one-dimensional array expression containing the 
+//                          frequency of each bin
+//      response:           one-dimensional array expression containing the 
+//                          response function of each bin
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model
+//
+// OUTPUT:
+//      void
+//
+// NOTE:
+//      The free parameters are to be given in the same order of predict().
+//
+
+template <typename PredictionArray, typename FrequencyArray, typename ResponseArray>
+void FlatBackgroundModel::predictOnFrequencies(PredictionArray predictions, const Eigen::ArrayBase<FrequencyArray> &frequencies, 
+                                               const Eigen::ArrayBase<ResponseArray> &response, RefArrayXd const modelParameters)
+{
+    // Initialize global parameters in the same precision of the predictions
+
+    typedef typename PredictionArray::Scalar Scalar;
+    Scalar flatNoiseLevel = modelParameters(0);
+    Scalar heightOscillation = modelParameters(1);
+    Scalar nuMax = modelParameters(2);
+    Scalar sigma = modelParameters(3);
+
+
+    // Compute the Gaussian envelope for the oscillations, modulate them by the response function
+    // (apodization) and add the flat noise component. The Gaussian envelope is first computed
+    // with the vectorized exponential, by using the predictions as temporary storage, then all
+    // the components are combined in a single expression.
+
+    predictions = -1.0*(nuMax - frequencies)*(nuMax - frequencies)/(2.0 * sigma * sigma);
+    VectorKernels::exponential(predictions.data(), predictions.size());
+
+    predictions = (heightOscillation * predictions) * response
+                  + flatNoiseLevel;
+}
@@ -23,8 +23,11 @@ FlatNoGaussianBackgroundModel::FlatNoGaussianBackgroundModel(const RefArrayXd co
 
     readNyquistFrequencyFromFile(inputNyquistFrequencyFileName);
 
-    ArrayXd sincFunctionArgument = (Functions::PI / 2.0) * covariates / NyquistFrequency;
-    responseFunction = (sincFunctionArgument.sin() / sincFunctionArgument).square();
+    updateResponseFunction();
+
+    // Additive components of the model, each one scaled by one of the free parameters
+
+    addComponent("flatNoise", 0);
 }
 
 
@@ -62,6 +65,9 @@ FlatNoGaussianBackgroundModel::~FlatNoGaussianBackgroundModel()
 //      Builds the predictions from a background model for solar-like and giant stars.
 //      The model consists of one constant component without the Gaussian envelope.
 //
+//      The model is evaluated either on the stored covariates or on the implicit
+//      uniform frequency grid, if the latter has been activated.
+//
 // INPUT:
 //      predictions:        one-dimensional array to contain the predictions
 //                          from the model
@@ -78,13 +84,117 @@ FlatNoGaussianBackgroundModel::~FlatNoGaussianBackgroundModel()
 
 void FlatNoGaussianBackgroundModel::predict(RefArrayXd predictions, RefArrayXd const modelParameters)
 {
-    // Initialize global parameters
+    if (uniformGrid && !singlePrecision)
+    {
+        predictOnFrequencies(predictions, gridCovariates(), responseFunction, modelParameters);
+    }
+    else if (uniformGrid)
+    {
+        predictOnFrequencies(predictions, gridCovariates(), compressedResponseFunction.cast<double>(), modelParameters);
+    }
+    else if (singlePrecision)
+    {
+        predictOnFrequencies(predictions, singlePrecisionCovariates.cast<double>(), compressedResponseFunction.cast<double>(), modelParameters);
+    }
+    else
+    {
+        predictOnFrequencies(predictions, covariates, responseFunction, modelParameters);
+    }
+}
+
+
+
 
-    double flatNoiseLevel = modelParameters(0);
 
 
-    // Add flat noise level component
 
-    predictions += flatNoiseLevel;
+
+
+
+
+// FlatNoGaussianBackgroundModel::predictSinglePrecision()
+//
+// PURPOSE:
+//      Builds the predictions of the model in single precision, by using the
+//      single-precision frequencies and response function.
+//
+// INPUT:
+//      predictions:        one-dimensional single-precision array to contain the 
+//                          predictions from the model
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model
+//
+// OUTPUT:
+//      void
+//
+// NOTE:
+//      The free parameters are to be given in the same order of predict().
+//
+
+void FlatNoGaussianBackgroundModel::predictSinglePrecision(RefArrayXf predictions, RefArrayXd const modelParameters)
+{
+    if (uniformGrid && !singlePrecision)
+    {
+        predictOnFrequencies(predictions, singlePrecisionGridCovariates(), responseFunction.cast<float>(), modelParameters);
+    }
+    else if (uniformGrid)
+    {
+        predictOnFrequencies(predictions, singlePrecisionGridCovariates(), compressedResponseFunction, modelParameters);
+    }
+    else if (singlePrecision)
+    {
+        predictOnFrequencies(predictions, singlePrecisionCovariates, compressedResponseFunction, modelParameters);
+    }
+    else
+    {
+        predictOnFrequencies(predictions, covariates.cast<float>(), responseFunction.cast<float>(), modelParameters);
+    }
 }
 
+
+
+
+
+
+
+
+
+
+// FlatNoGaussianBackgroundModel::predictOnFrequencies()
+//
+// PURPOSE:
+//      Computes the predictions of the model for a given array of frequencies and
+//      response function, which can be either stored arrays or Eigen expressions
+//      generated on the fly.
+//
+// INPUT:
+//      predictions:        one-dimensional array, in either double or single precision,
+//                          to contain the predictions from the model
+//      frequencies:        one-dimensional array expression containing the 
+//                          frequency of each bin
+//      response:           one-dimensional array expression containing the 
+//                          response function of each bin
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model
+//
+// OUTPUT:
+//      void
+//
+// NOTE:
+//      The free parameters are to be given in the same order of predict().
+//
+
+template <typename PredictionArray, typename FrequencyArray, typename ResponseArray>
+void FlatNoGaussianBackgroundModel::predictOnFrequencies(PredictionArray predictions, const Eigen::ArrayBase<FrequencyArray> &frequencies, 
+                                                         const Eigen::ArrayBase<ResponseArray> &response, RefArrayXd const modelParameters)
+{
+    // Initialize global parameters in the same precision of the predictions
+
+    typedef typename PredictionArray::Scalar Scalar;
+    Scalar flatNoiseLevel = modelParameters(0);
+
+
+    // Set the flat noise component
+
+    predictions.setConstant(flatNoiseLevel);
+}
@@ -0,0 +1,128 @@
+#include "GammaLikelihood.h"
+
+
+// GammaLikelihood::GammaLikelihood()
+//
+// PURPOSE: 
+//      Constructor. Computes the terms of the log-likelihood that only depend on the data.
+//
+// INPUT:
+//      observations:       one-dimensional array containing the averaged power spectral density
+//                          of each rebinned bin.
+//      binWeights:         one-dimensional array containing the number of original bins M
+//                          averaged into each rebinned bin. If empty, M = 1 for all the bins,
+//                          which corresponds to the ExponentialLikelihood.
+//      model:              an object of class Model specifying the model to be adopted
+//                          in the likelihood computation.
+//
+
+GammaLikelihood::GammaLikelihood(const RefArrayXd observations, const RefArrayXd binWeights, Model &model)
+: Likelihood(observations, model),
+  binWeights(binWeights)
+{
+    weightsAreUnity = (binWeights.size() == 0);
+
+    if (!weightsAreUnity && (binWeights.size() != observations.size()))
+    {
+        cerr << "Number of bin weights does not match the number of observations." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // The Gamma distribution of shape M and scale m/M is
+    // p(x) = M^M / Gamma(M) * x^(M-1) / m^M * exp(-M*x/m),
+    // so that the part independent of the model m can be computed only once.
+
+    logNormalizationConstant = 0.0;
+
+    for (int bin = 0; bin < binWeights.size(); ++bin)
+    {
+        double M = binWeights(bin);
+        logNormalizationConstant += M*log(M) - lgamma(M) + (M - 1.0)*log(observations(bin));
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// GammaLikelihood::~GammaLikelihood()
+//
+// PURPOSE: 
+//      Destructor.
+//
+
+GammaLikelihood::~GammaLikelihood()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// GammaLikelihood::getBinWeights()
+//
+// PURPOSE:
+//      Gets the protected data member binWeights.
+//
+// OUTPUT:
+//      An eigen array containing the number of original bins averaged into each rebinned bin.
+//
+
+ArrayXd GammaLikelihood::getBinWeights()
+{
+    return binWeights;
+}
+
+
+
+
+
+
+
+
+
+
+// GammaLikelihood::logValue()
+//
+// PURPOSE:
+//      Computes the natural logarithm of the Gamma likelihood for a given set of observations
+//      averaged over a number of bins M and a given set of model parameters.
+//
+// INPUT:
+//      modelParameters:    one-dimensional array containing the values of the free parameters of the model.
+//
+// OUTPUT:
+//      A double containing the natural logarithm of the likelihood.
+//
+
+double GammaLikelihood::logValue(RefArrayXd const modelParameters)
+{
+    // The predictions are stored in the scratch arena of the calling thread, so that 
+    // no heap allocation is made within the evaluation
+
+    unsigned long Nobservations = observations.size();
+    Eigen::Map<ArrayXd> predictions = ScratchArena::getThreadArena().getDoubleBuffer(ScratchArena::likelihoodPredictions, Nobservations);
+    AllocationGuard allocationGuard("GammaLikelihood::logValue()");
+
+    predictions.setZero();
+    model.predict(predictions, modelParameters);
+    
+
+    // Sum the terms M*(P/m + ln m) with the vectorized kernels
+
+    const double *weights = weightsAreUnity ? 0 : binWeights.data();
+    double sum = VectorKernels::sumLogLikelihoodTerms(observations.data(), predictions.data(), weights, Nobservations);
+
+    return logNormalizationConstant - sum;
+}
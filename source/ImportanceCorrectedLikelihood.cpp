@@ -0,0 +1,144 @@
+#include "ImportanceCorrectedLikelihood.h"
+
+
+ArrayXd ImportanceCorrectedLikelihood::noObservations;
+
+
+// ImportanceCorrectedLikelihood::ImportanceCorrectedLikelihood()
+//
+// PURPOSE: 
+//      Constructor.
+//
+// INPUT:
+//      likelihood:         the likelihood of the background model, which holds the observations.
+//      warmStartPrior:     the warm-start prior used by the sampler.
+//      model:              an object of class Model specifying the background model.
+//
+
+ImportanceCorrectedLikelihood::ImportanceCorrectedLikelihood(Likelihood &likelihood, WarmStartPrior &warmStartPrior, Model &model)
+: Likelihood(noObservations, model),
+  likelihood(likelihood),
+  warmStartPrior(warmStartPrior)
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// ImportanceCorrectedLikelihood::~ImportanceCorrectedLikelihood()
+//
+// PURPOSE: 
+//      Destructor.
+//
+
+ImportanceCorrectedLikelihood::~ImportanceCorrectedLikelihood()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// ImportanceCorrectedLikelihood::logValue()
+//
+// PURPOSE:
+//      Computes the log-likelihood of the background model, corrected by the natural logarithm
+//      of the ratio of the original prior to the warm-start prior.
+//
+// INPUT:
+//      modelParameters:    one-dimensional array containing the free parameters of the model.
+//
+// OUTPUT:
+//      The corrected natural logarithm of the likelihood.
+//
+
+double ImportanceCorrectedLikelihood::logValue(RefArrayXd const modelParameters)
+{
+    return likelihood.logValue(modelParameters) + warmStartPrior.logDensityRatio(modelParameters);
+}
+
+
+
+
+
+
+
+
+
+
+// ImportanceCorrectedLikelihood::removeCorrection()
+//
+// PURPOSE:
+//      Removes the correction from the log-likelihood of a sample of points, so that the
+//      log-likelihood of the posterior sample is that of the background model.
+//
+// INPUT:
+//      sample:                     two-dimensional array of size (Ndimensions, Npoints) containing the sample.
+//      logLikelihoodOfSample:      one-dimensional array containing the corrected log-likelihood of each point.
+//
+// OUTPUT:
+//      A one-dimensional array containing the log-likelihood of the background model of each point.
+//
+
+ArrayXd ImportanceCorrectedLikelihood::removeCorrection(const ArrayXXd &sample, const ArrayXd &logLikelihoodOfSample)
+{
+    ArrayXd logLikelihoodOfModel(logLikelihoodOfSample.size());
+
+    for (int point = 0; point < sample.cols(); ++point)
+    {
+        ArrayXd parameters = sample.col(point);
+        logLikelihoodOfModel(point) = logLikelihoodOfSample(point) - warmStartPrior.logDensityRatio(parameters);
+    }
+
+    return logLikelihoodOfModel;
+}
+
+
+
+
+
+
+
+
+
+
+// ImportanceCorrectedLikelihood::correctResults()
+//
+// PURPOSE:
+//      Corrects the results of a nested sampling run made with the corrected likelihood and the 
+//      warm-start prior. The corrected log-likelihood of the posterior sample is replaced with that of 
+//      the background model, and the information gain is expressed relative to the original prior instead 
+//      of the warm-start prior, by subtracting the posterior mean of the log-ratio of the original to the 
+//      warm-start prior. The evidence and the weights of the posterior sample need no correction.
+//
+// INPUT:
+//      nestedSampler:      the nested sampler, whose results are corrected.
+//
+// OUTPUT:
+//      void
+//
+
+void ImportanceCorrectedLikelihood::correctResults(NestedSampler &nestedSampler)
+{
+    ArrayXd correctedLogLikelihood = nestedSampler.getLogLikelihoodOfPosteriorSample();
+    ArrayXd logLikelihoodOfPosteriorSample = removeCorrection(nestedSampler.getPosteriorSample(), correctedLogLikelihood);
+    ArrayXd posteriorProbability = (nestedSampler.getLogWeightOfPosteriorSample() - nestedSampler.getLogEvidence()).exp();
+    double meanLogDensityRatio = (posteriorProbability*(correctedLogLikelihood - logLikelihoodOfPosteriorSample)).sum() 
+                                 / posteriorProbability.sum();
+
+    nestedSampler.setLogLikelihoodOfPosteriorSample(logLikelihoodOfPosteriorSample);
+    nestedSampler.setInformationGain(nestedSampler.getInformationGain() - meanLogDensityRatio);
+}
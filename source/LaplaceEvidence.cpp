@@ -0,0 +1,865 @@
+#include "LaplaceEvidence.h"
+
+
+// LaplaceEvidence::LaplaceEvidence()
+//
+// PURPOSE:
+//      Constructor.
+//
+// INPUT:
+//      ptrPriors:      vector of pointers to the prior distributions of the free parameters,
+//                      in the same order used by the nested sampler.
+//      likelihood:     the likelihood function of the dataset, for the model to be evaluated.
+//
+
+LaplaceEvidence::LaplaceEvidence(vector<Prior*> ptrPriors, Likelihood &likelihood)
+: ptrPriors(ptrPriors),
+  likelihood(likelihood),
+  Nevaluations(0),
+  NimportanceDraws(0),
+  logEvidence(0.0),
+  logEvidenceError(0.0),
+  importanceLogEvidence(0.0),
+  hessianConditionNumber(1.0),
+  informationGain(0.0),
+  logMaxLikelihood(0.0),
+  maximumOnBoundary(false),
+  normal(0.0, 1.0)
+{
+    Ndimensions = 0;
+
+    for (size_t prior = 0; prior < ptrPriors.size(); ++prior)
+    {
+        Ndimensions += ptrPriors[prior]->getNdimensions();
+    }
+
+    random_device randomDevice;
+    engine.seed(randomDevice());
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::~LaplaceEvidence()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+LaplaceEvidence::~LaplaceEvidence()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::compute()
+//
+// PURPOSE:
+//      Finds the MAP of the free parameters and computes the Laplace approximation of the evidence,
+//
+//          ln Z = ln L(MAP) + ln pi(MAP) + d/2 ln(2 pi) + 1/2 ln det(C),
+//
+//      where C is the inverse of the Hessian of minus the log-posterior at the MAP. For the uniform
+//      priors, the evidence is corrected for the fraction of the Gaussian that falls outside the prior
+//      boundaries in each parameter, which matters when the MAP lies close to a boundary.
+//      The information gain is that of a Gaussian posterior, ln L(MAP) - d/2 - ln Z.
+//
+// INPUT:
+//      NinitialDraws:      the number of points drawn from the priors, the best of which starts the search.
+//      maxNevaluations:    the largest number of evaluations of the likelihood in each Nelder-Mead search.
+//      NimportanceDraws:   the number of points drawn from the Gaussian approximation of the posterior
+//                          to estimate the error of the evidence.
+//
+// OUTPUT:
+//      void
+//
+
+void LaplaceEvidence::compute(const int NinitialDraws, const int maxNevaluations, const int NimportanceDraws)
+{
+    // Draw the initial points from the priors. Their range also sets the scale of each parameter,
+    // used for the initial simplex and for the finite differences.
+
+    ArrayXXd initialSample(Ndimensions, max(NinitialDraws, 2));
+    int firstRow = 0;
+
+    for (size_t prior = 0; prior < ptrPriors.size(); ++prior)
+    {
+        int NpriorDimensions = ptrPriors[prior]->getNdimensions();
+        ArrayXXd priorSample(NpriorDimensions, initialSample.cols());
+        ptrPriors[prior]->draw(priorSample);
+        initialSample.middleRows(firstRow, NpriorDimensions) = priorSample;
+        firstRow += NpriorDimensions;
+    }
+
+    scales = initialSample.rowwise().maxCoeff() - initialSample.rowwise().minCoeff();
+    scales = (scales > 0.0).select(scales, 1.0);
+
+    Nevaluations = 0;
+    ArrayXd parameters = initialSample.col(0);
+    double value = logPosterior(parameters);
+
+    for (int draw = 1; draw < initialSample.cols(); ++draw)
+    {
+        ArrayXd drawnParameters = initialSample.col(draw);
+        double drawnValue = logPosterior(drawnParameters);
+
+        if (drawnValue > value)
+        {
+            parameters = drawnParameters;
+            value = drawnValue;
+        }
+    }
+
+
+    // Search the MAP, restarting once from the maximum found with a smaller simplex,
+    // since the simplex can collapse before reaching the maximum in many dimensions
+
+    searchNelderMead(parameters, value, 0.1, maxNevaluations);
+    searchNelderMead(parameters, value, 0.01, maxNevaluations);
+
+
+    // Refine the MAP with Newton steps, accepted only if they increase the log-posterior.
+    // The steps of the finite differences are set from the width of the posterior, once known.
+
+    ArrayXd steps = 1.e-4 * scales;
+    VectorXd gradient;
+    MatrixXd hessian;
+
+    for (int iteration = 0; iteration < 10; ++iteration)
+    {
+        hessian = computeHessian(parameters, steps, gradient);
+        Eigen::LLT<MatrixXd> decomposition(-hessian);
+
+        if (decomposition.info() != Eigen::Success)
+        {
+            break;
+        }
+
+        ArrayXd variances = decomposition.solve(MatrixXd::Identity(Ndimensions, Ndimensions)).diagonal().array();
+        steps = (variances > 0.0).select(0.2 * variances.sqrt(), steps).max(1.e-9 * scales).min(1.e-2 * scales);
+
+        ArrayXd newParameters = parameters + decomposition.solve(gradient).array();
+        double newValue = logPosterior(newParameters);
+
+        if (!(newValue > value))
+        {
+            break;
+        }
+
+        bool converged = (newValue - value < 1.e-6);
+        parameters = newParameters;
+        value = newValue;
+
+        if (converged)
+        {
+            break;
+        }
+    }
+
+    hessian = computeHessian(parameters, steps, gradient);
+    maximumAPosteriori = parameters;
+    logMaxLikelihood = likelihood.logValue(parameters);
+
+
+    // Covariance of the Gaussian approximation. If the Hessian is not negative definite, e.g. because
+    // the MAP lies on a prior boundary, the absolute values of its eigenvalues are used. These are
+    // the singular values of the Hessian, since the matrix is symmetric.
+
+    if (Eigen::LLT<MatrixXd>(-hessian).info() != Eigen::Success)
+    {
+        cerr << "The Hessian of the log-posterior is not negative definite at the MAP. "
+             << "The Laplace evidence is not reliable." << endl;
+    }
+
+    Eigen::JacobiSVD<MatrixXd, Eigen::NoQRPreconditioner> singularValueDecomposition(-hessian, Eigen::ComputeFullV);
+    VectorXd eigenvalues = singularValueDecomposition.singularValues().cwiseMax(1.e-300);
+    MatrixXd eigenvectors = singularValueDecomposition.matrixV();
+    covariance = eigenvectors * eigenvalues.cwiseInverse().asDiagonal() * eigenvectors.transpose();
+    double logDeterminant = -eigenvalues.array().log().sum();
+    hessianConditionNumber = eigenvalues.maxCoeff() / eigenvalues.minCoeff();
+
+    logEvidence = value + 0.5 * Ndimensions * log(2.0 * M_PI) + 0.5 * logDeterminant;
+
+
+    // Correction for the prior boundaries of the uniform priors
+
+    maximumOnBoundary = false;
+    firstRow = 0;
+
+    for (size_t prior = 0; prior < ptrPriors.size(); ++prior)
+    {
+        int NpriorDimensions = ptrPriors[prior]->getNdimensions();
+        UniformPrior *uniformPrior = dynamic_cast<UniformPrior*>(ptrPriors[prior]);
+
+        if (uniformPrior != nullptr)
+        {
+            ArrayXd minima = uniformPrior->getMinima();
+            ArrayXd maxima = uniformPrior->getMaxima();
+
+            for (int i = 0; i < NpriorDimensions; ++i)
+            {
+                int dimension = firstRow + i;
+                double sigma = sqrt(covariance(dimension, dimension));
+                double lowerCut = (minima(i) - parameters(dimension)) / (sqrt(2.0) * sigma);
+                double upperCut = (maxima(i) - parameters(dimension)) / (sqrt(2.0) * sigma);
+                double massInside = 0.5 * (erf(upperCut) - erf(lowerCut));
+                logEvidence += log(max(massInside, 1.e-300));
+
+                if (massInside < 0.99)
+                {
+                    maximumOnBoundary = true;
+                }
+            }
+        }
+
+        firstRow += NpriorDimensions;
+    }
+
+    informationGain = logMaxLikelihood - 0.5 * Ndimensions - logEvidence;
+
+
+    // Error of the evidence. The posterior is importance sampled with the (untruncated) Gaussian approximation,
+    // whose weights average to the evidence without assuming a Gaussian posterior nor a MAP away from the
+    // prior boundaries. The error combines the difference between the two estimates of the evidence with
+    // the statistical error of the importance sampling estimate.
+
+    this->NimportanceDraws = max(NimportanceDraws, 2);
+    ArrayXd logWeights(this->NimportanceDraws);
+    ArrayXd standardDeviations = eigenvalues.cwiseInverse().cwiseSqrt().array();
+
+    for (int draw = 0; draw < logWeights.size(); ++draw)
+    {
+        ArrayXd normalDeviates(Ndimensions);
+
+        for (int dimension = 0; dimension < Ndimensions; ++dimension)
+        {
+            normalDeviates(dimension) = normal(engine);
+        }
+
+        ArrayXd drawnParameters = parameters + (eigenvectors * (standardDeviations * normalDeviates).matrix()).array();
+        double logGaussian = -0.5 * normalDeviates.square().sum() - 0.5 * Ndimensions * log(2.0 * M_PI) - 0.5 * logDeterminant;
+        logWeights(draw) = logPosterior(drawnParameters) - logGaussian;
+    }
+
+    double maxLogWeight = logWeights.maxCoeff();
+
+    if (std::isfinite(maxLogWeight))
+    {
+        ArrayXd weights = (logWeights - maxLogWeight).exp();
+        double meanWeight = weights.mean();
+        double relativeVariance = (weights - meanWeight).square().sum() / (weights.size() - 1) / (meanWeight * meanWeight);
+        importanceLogEvidence = maxLogWeight + log(meanWeight);
+        logEvidenceError = sqrt((importanceLogEvidence - logEvidence) * (importanceLogEvidence - logEvidence) 
+                                + relativeVariance / weights.size());
+    }
+    else
+    {
+        importanceLogEvidence = -numeric_limits<double>::infinity();
+        logEvidenceError = numeric_limits<double>::infinity();
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::getLogEvidence()
+//
+// PURPOSE:
+//      Gets the natural logarithm of the Laplace approximation of the evidence.
+//
+// OUTPUT:
+//      The natural logarithm of the evidence.
+//
+
+double LaplaceEvidence::getLogEvidence()
+{
+    return logEvidence;
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::getLogEvidenceError()
+//
+// PURPOSE:
+//      Gets the error of the natural logarithm of the evidence, estimated by importance sampling 
+//      the posterior with its Gaussian approximation.
+//
+// OUTPUT:
+//      The error of the natural logarithm of the evidence, infinite if none of the drawn points 
+//      has a finite posterior.
+//
+
+double LaplaceEvidence::getLogEvidenceError()
+{
+    return logEvidenceError;
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::getHessianConditionNumber()
+//
+// PURPOSE:
+//      Gets the condition number of the Hessian of the log-posterior at the MAP, namely the ratio 
+//      of its largest to its smallest singular value. A large condition number indicates a poorly 
+//      constrained direction in the parameter space, along which the approximation is less accurate.
+//
+// OUTPUT:
+//      The condition number of the Hessian.
+//
+
+double LaplaceEvidence::getHessianConditionNumber()
+{
+    return hessianConditionNumber;
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::getInformationGain()
+//
+// PURPOSE:
+//      Gets the information gain (Kullback-Leibler divergence) of the Gaussian approximation
+//      of the posterior with respect to the prior.
+//
+// OUTPUT:
+//      The information gain, in natural units.
+//
+
+double LaplaceEvidence::getInformationGain()
+{
+    return informationGain;
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::getLogMaxLikelihood()
+//
+// PURPOSE:
+//      Gets the natural logarithm of the likelihood at the MAP.
+//
+// OUTPUT:
+//      The log-likelihood at the MAP.
+//
+
+double LaplaceEvidence::getLogMaxLikelihood()
+{
+    return logMaxLikelihood;
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::getMaximumAPosteriori()
+//
+// PURPOSE:
+//      Gets the values of the free parameters at the MAP.
+//
+// OUTPUT:
+//      One-dimensional array containing the MAP of the free parameters.
+//
+
+ArrayXd LaplaceEvidence::getMaximumAPosteriori()
+{
+    return maximumAPosteriori;
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::getCovariance()
+//
+// PURPOSE:
+//      Gets the covariance matrix of the Gaussian approximation of the posterior.
+//
+// OUTPUT:
+//      The covariance matrix of the free parameters.
+//
+
+MatrixXd LaplaceEvidence::getCovariance()
+{
+    return covariance;
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::getNevaluations()
+//
+// PURPOSE:
+//      Gets the total number of evaluations of the likelihood used by the computation.
+//
+// OUTPUT:
+//      The number of evaluations of the likelihood.
+//
+
+long LaplaceEvidence::getNevaluations()
+{
+    return Nevaluations;
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::isMaximumOnBoundary()
+//
+// PURPOSE:
+//      Checks whether the Gaussian approximation of the posterior is truncated by a
+//      prior boundary, i.e. if more than 1% of its marginal mass falls outside the boundaries
+//      in any parameter. In this case the evidence is less accurate, and the priors may be too narrow.
+//
+// OUTPUT:
+//      True if the MAP lies close to a prior boundary, false otherwise.
+//
+
+bool LaplaceEvidence::isMaximumOnBoundary()
+{
+    return maximumOnBoundary;
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::writeEvidenceInformationToFile()
+//
+// PURPOSE:
+//      Writes the evidence into an ASCII file with the same columns of the evidence information
+//      of a nested sampling run, so that the two can be read by the same routines. The error is
+//      that estimated by importance sampling (see compute()).
+//
+// INPUT:
+//      fileName:       a string containing the full path of the output file.
+//
+// OUTPUT:
+//      void
+//
+
+void LaplaceEvidence::writeEvidenceInformationToFile(const string fileName)
+{
+    ofstream outputFile(fileName.c_str());
+
+    if (!outputFile)
+    {
+        cerr << "Error opening output file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    outputFile << "# Evidence results from the Laplace approximation" << endl;
+    outputFile << "# Column #1: Laplace log(Evidence)" << endl;
+    outputFile << "# Column #2: Error log(Evidence) from importance sampling of the Gaussian approximation" << endl;
+    outputFile << "# Column #3: Information Gain of the Gaussian approximation" << endl;
+    outputFile << scientific << setprecision(9) << logEvidence << "  " << logEvidenceError << "  " << informationGain << endl;
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::writeParametersToFile()
+//
+// PURPOSE:
+//      Writes the MAP of the free parameters and their standard deviation from the Gaussian
+//      approximation of the posterior into an ASCII file, one row for each free parameter.
+//
+// INPUT:
+//      fileName:       a string containing the full path of the output file.
+//
+// OUTPUT:
+//      void
+//
+
+void LaplaceEvidence::writeParametersToFile(const string fileName)
+{
+    ofstream outputFile(fileName.c_str());
+
+    if (!outputFile)
+    {
+        cerr << "Error opening output file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    outputFile << "# Laplace approximation of the posterior." << endl;
+    outputFile << "# Column #1: MAP value" << endl;
+    outputFile << "# Column #2: Standard deviation" << endl;
+    outputFile << scientific << setprecision(9);
+
+    for (int dimension = 0; dimension < Ndimensions; ++dimension)
+    {
+        outputFile << maximumAPosteriori(dimension) << "  " << sqrt(covariance(dimension, dimension)) << endl;
+    }
+
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::writeComputationInformation()
+//
+// PURPOSE:
+//      Writes the settings and the diagnostics of the Laplace approximation in the file of 
+//      computation parameters of the run.
+//
+// INPUT:
+//      outputFile:     the open file of computation parameters of the run.
+//
+// OUTPUT:
+//      void
+//
+
+void LaplaceEvidence::writeComputationInformation(ofstream &outputFile)
+{
+    outputFile << "# Laplace approximation of the evidence" << endl;
+    outputFile << "# Row #1: Number of evaluations of the likelihood" << endl;
+    outputFile << "# Row #2: Number of points drawn for the importance sampling" << endl;
+    outputFile << "# Row #3: log(Evidence) from importance sampling of the Gaussian approximation" << endl;
+    outputFile << "# Row #4: Condition number of the Hessian of the log-posterior at the MAP" << endl;
+    outputFile << "# Row #5: MAP close to a prior boundary (1 = yes / 0 = no)" << endl;
+    outputFile << Nevaluations << endl;
+    outputFile << NimportanceDraws << endl;
+    outputFile << setprecision(12) << importanceLogEvidence << endl;
+    outputFile << setprecision(6) << hessianConditionNumber << endl;
+    outputFile << maximumOnBoundary << endl;
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::logPosterior()
+//
+// PURPOSE:
+//      Computes the natural logarithm of the unnormalized posterior, including the normalization
+//      constants of the priors, so that its integral is the evidence.
+//
+// INPUT:
+//      parameters:             one-dimensional array containing the values of the free parameters.
+//      includeUniformPriors:   if false, the uniform priors are left out, and the likelihood is also evaluated
+//                              outside their boundaries. Since their density is constant, this does not change
+//                              the derivatives, which can then be computed also at a MAP on a boundary.
+//
+// OUTPUT:
+//      The log-posterior, or minus infinity outside the support of the priors or where the model is not defined.
+//
+
+double LaplaceEvidence::logPosterior(const ArrayXd &parameters, const bool includeUniformPriors)
+{
+    double logPrior = 0.0;
+    int firstRow = 0;
+
+    for (size_t prior = 0; prior < ptrPriors.size(); ++prior)
+    {
+        int NpriorDimensions = ptrPriors[prior]->getNdimensions();
+
+        if (includeUniformPriors || (dynamic_cast<UniformPrior*>(ptrPriors[prior]) == nullptr))
+        {
+            ArrayXd priorParameters = parameters.segment(firstRow, NpriorDimensions);
+            double logDensity = ptrPriors[prior]->logDensity(priorParameters, true);
+
+            if (logDensity <= ptrPriors[prior]->minusInfinity)
+            {
+                return -numeric_limits<double>::infinity();
+            }
+
+            logPrior += logDensity;
+        }
+
+        firstRow += NpriorDimensions;
+    }
+
+    ArrayXd modelParameters = parameters;
+    double logValue = likelihood.logValue(modelParameters) + logPrior;
+    ++Nevaluations;
+
+    return std::isnan(logValue) ? -numeric_limits<double>::infinity() : logValue;
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::searchNelderMead()
+//
+// PURPOSE:
+//      Maximizes the log-posterior with the Nelder-Mead simplex algorithm, with the coefficients
+//      adapted to the number of dimensions (Gao & Han 2012). Points outside the support of the
+//      priors have a log-posterior of minus infinity, hence they are always rejected.
+//
+// INPUT:
+//      parameters:         one-dimensional array containing the starting point, replaced by the maximum found.
+//      value:              the log-posterior at the starting point, replaced by that at the maximum found.
+//      simplexSize:        the size of the initial simplex, in units of the scale of each parameter.
+//      maxNevaluations:    the largest number of evaluations of the likelihood.
+//
+// OUTPUT:
+//      void
+//
+
+void LaplaceEvidence::searchNelderMead(ArrayXd &parameters, double &value, const double simplexSize, const int maxNevaluations)
+{
+    double reflection = 1.0;
+    double expansion = 1.0 + 2.0 / Ndimensions;
+    double contraction = 0.75 - 0.5 / Ndimensions;
+    double shrinkage = 1.0 - 1.0 / Ndimensions;
+
+    vector<ArrayXd> vertices(Ndimensions + 1, parameters);
+    vector<double> values(Ndimensions + 1, value);
+
+    for (int dimension = 0; dimension < Ndimensions; ++dimension)
+    {
+        vertices[dimension + 1](dimension) += simplexSize * scales(dimension);
+        values[dimension + 1] = logPosterior(vertices[dimension + 1]);
+
+        if (values[dimension + 1] == -numeric_limits<double>::infinity())
+        {
+            vertices[dimension + 1](dimension) -= 2.0 * simplexSize * scales(dimension);
+            values[dimension + 1] = logPosterior(vertices[dimension + 1]);
+        }
+    }
+
+    vector<int> order(Ndimensions + 1);
+    long lastEvaluation = Nevaluations + maxNevaluations;
+
+    while (Nevaluations < lastEvaluation)
+    {
+        // Sort the vertices from the largest to the smallest log-posterior
+
+        for (int vertex = 0; vertex <= Ndimensions; ++vertex)
+        {
+            order[vertex] = vertex;
+        }
+
+        sort(order.begin(), order.end(), [&](const int first, const int second) { return values[first] > values[second]; });
+
+        int best = order[0];
+        int worst = order[Ndimensions];
+        int secondWorst = order[Ndimensions - 1];
+
+        if (values[best] - values[worst] < 1.e-8)
+        {
+            break;
+        }
+
+        ArrayXd centroid = ArrayXd::Zero(Ndimensions);
+
+        for (int vertex = 0; vertex < Ndimensions; ++vertex)
+        {
+            centroid += vertices[order[vertex]];
+        }
+
+        centroid /= Ndimensions;
+
+        ArrayXd reflected = centroid + reflection * (centroid - vertices[worst]);
+        double reflectedValue = logPosterior(reflected);
+
+        if (reflectedValue > values[best])
+        {
+            ArrayXd expanded = centroid + expansion * (reflected - centroid);
+            double expandedValue = logPosterior(expanded);
+
+            if (expandedValue > reflectedValue)
+            {
+                vertices[worst] = expanded;
+                values[worst] = expandedValue;
+            }
+            else
+            {
+                vertices[worst] = reflected;
+                values[worst] = reflectedValue;
+            }
+        }
+        else if (reflectedValue > values[secondWorst])
+        {
+            vertices[worst] = reflected;
+            values[worst] = reflectedValue;
+        }
+        else
+        {
+            bool outside = (reflectedValue > values[worst]);
+            ArrayXd contracted = outside ? ArrayXd(centroid + contraction * (reflected - centroid))
+                                         : ArrayXd(centroid + contraction * (vertices[worst] - centroid));
+            double contractedValue = logPosterior(contracted);
+
+            if (contractedValue > (outside ? reflectedValue : values[worst]))
+            {
+                vertices[worst] = contracted;
+                values[worst] = contractedValue;
+            }
+            else
+            {
+                for (int vertex = 1; vertex <= Ndimensions; ++vertex)
+                {
+                    vertices[order[vertex]] = vertices[best] + shrinkage * (vertices[order[vertex]] - vertices[best]);
+                    values[order[vertex]] = logPosterior(vertices[order[vertex]]);
+                }
+            }
+        }
+    }
+
+    int best = max_element(values.begin(), values.end()) - values.begin();
+    parameters = vertices[best];
+    value = values[best];
+}
+
+
+
+
+
+
+
+
+
+
+// LaplaceEvidence::computeHessian()
+//
+// PURPOSE:
+//      Computes the gradient and the Hessian of the log-posterior by central finite differences,
+//      with 2 d^2 + 1 evaluations of the likelihood. The uniform priors are left out, since they
+//      do not contribute to the derivatives.
+//
+// INPUT:
+//      parameters:     one-dimensional array containing the point where the derivatives are computed.
+//      steps:          one-dimensional array containing the step of the finite differences for each parameter.
+//      gradient:       the vector where the gradient is stored.
+//
+// OUTPUT:
+//      The Hessian matrix of the log-posterior.
+//
+
+MatrixXd LaplaceEvidence::computeHessian(const ArrayXd &parameters, const ArrayXd &steps, VectorXd &gradient)
+{
+    double centralValue = logPosterior(parameters, false);
+    MatrixXd hessian(Ndimensions, Ndimensions);
+    gradient.resize(Ndimensions);
+    ArrayXd point = parameters;
+
+    for (int i = 0; i < Ndimensions; ++i)
+    {
+        point(i) = parameters(i) + steps(i);
+        double forwardValue = logPosterior(point, false);
+        point(i) = parameters(i) - steps(i);
+        double backwardValue = logPosterior(point, false);
+        point(i) = parameters(i);
+
+        gradient(i) = (forwardValue - backwardValue) / (2.0 * steps(i));
+        hessian(i, i) = (forwardValue - 2.0 * centralValue + backwardValue) / (steps(i) * steps(i));
+
+        for (int j = 0; j < i; ++j)
+        {
+            double values[4];
+            int signs[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+            for (int corner = 0; corner < 4; ++corner)
+            {
+                point(i) = parameters(i) + signs[corner][0] * steps(i);
+                point(j) = parameters(j) + signs[corner][1] * steps(j);
+                values[corner] = logPosterior(point, false);
+            }
+
+            point(i) = parameters(i);
+            point(j) = parameters(j);
+            hessian(i, j) = (values[0] - values[1] - values[2] + values[3]) / (4.0 * steps(i) * steps(j));
+            hessian(j, i) = hessian(i, j);
+        }
+    }
+
+    return hessian;
+}
@@ -0,0 +1,207 @@
+#include "NpyFile.h"
+
+
+// NpyFile::hostIsLittleEndian()
+//
+// PURPOSE:
+//      Checks the byte order of the machine, which is written in the header of the file.
+//
+// OUTPUT:
+//      True if the machine is little-endian, false otherwise.
+//
+
+bool NpyFile::hostIsLittleEndian()
+{
+    uint16_t testValue = 1;
+    return *reinterpret_cast<unsigned char*>(&testValue) == 1;
+}
+
+
+
+
+
+
+
+
+
+
+// NpyFile::makeHeader()
+//
+// PURPOSE:
+//      Builds the header of a .npy file (format version 1.0) for a two-dimensional array of doubles 
+//      stored in column-major order.
+//
+// INPUT:
+//      Nrows:          the number of rows of the array.
+//      Ncolumns:       the number of columns of the array.
+//
+// OUTPUT:
+//      A string containing the magic string, the version, the length of the header and the header 
+//      dictionary, padded with spaces so that the data start at a multiple of 64 bytes.
+//
+
+string NpyFile::makeHeader(const long Nrows, const long Ncolumns)
+{
+    ostringstream dictionary;
+    dictionary << "{'descr': '" << (hostIsLittleEndian() ? "<" : ">") << "f8', 'fortran_order': True, 'shape': (" 
+               << Nrows << ", " << Ncolumns << "), }";
+
+    string header = dictionary.str();
+    const size_t preambleLength = 10;     // Magic string (6), version (2) and header length (2)
+    size_t totalLength = preambleLength + header.size() + 1;
+    header.append((64 - totalLength % 64) % 64, ' ');
+    header.push_back('\n');
+
+    uint16_t headerLength = static_cast<uint16_t>(header.size());
+    string preamble("\x93NUMPY\x01\x00", 8);
+    preamble.push_back(static_cast<char>(headerLength & 0xFF));
+    preamble.push_back(static_cast<char>(headerLength >> 8));
+
+    return preamble + header;
+}
+
+
+
+
+
+
+
+
+
+
+// NpyFile::arrayXXdToFile()
+//
+// PURPOSE:
+//      Writes a two-dimensional array of doubles into a .npy file.
+//
+// INPUT:
+//      fileName:       a string specifying the full path (filename included) of the output file.
+//      array:          the Eigen array to be written.
+//
+// OUTPUT:
+//      void
+//
+
+void NpyFile::arrayXXdToFile(const string fileName, const ArrayXXd &array)
+{
+    ofstream outputFile(fileName.c_str(), ios::out | ios::binary);
+
+    if (!outputFile.good())
+    {
+        cerr << "Error opening output file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    string header = makeHeader(array.rows(), array.cols());
+    outputFile.write(header.data(), header.size());
+    outputFile.write(reinterpret_cast<const char*>(array.data()), array.size()*sizeof(double));
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+// NpyFile::arrayXXdToString()
+//
+// PURPOSE:
+//      Builds the content of a .npy file for a two-dimensional array of doubles, 
+//      e.g. for storing it into a .npz archive.
+//
+// INPUT:
+//      array:          the Eigen array to be converted.
+//
+// OUTPUT:
+//      A string containing the header of the file followed by the values of the array.
+//
+
+string NpyFile::arrayXXdToString(const ArrayXXd &array)
+{
+    string content = makeHeader(array.rows(), array.cols());
+    content.append(reinterpret_cast<const char*>(array.data()), array.size()*sizeof(double));
+
+    return content;
+}
+
+
+
+
+
+
+
+
+
+
+// NpyFile::arrayXXdFromFile()
+//
+// PURPOSE:
+//      Reads a two-dimensional array of doubles from a .npy file written by arrayXXdToFile().
+//
+// INPUT:
+//      fileName:       a string specifying the full path (filename included) of the input file.
+//
+// OUTPUT:
+//      An Eigen array with the content of the file.
+//
+// NOTE:
+//      Only arrays of doubles in column-major order and in the byte order of the machine are supported.
+//
+
+ArrayXXd NpyFile::arrayXXdFromFile(const string fileName)
+{
+    ifstream inputFile(fileName.c_str(), ios::in | ios::binary);
+
+    if (!inputFile.good())
+    {
+        cerr << "Error opening input file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    char preamble[10];
+    inputFile.read(preamble, 10);
+
+    if (!inputFile.good() || (string(preamble, 6) != "\x93NUMPY") || (preamble[6] != 1))
+    {
+        cerr << "File " << fileName << " is not a .npy file of version 1.0." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    size_t headerLength = static_cast<unsigned char>(preamble[8]) + 256*static_cast<unsigned char>(preamble[9]);
+    string header(headerLength, ' ');
+    inputFile.read(&header[0], headerLength);
+
+    string expectedDescription = string("'descr': '") + (hostIsLittleEndian() ? "<" : ">") + "f8'";
+
+    if ((header.find(expectedDescription) == string::npos) || (header.find("'fortran_order': True") == string::npos))
+    {
+        cerr << "File " << fileName << " does not contain a column-major array of doubles." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    long Nrows = 0;
+    long Ncolumns = 0;
+    size_t shapePosition = header.find("'shape': (");
+
+    if (shapePosition != string::npos)
+    {
+        istringstream shapeStream(header.substr(shapePosition + 10));
+        char separator;
+        shapeStream >> Nrows >> separator >> Ncolumns;
+    }
+
+    ArrayXXd array(Nrows, Ncolumns);
+    inputFile.read(reinterpret_cast<char*>(array.data()), array.size()*sizeof(double));
+
+    if (!inputFile.good())
+    {
+        cerr << "File " << fileName << " is truncated." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    return array;
+}
@@ -0,0 +1,494 @@
+#include "NuMaxEstimator.h"
+
+
+// NuMaxEstimator::NuMaxEstimator()
+//
+// PURPOSE:
+//      Constructor. Estimates nuMax and the background level at nuMax from the power spectral density.
+//      The spectrum is first averaged on a grid of frequencies equally spaced in natural logarithm,
+//      and its logarithm is smoothed at the scale of the oscillation envelope (a local average)
+//      and at the scale of the background (a local quadratic fit), both with Gaussian weights.
+//      nuMax is the frequency of the largest difference between the two smoothings, refined by a
+//      parabolic interpolation, searched away from the edges of the grid, where the local fit of
+//      the background is poorly constrained. The lower edge of the grid is set at 100 frequency
+//      resolutions, to skip the region dominated by the spectral window and the slow trends.
+//
+// INPUT:
+//      frequencies:        one-dimensional array containing the frequencies of the dataset (muHz),
+//                          sorted in increasing order.
+//      spectralDensity:    one-dimensional array containing the power spectral density of the dataset.
+//      NlogBins:           the number of bins of the logarithmic grid of frequencies.
+//
+
+NuMaxEstimator::NuMaxEstimator(const ConstRefArrayXd frequencies, const ConstRefArrayXd spectralDensity, const int NlogBins)
+{
+    long Nbins = frequencies.size();
+
+    if ((Nbins < 10) || (Nbins != spectralDensity.size()) || (NlogBins < 16))
+    {
+        cerr << "Cannot estimate nuMax from a dataset with less than ten frequency bins." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // White noise, as the average power spectral density of the highest tenth of the frequency range
+
+    long NwhiteNoiseBins = Nbins / 10;
+    whiteNoiseLevel = spectralDensity.tail(NwhiteNoiseBins).mean();
+
+
+    // Average of the spectrum on the logarithmic grid of frequencies
+
+    double frequencyResolution = (frequencies(Nbins - 1) - frequencies(0)) / (Nbins - 1);
+    double lowerFrequency = max(frequencies(0), 100.0 * frequencyResolution);
+    const double *firstFrequency = frequencies.data();
+    long firstBin = lower_bound(firstFrequency, firstFrequency + Nbins, lowerFrequency) - firstFrequency;
+
+    if (Nbins - firstBin < 10)
+    {
+        cerr << "Too few frequency bins above " << lowerFrequency << " muHz for estimating nuMax." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    double lowerLogFrequency = log(frequencies(firstBin));
+    double upperLogFrequency = log(frequencies(Nbins - 1));
+    double logBinWidth = (upperLogFrequency - lowerLogFrequency) / (NlogBins - 1);
+    ArrayXd logFrequencies = ArrayXd::LinSpaced(NlogBins, lowerLogFrequency, upperLogFrequency);
+    ArrayXd sums = ArrayXd::Zero(NlogBins);
+    ArrayXd counts = ArrayXd::Zero(NlogBins);
+
+    for (long bin = firstBin; bin < Nbins; ++bin)
+    {
+        int logBin = static_cast<int>(floor((log(frequencies(bin)) - lowerLogFrequency) / logBinWidth + 0.5));
+        logBin = min(max(logBin, 0), NlogBins - 1);
+        sums(logBin) += spectralDensity(bin);
+        counts(logBin) += 1.0;
+    }
+
+
+    // The empty bins of the grid, where the frequency resolution is coarser than the grid,
+    // are filled by linear interpolation of the logarithm of the average spectrum
+
+    vector<int> filledBins;
+
+    for (int logBin = 0; logBin < NlogBins; ++logBin)
+    {
+        if ((counts(logBin) > 0) && (sums(logBin) > 0.0))
+        {
+            filledBins.push_back(logBin);
+        }
+    }
+
+    if (filledBins.size() < 2)
+    {
+        cerr << "Cannot estimate nuMax from a spectrum with no positive power spectral density." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    ArrayXd logSpectrum(NlogBins);
+    size_t next = 0;
+
+    for (int logBin = 0; logBin < NlogBins; ++logBin)
+    {
+        while ((next < filledBins.size()) && (filledBins[next] < logBin))
+        {
+            ++next;
+        }
+
+        if ((next < filledBins.size()) && (filledBins[next] == logBin))
+        {
+            logSpectrum(logBin) = log(sums(logBin) / counts(logBin));
+        }
+        else if (next == 0)
+        {
+            logSpectrum(logBin) = log(sums(filledBins[0]) / counts(filledBins[0]));
+        }
+        else if (next == filledBins.size())
+        {
+            int lastBin = filledBins.back();
+            logSpectrum(logBin) = log(sums(lastBin) / counts(lastBin));
+        }
+        else
+        {
+            int leftBin = filledBins[next - 1];
+            int rightBin = filledBins[next];
+            double leftValue = log(sums(leftBin) / counts(leftBin));
+            double rightValue = log(sums(rightBin) / counts(rightBin));
+            logSpectrum(logBin) = leftValue + (rightValue - leftValue) * (logBin - leftBin) / (rightBin - leftBin);
+        }
+    }
+
+
+    // Power excess, as the difference between the two smoothings of the logarithmic spectrum
+
+    ArrayXd envelope = smoothLocalPolynomial(logSpectrum, envelopeWidth / logBinWidth, 0);
+    ArrayXd background = smoothLocalPolynomial(logSpectrum, backgroundWidth / logBinWidth, 2);
+    ArrayXd powerExcess = envelope - background;
+
+    int firstSearchBin = min(static_cast<int>(ceil(backgroundWidth / logBinWidth)), NlogBins - 1);
+    int lastSearchBin = max(static_cast<int>(floor(NlogBins - 1 - upperEdgeWidth / logBinWidth)), firstSearchBin);
+    int NsearchBins = lastSearchBin - firstSearchBin + 1;
+
+    int peakBin;
+    powerExcess.segment(firstSearchBin, NsearchBins).maxCoeff(&peakBin);
+    peakBin += firstSearchBin;
+
+    double offset = 0.0;
+
+    if ((peakBin > 0) && (peakBin < NlogBins - 1))
+    {
+        double curvature = powerExcess(peakBin - 1) - 2.0 * powerExcess(peakBin) + powerExcess(peakBin + 1);
+
+        if (curvature < 0.0)
+        {
+            offset = 0.5 * (powerExcess(peakBin - 1) - powerExcess(peakBin + 1)) / curvature;
+        }
+    }
+
+    nuMax = exp(logFrequencies(peakBin) + offset * logBinWidth);
+    backgroundLevel = exp(background(peakBin));
+
+
+    // Significance of the power excess, in units of the robust standard deviation
+    // (from the median absolute deviation) of the power excess over the searched range
+
+    ArrayXd searchedExcess = powerExcess.segment(firstSearchBin, NsearchBins);
+    vector<double> values(searchedExcess.data(), searchedExcess.data() + NsearchBins);
+    nth_element(values.begin(), values.begin() + NsearchBins / 2, values.end());
+    double median = values[NsearchBins / 2];
+
+    for (int i = 0; i < NsearchBins; ++i)
+    {
+        values[i] = fabs(searchedExcess(i) - median);
+    }
+
+    nth_element(values.begin(), values.begin() + NsearchBins / 2, values.end());
+    double robustDeviation = 1.4826 * values[NsearchBins / 2];
+    significance = (robustDeviation > 0.0) ? (powerExcess(peakBin) - median) / robustDeviation : 0.0;
+}
+
+
+
+
+
+
+
+
+
+
+// NuMaxEstimator::~NuMaxEstimator()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+NuMaxEstimator::~NuMaxEstimator()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// NuMaxEstimator::getNuMax()
+//
+// PURPOSE:
+//      Gets the estimate of the frequency of maximum oscillation power.
+//
+// OUTPUT:
+//      nuMax (muHz).
+//
+
+double NuMaxEstimator::getNuMax()
+{
+    return nuMax;
+}
+
+
+
+
+
+
+
+
+
+
+// NuMaxEstimator::getSignificance()
+//
+// PURPOSE:
+//      Gets the significance of the power excess found at nuMax, as the ratio between its
+//      height above the median and the robust standard deviation of the power excess.
+//      Values below about 3 indicate that no clear oscillation envelope was found.
+//
+// OUTPUT:
+//      The significance of the power excess.
+//
+
+double NuMaxEstimator::getSignificance()
+{
+    return significance;
+}
+
+
+
+
+
+
+
+
+
+
+// NuMaxEstimator::getBackgroundLevel()
+//
+// PURPOSE:
+//      Gets the level of the background at nuMax, from the local quadratic fit of the
+//      logarithmic spectrum. This includes both the granulation and the white noise.
+//
+// OUTPUT:
+//      The power spectral density of the background at nuMax.
+//
+
+double NuMaxEstimator::getBackgroundLevel()
+{
+    return backgroundLevel;
+}
+
+
+
+
+
+
+
+
+
+
+// NuMaxEstimator::getWhiteNoiseLevel()
+//
+// PURPOSE:
+//      Gets the level of the white noise, as the average power spectral density
+//      of the highest tenth of the frequency range.
+//
+// OUTPUT:
+//      The power spectral density of the white noise.
+//
+
+double NuMaxEstimator::getWhiteNoiseLevel()
+{
+    return whiteNoiseLevel;
+}
+
+
+
+
+
+
+
+
+
+
+// NuMaxEstimator::getGranulationLevel()
+//
+// PURPOSE:
+//      Gets a rough level of the granulation at nuMax, as the background level
+//      in excess of the white noise.
+//
+// OUTPUT:
+//      The power spectral density of the granulation at nuMax.
+//
+
+double NuMaxEstimator::getGranulationLevel()
+{
+    return max(backgroundLevel - whiteNoiseLevel, 0.0);
+}
+
+
+
+
+
+
+
+
+
+
+// NuMaxEstimator::writeToFile()
+//
+// PURPOSE:
+//      Writes the estimates into an ASCII file, one value per line.
+//
+// INPUT:
+//      fileName:       a string containing the full path of the output file.
+//
+// OUTPUT:
+//      void
+//
+
+void NuMaxEstimator::writeToFile(const string fileName)
+{
+    ofstream outputFile(fileName.c_str());
+
+    if (!outputFile)
+    {
+        cerr << "Error opening output file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    outputFile << "# Estimate of nuMax from the power excess in the spectrum." << endl;
+    outputFile << "# Rows: nuMax (muHz), significance of the power excess, background level at nuMax," << endl;
+    outputFile << "# white noise level, granulation level at nuMax." << endl;
+    outputFile << setiosflags(ios::scientific) << setprecision(9);
+    outputFile << nuMax << endl;
+    outputFile << significance << endl;
+    outputFile << backgroundLevel << endl;
+    outputFile << whiteNoiseLevel << endl;
+    outputFile << getGranulationLevel() << endl;
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+// NuMaxEstimator::convolve()
+//
+// PURPOSE:
+//      Convolves a signal with a kernel by means of the fast Fourier transform. The signal is padded
+//      with zeros up to a power of two at least as large as the signal plus the kernel, so that
+//      the convolution is not circular, and the output has the size of the input signal.
+//
+// INPUT:
+//      signal:         one-dimensional array containing the signal.
+//      kernel:         one-dimensional array of odd size containing the kernel, centered on its middle element.
+//
+// OUTPUT:
+//      One-dimensional array containing the convolution of the signal with the kernel.
+//
+
+ArrayXd NuMaxEstimator::convolve(const ArrayXd &signal, const ArrayXd &kernel)
+{
+    int Nsignal = signal.size();
+    int halfWidth = (kernel.size() - 1) / 2;
+    int Nfft = 1;
+
+    while (Nfft < Nsignal + 2 * halfWidth)
+    {
+        Nfft *= 2;
+    }
+
+    vector<double> paddedSignal(Nfft, 0.0);
+    vector<double> paddedKernel(Nfft, 0.0);
+
+    for (int i = 0; i < Nsignal; ++i)
+    {
+        paddedSignal[i] = signal(i);
+    }
+
+    for (int offset = -halfWidth; offset <= halfWidth; ++offset)
+    {
+        paddedKernel[(offset + Nfft) % Nfft] = kernel(offset + halfWidth);
+    }
+
+    Eigen::FFT<double> fft;
+    vector<complex<double> > signalSpectrum;
+    vector<complex<double> > kernelSpectrum;
+    fft.fwd(signalSpectrum, paddedSignal);
+    fft.fwd(kernelSpectrum, paddedKernel);
+
+    for (size_t i = 0; i < signalSpectrum.size(); ++i)
+    {
+        signalSpectrum[i] *= kernelSpectrum[i];
+    }
+
+    vector<double> convolution;
+    fft.inv(convolution, signalSpectrum);
+
+    return Eigen::Map<ArrayXd>(convolution.data(), Nsignal);
+}
+
+
+
+
+
+
+
+
+
+
+// NuMaxEstimator::smoothLocalPolynomial()
+//
+// PURPOSE:
+//      Smooths a signal by a local polynomial fit with Gaussian weights. At each point, the polynomial
+//      is fitted to the signal around that point, and its value at the point is taken as the smoothed
+//      signal. The weighted sums of the normal equations of all the points are computed at once as
+//      convolutions with the Gaussian kernel multiplied by the powers of the offset, so that the
+//      cost scales as N log(N) regardless of the width of the kernel. Near the edges, the fit only
+//      uses the points available, so no extrapolation of the signal is needed.
+//
+// INPUT:
+//      signal:             one-dimensional array containing the signal, on an equally spaced grid.
+//      kernelWidth:        the standard deviation of the Gaussian weights, in grid bins.
+//      degree:             the degree of the local polynomial, with 0 for a local weighted average.
+//
+// OUTPUT:
+//      One-dimensional array containing the smoothed signal.
+//
+
+ArrayXd NuMaxEstimator::smoothLocalPolynomial(const ArrayXd &signal, const double kernelWidth, const int degree)
+{
+    int Nsignal = signal.size();
+    int halfWidth = max(static_cast<int>(4.0 * kernelWidth), 1);
+    ArrayXd offsets = ArrayXd::LinSpaced(2 * halfWidth + 1, -halfWidth, halfWidth) / kernelWidth;
+    ArrayXd gaussian = (-0.5 * offsets.square()).exp();
+    ArrayXd ones = ArrayXd::Ones(Nsignal);
+
+
+    // Weighted sums of the powers of the offset from each point, and of the signal times those powers.
+    // The kernel is evaluated at minus the offset, since the convolution reverses it.
+
+    vector<ArrayXd> weightSums(2 * degree + 1);
+    vector<ArrayXd> signalSums(degree + 1);
+    ArrayXd kernel = gaussian;
+
+    for (int power = 0; power <= 2 * degree; ++power)
+    {
+        weightSums[power] = convolve(ones, kernel);
+
+        if (power <= degree)
+        {
+            signalSums[power] = convolve(signal, kernel);
+        }
+
+        kernel *= -offsets;
+    }
+
+    ArrayXd smoothedSignal(Nsignal);
+    Eigen::MatrixXd normalMatrix(degree + 1, degree + 1);
+    Eigen::VectorXd normalVector(degree + 1);
+
+    for (int i = 0; i < Nsignal; ++i)
+    {
+        for (int row = 0; row <= degree; ++row)
+        {
+            for (int col = 0; col <= degree; ++col)
+            {
+                normalMatrix(row, col) = weightSums[row + col](i);
+            }
+
+            normalVector(row) = signalSums[row](i);
+        }
+
+        smoothedSignal(i) = normalMatrix.ldlt().solve(normalVector)(0);
+    }
+
+    return smoothedSignal;
+}
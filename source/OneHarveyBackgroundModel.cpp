@@ -23,8 +23,13 @@ OneHarveyBackgroundModel::OneHarveyBackgroundModel(const RefArrayXd covariates,
 
     readNyquistFrequencyFromFile(inputNyquistFrequencyFileName);
 
-    ArrayXd sincFunctionArgument = (Functions::PI / 2.0) * covariates / NyquistFrequency;
-    responseFunction = (sincFunctionArgument.sin() / sincFunctionArgument).square();
+    updateResponseFunction();
+
+    // Additive components of the model, each one scaled by one of the free parameters
+
+    addComponent("flatNoise", 0);
+    addComponent("harvey1", 1);
+    addComponent("envelope", 3);
 }
 
 
@@ -66,6 +71,9 @@ OneHarveyBackgroundModel::~OneHarveyBackgroundModel()
 //      This model is more suited for very low-numax stars.
 //      A component for colored noise is included, more indicated for low-numax stars
 //
+//      The model is evaluated either on the stored covariates or on the implicit
+//      uniform frequency grid, if the latter has been activated.
+//
 // INPUT:
 //      predictions:        one-dimensional array to contain the predictions
 //                          from the model
@@ -87,35 +95,71 @@ OneHarveyBackgroundModel::~OneHarveyBackgroundModel()
 
 void OneHarveyBackgroundModel::predict(RefArrayXd predictions, RefArrayXd const modelParameters)
 {
-    // Initialize global parameters
+    if (uniformGrid && !singlePrecision)
+    {
+        predictOnFrequencies(predictions, gridCovariates(), responseFunction, modelParameters);
+    }
+    else if (uniformGrid)
+    {
+        predictOnFrequencies(predictions, gridCovariates(), compressedResponseFunction.cast<double>(), modelParameters);
+    }
+    else if (singlePrecision)
+    {
+        predictOnFrequencies(predictions, singlePrecisionCovariates.cast<double>(), compressedResponseFunction.cast<double>(), modelParameters);
+    }
+    else
+    {
+        predictOnFrequencies(predictions, covariates, responseFunction, modelParameters);
+    }
+}
 
-    double flatNoiseLevel = modelParameters(0);
-    double amplitudeHarvey1 = modelParameters(1);
-    double frequencyHarvey1 = modelParameters(2);
-    double heightOscillation = modelParameters(3);
-    double nuMax = modelParameters(4);
-    double sigma = modelParameters(5);
 
 
-    // Compute Harvey components and add them to the predictions
 
-    double zeta = 2.0*sqrt(2.0)/Functions::PI;
-    predictions = zeta*amplitudeHarvey1*amplitudeHarvey1/(frequencyHarvey1*(1.0 + (covariates/frequencyHarvey1).pow(4)));
 
 
-    // Compute Gaussian envelope for RGB Oscillations and add it to the predictions
 
-    predictions += heightOscillation * exp(-1.0*(nuMax - covariates)*(nuMax - covariates)/(2.0 * sigma * sigma));
 
-    
-    // Modulate the model by the response function (apodization)
-    
-    predictions *= responseFunction;           
 
 
-    // Add flat noise and colored noise components
 
-    predictions += flatNoiseLevel;
+// OneHarveyBackgroundModel::predictSinglePrecision()
+//
+// PURPOSE:
+//      Builds the predictions of the model in single precision, by using the
+//      single-precision frequencies and response function.
+//
+// INPUT:
+//      predictions:        one-dimensional single-precision array to contain the 
+//                          predictions from the model
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model
+//
+// OUTPUT:
+//      void
+//
+// NOTE:
+//      The free parameters are to be given in the same order of predict().
+//
+
+void OneHarveyBackgroundModel::predictSinglePrecision(RefArrayXf predictions, RefArrayXd const modelParameters)
+{
+    if (uniformGrid && !singlePrecision)
+    {
+        predictOnFrequencies(predictions, singlePrecisionGridCovariates(), responseFunction.cast<float>(), modelParameters);
+    }
+    else if (uniformGrid)
+    {
+        predictOnFrequencies(predictions, singlePrecisionGridCovariates(), compressedResponseFunction, modelParameters);
+    }
+    else if (singlePrecision)
+    {
+        predictOnFrequencies(predictions, singlePrecisionCovariates, compressedResponseFunction, modelParameters);
+    }
+    else
+    {
+        predictOnFrequencies(predictions, covariates.cast<float>(), responseFunction.cast<float>(), modelParameters);
+    }
 }
 
 
@@ -127,4 +171,55 @@ void OneHarveyBackgroundModel::predict(RefArrayXd predictions, RefArrayXd const
 
 
 
+// OneHarveyBackgroundModel::predictOnFrequencies()
+//
+// PURPOSE:
+//      Computes the predictions of the model for a given array of frequencies and
+//      response function, which can be either stored arrays or Eigen expressions
+//      generated on the fly.
+//
+// INPUT:
+//      predictions:        one-dimensional array, in either double or single precision,
+//                          to contain the predictions from the model
+//      frequencies:        one-dimensional array expression containing the 
+//                          frequency of each bin
+//      response:           one-dimensional array expression containing the 
+//                          response function of each bin
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model
+//
+// OUTPUT:
+//      void
+//
+// NOTE:
+//      The free parameters are to be given in the same order of predict().
+//
+
+template <typename PredictionArray, typename FrequencyArray, typename ResponseArray>
+void OneHarveyBackgroundModel::predictOnFrequencies(PredictionArray predictions, const Eigen::ArrayBase<FrequencyArray> &frequencies, 
+                                                    const Eigen::ArrayBase<ResponseArray> &response, RefArrayXd const modelParameters)
+{
+    // Initialize global parameters in the same precision of the predictions
+
+    typedef typename PredictionArray::Scalar Scalar;
+    Scalar flatNoiseLevel = modelParameters(0);
+    Scalar amplitudeHarvey1 = modelParameters(1);
+    Scalar frequencyHarvey1 = modelParameters(2);
+    Scalar heightOscillation = modelParameters(3);
+    Scalar nuMax = modelParameters(4);
+    Scalar sigma = modelParameters(5);
 
+
+    // Compute the Harvey components and the Gaussian envelope for the oscillations, modulate them by the
+    // response function (apodization) and add the flat noise component. The Gaussian envelope is first
+    // computed with the vectorized exponential, by using the predictions as temporary storage, then all
+    // the components are combined in a single expression.
+
+    predictions = -1.0*(nuMax - frequencies)*(nuMax - frequencies)/(2.0 * sigma * sigma);
+    VectorKernels::exponential(predictions.data(), predictions.size());
+
+    Scalar zeta = 2.0*sqrt(2.0)/Functions::PI;
+    predictions = (zeta*amplitudeHarvey1*amplitudeHarvey1/(frequencyHarvey1*(1.0 + (frequencies/frequencyHarvey1).square().square()))
+                   + heightOscillation * predictions) * response
+                  + flatNoiseLevel;
+}
@@ -0,0 +1,372 @@
+#include "ParameterSummary.h"
+
+
+// ParameterSummary::ParameterSummary()
+//
+// PURPOSE:
+//      Constructor.
+//
+// INPUT:
+//      Nthreads:       the largest number of threads computing the summary, each one
+//                      processing a subset of the free parameters.
+//
+
+ParameterSummary::ParameterSummary(const int Nthreads)
+: Nthreads(max(Nthreads, 1))
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// ParameterSummary::~ParameterSummary()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+ParameterSummary::~ParameterSummary()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// ParameterSummary::compute()
+//
+// PURPOSE:
+//      Computes the summary statistics and the marginal distribution of each free parameter.
+//      The posterior sample is first transposed, so that the sampling of each parameter is contiguous
+//      in memory, and the parameters are then shared among the threads.
+//
+// INPUT:
+//      posteriorSample:            two-dimensional array containing the posterior sample of the run,
+//                                  with one row for each free parameter and one column for each sampling point.
+//      posteriorProbability:       one-dimensional array containing the posterior probability
+//                                  of each sampling point.
+//      credibleLevel:              the credible level (in percent) of the credible limits.
+//
+// OUTPUT:
+//      void
+//
+
+void ParameterSummary::compute(const ArrayXXd &posteriorSample, const ArrayXd &posteriorProbability, const double credibleLevel)
+{
+    if ((posteriorSample.cols() == 0) || (posteriorSample.cols() != posteriorProbability.size()))
+    {
+        cerr << "Cannot compute the parameter summary from an empty posterior sample." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    int Ndimensions = posteriorSample.rows();
+    ArrayXXd sampleColumns = posteriorSample.transpose();
+    ArrayXd weights = posteriorProbability / posteriorProbability.sum();
+
+    summary.resize(Ndimensions, 7);
+    marginalDistributions.assign(Ndimensions, ArrayXXd());
+
+    auto summarizeParameters = [&](const int thread, const int NactiveThreads)
+    {
+        for (int parameter = thread; parameter < Ndimensions; parameter += NactiveThreads)
+        {
+            summarizeParameter(parameter, sampleColumns.col(parameter).data(), weights, credibleLevel);
+        }
+    };
+
+    int NactiveThreads = min(Nthreads, Ndimensions);
+    vector<thread> threads;
+
+    for (int thread = 0; thread < NactiveThreads; ++thread)
+    {
+        threads.push_back(std::thread(summarizeParameters, thread, NactiveThreads));
+    }
+
+    for (size_t thread = 0; thread < threads.size(); ++thread)
+    {
+        threads[thread].join();
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// ParameterSummary::getSummary()
+//
+// PURPOSE:
+//      Gets the summary statistics of the free parameters.
+//
+// OUTPUT:
+//      A two-dimensional array with one row for each free parameter, containing the expectation,
+//      the median, the mode, the second central moment, the lower and upper credible limits and the 
+//      skewness, in the same order of the columns of the file parameterSummary.txt written by DIAMONDS.
+//
+
+ArrayXXd ParameterSummary::getSummary()
+{
+    return summary;
+}
+
+
+
+
+
+
+
+
+
+
+// ParameterSummary::getMarginalDistribution()
+//
+// PURPOSE:
+//      Gets the marginal distribution of a free parameter.
+//
+// INPUT:
+//      parameter:      the number of the free parameter, starting from 0.
+//
+// OUTPUT:
+//      A two-dimensional array containing the central value of each bin of the parameter
+//      in its first column, and the marginal probability of the bin in its second column.
+//
+
+ArrayXXd ParameterSummary::getMarginalDistribution(const int parameter)
+{
+    return marginalDistributions[parameter];
+}
+
+
+
+
+
+
+
+
+
+
+// ParameterSummary::weightedQuantile()
+//
+// PURPOSE:
+//      Finds the quantile of a weighted sample by means of a selection algorithm. At each step,
+//      the values are partially ordered around their middle element, and the search continues
+//      in the half containing the quantile, so that the number of operations scales linearly
+//      with the size of the sample instead of requiring a full sort.
+//
+// INPUT:
+//      sample:             a vector of pairs containing each value and its weight. The order
+//                          of its elements is changed.
+//      probability:        the fraction of the total weight up to the quantile, between 0 and 1.
+//
+// OUTPUT:
+//      The smallest value of the sample for which the cumulative weight, including the value itself,
+//      is at least the given fraction of the total weight.
+//
+
+double ParameterSummary::weightedQuantile(vector<pair<double, double> > &sample, const double probability)
+{
+    double totalWeight = 0.0;
+
+    for (size_t i = 0; i < sample.size(); ++i)
+    {
+        totalWeight += sample[i].second;
+    }
+
+    double targetWeight = probability * totalWeight;
+    auto first = sample.begin();
+    auto last = sample.end();
+
+    while (last - first > 1)
+    {
+        auto middle = first + (last - first) / 2;
+        nth_element(first, middle, last);
+
+        double lowerWeight = 0.0;
+
+        for (auto element = first; element != middle; ++element)
+        {
+            lowerWeight += element->second;
+        }
+
+        if (lowerWeight >= targetWeight)
+        {
+            last = middle;
+        }
+        else
+        {
+            targetWeight -= lowerWeight;
+            first = middle;
+        }
+    }
+
+    return first->first;
+}
+
+
+
+
+
+
+
+
+
+
+// ParameterSummary::summarizeParameter()
+//
+// PURPOSE:
+//      Computes the summary statistics and the marginal distribution of a single free parameter.
+//      The expectation and the range of the parameter are computed in a first pass over its sampling,
+//      and the central moments and the histogram of the marginal distribution in a second one.
+//      The number of bins of the marginal distribution is the square root of the number of sampling
+//      points. The mode is the central value of the bin with the largest marginal probability, and the
+//      credible region is built from this bin by adding, at each step, the adjacent bin with the
+//      largest probability until the credible level is reached. The excess probability of the last bin
+//      added is then removed by assuming a uniform distribution within that bin.
+//
+// INPUT:
+//      parameter:          the number of the free parameter, starting from 0.
+//      values:             a pointer to the contiguous sampling of the free parameter.
+//      weights:            one-dimensional array containing the normalized posterior probability
+//                          of each sampling point.
+//      credibleLevel:      the credible level (in percent) of the credible limits.
+//
+// OUTPUT:
+//      void
+//
+
+void ParameterSummary::summarizeParameter(const int parameter, const double *values, const ArrayXd &weights,
+                                          const double credibleLevel)
+{
+    long Nsamples = weights.size();
+
+
+    // First pass: range and expectation
+
+    double minValue = values[0];
+    double maxValue = values[0];
+    double expectation = 0.0;
+
+    for (long i = 0; i < Nsamples; ++i)
+    {
+        minValue = min(minValue, values[i]);
+        maxValue = max(maxValue, values[i]);
+        expectation += weights(i) * values[i];
+    }
+
+
+    // Second pass: central moments and histogram of the marginal distribution
+
+    int Nbins = max(1, static_cast<int>(ceil(sqrt(static_cast<double>(Nsamples)))));
+    double binWidth = (maxValue - minValue) / Nbins;
+    ArrayXd marginalDistribution = ArrayXd::Zero(Nbins);
+    double secondMoment = 0.0;
+    double thirdMoment = 0.0;
+
+    for (long i = 0; i < Nsamples; ++i)
+    {
+        double deviation = values[i] - expectation;
+        double squaredDeviation = deviation * deviation;
+        secondMoment += weights(i) * squaredDeviation;
+        thirdMoment += weights(i) * squaredDeviation * deviation;
+
+        int bin = (binWidth > 0.0) ? min(static_cast<int>((values[i] - minValue) / binWidth), Nbins - 1) : 0;
+        marginalDistribution(bin) += weights(i);
+    }
+
+    double skewness = (secondMoment > 0.0) ? thirdMoment / pow(secondMoment, 1.5) : 0.0;
+
+
+    // Median, by weighted selection on the sampling
+
+    vector<pair<double, double> > sample(Nsamples);
+
+    for (long i = 0; i < Nsamples; ++i)
+    {
+        sample[i] = make_pair(values[i], weights(i));
+    }
+
+    double median = weightedQuantile(sample, 0.5);
+
+
+    // Mode and credible limits, from the marginal distribution
+
+    int modeBin;
+    marginalDistribution.maxCoeff(&modeBin);
+    double mode = minValue + (modeBin + 0.5) * binWidth;
+
+    double credibleProbability = credibleLevel / 100.0;
+    double probability = marginalDistribution(modeBin);
+    int lowerBin = modeBin;
+    int upperBin = modeBin;
+    bool lastBinIsLower = true;
+
+    while ((probability < credibleProbability) && ((lowerBin > 0) || (upperBin < Nbins - 1)))
+    {
+        double lowerProbability = (lowerBin > 0) ? marginalDistribution(lowerBin - 1) : -1.0;
+        double upperProbability = (upperBin < Nbins - 1) ? marginalDistribution(upperBin + 1) : -1.0;
+        lastBinIsLower = (lowerProbability >= upperProbability);
+
+        if (lastBinIsLower)
+        {
+            --lowerBin;
+            probability += lowerProbability;
+        }
+        else
+        {
+            ++upperBin;
+            probability += upperProbability;
+        }
+    }
+
+    double lowerCredibleLimit = minValue + lowerBin * binWidth;
+    double upperCredibleLimit = minValue + (upperBin + 1) * binWidth;
+    double excessProbability = probability - credibleProbability;
+
+    if (excessProbability > 0.0)
+    {
+        if (lowerBin == upperBin)
+        {
+            double excessWidth = binWidth * excessProbability / marginalDistribution(modeBin);
+            lowerCredibleLimit += 0.5 * excessWidth;
+            upperCredibleLimit -= 0.5 * excessWidth;
+        }
+        else if (lastBinIsLower)
+        {
+            lowerCredibleLimit += binWidth * excessProbability / marginalDistribution(lowerBin);
+        }
+        else
+        {
+            upperCredibleLimit -= binWidth * excessProbability / marginalDistribution(upperBin);
+        }
+    }
+
+    summary(parameter, 0) = expectation;
+    summary(parameter, 1) = median;
+    summary(parameter, 2) = mode;
+    summary(parameter, 3) = secondMoment;
+    summary(parameter, 4) = lowerCredibleLimit;
+    summary(parameter, 5) = upperCredibleLimit;
+    summary(parameter, 6) = skewness;
+
+    ArrayXXd marginal(Nbins, 2);
+    marginal.col(0) = minValue + (ArrayXd::LinSpaced(Nbins, 0, Nbins - 1) + 0.5) * binWidth;
+    marginal.col(1) = marginalDistribution;
+    marginalDistributions[parameter] = marginal;
+}
@@ -0,0 +1,329 @@
+#include "PredictiveBands.h"
+
+
+// PredictiveBands::PredictiveBands()
+//
+// PURPOSE:
+//      Constructor. Creates the background model on the frequencies where the bands are computed.
+//      The curves are the total model, the background alone, i.e. the total model without the
+//      Gaussian envelope, and each additive component of the model.
+//
+// INPUT:
+//      backgroundModelName:    the string containing the reference name of the background model.
+//      frequencies:            one-dimensional array containing the frequencies where the bands
+//                              are computed (muHz).
+//      NyquistFrequency:       the Nyquist frequency of the dataset (muHz), used in the response function.
+//      Nthreads:               the number of threads evaluating the model.
+//
+
+PredictiveBands::PredictiveBands(const string backgroundModelName, const RefArrayXd frequencies, const double NyquistFrequency,
+                                 const int Nthreads)
+: frequencies(frequencies),
+  Nthreads(max(Nthreads, 1))
+{
+    model = BackgroundModelRegistry::createModel(backgroundModelName, this->frequencies, "");
+
+    if (model == nullptr)
+    {
+        cerr << "Background model " << backgroundModelName << " is not implemented." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    model->setNyquistFrequency(NyquistFrequency);
+
+    vector<string> componentNames = model->getComponentNames();
+    curveNames.push_back("total");
+    curveNames.push_back("background");
+    curveNames.insert(curveNames.end(), componentNames.begin(), componentNames.end());
+}
+
+
+
+
+
+
+
+
+
+
+// PredictiveBands::~PredictiveBands()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+PredictiveBands::~PredictiveBands()
+{
+    delete model;
+}
+
+
+
+
+
+
+
+
+
+
+// PredictiveBands::compute()
+//
+// PURPOSE:
+//      Computes the median and the credible band of each curve at each frequency. The posterior
+//      sample is first resampled into a set of equally-weighted draws according to the posterior
+//      probability of each sampling point. The draws are then evaluated in parallel, each thread
+//      taking a subset of them, and the quantiles of each frequency are computed in parallel as well.
+//
+// INPUT:
+//      posteriorSample:        two-dimensional array containing the posterior sample of the run,
+//                              with one row for each free parameter and one column for each sampling point.
+//      logWeights:             one-dimensional array containing the natural logarithm of the weight
+//                              of each sampling point, i.e. the posterior probability up to a constant.
+//      Ndraws:                 the number of equally-weighted draws used to compute the bands.
+//      credibleLevel:          the credible level of the bands, in percentage (e.g. 68.3).
+//
+// OUTPUT:
+//      void
+//
+
+void PredictiveBands::compute(const ArrayXXd &posteriorSample, const ArrayXd &logWeights, const int Ndraws, const double credibleLevel)
+{
+    if ((Ndraws < 1) || (posteriorSample.cols() == 0) || (posteriorSample.cols() != logWeights.size()))
+    {
+        cerr << "Cannot compute the predictive bands from an empty posterior sample." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    vector<long> drawIndices = resample(logWeights, Ndraws);
+    long Nbins = frequencies.size();
+    int Ncurves = curveNames.size();
+    int Ncomponents = Ncurves - 2;
+    vector<string> componentNames = model->getComponentNames();
+
+
+    // Evaluate the model on the draws. The values of each curve are stored with one column for each
+    // frequency, so that the values of all the draws at the same frequency are contiguous in memory.
+
+    vector<ArrayXXd> curveDraws(Ncurves, ArrayXXd(Ndraws, Nbins));
+
+    auto evaluateDraws = [&](const int thread)
+    {
+        ArrayXd predictions(Nbins);
+        ArrayXXd componentPredictions(Nbins, Ncomponents);
+        ArrayXd parameters;
+
+        for (int draw = thread; draw < Ndraws; draw += Nthreads)
+        {
+            parameters = posteriorSample.col(drawIndices[draw]);
+            model->predictComponents(predictions, componentPredictions, parameters);
+            curveDraws[0].row(draw) = predictions.transpose();
+            curveDraws[1].row(draw).setZero();
+
+            for (int component = 0; component < Ncomponents; ++component)
+            {
+                curveDraws[component + 2].row(draw) = componentPredictions.col(component).transpose();
+
+                if (componentNames[component] != "envelope")
+                {
+                    curveDraws[1].row(draw) += componentPredictions.col(component).transpose();
+                }
+            }
+        }
+    };
+
+
+    // Compute the median and the limits of the credible band of each curve at each frequency
+
+    double lowerProbability = (1.0 - credibleLevel / 100.0) / 2.0;
+    double upperProbability = (1.0 + credibleLevel / 100.0) / 2.0;
+    long medianPosition = lround(0.5 * (Ndraws - 1));
+    long lowerPosition = lround(lowerProbability * (Ndraws - 1));
+    long upperPosition = lround(upperProbability * (Ndraws - 1));
+    bands.assign(Ncurves, ArrayXXd(Nbins, 3));
+
+    auto computeQuantiles = [&](const int thread)
+    {
+        for (int curve = 0; curve < Ncurves; ++curve)
+        {
+            for (long bin = thread; bin < Nbins; bin += Nthreads)
+            {
+                double *values = curveDraws[curve].col(bin).data();
+                nth_element(values, values + medianPosition, values + Ndraws);
+                bands[curve](bin, 0) = values[medianPosition];
+                nth_element(values, values + lowerPosition, values + medianPosition);
+                bands[curve](bin, 1) = values[lowerPosition];
+                nth_element(values + medianPosition, values + upperPosition, values + Ndraws);
+                bands[curve](bin, 2) = values[upperPosition];
+            }
+        }
+    };
+
+    vector<thread> threads;
+
+    for (int thread = 0; thread < Nthreads; ++thread)
+    {
+        threads.push_back(std::thread(evaluateDraws, thread));
+    }
+
+    for (size_t thread = 0; thread < threads.size(); ++thread)
+    {
+        threads[thread].join();
+    }
+
+    threads.clear();
+
+    for (int thread = 0; thread < Nthreads; ++thread)
+    {
+        threads.push_back(std::thread(computeQuantiles, thread));
+    }
+
+    for (size_t thread = 0; thread < threads.size(); ++thread)
+    {
+        threads[thread].join();
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// PredictiveBands::writeToFile()
+//
+// PURPOSE:
+//      Writes the bands into a .npz file, i.e. a ZIP archive of .npy files that is read by the
+//      load function of numpy. The archive contains the array frequency, and one array for each
+//      curve, named after the curve, with the median, the lower and the upper limit of the credible
+//      band in its three columns.
+//
+// INPUT:
+//      fileName:       a string specifying the full path (filename included) of the output file.
+//
+// OUTPUT:
+//      void
+//
+
+void PredictiveBands::writeToFile(const string fileName)
+{
+    if (bands.empty())
+    {
+        cerr << "The predictive bands have not been computed." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    vector<string> entryNames;
+    vector<string> contents;
+    entryNames.push_back("frequency.npy");
+    contents.push_back(NpyFile::arrayXXdToString(frequencies));
+
+    for (size_t curve = 0; curve < curveNames.size(); ++curve)
+    {
+        entryNames.push_back(curveNames[curve] + ".npy");
+        contents.push_back(NpyFile::arrayXXdToString(bands[curve]));
+    }
+
+    ResultsArchive::writeArchive(fileName, entryNames, contents);
+}
+
+
+
+
+
+
+
+
+
+
+// PredictiveBands::getCurveNames()
+//
+// PURPOSE:
+//      Gets the names of the curves for which the bands are computed.
+//
+// OUTPUT:
+//      A vector of strings containing total, background and the names of the components of the model.
+//
+
+vector<string> PredictiveBands::getCurveNames()
+{
+    return curveNames;
+}
+
+
+
+
+
+
+
+
+
+
+// PredictiveBands::getBand()
+//
+// PURPOSE:
+//      Gets the band of one curve.
+//
+// INPUT:
+//      curve:      the position of the curve, in the order of getCurveNames().
+//
+// OUTPUT:
+//      A two-dimensional array containing the median, the lower and the upper limit of the
+//      credible band in its three columns, with one row for each frequency.
+//
+
+ArrayXXd PredictiveBands::getBand(const int curve)
+{
+    return bands[curve];
+}
+
+
+
+
+
+
+
+
+
+
+// PredictiveBands::resample()
+//
+// PURPOSE:
+//      Draws a set of equally-weighted sampling points from a weighted sample, by means of
+//      systematic resampling, which selects each point a number of times proportional to its weight.
+//      The draws are deterministic, so that the bands of a run can be reproduced.
+//
+// INPUT:
+//      logWeights:     one-dimensional array containing the natural logarithm of the weight
+//                      of each sampling point.
+//      Ndraws:         the number of draws.
+//
+// OUTPUT:
+//      A vector containing the index of the sampling point selected by each draw.
+//
+
+vector<long> PredictiveBands::resample(const ArrayXd &logWeights, const int Ndraws)
+{
+    ArrayXd weights = (logWeights - logWeights.maxCoeff()).exp();
+    double cumulativeWeight = 0.0;
+    double totalWeight = weights.sum();
+    vector<long> drawIndices(Ndraws);
+    long index = 0;
+
+    for (int draw = 0; draw < Ndraws; ++draw)
+    {
+        double threshold = (draw + 0.5) / Ndraws * totalWeight;
+
+        while ((index < weights.size() - 1) && (cumulativeWeight + weights(index) < threshold))
+        {
+            cumulativeWeight += weights(index);
+            ++index;
+        }
+
+        drawIndices[draw] = index;
+    }
+
+    return drawIndices;
+}
@@ -0,0 +1,562 @@
+#include "PreviousRun.h"
+
+
+// PreviousRun::PreviousRun()
+//
+// PURPOSE:
+//      Constructor. Reads the posterior sample, the evidence, the uniform priors and the
+//      settings of the dataset of the run, also from the archive of its results (see ArchivedRun).
+//
+// INPUT:
+//      runPathPrefix:      a string containing the output path prefix of the run.
+//
+
+PreviousRun::PreviousRun(const string runPathPrefix)
+: runPathPrefix(runPathPrefix)
+{
+    ArchivedRun archivedRun(runPathPrefix);
+    string filePathPrefix = archivedRun.getPathPrefix();
+    ArrayXXd sampleColumns = BackgroundResults::readSampleColumns(filePathPrefix);
+    int Ndimensions = sampleColumns.cols() - 3;
+    posteriorSample = sampleColumns.leftCols(Ndimensions).transpose();
+    logLikelihoodOfPosteriorSample = sampleColumns.col(Ndimensions);
+    logWeightOfPosteriorSample = sampleColumns.col(Ndimensions + 1);
+
+    ifstream inputFile;
+    unsigned long Nrows;
+    int Ncols;
+
+    File::openInputFile(inputFile, filePathPrefix + "evidenceInformation.txt");
+    File::sniffFile(inputFile, Nrows, Ncols);
+    ArrayXXd evidenceInformation = File::arrayXXdFromFile(inputFile, Nrows, Ncols);
+    inputFile.close();
+
+    logEvidence = evidenceInformation(0, 0);
+    logEvidenceError = evidenceInformation(0, 1);
+    informationGain = evidenceInformation(0, 2);
+
+
+    // The priors of the run are available only if they were uniform
+
+    if (ifstream(filePathPrefix + "hyperParametersUniform.txt").good())
+    {
+        File::openInputFile(inputFile, filePathPrefix + "hyperParametersUniform.txt");
+        File::sniffFile(inputFile, Nrows, Ncols);
+        ArrayXXd hyperParameters = File::arrayXXdFromFile(inputFile, Nrows, Ncols);
+        inputFile.close();
+
+        priorMinima = hyperParameters.col(0);
+        priorMaxima = hyperParameters.col(1);
+    }
+
+    readComputationParameters(filePathPrefix);
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::PreviousRun()
+//
+// PURPOSE:
+//      Constructor. Sets the results of a run held in memory. The priors of the run are those given,
+//      if uniform, while the settings of the dataset are not set.
+//
+// INPUT:
+//      ptrPriors:                          vector of pointers to the priors of the run.
+//      posteriorSample:                    two-dimensional array of size (Ndimensions, Nsamples) containing
+//                                          the posterior sample.
+//      logLikelihoodOfPosteriorSample:     one-dimensional array containing the log-likelihood of each sampling point.
+//      logWeightOfPosteriorSample:         one-dimensional array containing the log-weight of each sampling point.
+//      logEvidence:                        the natural logarithm of the evidence.
+//      logEvidenceError:                   the error on the log-evidence.
+//      informationGain:                    the information gain in natural units.
+//
+
+PreviousRun::PreviousRun(vector<Prior*> ptrPriors, const ArrayXXd &posteriorSample, const ArrayXd &logLikelihoodOfPosteriorSample,
+                         const ArrayXd &logWeightOfPosteriorSample, const double logEvidence, const double logEvidenceError, 
+                         const double informationGain)
+: posteriorSample(posteriorSample),
+  logLikelihoodOfPosteriorSample(logLikelihoodOfPosteriorSample),
+  logWeightOfPosteriorSample(logWeightOfPosteriorSample),
+  logEvidence(logEvidence),
+  logEvidenceError(logEvidenceError),
+  informationGain(informationGain),
+  lowFrequencyThreshold(0.0),
+  highFrequencyThreshold(0.0),
+  rebinningMode("none")
+{
+    if (!getUniformPriorRanges(ptrPriors, priorMinima, priorMaxima))
+    {
+        priorMinima.resize(0);
+        priorMaxima.resize(0);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::~PreviousRun()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+PreviousRun::~PreviousRun()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::getRunPathPrefix()
+//
+// PURPOSE:
+//      Gets the output path prefix of the run.
+//
+// OUTPUT:
+//      A string containing the output path prefix.
+//
+
+string PreviousRun::getRunPathPrefix()
+{
+    return runPathPrefix;
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::getPosteriorSample()
+//
+// PURPOSE:
+//      Gets the posterior sample of the run.
+//
+// OUTPUT:
+//      A two-dimensional array of size (Ndimensions, Nsamples) containing the posterior sample.
+//
+
+ArrayXXd PreviousRun::getPosteriorSample()
+{
+    return posteriorSample;
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::getLogLikelihoodOfPosteriorSample()
+//
+// PURPOSE:
+//      Gets the log-likelihood of the posterior sample of the run.
+//
+// OUTPUT:
+//      A one-dimensional array containing the log-likelihood of each sampling point.
+//
+
+ArrayXd PreviousRun::getLogLikelihoodOfPosteriorSample()
+{
+    return logLikelihoodOfPosteriorSample;
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::getLogWeightOfPosteriorSample()
+//
+// PURPOSE:
+//      Gets the nested sampling log-weights of the posterior sample of the run.
+//
+// OUTPUT:
+//      A one-dimensional array containing the log-weight of each sampling point.
+//
+
+ArrayXd PreviousRun::getLogWeightOfPosteriorSample()
+{
+    return logWeightOfPosteriorSample;
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::getLogEvidence()
+//
+// PURPOSE:
+//      Gets the natural logarithm of the evidence of the run.
+//
+// OUTPUT:
+//      The log-evidence.
+//
+
+double PreviousRun::getLogEvidence()
+{
+    return logEvidence;
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::getLogEvidenceError()
+//
+// PURPOSE:
+//      Gets the error on the natural logarithm of the evidence of the run.
+//
+// OUTPUT:
+//      The error on the log-evidence.
+//
+
+double PreviousRun::getLogEvidenceError()
+{
+    return logEvidenceError;
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::getInformationGain()
+//
+// PURPOSE:
+//      Gets the information gain of the run.
+//
+// OUTPUT:
+//      The information gain in natural units.
+//
+
+double PreviousRun::getInformationGain()
+{
+    return informationGain;
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::getLowFrequencyThreshold()
+//
+// PURPOSE:
+//      Gets the low-frequency threshold of the run.
+//
+// OUTPUT:
+//      The low-frequency threshold in muHz, 0 if not used.
+//
+
+double PreviousRun::getLowFrequencyThreshold()
+{
+    return lowFrequencyThreshold;
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::getHighFrequencyThreshold()
+//
+// PURPOSE:
+//      Gets the high-frequency threshold of the run.
+//
+// OUTPUT:
+//      The high-frequency threshold in muHz, 0 if not used.
+//
+
+double PreviousRun::getHighFrequencyThreshold()
+{
+    return highFrequencyThreshold;
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::getBackgroundModelName()
+//
+// PURPOSE:
+//      Gets the name of the background model of the run.
+//
+// OUTPUT:
+//      A string containing the name of the background model.
+//
+
+string PreviousRun::getBackgroundModelName()
+{
+    return backgroundModelName;
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::getRebinningMode()
+//
+// PURPOSE:
+//      Gets the rebinning mode of the dataset of the run.
+//
+// OUTPUT:
+//      A string containing the rebinning mode (none / factor / logarithmic).
+//
+
+string PreviousRun::getRebinningMode()
+{
+    return rebinningMode;
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::getLogPriorRatio()
+//
+// PURPOSE:
+//      Computes the natural logarithm of the ratio of a set of uniform priors to the uniform priors
+//      of the run, within the range of the former. The posterior sample of the run can be reweighted
+//      to the new priors only if their ranges are contained in those of the run, since the rest of the
+//      new prior volume was never sampled.
+//
+// INPUT:
+//      ptrPriors:      vector of pointers to the new priors.
+//      minima:         one-dimensional array to contain the minima of the new priors.
+//      maxima:         one-dimensional array to contain the maxima of the new priors.
+//
+// OUTPUT:
+//      The log-ratio of the new priors to the priors of the run, or NaN if the new priors are
+//      not uniform or extend beyond the priors of the run.
+//
+
+double PreviousRun::getLogPriorRatio(vector<Prior*> ptrPriors, ArrayXd &minima, ArrayXd &maxima)
+{
+    if (!getUniformPriorRanges(ptrPriors, minima, maxima) || (minima.size() != posteriorSample.rows())
+        || (priorMinima.size() != minima.size()) || (minima < priorMinima).any() || (maxima > priorMaxima).any())
+    {
+        return numeric_limits<double>::quiet_NaN();
+    }
+
+    return (priorMaxima - priorMinima).log().sum() - (maxima - minima).log().sum();
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::getUniformPriorRanges()
+//
+// PURPOSE:
+//      Collects the ranges of a set of uniform priors, in the order of the free parameters.
+//
+// INPUT:
+//      ptrPriors:      vector of pointers to the priors.
+//      minima:         one-dimensional array to contain the minima of the priors.
+//      maxima:         one-dimensional array to contain the maxima of the priors.
+//
+// OUTPUT:
+//      True if all the priors are uniform, false otherwise.
+//
+
+bool PreviousRun::getUniformPriorRanges(vector<Prior*> ptrPriors, ArrayXd &minima, ArrayXd &maxima)
+{
+    int Ndimensions = 0;
+
+    for (size_t prior = 0; prior < ptrPriors.size(); ++prior)
+    {
+        Ndimensions += ptrPriors[prior]->getNdimensions();
+    }
+
+    minima.resize(Ndimensions);
+    maxima.resize(Ndimensions);
+    int firstDimension = 0;
+
+    for (size_t prior = 0; prior < ptrPriors.size(); ++prior)
+    {
+        UniformPrior *uniformPrior = dynamic_cast<UniformPrior*>(ptrPriors[prior]);
+
+        if (uniformPrior == nullptr)
+        {
+            return false;
+        }
+
+        int NpriorDimensions = uniformPrior->getNdimensions();
+        minima.segment(firstDimension, NpriorDimensions) = uniformPrior->getMinima();
+        maxima.segment(firstDimension, NpriorDimensions) = uniformPrior->getMaxima();
+        firstDimension += NpriorDimensions;
+    }
+
+    return true;
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::computeEffectiveSampleSize()
+//
+// PURPOSE:
+//      Computes the effective sample size of a weighted sample.
+//
+// INPUT:
+//      logWeights:     one-dimensional array containing the natural logarithm of the weights.
+//
+// OUTPUT:
+//      The effective sample size, i.e. the squared sum of the weights divided by the sum of the squared weights.
+//
+
+double PreviousRun::computeEffectiveSampleSize(const ArrayXd &logWeights)
+{
+    ArrayXd weights = (logWeights - logWeights.maxCoeff()).exp();
+
+    return weights.sum() * weights.sum() / weights.square().sum();
+}
+
+
+
+
+
+
+
+
+
+
+// PreviousRun::readComputationParameters()
+//
+// PURPOSE:
+//      Reads the rebinning mode, the frequency thresholds and the background model of the run
+//      from its file of computation parameters, where each group of values follows its header.
+//
+// INPUT:
+//      filePathPrefix:     a string containing the path prefix of the output files of the run,
+//                          which differs from that of the run if they are read from its archive.
+//
+// OUTPUT:
+//      void
+//
+
+void PreviousRun::readComputationParameters(const string filePathPrefix)
+{
+    ifstream inputFile;
+    File::openInputFile(inputFile, filePathPrefix + "computationParameters.txt");
+
+    vector<string> rebinningRows;
+    vector<string> otherRows;
+    vector<string> *currentRows = nullptr;
+    string line;
+
+    while (getline(inputFile, line))
+    {
+        if (line == "# Rebinning of the dataset")
+        {
+            currentRows = &rebinningRows;
+        }
+        else if (line == "# Other information on the run")
+        {
+            currentRows = &otherRows;
+        }
+        else if (!line.empty() && (line[0] == '#'))
+        {
+            if (line.compare(0, 7, "# Row #") != 0)
+            {
+                currentRows = nullptr;
+            }
+        }
+        else if (currentRows != nullptr)
+        {
+            currentRows->push_back(line);
+        }
+    }
+
+    inputFile.close();
+
+    if ((rebinningRows.size() < 1) || (otherRows.size() < 6))
+    {
+        cerr << "Incomplete computation parameters of the run with prefix " << runPathPrefix << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    rebinningMode = rebinningRows[0];
+    lowFrequencyThreshold = stod(otherRows[0]);
+    highFrequencyThreshold = stod(otherRows[1]);
+    backgroundModelName = otherRows[5];
+}
@@ -0,0 +1,202 @@
+#include "RacingSampler.h"
+
+
+// RacingSampler::RacingSampler()
+//
+// PURPOSE:
+//      Constructor. The inputs are the same of the multi-ellipsoidal sampler, with in addition:
+//
+// INPUT:
+//      evidenceRace:           a pointer to the evidence race of the run, or nullptr if the run is not racing.
+//      NiterationsPerUpdate:   the number of nested iterations between two updates of the race board.
+//
+
+RacingSampler::RacingSampler(const bool printOnTheScreen, vector<Prior*> ptrPriors, Likelihood &likelihood, Metric &metric, 
+                             Clusterer &clusterer, const int initialNlivePoints, const int minNlivePoints, 
+                             const double initialEnlargementFraction, const double shrinkingRate, 
+                             EvidenceRace *evidenceRace, const int NiterationsPerUpdate)
+: MultiEllipsoidSampler(printOnTheScreen, ptrPriors, likelihood, metric, clusterer, initialNlivePoints, minNlivePoints, 
+                        initialEnlargementFraction, shrinkingRate),
+  evidenceRace(evidenceRace),
+  NiterationsPerUpdate(max(NiterationsPerUpdate, 1)),
+  lastUpdateIteration(0),
+  aborted(false)
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// RacingSampler::~RacingSampler()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+RacingSampler::~RacingSampler()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// RacingSampler::drawWithConstraint()
+//
+// PURPOSE:
+//      Draws a new point with a likelihood larger than the given constraint, as the multi-ellipsoidal
+//      sampler does, unless the run is dominated in the evidence race, in which case no point is drawn.
+//
+// INPUT:
+//      The same of MultiEllipsoidSampler::drawWithConstraint().
+//
+// OUTPUT:
+//      True if a new point is drawn, false if the drawing failed or the run is dominated.
+//
+
+bool RacingSampler::drawWithConstraint(const RefArrayXXd totalSample, const unsigned int Nclusters, const vector<int> &clusterIndices,
+                                       const vector<int> &clusterSizes, RefArrayXd drawnPoint, 
+                                       double &logLikelihoodOfDrawnPoint, const int maxNdrawAttempts)
+{
+    if (aborted)
+    {
+        return false;
+    }
+
+    if ((evidenceRace != nullptr) && (Niterations >= lastUpdateIteration + NiterationsPerUpdate))
+    {
+        lastUpdateIteration = Niterations;
+
+        if (evidenceRace->isDominated(getLowerLogEvidence(), getUpperLogEvidence(), Niterations))
+        {
+            EvidenceRace::Entry leader = evidenceRace->getLeader();
+            aborted = true;
+
+            cerr << " Run dominated by run " << leader.runNumber << " (" << leader.backgroundModelName 
+                 << ") in the evidence race: stopped at iteration " << Niterations << "." << endl;
+
+            return false;
+        }
+    }
+
+    return MultiEllipsoidSampler::drawWithConstraint(totalSample, Nclusters, clusterIndices, clusterSizes, drawnPoint,
+                                                     logLikelihoodOfDrawnPoint, maxNdrawAttempts);
+}
+
+
+
+
+
+
+
+
+
+
+// RacingSampler::setEvidenceRace()
+//
+// PURPOSE:
+//      Enters the sampler into an evidence race after its construction, e.g. once it is known
+//      that the run is not replaced by a refit of a previous run. It must be called before the run starts.
+//
+// INPUT:
+//      newEvidenceRace:    a pointer to the evidence race of the run, or nullptr if the run is not racing.
+//
+// OUTPUT:
+//      void
+//
+
+void RacingSampler::setEvidenceRace(EvidenceRace *newEvidenceRace)
+{
+    evidenceRace = newEvidenceRace;
+}
+
+
+
+
+
+
+
+
+
+
+// RacingSampler::isAborted()
+//
+// PURPOSE:
+//      Checks whether the run was stopped because dominated in the evidence race.
+//
+// OUTPUT:
+//      True if the run was stopped, false otherwise.
+//
+
+bool RacingSampler::isAborted()
+{
+    return aborted;
+}
+
+
+
+
+
+
+
+
+
+
+// RacingSampler::getLowerLogEvidence()
+//
+// PURPOSE:
+//      Gets the lower bound of the log-evidence of the run, namely the evidence accumulated so far,
+//      since the contributions of the following iterations are positive.
+//
+// OUTPUT:
+//      The lower bound of the log-evidence.
+//
+
+double RacingSampler::getLowerLogEvidence()
+{
+    return getLogEvidence();
+}
+
+
+
+
+
+
+
+
+
+
+// RacingSampler::getUpperLogEvidence()
+//
+// PURPOSE:
+//      Gets the upper bound of the log-evidence of the run, namely the evidence accumulated so far plus
+//      the remaining prior mass times the largest likelihood of the live points. This is the usual bound
+//      of the termination condition of the nested sampling, and holds as long as the maximum of the
+//      likelihood is not much larger than that of the live points.
+//
+// OUTPUT:
+//      The upper bound of the log-evidence.
+//
+
+double RacingSampler::getUpperLogEvidence()
+{
+    if (logLikelihood.size() == 0)
+    {
+        return numeric_limits<double>::infinity();
+    }
+
+    return Functions::logExpSum(getLogEvidence(), getLogRemainingPriorMass() + logLikelihood.maxCoeff());
+}
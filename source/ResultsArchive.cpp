@@ -0,0 +1,766 @@
+#include "ResultsArchive.h"
+
+
+// Signatures of the records of a ZIP file
+
+namespace
+{
+    const uint32_t localFileHeaderSignature = 0x04034b50;
+    const uint32_t centralDirectorySignature = 0x02014b50;
+    const uint32_t endOfCentralDirectorySignature = 0x06054b50;
+    const uint16_t versionNeeded = 20;
+    const uint16_t versionMadeBy = (3 << 8) | 20;       // Unix, ZIP specification 2.0
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsArchive::writeArchive()
+//
+// PURPOSE:
+//      Writes all the files of a directory whose name starts with a given prefix into a single
+//      ZIP archive, in alphabetical order. Each file is compressed with the deflate codec, unless
+//      zlib is not available or the compression does not reduce its size, in which case it is stored.
+//      The archive is first written to a temporary file, which is renamed once completed, so that
+//      the original files are only removed if the archive is complete.
+//
+// INPUT:
+//      directoryName:          a string specifying the path of the directory containing the files.
+//      prefix:                 a string specifying the prefix of the names of the files to be archived.
+//      archiveFileName:        a string specifying the name of the archive, within the same directory.
+//      removeArchivedFiles:    a boolean specifying whether the archived files are removed.
+//
+// OUTPUT:
+//      void
+//
+// NOTE:
+//      The archive cannot contain files larger than 4 GB, nor be larger than 4 GB.
+//
+
+void ResultsArchive::writeArchive(const string directoryName, const string prefix, const string archiveFileName,
+                                  const bool removeArchivedFiles)
+{
+    vector<string> fileNames = listFiles(directoryName, prefix);
+    string archivePath = directoryName + "/" + archiveFileName;
+    string temporaryArchivePath = archivePath + ".tmp";
+    fileNames.erase(remove(fileNames.begin(), fileNames.end(), archiveFileName), fileNames.end());
+    fileNames.erase(remove(fileNames.begin(), fileNames.end(), archiveFileName + ".tmp"), fileNames.end());
+    ofstream archiveFile(temporaryArchivePath.c_str(), ios::binary);
+
+    if (!archiveFile.good())
+    {
+        cerr << "Error opening output file " << temporaryArchivePath << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    vector<ArchiveEntry> entries;
+    uint64_t offset = 0;
+
+    for (size_t file = 0; file < fileNames.size(); ++file)
+    {
+        string filePath = directoryName + "/" + fileNames[file];
+        string content = readFile(filePath);
+        struct stat fileStatus;
+        stat(filePath.c_str(), &fileStatus);
+
+        appendEntry(archiveFile, archivePath, fileNames[file], content, fileStatus.st_mtime, entries, offset);
+    }
+
+    finishArchive(archiveFile, archivePath, entries, offset);
+
+    if (removeArchivedFiles)
+    {
+        for (size_t file = 0; file < fileNames.size(); ++file)
+        {
+            remove((directoryName + "/" + fileNames[file]).c_str());
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsArchive::writeArchive()
+//
+// PURPOSE:
+//      Writes a ZIP archive from a list of files held in memory, e.g. the arrays of a .npz file
+//      of numpy, compressing each one as in the previous function. As before, the archive is
+//      first written to a temporary file, which is renamed once completed.
+//
+// INPUT:
+//      archivePath:            a string specifying the full path (filename included) of the archive.
+//      entryNames:             the names of the files within the archive.
+//      contents:               the contents of the files, in the same order of their names.
+//
+// OUTPUT:
+//      void
+//
+
+void ResultsArchive::writeArchive(const string archivePath, const vector<string> &entryNames, const vector<string> &contents)
+{
+    string temporaryArchivePath = archivePath + ".tmp";
+    ofstream archiveFile(temporaryArchivePath.c_str(), ios::binary);
+
+    if (!archiveFile.good())
+    {
+        cerr << "Error opening output file " << temporaryArchivePath << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    vector<ArchiveEntry> entries;
+    uint64_t offset = 0;
+    time_t currentTime = time(nullptr);
+
+    for (size_t entry = 0; entry < entryNames.size(); ++entry)
+    {
+        string content = contents[entry];
+        appendEntry(archiveFile, archivePath, entryNames[entry], content, currentTime, entries, offset);
+    }
+
+    finishArchive(archiveFile, archivePath, entries, offset);
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsArchive::extractArchive()
+//
+// PURPOSE:
+//      Extracts all the files of an archive written by writeArchive(), recreating them
+//      with their original names.
+//
+// INPUT:
+//      archiveFileName:        a string specifying the full path (filename included) of the archive.
+//      outputDirectoryName:    a string specifying the path of the directory where the files are written.
+//
+// OUTPUT:
+//      A vector of strings containing the names of the extracted files.
+//
+
+vector<string> ResultsArchive::extractArchive(const string archiveFileName, const string outputDirectoryName)
+{
+    string archive = readFile(archiveFileName);
+
+
+    // Find the end record of the central directory, searching backwards for its signature
+
+    const size_t endRecordSize = 22;
+    size_t endRecordPosition = string::npos;
+
+    for (size_t position = archive.size() >= endRecordSize ? archive.size() - endRecordSize + 1 : 0; position > 0; --position)
+    {
+        if (readUint32(archive, position - 1) == endOfCentralDirectorySignature)
+        {
+            endRecordPosition = position - 1;
+            break;
+        }
+    }
+
+    if (endRecordPosition == string::npos)
+    {
+        cerr << "File " << archiveFileName << " is not a valid archive." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    uint16_t Nentries = readUint16(archive, endRecordPosition + 10);
+    size_t position = readUint32(archive, endRecordPosition + 16);
+    vector<string> fileNames;
+
+    for (uint16_t file = 0; file < Nentries; ++file)
+    {
+        if ((position + 46 > archive.size()) || (readUint32(archive, position) != centralDirectorySignature))
+        {
+            cerr << "Corrupted table of contents in archive " << archiveFileName << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        ArchiveEntry entry;
+        entry.compressionMethod = readUint16(archive, position + 10);
+        entry.crc = readUint32(archive, position + 16);
+        entry.compressedSize = readUint32(archive, position + 20);
+        entry.uncompressedSize = readUint32(archive, position + 24);
+        uint16_t fileNameLength = readUint16(archive, position + 28);
+        uint16_t extraFieldLength = readUint16(archive, position + 30);
+        uint16_t commentLength = readUint16(archive, position + 32);
+        entry.localHeaderOffset = readUint32(archive, position + 42);
+        entry.fileName = archive.substr(position + 46, fileNameLength);
+        position += 46 + fileNameLength + extraFieldLength + commentLength;
+
+
+        // Only plain file names are accepted, so that no file is written outside the output directory
+
+        if (entry.fileName.empty() || (entry.fileName.find('/') != string::npos) || (entry.fileName.find('\\') != string::npos)
+            || (entry.fileName == ".") || (entry.fileName == ".."))
+        {
+            cerr << "Invalid file name " << entry.fileName << " in archive " << archiveFileName << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        size_t dataPosition = entry.localHeaderOffset + 30;
+
+        if (dataPosition > archive.size())
+        {
+            cerr << "Corrupted archive " << archiveFileName << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        dataPosition += readUint16(archive, entry.localHeaderOffset + 26) + readUint16(archive, entry.localHeaderOffset + 28);
+
+        if (dataPosition + entry.compressedSize > archive.size())
+        {
+            cerr << "Corrupted archive " << archiveFileName << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        string content;
+
+        if (entry.compressionMethod == 0)
+        {
+            content = archive.substr(dataPosition, entry.compressedSize);
+        }
+        else if (entry.compressionMethod == 8)
+        {
+#ifdef BACKGROUND_USE_ZLIB
+            content.resize(entry.uncompressedSize);
+            z_stream stream = z_stream();
+            inflateInit2(&stream, -MAX_WBITS);
+            stream.next_in = reinterpret_cast<Bytef*>(&archive[dataPosition]);
+            stream.avail_in = entry.compressedSize;
+            stream.next_out = reinterpret_cast<Bytef*>(content.empty() ? nullptr : &content[0]);
+            stream.avail_out = entry.uncompressedSize;
+            int status = inflate(&stream, Z_FINISH);
+            inflateEnd(&stream);
+
+            if ((status != Z_STREAM_END) || (stream.total_out != entry.uncompressedSize))
+            {
+                cerr << "Error decompressing " << entry.fileName << " from archive " << archiveFileName << endl;
+                exit(EXIT_FAILURE);
+            }
+#else
+            cerr << "File " << entry.fileName << " of archive " << archiveFileName << " is compressed, "
+                 << "but the code was compiled without zlib support." << endl;
+            exit(EXIT_FAILURE);
+#endif
+        }
+        else
+        {
+            cerr << "Unsupported compression method for " << entry.fileName << " in archive " << archiveFileName << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        if (computeCrc(content) != entry.crc)
+        {
+            cerr << "Checksum mismatch for " << entry.fileName << " in archive " << archiveFileName << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        string outputFileName = outputDirectoryName + "/" + entry.fileName;
+        ofstream outputFile(outputFileName.c_str(), ios::binary);
+        outputFile.write(content.data(), content.size());
+
+        if (!outputFile.good())
+        {
+            cerr << "Error writing output file " << outputFileName << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        fileNames.push_back(entry.fileName);
+    }
+
+    return fileNames;
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsArchive::appendEntry()
+//
+// PURPOSE:
+//      Compresses a file and writes it into the archive, preceded by its local file header.
+//
+// INPUT:
+//      archiveFile:            the output stream of the temporary archive.
+//      archivePath:            the full path of the archive, used in the error messages.
+//      entryName:              the name of the file within the archive.
+//      content:                the content of the file. It is overwritten to save memory.
+//      modificationTime:       the modification time of the file.
+//      entries:                the entries written so far, to which the new entry is added.
+//      offset:                 the current size of the archive, which is updated.
+//
+// OUTPUT:
+//      void
+//
+
+void ResultsArchive::appendEntry(ofstream &archiveFile, const string archivePath, const string entryName, string &content,
+                                 const time_t modificationTime, vector<ArchiveEntry> &entries, uint64_t &offset)
+{
+    string compressedContent;
+
+    ArchiveEntry entry;
+    entry.fileName = entryName;
+    entry.crc = computeCrc(content);
+    entry.uncompressedSize = content.size();
+
+    if ((content.size() > 0xFFFFFFFFULL) || (offset > 0xFFFFFFFFULL))
+    {
+        cerr << "Files are too large to be archived in " << archivePath << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (compress(content, compressedContent) && (compressedContent.size() < content.size()))
+    {
+        entry.compressionMethod = 8;
+    }
+    else
+    {
+        entry.compressionMethod = 0;
+        compressedContent.swap(content);
+    }
+
+    entry.compressedSize = compressedContent.size();
+
+
+    // Modification time of the file, in the MS-DOS format of ZIP files
+
+    struct tm localModificationTime;
+    localtime_r(&modificationTime, &localModificationTime);
+    entry.modificationTime = (localModificationTime.tm_hour << 11) | (localModificationTime.tm_min << 5) | (localModificationTime.tm_sec / 2);
+    entry.modificationDate = ((max(localModificationTime.tm_year - 80, 0)) << 9) | ((localModificationTime.tm_mon + 1) << 5) | localModificationTime.tm_mday;
+    entry.localHeaderOffset = offset;
+
+
+    // Local file header followed by the content of the file
+
+    string header;
+    appendUint32(header, localFileHeaderSignature);
+    appendUint16(header, versionNeeded);
+    appendUint16(header, 0);
+    appendUint16(header, entry.compressionMethod);
+    appendUint16(header, entry.modificationTime);
+    appendUint16(header, entry.modificationDate);
+    appendUint32(header, entry.crc);
+    appendUint32(header, entry.compressedSize);
+    appendUint32(header, entry.uncompressedSize);
+    appendUint16(header, entry.fileName.size());
+    appendUint16(header, 0);
+    header += entry.fileName;
+
+    archiveFile.write(header.data(), header.size());
+    archiveFile.write(compressedContent.data(), compressedContent.size());
+    offset += header.size() + compressedContent.size();
+
+    entries.push_back(entry);
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsArchive::finishArchive()
+//
+// PURPOSE:
+//      Writes the central directory of the archive, i.e. its table of contents, and its end record,
+//      then renames the temporary archive with its final name.
+//
+// INPUT:
+//      archiveFile:            the output stream of the temporary archive, named as the archive 
+//                              followed by the extension .tmp.
+//      archivePath:            the full path of the archive.
+//      entries:                the entries written into the archive.
+//      offset:                 the current size of the archive, i.e. the position of the central directory.
+//
+// OUTPUT:
+//      void
+//
+
+void ResultsArchive::finishArchive(ofstream &archiveFile, const string archivePath, const vector<ArchiveEntry> &entries,
+                                   const uint64_t offset)
+{
+    string centralDirectory;
+
+    for (size_t file = 0; file < entries.size(); ++file)
+    {
+        const ArchiveEntry &entry = entries[file];
+        appendUint32(centralDirectory, centralDirectorySignature);
+        appendUint16(centralDirectory, versionMadeBy);
+        appendUint16(centralDirectory, versionNeeded);
+        appendUint16(centralDirectory, 0);
+        appendUint16(centralDirectory, entry.compressionMethod);
+        appendUint16(centralDirectory, entry.modificationTime);
+        appendUint16(centralDirectory, entry.modificationDate);
+        appendUint32(centralDirectory, entry.crc);
+        appendUint32(centralDirectory, entry.compressedSize);
+        appendUint32(centralDirectory, entry.uncompressedSize);
+        appendUint16(centralDirectory, entry.fileName.size());
+        appendUint16(centralDirectory, 0);
+        appendUint16(centralDirectory, 0);
+        appendUint16(centralDirectory, 0);
+        appendUint16(centralDirectory, 0);
+        appendUint32(centralDirectory, 0100644u << 16);       // Regular file with permissions rw-r--r--
+        appendUint32(centralDirectory, entry.localHeaderOffset);
+        centralDirectory += entry.fileName;
+    }
+
+    if (offset + centralDirectory.size() > 0xFFFFFFFFULL)
+    {
+        cerr << "Files are too large to be archived in " << archivePath << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    uint32_t centralDirectorySize = centralDirectory.size();
+    appendUint32(centralDirectory, endOfCentralDirectorySignature);
+    appendUint16(centralDirectory, 0);
+    appendUint16(centralDirectory, 0);
+    appendUint16(centralDirectory, entries.size());
+    appendUint16(centralDirectory, entries.size());
+    appendUint32(centralDirectory, centralDirectorySize);
+    appendUint32(centralDirectory, offset);
+    appendUint16(centralDirectory, 0);
+
+    archiveFile.write(centralDirectory.data(), centralDirectory.size());
+    archiveFile.close();
+
+    string temporaryArchivePath = archivePath + ".tmp";
+
+    if (!archiveFile.good() || (rename(temporaryArchivePath.c_str(), archivePath.c_str()) != 0))
+    {
+        cerr << "Error writing archive " << archivePath << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsArchive::listFiles()
+//
+// PURPOSE:
+//      Lists the regular files of a directory whose name starts with a given prefix.
+//
+// INPUT:
+//      directoryName:      a string specifying the path of the directory.
+//      prefix:             a string specifying the prefix of the names of the files.
+//
+// OUTPUT:
+//      A vector of strings containing the names of the files, sorted alphabetically.
+//
+
+vector<string> ResultsArchive::listFiles(const string directoryName, const string prefix)
+{
+    DIR *directory = opendir(directoryName.c_str());
+
+    if (directory == nullptr)
+    {
+        cerr << "Error opening directory " << directoryName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    vector<string> fileNames;
+    struct dirent *directoryEntry;
+
+    while ((directoryEntry = readdir(directory)) != nullptr)
+    {
+        string fileName(directoryEntry->d_name);
+        struct stat fileStatus;
+
+        if ((fileName.compare(0, prefix.size(), prefix) == 0) && (stat((directoryName + "/" + fileName).c_str(), &fileStatus) == 0)
+            && S_ISREG(fileStatus.st_mode))
+        {
+            fileNames.push_back(fileName);
+        }
+    }
+
+    closedir(directory);
+    sort(fileNames.begin(), fileNames.end());
+
+    return fileNames;
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsArchive::readFile()
+//
+// PURPOSE:
+//      Reads the whole content of a file.
+//
+// INPUT:
+//      fileName:       a string specifying the full path (filename included) of the file.
+//
+// OUTPUT:
+//      A string containing the bytes of the file.
+//
+
+string ResultsArchive::readFile(const string fileName)
+{
+    ifstream inputFile(fileName.c_str(), ios::binary);
+
+    if (!inputFile.good())
+    {
+        cerr << "Error opening input file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    ostringstream content;
+    content << inputFile.rdbuf();
+
+    return content.str();
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsArchive::computeCrc()
+//
+// PURPOSE:
+//      Computes the CRC-32 checksum of the content of a file, as required by the ZIP format.
+//
+// INPUT:
+//      content:        the bytes of the file.
+//
+// OUTPUT:
+//      The CRC-32 checksum.
+//
+
+uint32_t ResultsArchive::computeCrc(const string &content)
+{
+    static uint32_t table[256];
+    static bool tableIsReady = false;
+
+    if (!tableIsReady)
+    {
+        for (uint32_t byte = 0; byte < 256; ++byte)
+        {
+            uint32_t value = byte;
+
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+            }
+
+            table[byte] = value;
+        }
+
+        tableIsReady = true;
+    }
+
+    uint32_t crc = 0xFFFFFFFFu;
+
+    for (size_t byte = 0; byte < content.size(); ++byte)
+    {
+        crc = table[(crc ^ static_cast<unsigned char>(content[byte])) & 0xFF] ^ (crc >> 8);
+    }
+
+    return crc ^ 0xFFFFFFFFu;
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsArchive::compress()
+//
+// PURPOSE:
+//      Compresses the content of a file with the fastest level of the deflate codec.
+//
+// INPUT:
+//      content:                the bytes of the file.
+//      compressedContent:      the string where the compressed bytes are stored.
+//
+// OUTPUT:
+//      True if the content was compressed, false if zlib is not available.
+//
+
+bool ResultsArchive::compress(const string &content, string &compressedContent)
+{
+#ifdef BACKGROUND_USE_ZLIB
+    z_stream stream = z_stream();
+    deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+
+    compressedContent.resize(deflateBound(&stream, content.size()));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(content.data()));
+    stream.avail_in = content.size();
+    stream.next_out = reinterpret_cast<Bytef*>(&compressedContent[0]);
+    stream.avail_out = compressedContent.size();
+
+    int status = deflate(&stream, Z_FINISH);
+    compressedContent.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    return (status == Z_STREAM_END);
+#else
+    return false;
+#endif
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsArchive::appendUint16()
+//
+// PURPOSE:
+//      Appends an unsigned integer of 2 bytes to a buffer, in little-endian byte order.
+//
+// INPUT:
+//      buffer:     the string where the bytes are appended.
+//      value:      the value to be appended.
+//
+// OUTPUT:
+//      void
+//
+
+void ResultsArchive::appendUint16(string &buffer, const uint16_t value)
+{
+    buffer.push_back(static_cast<char>(value & 0xFF));
+    buffer.push_back(static_cast<char>(value >> 8));
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsArchive::appendUint32()
+//
+// PURPOSE:
+//      Appends an unsigned integer of 4 bytes to a buffer, in little-endian byte order.
+//
+// INPUT:
+//      buffer:     the string where the bytes are appended.
+//      value:      the value to be appended.
+//
+// OUTPUT:
+//      void
+//
+
+void ResultsArchive::appendUint32(string &buffer, const uint32_t value)
+{
+    appendUint16(buffer, value & 0xFFFF);
+    appendUint16(buffer, value >> 16);
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsArchive::readUint16()
+//
+// PURPOSE:
+//      Reads an unsigned integer of 2 bytes stored in little-endian byte order.
+//
+// INPUT:
+//      buffer:         the string containing the bytes.
+//      position:       the position of the first byte.
+//
+// OUTPUT:
+//      The value read, or 0 if the buffer is too short.
+//
+
+uint16_t ResultsArchive::readUint16(const string &buffer, const size_t position)
+{
+    if (position + 2 > buffer.size())
+    {
+        return 0;
+    }
+
+    return static_cast<unsigned char>(buffer[position]) | (static_cast<unsigned char>(buffer[position + 1]) << 8);
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsArchive::readUint32()
+//
+// PURPOSE:
+//      Reads an unsigned integer of 4 bytes stored in little-endian byte order.
+//
+// INPUT:
+//      buffer:         the string containing the bytes.
+//      position:       the position of the first byte.
+//
+// OUTPUT:
+//      The value read, or 0 if the buffer is too short.
+//
+
+uint32_t ResultsArchive::readUint32(const string &buffer, const size_t position)
+{
+    if (position + 4 > buffer.size())
+    {
+        return 0;
+    }
+
+    return readUint16(buffer, position) | (static_cast<uint32_t>(readUint16(buffer, position + 2)) << 16);
+}
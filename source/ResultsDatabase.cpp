@@ -0,0 +1,424 @@
+#include "ResultsDatabase.h"
+
+
+// ResultsDatabase::ResultsDatabase()
+//
+// PURPOSE:
+//      Constructor. Opens the database file, creating it with its tables if it does not exist yet.
+//      The database is opened in write-ahead logging mode and waits for the locks of other processes,
+//      so that the runs of different stars can insert their results at the same time.
+//
+// INPUT:
+//      fileName:       a string specifying the full path (filename included) of the database file.
+//
+
+ResultsDatabase::ResultsDatabase(const string fileName)
+: fileName(fileName)
+{
+#ifdef BACKGROUND_USE_SQLITE
+    checkError(sqlite3_open(fileName.c_str(), &database), "opening the results database " + fileName);
+    sqlite3_busy_timeout(database, 600000);
+
+    execute("PRAGMA journal_mode = WAL");
+    execute("CREATE TABLE IF NOT EXISTS runs ("
+            "star TEXT NOT NULL, model TEXT NOT NULL, run TEXT NOT NULL, "
+            "logEvidence REAL, logEvidenceError REAL, informationGain REAL, "
+            "Niterations INTEGER, Nsamples INTEGER, Ndimensions INTEGER, computationalTime REAL, "
+            "lowFrequencyThreshold REAL, highFrequencyThreshold REAL, completionTime TEXT, "
+            "PRIMARY KEY (star, model, run))");
+    execute("CREATE INDEX IF NOT EXISTS runsByEvidence ON runs (star, logEvidence)");
+    execute("CREATE TABLE IF NOT EXISTS parameters ("
+            "star TEXT NOT NULL, model TEXT NOT NULL, run TEXT NOT NULL, parameter INTEGER NOT NULL, "
+            "mean REAL, median REAL, mode REAL, secondMoment REAL, lowerCredibleLimit REAL, "
+            "upperCredibleLimit REAL, skewness REAL, "
+            "PRIMARY KEY (star, model, run, parameter))");
+    execute("CREATE TABLE IF NOT EXISTS configuration ("
+            "star TEXT NOT NULL, model TEXT NOT NULL, run TEXT NOT NULL, name TEXT NOT NULL, value NUMERIC, "
+            "PRIMARY KEY (star, model, run, name))");
+#else
+    cerr << "The results database " << fileName << " cannot be used: "
+         << "the code was compiled without SQLite support." << endl;
+    exit(EXIT_FAILURE);
+#endif
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsDatabase::~ResultsDatabase()
+//
+// PURPOSE:
+//      Destructor. Closes the database file.
+//
+
+ResultsDatabase::~ResultsDatabase()
+{
+#ifdef BACKGROUND_USE_SQLITE
+    sqlite3_close(database);
+#endif
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsDatabase::addConfiguration()
+//
+// PURPOSE:
+//      Adds a configuring parameter of the run, which is stored together with
+//      the results of the run at the next call of insertRun().
+//
+// INPUT:
+//      name:       a string specifying the name of the configuring parameter.
+//      value:      the value of the configuring parameter, either a number or a string.
+//
+// OUTPUT:
+//      void
+//
+
+void ResultsDatabase::addConfiguration(const string name, const double value)
+{
+    configurationNames.push_back(name);
+    configurationTexts.push_back("");
+    configurationValues.push_back(value);
+    configurationIsNumeric.push_back(true);
+}
+
+
+
+
+
+
+
+
+
+
+void ResultsDatabase::addConfiguration(const string name, const string value)
+{
+    configurationNames.push_back(name);
+    configurationTexts.push_back(value);
+    configurationValues.push_back(0.0);
+    configurationIsNumeric.push_back(false);
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsDatabase::insertRun()
+//
+// PURPOSE:
+//      Stores the results of a completed run: the evidence and the timing of the nested sampling,
+//      the thresholds in frequency, the summary statistics of each free parameter, as read from
+//      the parameterSummary.txt file of the run, and the configuring parameters added by means
+//      of addConfiguration(). The results of a previous run with the same star, model and run number
+//      are replaced. All the rows are written in a single transaction.
+//
+// INPUT:
+//      starID:                     a string specifying the catalog and star ID, e.g. KIC012008916.
+//      modelName:                  a string specifying the name of the background model.
+//      runNumber:                  a string specifying the run number (the name of the output subfolder).
+//      nestedSampler:              an object of class NestedSampler containing the results of the run.
+//      lowFrequencyThreshold:      the lower frequency threshold of the run (0 if not used).
+//      highFrequencyThreshold:     the upper frequency threshold of the run (0 if not used).
+//
+// OUTPUT:
+//      void
+//
+
+void ResultsDatabase::insertRun(const string starID, const string modelName, const string runNumber, NestedSampler &nestedSampler,
+                                const double lowFrequencyThreshold, const double highFrequencyThreshold)
+{
+#ifdef BACKGROUND_USE_SQLITE
+    // Read the summary of the free parameters written at the end of the run
+
+    ifstream summaryFile;
+    unsigned long Nparameters;
+    int Ncols;
+    File::openInputFile(summaryFile, nestedSampler.getOutputPathPrefix() + "parameterSummary.txt");
+    File::sniffFile(summaryFile, Nparameters, Ncols);
+    ArrayXXd parameterSummary = File::arrayXXdFromFile(summaryFile, Nparameters, Ncols);
+    summaryFile.close();
+
+    execute("BEGIN IMMEDIATE");
+
+    sqlite3_stmt *statement;
+    const char *keyColumns[] = {starID.c_str(), modelName.c_str(), runNumber.c_str()};
+
+    const char *tables[] = {"parameters", "configuration"};
+
+    for (int table = 0; table < 2; ++table)
+    {
+        string deletion = string("DELETE FROM ") + tables[table] + " WHERE star = ?1 AND model = ?2 AND run = ?3";
+        checkError(sqlite3_prepare_v2(database, deletion.c_str(), -1, &statement, nullptr), "preparing " + deletion);
+
+        for (int key = 0; key < 3; ++key)
+        {
+            sqlite3_bind_text(statement, key + 1, keyColumns[key], -1, SQLITE_TRANSIENT);
+        }
+
+        checkError(sqlite3_step(statement), "executing " + deletion);
+        sqlite3_finalize(statement);
+    }
+
+
+    // Evidence, timing and thresholds of the run
+
+    checkError(sqlite3_prepare_v2(database, "INSERT OR REPLACE INTO runs VALUES "
+                                  "(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, datetime('now'))",
+                                  -1, &statement, nullptr), "preparing the insertion of the run");
+
+    for (int key = 0; key < 3; ++key)
+    {
+        sqlite3_bind_text(statement, key + 1, keyColumns[key], -1, SQLITE_TRANSIENT);
+    }
+
+    sqlite3_bind_double(statement, 4, nestedSampler.getLogEvidence());
+    sqlite3_bind_double(statement, 5, nestedSampler.getLogEvidenceError());
+    sqlite3_bind_double(statement, 6, nestedSampler.getInformationGain());
+    sqlite3_bind_int(statement, 7, nestedSampler.getNiterations());
+    sqlite3_bind_int(statement, 8, nestedSampler.getLogLikelihoodOfPosteriorSample().size());
+    sqlite3_bind_int(statement, 9, nestedSampler.getNdimensions());
+    sqlite3_bind_double(statement, 10, nestedSampler.getComputationalTime());
+    sqlite3_bind_double(statement, 11, lowFrequencyThreshold);
+    sqlite3_bind_double(statement, 12, highFrequencyThreshold);
+    checkError(sqlite3_step(statement), "inserting the run");
+    sqlite3_finalize(statement);
+
+
+    // Summary statistics of each free parameter
+
+    checkError(sqlite3_prepare_v2(database, "INSERT INTO parameters (star, model, run, parameter, mean, median, mode, secondMoment, "
+                                  "lowerCredibleLimit, upperCredibleLimit, skewness) VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11)",
+                                  -1, &statement, nullptr), "preparing the insertion of the parameters");
+
+    for (int parameter = 0; parameter < parameterSummary.rows(); ++parameter)
+    {
+        for (int key = 0; key < 3; ++key)
+        {
+            sqlite3_bind_text(statement, key + 1, keyColumns[key], -1, SQLITE_TRANSIENT);
+        }
+
+        sqlite3_bind_int(statement, 4, parameter);
+
+        for (int column = 0; column < min(Ncols, 7); ++column)
+        {
+            sqlite3_bind_double(statement, column + 5, parameterSummary(parameter, column));
+        }
+
+        checkError(sqlite3_step(statement), "inserting the parameters");
+        sqlite3_reset(statement);
+        sqlite3_clear_bindings(statement);
+    }
+
+    sqlite3_finalize(statement);
+
+
+    // Configuring parameters of the run
+
+    checkError(sqlite3_prepare_v2(database, "INSERT INTO configuration VALUES (?1, ?2, ?3, ?4, ?5)",
+                                  -1, &statement, nullptr), "preparing the insertion of the configuration");
+
+    for (size_t entry = 0; entry < configurationNames.size(); ++entry)
+    {
+        for (int key = 0; key < 3; ++key)
+        {
+            sqlite3_bind_text(statement, key + 1, keyColumns[key], -1, SQLITE_TRANSIENT);
+        }
+
+        sqlite3_bind_text(statement, 4, configurationNames[entry].c_str(), -1, SQLITE_TRANSIENT);
+
+        if (configurationIsNumeric[entry])
+        {
+            sqlite3_bind_double(statement, 5, configurationValues[entry]);
+        }
+        else
+        {
+            sqlite3_bind_text(statement, 5, configurationTexts[entry].c_str(), -1, SQLITE_TRANSIENT);
+        }
+
+        checkError(sqlite3_step(statement), "inserting the configuration");
+        sqlite3_reset(statement);
+    }
+
+    sqlite3_finalize(statement);
+
+    execute("COMMIT");
+#endif
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsDatabase::printQuery()
+//
+// PURPOSE:
+//      Executes an SQL query and prints its result as a table, one row per line,
+//      preceded by the names of the columns.
+//
+// INPUT:
+//      query:      a string containing the SQL query, with the parameters ?1, ?2, ... if any.
+//      values:     the strings bound to the parameters of the query, in the same order.
+//      output:     the stream where the table is printed.
+//
+// OUTPUT:
+//      void
+//
+
+void ResultsDatabase::printQuery(const string query, const vector<string> &values, ostream &output)
+{
+#ifdef BACKGROUND_USE_SQLITE
+    sqlite3_stmt *statement;
+    checkError(sqlite3_prepare_v2(database, query.c_str(), -1, &statement, nullptr), "preparing the query " + query);
+
+    for (size_t value = 0; value < values.size(); ++value)
+    {
+        sqlite3_bind_text(statement, value + 1, values[value].c_str(), -1, SQLITE_TRANSIENT);
+    }
+
+
+    int Ncolumns = sqlite3_column_count(statement);
+    const int columnWidth = 20;
+
+    for (int column = 0; column < Ncolumns; ++column)
+    {
+        output << left << setw(columnWidth) << sqlite3_column_name(statement, column) << " ";
+    }
+
+    output << endl;
+    int errorCode;
+
+    while ((errorCode = sqlite3_step(statement)) == SQLITE_ROW)
+    {
+        for (int column = 0; column < Ncolumns; ++column)
+        {
+            const unsigned char *text = sqlite3_column_text(statement, column);
+            output << left << setw(columnWidth) << (text == nullptr ? "NULL" : reinterpret_cast<const char*>(text)) << " ";
+        }
+
+        output << endl;
+    }
+
+    checkError(errorCode, "executing the query " + query);
+    sqlite3_finalize(statement);
+#endif
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsDatabase::isAvailable()
+//
+// PURPOSE:
+//      Checks whether the code was compiled with SQLite support.
+//
+// OUTPUT:
+//      True if the results database can be used, false otherwise.
+//
+
+bool ResultsDatabase::isAvailable()
+{
+#ifdef BACKGROUND_USE_SQLITE
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsDatabase::execute()
+//
+// PURPOSE:
+//      Executes an SQL statement that does not return any row.
+//
+// INPUT:
+//      statement:      a string containing the SQL statement.
+//
+// OUTPUT:
+//      void
+//
+
+void ResultsDatabase::execute(const string statement)
+{
+#ifdef BACKGROUND_USE_SQLITE
+    char *errorMessage = nullptr;
+
+    if (sqlite3_exec(database, statement.c_str(), nullptr, nullptr, &errorMessage) != SQLITE_OK)
+    {
+        cerr << "Error executing " << statement << " on the results database " << fileName << ": "
+             << errorMessage << endl;
+        sqlite3_free(errorMessage);
+        exit(EXIT_FAILURE);
+    }
+#endif
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsDatabase::checkError()
+//
+// PURPOSE:
+//      Stops the program with an error message if an SQLite function did not succeed.
+//
+// INPUT:
+//      errorCode:      the value returned by the SQLite function.
+//      action:         a string describing the operation, printed in the error message.
+//
+// OUTPUT:
+//      void
+//
+
+void ResultsDatabase::checkError(const int errorCode, const string action)
+{
+#ifdef BACKGROUND_USE_SQLITE
+    if ((errorCode != SQLITE_OK) && (errorCode != SQLITE_DONE) && (errorCode != SQLITE_ROW))
+    {
+        cerr << "Error " << action << " on the results database " << fileName << ": "
+             << sqlite3_errmsg(database) << endl;
+        exit(EXIT_FAILURE);
+    }
+#endif
+}
@@ -0,0 +1,344 @@
+#include "ResultsWriter.h"
+
+
+// ResultsWriter::ResultsWriter()
+//
+// PURPOSE:
+//      Constructor. Starts the worker threads, which wait for tasks to be submitted.
+//
+// INPUT:
+//      Nthreads:       the number of worker threads. If 0, no thread is started and
+//                      each task is executed by the calling thread as soon as it is submitted.
+//
+
+ResultsWriter::ResultsWriter(const int Nthreads)
+: NpendingTasks(0),
+  stopRequested(false)
+{
+    for (int thread = 0; thread < Nthreads; ++thread)
+    {
+        workers.push_back(std::thread(&ResultsWriter::runWorker, this));
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsWriter::~ResultsWriter()
+//
+// PURPOSE:
+//      Destructor. Waits for all the submitted tasks to be completed and stops the worker threads.
+//
+
+ResultsWriter::~ResultsWriter()
+{
+    waitForCompletion();
+
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopRequested = true;
+    }
+
+    taskAvailable.notify_all();
+
+    for (size_t thread = 0; thread < workers.size(); ++thread)
+    {
+        workers[thread].join();
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsWriter::submit()
+//
+// PURPOSE:
+//      Adds a task to the queue, to be executed by the first worker thread available.
+//
+// INPUT:
+//      task:       a function with no arguments and no return value.
+//
+// OUTPUT:
+//      void
+//
+
+void ResultsWriter::submit(function<void()> task)
+{
+    if (workers.empty())
+    {
+        task();
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(queueMutex);
+        tasks.push(task);
+        NpendingTasks++;
+    }
+
+    taskAvailable.notify_one();
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsWriter::waitForCompletion()
+//
+// PURPOSE:
+//      Blocks the calling thread until all the submitted tasks have been completed.
+//
+// OUTPUT:
+//      void
+//
+
+void ResultsWriter::waitForCompletion()
+{
+    unique_lock<mutex> lock(queueMutex);
+
+    while (NpendingTasks > 0)
+    {
+        tasksCompleted.wait(lock);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsWriter::writeResults()
+//
+// PURPOSE:
+//      Submits the writing of all the output files of a run, one task per file.
+//      Each task uses its own object of class BackgroundResults, so that the tasks only
+//      share the nested sampler, which is not modified once the run is completed.
+//      The summary of the parameters, which includes the computation of the marginal distributions,
+//      is submitted first because it is the longest task. It is computed in parallel with the share of
+//      the hardware threads of each worker thread, so that the tasks do not oversubscribe the machine.
+//
+// INPUT:
+//      nestedSampler:                      an object of class NestedSampler containing the results of the run.
+//                                          It must not be modified or destroyed until all the tasks are completed.
+//      outputFormat:                       a string specifying the format of the posterior sample (text or npy).
+//      credibleLevel:                      the credible level (in percent) of the parameter summary.
+//      writeMarginalDistributionToFile:    a boolean specifying whether the marginal distributions are written.
+//
+// OUTPUT:
+//      void
+//
+
+void ResultsWriter::writeResults(NestedSampler &nestedSampler, const string outputFormat,
+                                 const double credibleLevel, const bool writeMarginalDistributionToFile)
+{
+    NestedSampler *sampler = &nestedSampler;
+    int NsummaryThreads = max(static_cast<int>(thread::hardware_concurrency()) / max(getNthreads(), 1), 1);
+
+    submit([=]() { BackgroundResults results(*sampler);
+                   results.writeParametersSummaryToFile("parameterSummary.txt", credibleLevel, writeMarginalDistributionToFile, 
+                                                        NsummaryThreads); });
+
+    if (outputFormat == "npy")
+    {
+        submit([=]() { BackgroundResults results(*sampler); results.writeSamplesToNpyFile("samples.npy"); });
+    }
+    else
+    {
+        submit([=]() { BackgroundResults results(*sampler); results.writeParametersToFile("parameter"); });
+        submit([=]() { BackgroundResults results(*sampler); results.writeLogLikelihoodToFile("logLikelihood.txt"); });
+        submit([=]() { BackgroundResults results(*sampler); results.writeLogWeightsToFile("logWeights.txt"); });
+        submit([=]() { BackgroundResults results(*sampler); results.writePosteriorProbabilityToFile("posteriorDistribution.txt"); });
+    }
+
+    submit([=]() { BackgroundResults results(*sampler); results.writeEvidenceInformationToFile("evidenceInformation.txt"); });
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsWriter::setResults()
+//
+// PURPOSE:
+//      Sets the results of a refit of the model, obtained without running the nested sampler,
+//      into the nested sampler of the run, so that they are written in the same output files
+//      of a nested sampling run.
+//
+// INPUT:
+//      nestedSampler:                      an object of class NestedSampler that receives the results.
+//      posteriorSample:                    two-dimensional array of size (Ndimensions, Nsamples) containing
+//                                          the posterior sample.
+//      logLikelihoodOfPosteriorSample:     one-dimensional array containing the log-likelihood of each sampling point.
+//      logWeightOfPosteriorSample:         one-dimensional array containing the log-weight of each sampling point.
+//      logEvidence:                        the natural logarithm of the evidence.
+//      logEvidenceError:                   the error on the log-evidence.
+//      informationGain:                    the information gain in natural units.
+//
+// OUTPUT:
+//      void
+//
+
+void ResultsWriter::setResults(NestedSampler &nestedSampler, const ArrayXXd &posteriorSample, 
+                               const ArrayXd &logLikelihoodOfPosteriorSample, const ArrayXd &logWeightOfPosteriorSample, 
+                               const double logEvidence, const double logEvidenceError, const double informationGain)
+{
+    nestedSampler.setPosteriorSample(posteriorSample);
+    nestedSampler.setLogLikelihoodOfPosteriorSample(logLikelihoodOfPosteriorSample);
+    nestedSampler.setLogWeightOfPosteriorSample(logWeightOfPosteriorSample);
+    nestedSampler.setLogEvidence(logEvidence);
+    nestedSampler.setLogEvidenceError(logEvidenceError);
+    nestedSampler.setInformationGain(informationGain);
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsWriter::writeRunInformation()
+//
+// PURPOSE:
+//      Writes the rebinning of the dataset and the other information on the run in the file
+//      of computation parameters, both for a nested sampling run and for a refit.
+//      Each group of values follows its header, which identifies it when the file is read back
+//      (see PreviousRun.h).
+//
+// INPUT:
+//      outputFile:         the open file of computation parameters of the run.
+//      runInformation:     the settings of the dataset and the identification of the run.
+//
+// OUTPUT:
+//      void
+//
+
+void ResultsWriter::writeRunInformation(ofstream &outputFile, const RunInformation &runInformation)
+{
+    outputFile << "# Rebinning of the dataset" << endl;
+    outputFile << "# Row #1: Rebinning mode (none / factor / logarithmic)" << endl;
+    outputFile << "# Row #2: Rebinning factor or number of bins per decade (1 if not used)" << endl;
+    outputFile << "# Row #3: Number of quadrature nodes per bin (1 = mid-bin evaluation)" << endl;
+    outputFile << runInformation.rebinningMode << endl;
+    outputFile << runInformation.rebinningParameter << endl;
+    outputFile << runInformation.NnodesPerBin << endl;
+    outputFile << "# Other information on the run" << endl;
+    outputFile << "# Row #1: Low-Frequency threshold (0 if not used)" << endl;
+    outputFile << "# Row #2: High-Frequency threshold (0 if not used)" << endl;
+    outputFile << "# Row #3: Local working path used" << endl;
+    outputFile << "# Row #4: Catalog and Star ID" << endl;
+    outputFile << "# Row #5: Run Number" << endl;
+    outputFile << "# Row #6: Background model adopted" << endl;
+    outputFile << "# Row #7: PCA activated (1 = yes / 0 = no)" << endl;
+    outputFile << setprecision(12) << runInformation.lowFrequencyThreshold << endl;
+    outputFile << runInformation.highFrequencyThreshold << endl;
+    outputFile << runInformation.localPath << endl;
+    outputFile << runInformation.starID << endl;
+    outputFile << runInformation.runNumber << endl;
+    outputFile << runInformation.backgroundModelName << endl;
+    outputFile << runInformation.featureProjectionActivated << endl;
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsWriter::getNthreads()
+//
+// PURPOSE:
+//      Gets the number of worker threads.
+//
+// OUTPUT:
+//      An integer containing the number of worker threads.
+//
+
+int ResultsWriter::getNthreads()
+{
+    return workers.size();
+}
+
+
+
+
+
+
+
+
+
+
+// ResultsWriter::runWorker()
+//
+// PURPOSE:
+//      Executes the tasks of the queue until the writer is destroyed.
+//      This is the function run by each worker thread.
+//
+// OUTPUT:
+//      void
+//
+
+void ResultsWriter::runWorker()
+{
+    while (true)
+    {
+        function<void()> task;
+
+        {
+            unique_lock<mutex> lock(queueMutex);
+
+            while (tasks.empty() && !stopRequested)
+            {
+                taskAvailable.wait(lock);
+            }
+
+            if (tasks.empty())
+            {
+                return;
+            }
+
+            task = tasks.front();
+            tasks.pop();
+        }
+
+        task();
+
+        {
+            lock_guard<mutex> lock(queueMutex);
+            NpendingTasks--;
+        }
+
+        tasksCompleted.notify_all();
+    }
+}
@@ -0,0 +1,161 @@
+#include "ScratchArena.h"
+#include "AllocationGuard.h"
+
+
+// ScratchArena::ScratchArena()
+//
+// PURPOSE: 
+//      Constructor. Creates one empty buffer for each slot, in both double and single precision.
+//
+
+ScratchArena::ScratchArena()
+: doubleBuffers(Nslots),
+  floatBuffers(Nslots),
+  Ngrowths(0)
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// ScratchArena::~ScratchArena()
+//
+// PURPOSE: 
+//      Destructor.
+//
+
+ScratchArena::~ScratchArena()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// ScratchArena::getThreadArena()
+//
+// PURPOSE:
+//      Gets the arena of the calling thread, which is created at its first call.
+//
+// OUTPUT:
+//      A reference to the arena of the calling thread.
+//
+
+ScratchArena & ScratchArena::getThreadArena()
+{
+    static thread_local ScratchArena arena;
+    return arena;
+}
+
+
+
+
+
+
+
+
+
+
+// ScratchArena::getDoubleBuffer()
+//
+// PURPOSE:
+//      Gets the double-precision buffer of a given slot, with a given number of elements.
+//      The buffer is only reallocated when it is smaller than required, so that after the first
+//      evaluation of the likelihood no further allocations are made.
+//
+// INPUT:
+//      slot:           the slot of the buffer.
+//      Nvalues:        the number of elements required.
+//
+// OUTPUT:
+//      An Eigen map of the first Nvalues elements of the buffer. The content of the buffer is undefined.
+//
+// NOTE:
+//      The map is valid until the same slot is requested again with a larger number of elements.
+//
+
+Eigen::Map<ArrayXd> ScratchArena::getDoubleBuffer(const BufferSlot slot, const long Nvalues)
+{
+    ArrayXd &buffer = doubleBuffers[slot];
+
+    if (buffer.size() < Nvalues)
+    {
+        AllocationGuard::Permission permission;
+        buffer.resize(Nvalues);
+        ++Ngrowths;
+    }
+
+    return Eigen::Map<ArrayXd>(buffer.data(), Nvalues);
+}
+
+
+
+
+
+
+
+
+
+
+// ScratchArena::getFloatBuffer()
+//
+// PURPOSE:
+//      Gets the single-precision buffer of a given slot, with a given number of elements.
+//
+// INPUT:
+//      slot:           the slot of the buffer.
+//      Nvalues:        the number of elements required.
+//
+// OUTPUT:
+//      An Eigen map of the first Nvalues elements of the buffer. The content of the buffer is undefined.
+//
+
+Eigen::Map<ArrayXf> ScratchArena::getFloatBuffer(const BufferSlot slot, const long Nvalues)
+{
+    ArrayXf &buffer = floatBuffers[slot];
+
+    if (buffer.size() < Nvalues)
+    {
+        AllocationGuard::Permission permission;
+        buffer.resize(Nvalues);
+        ++Ngrowths;
+    }
+
+    return Eigen::Map<ArrayXf>(buffer.data(), Nvalues);
+}
+
+
+
+
+
+
+
+
+
+
+// ScratchArena::getNgrowths()
+//
+// PURPOSE:
+//      Gets the number of times a buffer of the arena has been reallocated.
+//
+// OUTPUT:
+//      An unsigned long integer with the number of reallocations.
+//
+
+unsigned long ScratchArena::getNgrowths()
+{
+    return Ngrowths;
+}
@@ -0,0 +1,131 @@
+#include "SinglePrecisionLikelihood.h"
+
+
+// SinglePrecisionLikelihood::SinglePrecisionLikelihood()
+//
+// PURPOSE: 
+//      Constructor. Converts the observations into single precision and computes 
+//      the terms of the log-likelihood that only depend on the data, in double precision.
+//      The double-precision copy of the observations is released.
+//
+// INPUT:
+//      observations:       one-dimensional array containing the power spectral density of each bin.
+//      binWeights:         one-dimensional array containing the number of original bins M
+//                          averaged into each bin. If empty, M = 1 for all the bins,
+//                          which corresponds to the ExponentialLikelihood.
+//      model:              an object of class BackgroundModel specifying the model to be adopted
+//                          in the likelihood computation.
+//
+
+SinglePrecisionLikelihood::SinglePrecisionLikelihood(const RefArrayXd observations, const RefArrayXd binWeights, BackgroundModel &model)
+: Likelihood(observations, model),
+  backgroundModel(model),
+  NbinsPerBlock(4096)
+{
+    weightsAreUnity = (binWeights.size() == 0) || (binWeights == 1.0).all();
+    logNormalizationConstant = 0.0;
+
+    if (!weightsAreUnity)
+    {
+        if (binWeights.size() != observations.size())
+        {
+            cerr << "Number of bin weights does not match the number of observations." << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        for (int bin = 0; bin < binWeights.size(); ++bin)
+        {
+            double M = binWeights(bin);
+            logNormalizationConstant += M*log(M) - lgamma(M) + (M - 1.0)*log(observations(bin));
+        }
+
+        singlePrecisionBinWeights = binWeights.cast<float>();
+    }
+
+    singlePrecisionObservations = observations.cast<float>();
+    this->observations.resize(0);
+}
+
+
+
+
+
+
+
+
+
+
+// SinglePrecisionLikelihood::~SinglePrecisionLikelihood()
+//
+// PURPOSE: 
+//      Destructor.
+//
+
+SinglePrecisionLikelihood::~SinglePrecisionLikelihood()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// SinglePrecisionLikelihood::logValue()
+//
+// PURPOSE:
+//      Computes the natural logarithm of the likelihood for a given set of model parameters.
+//      The contribution of each bin is computed in single precision, then summed in double precision
+//      over blocks of bins, and the block sums are accumulated by means of a Neumaier compensated summation.
+//
+// INPUT:
+//      modelParameters:    one-dimensional array containing the values of the free parameters of the model.
+//
+// OUTPUT:
+//      A double containing the natural logarithm of the likelihood.
+//
+
+double SinglePrecisionLikelihood::logValue(RefArrayXd const modelParameters)
+{
+    // The predictions are stored in the scratch arena of the calling thread, so that 
+    // no heap allocation is made within the evaluation
+
+    int Nobservations = singlePrecisionObservations.size();
+    Eigen::Map<ArrayXf> predictions = ScratchArena::getThreadArena().getFloatBuffer(ScratchArena::likelihoodPredictions, Nobservations);
+    AllocationGuard allocationGuard("SinglePrecisionLikelihood::logValue()");
+
+    backgroundModel.predictSinglePrecision(predictions, modelParameters);
+
+    double sum = 0.0;
+    double compensation = 0.0;
+
+    for (int firstBin = 0; firstBin < Nobservations; firstBin += NbinsPerBlock)
+    {
+        int Nbins = min(NbinsPerBlock, Nobservations - firstBin);
+        const float *weights = weightsAreUnity ? 0 : singlePrecisionBinWeights.data() + firstBin;
+        double blockSum = VectorKernels::sumLogLikelihoodTerms(singlePrecisionObservations.data() + firstBin, 
+                                                               predictions.data() + firstBin, weights, Nbins);
+
+
+        // Neumaier summation of the block sums
+
+        double newSum = sum + blockSum;
+
+        if (fabs(sum) >= fabs(blockSum))
+        {
+            compensation += (sum - newSum) + blockSum;
+        }
+        else
+        {
+            compensation += (blockSum - newSum) + sum;
+        }
+
+        sum = newSum;
+    }
+
+    return logNormalizationConstant - (sum + compensation);
+}
@@ -0,0 +1,485 @@
+#include "SpectrumCache.h"
+#include "BackgroundModel.h"
+
+
+static_assert(sizeof(SpectrumCache::Header) == 64, "Unexpected size of the header of the spectrum cache");
+
+
+// SpectrumCache::SpectrumCache()
+//
+// PURPOSE:
+//      Constructor. Identifies the entry of the cache of a dataset. The source file of the dataset
+//      is identified by its path, device, inode, size and modification time, so that the entry
+//      is found without reading the file, and any change of the file leads to a different entry.
+//      The cache directory is created if it does not exist.
+//
+// INPUT:
+//      directoryName:              a string specifying the path of the cache directory.
+//      starID:                     the catalog and star ID, e.g. KIC012008916, used in the name of the entry.
+//      sourceFileName:             the full path of the file from which the dataset is read, either its
+//                                  ASCII file or the spectrum container of many stars.
+//      lowFrequencyThreshold:      the low-frequency threshold given to the background executable (muHz).
+//      highFrequencyThreshold:     the high-frequency threshold given to the background executable (muHz).
+//      NyquistFrequency:           the Nyquist frequency of the dataset (muHz), or 0 if it is taken from
+//                                  the largest frequency of the dataset, in which case its value is 
+//                                  determined by the source file and is only known from the entry.
+//
+
+SpectrumCache::SpectrumCache(const string directoryName, const string starID, const string sourceFileName,
+                             const double lowFrequencyThreshold, const double highFrequencyThreshold,
+                             const double NyquistFrequency)
+: NyquistFrequency(NyquistFrequency),
+  mappedFile(nullptr),
+  fileSize(0),
+  header(nullptr)
+{
+    struct stat sourceStatus;
+
+    if (stat(sourceFileName.c_str(), &sourceStatus) != 0)
+    {
+        cerr << "Error opening input file " << sourceFileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    #ifdef __APPLE__
+        const struct timespec &modificationTime = sourceStatus.st_mtimespec;
+    #else
+        const struct timespec &modificationTime = sourceStatus.st_mtim;
+    #endif
+
+    uint64_t sourceIdentity[5] = {static_cast<uint64_t>(sourceStatus.st_dev), static_cast<uint64_t>(sourceStatus.st_ino),
+                                  static_cast<uint64_t>(sourceStatus.st_size), static_cast<uint64_t>(modificationTime.tv_sec),
+                                  static_cast<uint64_t>(modificationTime.tv_nsec)};
+    double parameters[3] = {lowFrequencyThreshold, highFrequencyThreshold, NyquistFrequency};
+
+    key = hash(sourceFileName.c_str(), sourceFileName.size() + 1, 14695981039346656037ULL);
+    key = hash(starID.c_str(), starID.size() + 1, key);
+    key = hash(sourceIdentity, sizeof(sourceIdentity), key);
+    key = hash(parameters, sizeof(parameters), key);
+
+    if ((mkdir(directoryName.c_str(), 0777) != 0) && (errno != EEXIST))
+    {
+        cerr << "Error creating the spectrum cache directory " << directoryName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    ostringstream name;
+    name << directoryName << "/" << starID << "_" << hex << setw(16) << setfill('0') << key << ".bkgcache";
+    fileName = name.str();
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumCache::~SpectrumCache()
+//
+// PURPOSE:
+//      Destructor. Unmaps the entry of the cache, if mapped.
+//
+
+SpectrumCache::~SpectrumCache()
+{
+    if (mappedFile != nullptr)
+    {
+        munmap(const_cast<char*>(mappedFile), fileSize);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumCache::load()
+//
+// PURPOSE:
+//      Maps the entry of the cache read-only into memory, if it has already been written
+//      by this or another process.
+//
+// OUTPUT:
+//      True if the entry exists and is valid, false otherwise, in which case it has
+//      to be written by means of store().
+//
+
+bool SpectrumCache::load()
+{
+    if (mappedFile != nullptr)
+    {
+        return true;
+    }
+
+    int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+
+    if (fileDescriptor < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStatus;
+    fstat(fileDescriptor, &fileStatus);
+    size_t entrySize = fileStatus.st_size;
+
+    if (entrySize < sizeof(Header))
+    {
+        close(fileDescriptor);
+        return false;
+    }
+
+    void *mapping = mmap(nullptr, entrySize, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+    close(fileDescriptor);
+
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+
+    const Header *entryHeader = static_cast<const Header*>(mapping);
+
+    if ((memcmp(entryHeader->magic, "BKGCACH", 8) != 0) || (entryHeader->version != currentVersion)
+        || (entryHeader->byteOrderMark != byteOrderMark) || (entryHeader->key != key)
+        || ((NyquistFrequency > 0.0) && (entryHeader->NyquistFrequency != NyquistFrequency))
+        || (entrySize != sizeof(Header) + 3 * entryHeader->Nbins * sizeof(double)))
+    {
+        munmap(mapping, entrySize);
+        return false;
+    }
+
+    mappedFile = static_cast<const char*>(mapping);
+    fileSize = entrySize;
+    header = entryHeader;
+
+    return true;
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumCache::store()
+//
+// PURPOSE:
+//      Writes the entry of the cache from the trimmed dataset, computes its response function
+//      and maps the entry into memory. The entry is written into a temporary file that is then
+//      renamed, so that other processes find either no entry or a complete one. If several
+//      processes write the same entry at the same time, the last one replaces the others
+//      with identical content, while the processes that have already mapped an entry keep using it.
+//
+// INPUT:
+//      covariates:                 one-dimensional array containing the trimmed frequencies (muHz).
+//      observations:               one-dimensional array containing the trimmed power spectral density.
+//      lowFrequencyThreshold:      the low-frequency threshold actually applied (muHz), 0 if not used.
+//      highFrequencyThreshold:     the high-frequency threshold actually applied (muHz), 0 if not used.
+//      adoptedNyquistFrequency:    the Nyquist frequency actually adopted (muHz), which is the one given
+//                                  to the constructor unless this is 0.
+//
+// OUTPUT:
+//      void
+//
+
+void SpectrumCache::store(const ConstRefArrayXd covariates, const ConstRefArrayXd observations,
+                          const double lowFrequencyThreshold, const double highFrequencyThreshold,
+                          const double adoptedNyquistFrequency)
+{
+    if (covariates.size() != observations.size())
+    {
+        cerr << "Frequencies and power spectral density of the spectrum cache have different sizes." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if ((adoptedNyquistFrequency <= 0.0) || ((NyquistFrequency > 0.0) && (adoptedNyquistFrequency != NyquistFrequency)))
+    {
+        cerr << "The Nyquist frequency of the spectrum cache entry differs from the one identifying the entry." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    ArrayXd responseFunction = BackgroundModel::computeResponseFunction(covariates, adoptedNyquistFrequency);
+
+    Header entryHeader;
+    memset(&entryHeader, 0, sizeof(Header));
+    memcpy(entryHeader.magic, "BKGCACH", 8);
+    entryHeader.version = currentVersion;
+    entryHeader.byteOrderMark = byteOrderMark;
+    entryHeader.key = key;
+    entryHeader.Nbins = covariates.size();
+    entryHeader.lowFrequencyThreshold = lowFrequencyThreshold;
+    entryHeader.highFrequencyThreshold = highFrequencyThreshold;
+    entryHeader.NyquistFrequency = adoptedNyquistFrequency;
+
+    string temporaryFileName = fileName + ".tmp" + to_string(getpid());
+    FILE *outputFile = fopen(temporaryFileName.c_str(), "wb");
+
+    if (outputFile == nullptr)
+    {
+        cerr << "Error opening output file " << temporaryFileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    size_t Nbins = covariates.size();
+    bool written = (fwrite(&entryHeader, sizeof(Header), 1, outputFile) == 1)
+                   && (fwrite(covariates.data(), sizeof(double), Nbins, outputFile) == Nbins)
+                   && (fwrite(observations.data(), sizeof(double), Nbins, outputFile) == Nbins)
+                   && (fwrite(responseFunction.data(), sizeof(double), Nbins, outputFile) == Nbins);
+    written = (fclose(outputFile) == 0) && written;
+
+    if (!written || (rename(temporaryFileName.c_str(), fileName.c_str()) != 0))
+    {
+        remove(temporaryFileName.c_str());
+        cerr << "Error writing spectrum cache entry " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (!load())
+    {
+        cerr << "Error mapping spectrum cache entry " << fileName << " into memory." << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumCache::getFileName()
+//
+// PURPOSE:
+//      Gets the full path of the entry of the cache.
+//
+// OUTPUT:
+//      A string containing the name of the file of the entry.
+//
+
+string SpectrumCache::getFileName()
+{
+    return fileName;
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumCache::getCovariates()
+//
+// PURPOSE:
+//      Gets the trimmed frequencies of the dataset from the mapped entry.
+//
+// OUTPUT:
+//      A read-only Eigen map of the frequencies (muHz).
+//
+
+Eigen::Map<const ArrayXd> SpectrumCache::getCovariates()
+{
+    return Eigen::Map<const ArrayXd>(getColumn(0), header->Nbins);
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumCache::getObservations()
+//
+// PURPOSE:
+//      Gets the trimmed power spectral density of the dataset from the mapped entry.
+//
+// OUTPUT:
+//      A read-only Eigen map of the power spectral density.
+//
+
+Eigen::Map<const ArrayXd> SpectrumCache::getObservations()
+{
+    return Eigen::Map<const ArrayXd>(getColumn(1), header->Nbins);
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumCache::getResponseFunction()
+//
+// PURPOSE:
+//      Gets the response function at the trimmed frequencies of the dataset from the mapped entry.
+//
+// OUTPUT:
+//      A read-only Eigen map of the response function.
+//
+// NOTE:
+//      The map refers to the pages shared with the other processes, and remains valid
+//      as long as the cache object exists.
+//
+
+Eigen::Map<const ArrayXd> SpectrumCache::getResponseFunction()
+{
+    return Eigen::Map<const ArrayXd>(getColumn(2), header->Nbins);
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumCache::getLowFrequencyThreshold()
+//
+// PURPOSE:
+//      Gets the low-frequency threshold actually applied to the dataset of the entry.
+//
+// OUTPUT:
+//      The low-frequency threshold (muHz), 0 if the dataset was not trimmed at low frequency.
+//
+
+double SpectrumCache::getLowFrequencyThreshold()
+{
+    return header->lowFrequencyThreshold;
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumCache::getHighFrequencyThreshold()
+//
+// PURPOSE:
+//      Gets the high-frequency threshold actually applied to the dataset of the entry.
+//
+// OUTPUT:
+//      The high-frequency threshold (muHz), 0 if the dataset was not trimmed at high frequency.
+//
+
+double SpectrumCache::getHighFrequencyThreshold()
+{
+    return header->highFrequencyThreshold;
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumCache::getNyquistFrequency()
+//
+// PURPOSE:
+//      Gets the Nyquist frequency adopted for the dataset of the entry, which is also the one
+//      used to compute its response function.
+//
+// OUTPUT:
+//      The Nyquist frequency (muHz).
+//
+
+double SpectrumCache::getNyquistFrequency()
+{
+    return header->NyquistFrequency;
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumCache::hash()
+//
+// PURPOSE:
+//      Updates a 64-bit FNV-1a hash with a sequence of bytes.
+//
+// INPUT:
+//      bytes:          a pointer to the first byte of the sequence.
+//      Nbytes:         the number of bytes of the sequence.
+//      value:          the current value of the hash.
+//
+// OUTPUT:
+//      The updated value of the hash.
+//
+
+uint64_t SpectrumCache::hash(const void *bytes, const size_t Nbytes, uint64_t value)
+{
+    const unsigned char *byte = static_cast<const unsigned char*>(bytes);
+
+    for (size_t i = 0; i < Nbytes; ++i)
+    {
+        value ^= byte[i];
+        value *= 1099511628211ULL;
+    }
+
+    return value;
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumCache::getColumn()
+//
+// PURPOSE:
+//      Gets a pointer to one of the arrays of the mapped entry.
+//
+// INPUT:
+//      column:         0 for the frequencies, 1 for the power spectral density, 2 for the response function.
+//
+// OUTPUT:
+//      A pointer to the first value of the array.
+//
+
+const double * SpectrumCache::getColumn(const int column)
+{
+    if (mappedFile == nullptr)
+    {
+        cerr << "Spectrum cache entry " << fileName << " has not been loaded." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    return reinterpret_cast<const double*>(mappedFile + sizeof(Header)) + column * header->Nbins;
+}
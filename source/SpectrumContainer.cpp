@@ -0,0 +1,366 @@
+#include "SpectrumContainer.h"
+#include "File.h"
+
+
+static_assert(sizeof(SpectrumContainer::Header) == 64, "Unexpected size of the header of the spectrum container");
+static_assert(sizeof(SpectrumContainer::IndexEntry) == 80, "Unexpected size of the index entries of the spectrum container");
+
+
+// SpectrumContainer::SpectrumContainer()
+//
+// PURPOSE:
+//      Constructor. Maps the container file into memory and checks its header and index.
+//      Only the pages that are actually read, i.e. those of the index and of the spectra
+//      requested, are loaded from disk.
+//
+// INPUT:
+//      fileName:       a string specifying the full path (filename included) of the container file.
+//
+
+SpectrumContainer::SpectrumContainer(const string fileName)
+: fileName(fileName)
+{
+    fileDescriptor = open(fileName.c_str(), O_RDONLY);
+
+    if (fileDescriptor < 0)
+    {
+        cerr << "Error opening spectrum container " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    struct stat fileStatus;
+    fstat(fileDescriptor, &fileStatus);
+    fileSize = fileStatus.st_size;
+
+    if (fileSize < sizeof(Header))
+    {
+        cerr << "File " << fileName << " is not a spectrum container." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    void *mapping = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+
+    if (mapping == MAP_FAILED)
+    {
+        cerr << "Error mapping spectrum container " << fileName << " into memory." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    mappedFile = static_cast<const char*>(mapping);
+    header = reinterpret_cast<const Header*>(mappedFile);
+
+    if (memcmp(header->magic, "BKGSPEC", 8) != 0)
+    {
+        cerr << "File " << fileName << " is not a spectrum container." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if ((header->version != currentVersion) || (header->byteOrderMark != byteOrderMark))
+    {
+        cerr << "Spectrum container " << fileName << " was written with a different version or byte order." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (header->indexOffset + header->Nstars * sizeof(IndexEntry) > fileSize)
+    {
+        cerr << "Spectrum container " << fileName << " is truncated." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    index = reinterpret_cast<const IndexEntry*>(mappedFile + header->indexOffset);
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumContainer::~SpectrumContainer()
+//
+// PURPOSE:
+//      Destructor. Unmaps and closes the container file.
+//
+
+SpectrumContainer::~SpectrumContainer()
+{
+    munmap(const_cast<char*>(mappedFile), fileSize);
+    close(fileDescriptor);
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumContainer::findStar()
+//
+// PURPOSE:
+//      Finds a star in the index of the container by means of a binary search.
+//
+// INPUT:
+//      starID:     a string specifying the catalog and star ID, e.g. KIC012008916.
+//
+// OUTPUT:
+//      A pointer to the entry of the star in the index, or a null pointer if the star
+//      is not contained in the file.
+//
+
+const SpectrumContainer::IndexEntry * SpectrumContainer::findStar(const string starID)
+{
+    const IndexEntry *firstEntry = index;
+    const IndexEntry *lastEntry = index + header->Nstars;
+
+    const IndexEntry *entry = lower_bound(firstEntry, lastEntry, starID,
+                                          [](const IndexEntry &indexEntry, const string &ID)
+                                          { return strncmp(indexEntry.starID, ID.c_str(), sizeof(indexEntry.starID)) < 0; });
+
+    if ((entry == lastEntry) || (strncmp(entry->starID, starID.c_str(), sizeof(entry->starID)) != 0))
+    {
+        return nullptr;
+    }
+
+    return entry;
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumContainer::getSpectrum()
+//
+// PURPOSE:
+//      Gets the dataset of a star contained in the file.
+//
+// INPUT:
+//      entry:      the entry of the star in the index, as returned by findStar().
+//
+// OUTPUT:
+//      A two-dimensional Eigen array with the frequencies in the first column and the
+//      power spectral density in the second column, as read from the ASCII file of the dataset.
+//
+
+ArrayXXd SpectrumContainer::getSpectrum(const IndexEntry &entry)
+{
+    if (entry.dataOffset + 2 * entry.Nbins * sizeof(double) > fileSize)
+    {
+        cerr << "Spectrum of " << entry.starID << " exceeds the size of the container " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    const double *spectrum = reinterpret_cast<const double*>(mappedFile + entry.dataOffset);
+
+    return Eigen::Map<const ArrayXXd>(spectrum, entry.Nbins, 2);
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumContainer::getNstars()
+//
+// PURPOSE:
+//      Gets the number of stars contained in the file.
+//
+// OUTPUT:
+//      The number of stars.
+//
+
+uint64_t SpectrumContainer::getNstars()
+{
+    return header->Nstars;
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumContainer::getEntry()
+//
+// PURPOSE:
+//      Gets an entry of the index, sorted by star ID.
+//
+// INPUT:
+//      entryNumber:    the position of the entry in the index, from 0 to Nstars - 1.
+//
+// OUTPUT:
+//      A reference to the entry of the index.
+//
+
+const SpectrumContainer::IndexEntry & SpectrumContainer::getEntry(const uint64_t entryNumber)
+{
+    return index[entryNumber];
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumContainer::pack()
+//
+// PURPOSE:
+//      Writes a container file with the datasets of a list of stars. The ASCII files of the
+//      datasets are read one at a time, so that the memory used does not depend on the number of stars.
+//
+// INPUT:
+//      fileName:               a string specifying the full path (filename included) of the container file.
+//      starIDs:                the catalog and star IDs of the stars, e.g. KIC012008916.
+//      spectrumFileNames:      the full paths of the ASCII files of the datasets, with the frequencies
+//                              in the first column and the power spectral density in the second column.
+//      NyquistFrequencies:     the Nyquist frequencies of the datasets (muHz).
+//      gridTolerance:          the maximum deviation of the frequencies from a uniform grid, in units of
+//                              the frequency resolution, for the dataset to be flagged as uniformly spaced.
+//
+// OUTPUT:
+//      void
+//
+
+void SpectrumContainer::pack(const string fileName, const vector<string> &starIDs, const vector<string> &spectrumFileNames,
+                             const vector<double> &NyquistFrequencies, const double gridTolerance)
+{
+    // Sort the stars by ID, as required by the binary search of the index
+
+    vector<size_t> order(starIDs.size());
+
+    for (size_t star = 0; star < order.size(); ++star)
+    {
+        order[star] = star;
+
+        if (starIDs[star].size() >= sizeof(IndexEntry().starID))
+        {
+            cerr << "Star ID " << starIDs[star] << " is too long for the spectrum container." << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    sort(order.begin(), order.end(), [&starIDs](size_t star1, size_t star2) { return starIDs[star1] < starIDs[star2]; });
+
+    for (size_t star = 1; star < order.size(); ++star)
+    {
+        if (starIDs[order[star]] == starIDs[order[star - 1]])
+        {
+            cerr << "Star ID " << starIDs[order[star]] << " is listed more than once." << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    ofstream outputFile(fileName.c_str(), ios::binary);
+
+    if (!outputFile.good())
+    {
+        cerr << "Error opening output file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    Header fileHeader;
+    memset(&fileHeader, 0, sizeof(Header));
+    outputFile.write(reinterpret_cast<const char*>(&fileHeader), sizeof(Header));
+
+    vector<IndexEntry> entries(order.size());
+    const char padding[alignment] = {0};
+    uint64_t offset = sizeof(Header);
+
+    for (size_t star = 0; star < order.size(); ++star)
+    {
+        ifstream inputFile;
+        unsigned long Nrows;
+        int Ncols;
+        File::openInputFile(inputFile, spectrumFileNames[order[star]]);
+        File::sniffFile(inputFile, Nrows, Ncols);
+
+        if ((Ncols < 2) || (Nrows < 2))
+        {
+            cerr << "Dataset " << spectrumFileNames[order[star]] << " must contain at least two columns and two rows." << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        ArrayXXd data = File::arrayXXdFromFile(inputFile, Nrows, Ncols);
+        inputFile.close();
+
+
+        // Describe the frequency grid, which is uniform if no frequency deviates by more than
+        // the tolerance from the grid defined by the first frequency and the average spacing
+
+        ArrayXd frequencies = data.col(0);
+        double frequencyResolution = (frequencies(Nrows - 1) - frequencies(0)) / (Nrows - 1);
+        ArrayXd uniformFrequencies = ArrayXd::LinSpaced(Nrows, frequencies(0), frequencies(Nrows - 1));
+        double maxDeviation = (frequencies - uniformFrequencies).abs().maxCoeff();
+
+        IndexEntry &entry = entries[star];
+        memset(&entry, 0, sizeof(IndexEntry));
+        strncpy(entry.starID, starIDs[order[star]].c_str(), sizeof(entry.starID) - 1);
+        entry.Nbins = Nrows;
+        entry.NyquistFrequency = NyquistFrequencies[order[star]];
+        entry.startingFrequency = frequencies(0);
+        entry.frequencyResolution = frequencyResolution;
+        entry.uniformGrid = (maxDeviation <= gridTolerance * frequencyResolution) ? 1 : 0;
+
+
+        // Write the two columns of the dataset, starting from a multiple of the alignment
+
+        size_t NpaddingBytes = (alignment - offset % alignment) % alignment;
+        outputFile.write(padding, NpaddingBytes);
+        offset += NpaddingBytes;
+        entry.dataOffset = offset;
+
+        outputFile.write(reinterpret_cast<const char*>(data.col(0).data()), Nrows * sizeof(double));
+        outputFile.write(reinterpret_cast<const char*>(data.col(1).data()), Nrows * sizeof(double));
+        offset += 2 * Nrows * sizeof(double);
+    }
+
+
+    // Write the index at the end of the file and complete the header
+
+    size_t NpaddingBytes = (alignment - offset % alignment) % alignment;
+    outputFile.write(padding, NpaddingBytes);
+    offset += NpaddingBytes;
+
+    if (!entries.empty())
+    {
+        outputFile.write(reinterpret_cast<const char*>(&entries[0]), entries.size() * sizeof(IndexEntry));
+    }
+
+    memcpy(fileHeader.magic, "BKGSPEC", 8);
+    fileHeader.version = currentVersion;
+    fileHeader.byteOrderMark = byteOrderMark;
+    fileHeader.Nstars = entries.size();
+    fileHeader.indexOffset = offset;
+
+    outputFile.seekp(0);
+    outputFile.write(reinterpret_cast<const char*>(&fileHeader), sizeof(Header));
+
+    if (!outputFile.good())
+    {
+        cerr << "Error writing spectrum container " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    outputFile.close();
+}
@@ -0,0 +1,317 @@
+#include "SpectrumRebinner.h"
+
+
+// SpectrumRebinner::SpectrumRebinner()
+//
+// PURPOSE: 
+//      Constructor. Stores the input power spectrum to be rebinned.
+//      Before any rebinning is applied, the rebinned spectrum coincides with the input one.
+//
+// INPUT:
+//      covariates:             one-dimensional array containing the frequencies of the spectrum,
+//                              sorted in increasing order and uniformly sampled.
+//      observations:           one-dimensional array containing the power spectral density of each bin.
+//
+
+SpectrumRebinner::SpectrumRebinner(const ConstRefArrayXd covariates, const ConstRefArrayXd observations)
+: originalCovariates(covariates),
+  originalObservations(observations),
+  covariates(covariates),
+  observations(observations)
+{
+    if ((covariates.size() != observations.size()) || (covariates.size() < 2))
+    {
+        cerr << "Cannot rebin a spectrum with less than two bins or with mismatching array sizes." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    frequencyResolution = (covariates(covariates.size()-1) - covariates(0)) / (covariates.size() - 1);
+    
+    binWeights = ArrayXd::Ones(covariates.size());
+    binWidths = ArrayXd::Constant(covariates.size(), frequencyResolution);
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumRebinner::~SpectrumRebinner()
+//
+// PURPOSE: 
+//      Destructor.
+//
+
+SpectrumRebinner::~SpectrumRebinner()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumRebinner::rebinByFactor()
+//
+// PURPOSE:
+//      Rebins the input spectrum by averaging groups of consecutive bins. The last
+//      group can contain less bins than the rebinning factor, in which case its weight
+//      is reduced accordingly.
+//
+// INPUT:
+//      rebinningFactor:        an integer specifying the number of original bins averaged
+//                              into each new bin.
+//
+// OUTPUT:
+//      void
+//
+
+void SpectrumRebinner::rebinByFactor(const int rebinningFactor)
+{
+    if (rebinningFactor < 1)
+    {
+        cerr << "Rebinning factor has to be a positive integer." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    vector<int> firstIndices;
+
+    for (int index = 0; index < originalCovariates.size(); index += rebinningFactor)
+    {
+        firstIndices.push_back(index);
+    }
+
+    averageBins(firstIndices);
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumRebinner::rebinLogarithmically()
+//
+// PURPOSE:
+//      Rebins the input spectrum into bins that are equally spaced in the logarithm of the
+//      frequency. Original bins falling within the same logarithmic bin are averaged.
+//      At low frequency, where a logarithmic bin is narrower than the frequency resolution,
+//      the original bins are left unchanged. All the frequencies have to be positive.
+//
+// INPUT:
+//      NbinsPerDecade:         an integer specifying the number of logarithmic bins
+//                              per decade of frequency.
+//
+// OUTPUT:
+//      void
+//
+
+void SpectrumRebinner::rebinLogarithmically(const int NbinsPerDecade)
+{
+    if (NbinsPerDecade < 1)
+    {
+        cerr << "Number of logarithmic bins per decade has to be a positive integer." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (originalCovariates(0) <= 0.0)
+    {
+        cerr << "Logarithmic rebinning requires positive frequencies. Use a positive low-frequency threshold." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // The lower edge of the first bin is kept positive when the first frequency is within 
+    // half a frequency resolution from zero
+
+    double logStep = log(10.0) / NbinsPerDecade;
+    double minFrequency = max(originalCovariates(0) - frequencyResolution / 2.0, originalCovariates(0) / 2.0);
+    double logMinFrequency = log(minFrequency);
+    vector<int> firstIndices;
+    int previousLogBin = -1;
+
+    for (int index = 0; index < originalCovariates.size(); ++index)
+    {
+        int logBin = static_cast<int>(floor((log(originalCovariates(index)) - logMinFrequency) / logStep));
+        
+        if (logBin != previousLogBin)
+        {
+            firstIndices.push_back(index);
+            previousLogBin = logBin;
+        }
+    }
+
+    averageBins(firstIndices);
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumRebinner::averageBins()
+//
+// PURPOSE:
+//      Builds the rebinned spectrum by averaging the original bins between
+//      consecutive starting indices, and stores the weight and the width of each new bin.
+//
+// INPUT:
+//      firstIndices:       a vector of integers containing the index of the first original
+//                          bin of each new bin, sorted in increasing order.
+//
+// OUTPUT:
+//      void
+//
+
+void SpectrumRebinner::averageBins(const vector<int> &firstIndices)
+{
+    int Nbins = firstIndices.size();
+    int NoriginalBins = originalCovariates.size();
+
+    covariates.resize(Nbins);
+    observations.resize(Nbins);
+    binWeights.resize(Nbins);
+    binWidths.resize(Nbins);
+
+    for (int bin = 0; bin < Nbins; ++bin)
+    {
+        int firstIndex = firstIndices[bin];
+        int Nsegment = ((bin == Nbins-1) ? NoriginalBins : firstIndices[bin+1]) - firstIndex;
+
+        covariates(bin) = originalCovariates.segment(firstIndex, Nsegment).mean();
+        observations(bin) = originalObservations.segment(firstIndex, Nsegment).mean();
+        binWeights(bin) = Nsegment;
+        binWidths(bin) = Nsegment * frequencyResolution;
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumRebinner::getCovariates()
+//
+// PURPOSE:
+//      Gets the protected data member covariates.
+//
+// OUTPUT:
+//      An eigen array containing the central frequency of each rebinned bin.
+//
+
+ArrayXd SpectrumRebinner::getCovariates()
+{
+    return covariates;
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumRebinner::getObservations()
+//
+// PURPOSE:
+//      Gets the protected data member observations.
+//
+// OUTPUT:
+//      An eigen array containing the averaged power spectral density of each rebinned bin.
+//
+
+ArrayXd SpectrumRebinner::getObservations()
+{
+    return observations;
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumRebinner::getBinWeights()
+//
+// PURPOSE:
+//      Gets the protected data member binWeights.
+//
+// OUTPUT:
+//      An eigen array containing the number of original bins averaged into each rebinned bin.
+//
+
+ArrayXd SpectrumRebinner::getBinWeights()
+{
+    return binWeights;
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumRebinner::getBinWidths()
+//
+// PURPOSE:
+//      Gets the protected data member binWidths.
+//
+// OUTPUT:
+//      An eigen array containing the frequency width of each rebinned bin.
+//
+
+ArrayXd SpectrumRebinner::getBinWidths()
+{
+    return binWidths;
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumRebinner::getNbins()
+//
+// PURPOSE:
+//      Gets the number of bins of the rebinned spectrum.
+//
+// OUTPUT:
+//      An integer containing the number of rebinned bins.
+//
+
+int SpectrumRebinner::getNbins()
+{
+    return covariates.size();
+}
@@ -0,0 +1,195 @@
+#include "SpectrumTrimmer.h"
+
+
+// SpectrumTrimmer::SpectrumTrimmer()
+//
+// PURPOSE: 
+//      Constructor. Stores a reference to the frequencies of the spectrum to be trimmed.
+//      Before any trimming is applied, the trimmed range coincides with the entire spectrum.
+//
+// INPUT:
+//      frequencies:            one-dimensional array containing the frequencies of the spectrum,
+//                              sorted in increasing order. The array has to remain valid
+//                              as long as the trimmer is used.
+//
+
+SpectrumTrimmer::SpectrumTrimmer(const ConstRefArrayXd frequencies)
+: frequencies(frequencies.data()),
+  NinputBins(frequencies.size()),
+  firstBin(0),
+  Nbins(frequencies.size())
+{
+    if (NinputBins < 1)
+    {
+        cerr << "Cannot trim a spectrum without frequency bins." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (!is_sorted(this->frequencies, this->frequencies + NinputBins))
+    {
+        cerr << "The frequencies of the spectrum are not sorted in increasing order." << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumTrimmer::~SpectrumTrimmer()
+//
+// PURPOSE: 
+//      Destructor.
+//
+
+SpectrumTrimmer::~SpectrumTrimmer()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumTrimmer::trim()
+//
+// PURPOSE:
+//      Finds the range of bins with frequencies within the given thresholds, by means of
+//      a binary search on each side of the spectrum. The bins at a frequency equal to one 
+//      of the thresholds are kept.
+//
+// INPUT:
+//      lowFrequencyThreshold:      the lower boundary of the range (muHz). It is used only if it is 
+//                                  larger than the minimum frequency of the spectrum, and it is 
+//                                  set to 0 otherwise, meaning that it is not used within the computation.
+//      highFrequencyThreshold:     the upper boundary of the range (muHz). It is used only if it is
+//                                  smaller than the maximum frequency and larger than the minimum 
+//                                  frequency of the spectrum trimmed at low frequency, and it is 
+//                                  set to 0 otherwise.
+//
+// OUTPUT:
+//      void
+//
+
+void SpectrumTrimmer::trim(double &lowFrequencyThreshold, double &highFrequencyThreshold)
+{
+    const double *firstFrequency = frequencies;
+    const double *endFrequency = frequencies + NinputBins;
+
+    if ((lowFrequencyThreshold > *firstFrequency) && (lowFrequencyThreshold != 0.0))
+    {
+        firstFrequency = lower_bound(firstFrequency, endFrequency, lowFrequencyThreshold);
+    }
+    else
+    {
+        lowFrequencyThreshold = 0.0;
+    }
+
+    if (firstFrequency == endFrequency)
+    {
+        cerr << "No frequency bins above the low-frequency threshold of " << lowFrequencyThreshold << " muHz." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if ((highFrequencyThreshold < *(endFrequency - 1)) && (highFrequencyThreshold != 0.0) && (highFrequencyThreshold > *firstFrequency))
+    {
+        endFrequency = upper_bound(firstFrequency, endFrequency, highFrequencyThreshold);
+    }
+    else
+    {
+        highFrequencyThreshold = 0.0;
+    }
+
+    firstBin = firstFrequency - frequencies;
+    Nbins = endFrequency - firstFrequency;
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumTrimmer::getFirstBin()
+//
+// PURPOSE:
+//      Gets the position of the first bin of the trimmed range in the input spectrum.
+//
+// OUTPUT:
+//      The index of the first bin of the trimmed range.
+//
+
+long SpectrumTrimmer::getFirstBin()
+{
+    return firstBin;
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumTrimmer::getNbins()
+//
+// PURPOSE:
+//      Gets the number of bins of the trimmed range.
+//
+// OUTPUT:
+//      The number of bins of the trimmed range.
+//
+
+long SpectrumTrimmer::getNbins()
+{
+    return Nbins;
+}
+
+
+
+
+
+
+
+
+
+
+// SpectrumTrimmer::getTrimmedView()
+//
+// PURPOSE:
+//      Gets the trimmed range of an array defined on the bins of the input spectrum,
+//      e.g. its frequencies or its power spectral density, without copying it.
+//
+// INPUT:
+//      array:          one-dimensional array with one element for each bin of the input spectrum.
+//
+// OUTPUT:
+//      A read-only Eigen map referring to the elements of the input array within the trimmed range.
+//      It remains valid as long as the input array is neither resized nor destroyed.
+//
+
+Eigen::Map<const ArrayXd> SpectrumTrimmer::getTrimmedView(const ConstRefArrayXd array)
+{
+    if (array.size() != NinputBins)
+    {
+        cerr << "Cannot trim an array of " << array.size() << " elements on a spectrum of " << NinputBins << " bins." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    return Eigen::Map<const ArrayXd>(array.data() + firstBin, Nbins);
+}
@@ -0,0 +1,672 @@
+#include "SurrogateLikelihood.h"
+
+
+ArrayXd SurrogateLikelihood::noObservations;
+
+
+// SurrogateLikelihood::SurrogateLikelihood()
+//
+// PURPOSE: 
+//      Constructor.
+//
+// INPUT:
+//      likelihood:         the likelihood of the background model, which holds the observations.
+//      model:              an object of class Model specifying the background model.
+//      Ndimensions:        the number of free parameters.
+//      NtrainingPoints:    the number of the most recent exact evaluations used to fit the surrogate,
+//                          which is refitted every NtrainingPoints/10 exact evaluations.
+//      safetyFactor:       the number of RMS prediction errors by which the predicted log-likelihood
+//                          of a point must lie below the constraint for the point to be rejected.
+//      auditFraction:      the fraction of the rejected points that are evaluated exactly anyway.
+//      maxFalseRejectionRate:  the largest fraction of the audited points that may have a log-likelihood above
+//                              the constraint before the safety factor is widened.
+//
+
+SurrogateLikelihood::SurrogateLikelihood(Likelihood &likelihood, Model &model, const int Ndimensions, const int NtrainingPoints, 
+                                         const double safetyFactor, const double auditFraction, const double maxFalseRejectionRate)
+: Likelihood(noObservations, model),
+  likelihood(likelihood),
+  Ndimensions(Ndimensions),
+  NtrainingPoints(NtrainingPoints),
+  Ncoefficients(1 + Ndimensions + Ndimensions*(Ndimensions + 1)/2),
+  safetyFactor(safetyFactor),
+  auditFraction(auditFraction),
+  maxFalseRejectionRate(maxFalseRejectionRate),
+  screening(true),
+  Nwidenings(0),
+  uniform(0.0, 1.0),
+  logLikelihoodConstraint(-numeric_limits<double>::infinity()),
+  trainingPoints(Ndimensions, NtrainingPoints),
+  trainingLogLikelihood(NtrainingPoints),
+  NstoredPoints(0),
+  nextTrainingPoint(0),
+  NevaluationsSinceFit(0),
+  squaredResiduals(200),
+  Nresiduals(0),
+  nextResidual(0),
+  auditedSquaredResiduals(200),
+  NauditedResiduals(0),
+  nextAuditedResidual(0),
+  surrogateIsFitted(false),
+  logLikelihoodMean(0.0),
+  Nevaluations(0),
+  NscreenedPoints(0),
+  NauditedPoints(0),
+  NfalseRejections(0),
+  NauditedPointsSinceCheck(0),
+  NfalseRejectionsSinceCheck(0)
+{
+    if (NtrainingPoints < 2*Ncoefficients)
+    {
+        cerr << "The surrogate of the log-likelihood needs at least " << 2*Ncoefficients << " training points." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    random_device randomDevice;
+    engine.seed(randomDevice());
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::~SurrogateLikelihood()
+//
+// PURPOSE: 
+//      Destructor.
+//
+
+SurrogateLikelihood::~SurrogateLikelihood()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::logValue()
+//
+// PURPOSE:
+//      Computes the natural logarithm of the likelihood, unless the point is rejected by the surrogate
+//      because its predicted log-likelihood lies well below the current constraint. Each exact evaluation 
+//      is added to the training points, and its prediction error to the estimate of the RMS error, 
+//      separately for the audited points. The audited points are also checked for false rejections.
+//
+// INPUT:
+//      modelParameters:    one-dimensional array containing the free parameters of the model.
+//
+// OUTPUT:
+//      The natural logarithm of the likelihood, or its prediction if the point is rejected,
+//      which is then below the constraint.
+//
+
+double SurrogateLikelihood::logValue(RefArrayXd const modelParameters)
+{
+    double predictedLogLikelihood = numeric_limits<double>::quiet_NaN();
+    bool screened = false;
+
+    if (surrogateIsFitted && screening)
+    {
+        predictedLogLikelihood = predict(modelParameters);
+
+        if (std::isfinite(logLikelihoodConstraint) && std::isfinite(predictedLogLikelihood) && (Nresiduals >= 50)
+            && (predictedLogLikelihood + safetyFactor * getResidualRms() < logLikelihoodConstraint))
+        {
+            screened = true;
+            ++NscreenedPoints;
+
+            if (uniform(engine) >= auditFraction)
+            {
+                return predictedLogLikelihood;
+            }
+
+            ++NauditedPoints;
+            ++NauditedPointsSinceCheck;
+        }
+    }
+
+    double logLikelihoodValue = likelihood.logValue(modelParameters);
+    ++Nevaluations;
+
+    if (screened && (logLikelihoodValue > logLikelihoodConstraint))
+    {
+        ++NfalseRejections;
+        ++NfalseRejectionsSinceCheck;
+    }
+
+    if (screened)
+    {
+        addResidual(auditedSquaredResiduals, NauditedResiduals, nextAuditedResidual, logLikelihoodValue - predictedLogLikelihood);
+        checkFalseRejections();
+    }
+    else if (std::isfinite(predictedLogLikelihood))
+    {
+        addResidual(squaredResiduals, Nresiduals, nextResidual, logLikelihoodValue - predictedLogLikelihood);
+    }
+
+    addTrainingPoint(modelParameters, logLikelihoodValue);
+
+    return logLikelihoodValue;
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::setLogLikelihoodConstraint()
+//
+// PURPOSE:
+//      Sets the log-likelihood constraint of the point being drawn. Points are screened only for a 
+//      finite constraint, so that the initial live points, or any evaluation made outside the drawing 
+//      of a new point, are always exact.
+//
+// INPUT:
+//      logLikelihoodConstraint:    the log-likelihood constraint, or minus infinity to stop the screening.
+//
+// OUTPUT:
+//      void
+//
+
+void SurrogateLikelihood::setLogLikelihoodConstraint(const double logLikelihoodConstraint)
+{
+    this->logLikelihoodConstraint = logLikelihoodConstraint;
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::getNevaluations()
+//
+// PURPOSE:
+//      Gets the number of exact evaluations of the likelihood.
+//
+// OUTPUT:
+//      The number of exact evaluations.
+//
+
+long SurrogateLikelihood::getNevaluations()
+{
+    return Nevaluations;
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::getNscreenedPoints()
+//
+// PURPOSE:
+//      Gets the number of points rejected by the surrogate, including those audited.
+//
+// OUTPUT:
+//      The number of rejected points.
+//
+
+long SurrogateLikelihood::getNscreenedPoints()
+{
+    return NscreenedPoints;
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::getNauditedPoints()
+//
+// PURPOSE:
+//      Gets the number of points rejected by the surrogate and evaluated exactly anyway.
+//
+// OUTPUT:
+//      The number of audited points.
+//
+
+long SurrogateLikelihood::getNauditedPoints()
+{
+    return NauditedPoints;
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::getNfalseRejections()
+//
+// PURPOSE:
+//      Gets the number of audited points whose exact log-likelihood is above the constraint, namely 
+//      that would have been wrongly rejected without the audit.
+//
+// OUTPUT:
+//      The number of false rejections among the audited points.
+//
+
+long SurrogateLikelihood::getNfalseRejections()
+{
+    return NfalseRejections;
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::getResidualRms()
+//
+// PURPOSE:
+//      Gets the RMS of the most recent prediction errors of the surrogate. The points evaluated because not
+//      rejected lie mostly where the surrogate is accurate, so that their errors underestimate those of the 
+//      rejected points. Once enough points are audited, the larger of the two RMS errors is therefore adopted.
+//
+// OUTPUT:
+//      The RMS prediction error, in units of log-likelihood.
+//
+
+double SurrogateLikelihood::getResidualRms()
+{
+    if (Nresiduals == 0)
+    {
+        return numeric_limits<double>::infinity();
+    }
+
+    double residualRms = sqrt(squaredResiduals.head(Nresiduals).mean());
+
+    if (NauditedResiduals >= 10)
+    {
+        residualRms = max(residualRms, sqrt(auditedSquaredResiduals.head(NauditedResiduals).mean()));
+    }
+
+    return residualRms;
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::getSafetyFactor()
+//
+// PURPOSE:
+//      Gets the current safety factor, which is widened if the false rejections are too many.
+//
+// OUTPUT:
+//      The safety factor in RMS prediction errors.
+//
+
+double SurrogateLikelihood::getSafetyFactor()
+{
+    return safetyFactor;
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::isScreening()
+//
+// PURPOSE:
+//      Checks whether the drawn points are still screened, namely whether the screening was not
+//      stopped because of too many false rejections.
+//
+// OUTPUT:
+//      True if the points are screened, false otherwise.
+//
+
+bool SurrogateLikelihood::isScreening()
+{
+    return screening;
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::writeToFile()
+//
+// PURPOSE:
+//      Writes the outcome of the screening into an ASCII file.
+//
+// INPUT:
+//      fileName:       a string containing the full path of the output file.
+//
+// OUTPUT:
+//      void
+//
+
+void SurrogateLikelihood::writeToFile(const string fileName)
+{
+    ofstream outputFile;
+    File::openOutputFile(outputFile, fileName);
+
+    outputFile << "# Screening of the drawn points with a quadratic surrogate of the log-likelihood" << endl;
+    outputFile << "# Row #1: Number of training points" << endl;
+    outputFile << "# Row #2: Final safety factor in RMS prediction errors" << endl;
+    outputFile << "# Row #3: Audit fraction of the rejected points" << endl;
+    outputFile << "# Row #4: Largest rate of false rejections among the audited points" << endl;
+    outputFile << "# Row #5: Number of exact evaluations" << endl;
+    outputFile << "# Row #6: Number of points rejected by the surrogate" << endl;
+    outputFile << "# Row #7: Number of rejected points audited" << endl;
+    outputFile << "# Row #8: Number of false rejections among the audited points" << endl;
+    outputFile << "# Row #9: Number of times the safety factor was widened" << endl;
+    outputFile << "# Row #10: Screening active at the end of the run (1) or stopped (0)" << endl;
+    outputFile << "# Row #11: Final RMS prediction error" << endl;
+    outputFile << NtrainingPoints << endl;
+    outputFile << safetyFactor << endl;
+    outputFile << auditFraction << endl;
+    outputFile << maxFalseRejectionRate << endl;
+    outputFile << Nevaluations << endl;
+    outputFile << NscreenedPoints << endl;
+    outputFile << NauditedPoints << endl;
+    outputFile << NfalseRejections << endl;
+    outputFile << Nwidenings << endl;
+    outputFile << screening << endl;
+    outputFile << setprecision(6) << getResidualRms() << endl;
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::addTrainingPoint()
+//
+// PURPOSE:
+//      Adds an exact evaluation to the training points, replacing the oldest one once the buffer is full,
+//      and refits the surrogate every NtrainingPoints/10 exact evaluations.
+//
+// INPUT:
+//      modelParameters:        one-dimensional array containing the free parameters of the point.
+//      logLikelihoodValue:     the exact log-likelihood of the point.
+//
+// OUTPUT:
+//      void
+//
+
+void SurrogateLikelihood::addTrainingPoint(RefArrayXd const modelParameters, const double logLikelihoodValue)
+{
+    if (!std::isfinite(logLikelihoodValue))
+    {
+        return;
+    }
+
+    trainingPoints.col(nextTrainingPoint) = modelParameters;
+    trainingLogLikelihood(nextTrainingPoint) = logLikelihoodValue;
+    nextTrainingPoint = (nextTrainingPoint + 1) % NtrainingPoints;
+    NstoredPoints = min(NstoredPoints + 1, NtrainingPoints);
+    ++NevaluationsSinceFit;
+
+    if ((NstoredPoints >= 2*Ncoefficients) && (NevaluationsSinceFit >= max(NtrainingPoints/10, 1)))
+    {
+        fit();
+        NevaluationsSinceFit = 0;
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::addResidual()
+//
+// PURPOSE:
+//      Adds a prediction error to a ring buffer of the most recent ones.
+//
+// INPUT:
+//      buffer:         the ring buffer of the squared prediction errors.
+//      Nstored:        the number of prediction errors stored in the buffer, updated.
+//      next:           the position of the next prediction error in the buffer, updated.
+//      residual:       the exact minus the predicted log-likelihood of a point.
+//
+// OUTPUT:
+//      void
+//
+
+void SurrogateLikelihood::addResidual(ArrayXd &buffer, int &Nstored, int &next, const double residual)
+{
+    if (!std::isfinite(residual))
+    {
+        return;
+    }
+
+    buffer(next) = residual * residual;
+    next = (next + 1) % buffer.size();
+    Nstored = min(Nstored + 1, static_cast<int>(buffer.size()));
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::checkFalseRejections()
+//
+// PURPOSE:
+//      Checks the rate of false rejections among the points audited since the last check, once at least
+//      20 points are audited. If the rate is above the tolerance, the safety factor is widened by 50%, 
+//      and after three widenings that did not bring the rate below the tolerance the screening is stopped, 
+//      so that all the remaining drawn points are evaluated exactly.
+//
+// OUTPUT:
+//      void
+//
+
+void SurrogateLikelihood::checkFalseRejections()
+{
+    const long minNauditedPoints = 20;
+    const int maxNwidenings = 3;
+
+    if (NauditedPointsSinceCheck < minNauditedPoints)
+    {
+        return;
+    }
+
+    double falseRejectionRate = static_cast<double>(NfalseRejectionsSinceCheck) / NauditedPointsSinceCheck;
+    NauditedPointsSinceCheck = 0;
+    NfalseRejectionsSinceCheck = 0;
+
+    if (falseRejectionRate <= maxFalseRejectionRate)
+    {
+        return;
+    }
+
+    if (Nwidenings < maxNwidenings)
+    {
+        safetyFactor *= 1.5;
+        ++Nwidenings;
+    }
+    else
+    {
+        screening = false;
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::fit()
+//
+// PURPOSE:
+//      Fits the quadratic surrogate to the training points by least squares. The free parameters are
+//      standardized with the mean and standard deviation of the training points, and the normal equations 
+//      are solved with a small ridge term to keep them well conditioned.
+//
+// OUTPUT:
+//      void
+//
+
+void SurrogateLikelihood::fit()
+{
+    ArrayXXd points = trainingPoints.leftCols(NstoredPoints);
+    ArrayXd values = trainingLogLikelihood.head(NstoredPoints);
+
+    parameterMean = points.rowwise().mean();
+    parameterScale = ((points.colwise() - parameterMean).square().rowwise().mean()).sqrt();
+    parameterScale = (parameterScale > 0.0).select(parameterScale, 1.0);
+    logLikelihoodMean = values.mean();
+
+    MatrixXd design(NstoredPoints, Ncoefficients);
+
+    for (int point = 0; point < NstoredPoints; ++point)
+    {
+        ArrayXd scaledParameters = (points.col(point) - parameterMean) / parameterScale;
+        design.row(point) = computeFeatures(scaledParameters).transpose();
+    }
+
+    MatrixXd normalMatrix = design.transpose() * design;
+    normalMatrix.diagonal().array() += 1.e-10 * normalMatrix.diagonal().maxCoeff();
+    VectorXd rightHandSide = design.transpose() * (values - logLikelihoodMean).matrix();
+    Eigen::LDLT<MatrixXd> solver(normalMatrix);
+
+    if (solver.info() != Eigen::Success)
+    {
+        return;
+    }
+
+    coefficients = solver.solve(rightHandSide);
+    surrogateIsFitted = coefficients.allFinite();
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::predict()
+//
+// PURPOSE:
+//      Predicts the log-likelihood of a point with the surrogate.
+//
+// INPUT:
+//      modelParameters:    one-dimensional array containing the free parameters of the point.
+//
+// OUTPUT:
+//      The predicted log-likelihood.
+//
+
+double SurrogateLikelihood::predict(RefArrayXd const modelParameters)
+{
+    ArrayXd scaledParameters = (modelParameters - parameterMean) / parameterScale;
+
+    return logLikelihoodMean + computeFeatures(scaledParameters).dot(coefficients);
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateLikelihood::computeFeatures()
+//
+// PURPOSE:
+//      Computes the terms of the quadratic surrogate for a point, namely a constant, the
+//      standardized free parameters and all their products of second order.
+//
+// INPUT:
+//      scaledParameters:   one-dimensional array containing the standardized free parameters.
+//
+// OUTPUT:
+//      A vector containing the Ncoefficients terms of the surrogate.
+//
+
+VectorXd SurrogateLikelihood::computeFeatures(const ArrayXd &scaledParameters)
+{
+    VectorXd features(Ncoefficients);
+    int feature = 0;
+    features(feature++) = 1.0;
+
+    for (int i = 0; i < Ndimensions; ++i)
+    {
+        features(feature++) = scaledParameters(i);
+    }
+
+    for (int i = 0; i < Ndimensions; ++i)
+    {
+        for (int j = i; j < Ndimensions; ++j)
+        {
+            features(feature++) = scaledParameters(i) * scaledParameters(j);
+        }
+    }
+
+    return features;
+}
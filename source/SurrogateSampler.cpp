@@ -0,0 +1,85 @@
+#include "SurrogateSampler.h"
+
+
+// SurrogateSampler::SurrogateSampler()
+//
+// PURPOSE:
+//      Constructor. The inputs are the same of the racing sampler, with in addition:
+//
+// INPUT:
+//      surrogateLikelihood:    a pointer to the surrogate of the log-likelihood, which must be the likelihood
+//                              given to the sampler, or nullptr if the drawn points are not screened.
+//
+
+SurrogateSampler::SurrogateSampler(const bool printOnTheScreen, vector<Prior*> ptrPriors, Likelihood &likelihood, Metric &metric, 
+                                   Clusterer &clusterer, const int initialNlivePoints, const int minNlivePoints, 
+                                   const double initialEnlargementFraction, const double shrinkingRate, 
+                                   EvidenceRace *evidenceRace, const int NiterationsPerUpdate, 
+                                   SurrogateLikelihood *surrogateLikelihood)
+: RacingSampler(printOnTheScreen, ptrPriors, likelihood, metric, clusterer, initialNlivePoints, minNlivePoints, 
+                initialEnlargementFraction, shrinkingRate, evidenceRace, NiterationsPerUpdate),
+  surrogateLikelihood(surrogateLikelihood)
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateSampler::~SurrogateSampler()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+SurrogateSampler::~SurrogateSampler()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// SurrogateSampler::drawWithConstraint()
+//
+// PURPOSE:
+//      Draws a new point with a likelihood larger than the given constraint, as the racing sampler does,
+//      while the surrogate screens the drawn points against the same constraint. Since a rejected point
+//      gets a log-likelihood below the constraint, the new point is always evaluated exactly.
+//
+// INPUT:
+//      The same of MultiEllipsoidSampler::drawWithConstraint().
+//
+// OUTPUT:
+//      True if a new point is drawn, false if the drawing failed or the run is dominated.
+//
+
+bool SurrogateSampler::drawWithConstraint(const RefArrayXXd totalSample, const unsigned int Nclusters, const vector<int> &clusterIndices,
+                                          const vector<int> &clusterSizes, RefArrayXd drawnPoint, 
+                                          double &logLikelihoodOfDrawnPoint, const int maxNdrawAttempts)
+{
+    if (surrogateLikelihood == nullptr)
+    {
+        return RacingSampler::drawWithConstraint(totalSample, Nclusters, clusterIndices, clusterSizes, drawnPoint,
+                                                 logLikelihoodOfDrawnPoint, maxNdrawAttempts);
+    }
+
+    surrogateLikelihood->setLogLikelihoodConstraint(logLikelihoodOfDrawnPoint);
+    bool pointIsDrawn = RacingSampler::drawWithConstraint(totalSample, Nclusters, clusterIndices, clusterSizes, drawnPoint,
+                                                          logLikelihoodOfDrawnPoint, maxNdrawAttempts);
+    surrogateLikelihood->setLogLikelihoodConstraint(-numeric_limits<double>::infinity());
+
+    return pointIsDrawn;
+}
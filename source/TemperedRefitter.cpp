@@ -0,0 +1,780 @@
+#include "TemperedRefitter.h"
+
+
+// TemperedRefitter::TemperedRefitter()
+//
+// PURPOSE:
+//      Constructor.
+//
+// INPUT:
+//      previousRun:            the results of the previous run, on the previous dataset.
+//      ptrPriors:              vector of pointers to the uniform priors of the new run.
+//      previousLikelihood:     the likelihood of the previous dataset, as used by the previous run.
+//      likelihood:             the likelihood of the new dataset.
+//
+
+TemperedRefitter::TemperedRefitter(PreviousRun &previousRun, vector<Prior*> ptrPriors, Likelihood &previousLikelihood, 
+                                   Likelihood &likelihood)
+: previousRun(previousRun),
+  ptrPriors(ptrPriors),
+  previousLikelihood(previousLikelihood),
+  likelihood(likelihood),
+  logEvidence(-numeric_limits<double>::infinity()),
+  logEvidenceVariance(0.0),
+  proposalScale(0.0),
+  acceptanceRate(0.0),
+  posteriorShift(numeric_limits<double>::infinity()),
+  Nsteps(0),
+  Nevaluations(0)
+{
+    random_device randomDevice;
+    engine.seed(randomDevice());
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::~TemperedRefitter()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+TemperedRefitter::~TemperedRefitter()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::refit()
+//
+// PURPOSE:
+//      Moves the posterior sample of the previous run to the posterior of the new dataset by SMC tempering.
+//      The posterior sample is first reweighted to the new priors, and to the previous likelihood as computed 
+//      here, which must reproduce that of the previous run, and resampled into equally-weighted particles. 
+//      Once the tempering is completed, the shift of the posterior is measured as the largest difference
+//      between the new and the previous posterior mean of a free parameter, in units of its previous posterior
+//      standard deviation.
+//
+// INPUT:
+//      Nparticles:         the number of particles.
+//      NmovesPerStep:      the number of Metropolis steps of each particle after each resampling.
+//      maxNsteps:          the maximum number of tempering steps.
+//
+// OUTPUT:
+//      True if the tempering is completed, false otherwise, e.g. because the new priors extend
+//      beyond the previous ones or the maximum number of steps is reached (see getFailureReason()).
+//
+
+bool TemperedRefitter::refit(const int Nparticles, const int NmovesPerStep, const int maxNsteps)
+{
+    double logPriorRatio = previousRun.getLogPriorRatio(ptrPriors, minima, maxima);
+
+    if (std::isnan(logPriorRatio))
+    {
+        failureReason = "the priors are not uniform or extend beyond those of the previous run";
+        return false;
+    }
+
+    ArrayXXd previousSample = previousRun.getPosteriorSample();
+    ArrayXd storedLogLikelihood = previousRun.getLogLikelihoodOfPosteriorSample();
+    ArrayXd logWeights = previousRun.getLogWeightOfPosteriorSample();
+    ArrayXd recomputedLogLikelihood = storedLogLikelihood;
+    int Ndimensions = previousSample.rows();
+
+
+    // Reweight the previous sample to the new priors and to the previous likelihood computed here,
+    // which differs from the stored one only by the rounding of the output files
+
+    for (int sample = 0; sample < previousSample.cols(); ++sample)
+    {
+        ArrayXd parameters = previousSample.col(sample);
+
+        if ((parameters < minima).any() || (parameters > maxima).any())
+        {
+            logWeights(sample) = -numeric_limits<double>::infinity();
+            continue;
+        }
+
+        recomputedLogLikelihood(sample) = previousLikelihood.logValue(parameters);
+        ++Nevaluations;
+
+        if (fabs(recomputedLogLikelihood(sample) - storedLogLikelihood(sample)) > 1.e-6*fabs(storedLogLikelihood(sample)) + 1.e-3)
+        {
+            failureReason = "the previous dataset does not reproduce the likelihood of the previous run";
+            return false;
+        }
+
+        logWeights(sample) += recomputedLogLikelihood(sample) - storedLogLikelihood(sample) + logPriorRatio;
+        logEvidence = Functions::logExpSum(logEvidence, logWeights(sample));
+    }
+
+    if (!std::isfinite(logEvidence))
+    {
+        failureReason = "no sampling point of the previous run is within the new priors";
+        return false;
+    }
+
+    vector<long> indices = resample(logWeights, Nparticles);
+    particles.resize(Ndimensions, Nparticles);
+    previousLogLikelihood.resize(Nparticles);
+    logLikelihoodOfParticles.resize(Nparticles);
+
+    for (int particle = 0; particle < Nparticles; ++particle)
+    {
+        particles.col(particle) = previousSample.col(indices[particle]);
+        previousLogLikelihood(particle) = recomputedLogLikelihood(indices[particle]);
+        logLikelihoodOfParticles(particle) = likelihood.logValue(particles.col(particle));
+        ++Nevaluations;
+    }
+
+    
+    // Temper from the previous likelihood to the new one
+
+    double beta = 0.0;
+    proposalScale = 2.38 / sqrt(Ndimensions);
+    logEvidenceVariance = pow(previousRun.getLogEvidenceError(), 2);
+
+    while (beta < 1.0)
+    {
+        if (Nsteps >= maxNsteps)
+        {
+            failureReason = "the maximum number of tempering steps is reached";
+            return false;
+        }
+
+        double temperatureIncrement = findTemperatureIncrement(beta, 0.5 * Nparticles);
+        ArrayXd logIncrements = temperatureIncrement * (logLikelihoodOfParticles - previousLogLikelihood);
+        double maxLogIncrement = logIncrements.maxCoeff();
+        ArrayXd increments = (logIncrements - maxLogIncrement).exp();
+        double meanIncrement = increments.mean();
+
+        logEvidence += maxLogIncrement + log(meanIncrement);
+        logEvidenceVariance += (increments.square().mean() / (meanIncrement * meanIncrement) - 1.0) / Nparticles;
+        beta = (beta + temperatureIncrement > 1.0 - 1.e-12) ? 1.0 : beta + temperatureIncrement;
+
+        indices = resample(logIncrements, Nparticles);
+        ArrayXXd resampledParticles(Ndimensions, Nparticles);
+        ArrayXd resampledPreviousLogLikelihood(Nparticles);
+        ArrayXd resampledLogLikelihood(Nparticles);
+
+        for (int particle = 0; particle < Nparticles; ++particle)
+        {
+            resampledParticles.col(particle) = particles.col(indices[particle]);
+            resampledPreviousLogLikelihood(particle) = previousLogLikelihood(indices[particle]);
+            resampledLogLikelihood(particle) = logLikelihoodOfParticles(indices[particle]);
+        }
+
+        particles.swap(resampledParticles);
+        previousLogLikelihood.swap(resampledPreviousLogLikelihood);
+        logLikelihoodOfParticles.swap(resampledLogLikelihood);
+
+        move(beta, NmovesPerStep);
+        ++Nsteps;
+    }
+
+
+    // Shift of the posterior with respect to the previous one
+
+    ArrayXd previousProbability = (previousRun.getLogWeightOfPosteriorSample() - previousRun.getLogEvidence()).exp();
+    previousProbability /= previousProbability.sum();
+    ArrayXd previousMean = (previousSample.rowwise() * previousProbability.transpose()).rowwise().sum();
+    ArrayXd previousStandardDeviation = ((previousSample.colwise() - previousMean).square().rowwise() 
+                                         * previousProbability.transpose()).rowwise().sum().sqrt();
+    ArrayXd mean = particles.rowwise().mean();
+    posteriorShift = 0.0;
+
+    for (int parameter = 0; parameter < Ndimensions; ++parameter)
+    {
+        if (previousStandardDeviation(parameter) > 0.0)
+        {
+            posteriorShift = max(posteriorShift, fabs(mean(parameter) - previousMean(parameter)) / previousStandardDeviation(parameter));
+        }
+    }
+
+    return true;
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::getPosteriorSample()
+//
+// PURPOSE:
+//      Gets the posterior sample of the new dataset, namely the final particles.
+//
+// OUTPUT:
+//      A two-dimensional array of size (Ndimensions, Nparticles) containing the posterior sample.
+//
+
+ArrayXXd TemperedRefitter::getPosteriorSample()
+{
+    return particles;
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::getLogLikelihoodOfPosteriorSample()
+//
+// PURPOSE:
+//      Gets the log-likelihood of the new dataset for the posterior sample.
+//
+// OUTPUT:
+//      A one-dimensional array containing the log-likelihood of each particle.
+//
+
+ArrayXd TemperedRefitter::getLogLikelihoodOfPosteriorSample()
+{
+    return logLikelihoodOfParticles;
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::getLogWeightOfPosteriorSample()
+//
+// PURPOSE:
+//      Gets the log-weights of the posterior sample, which are all equal and sum up to the evidence,
+//      as the nested sampling weights.
+//
+// OUTPUT:
+//      A one-dimensional array containing the log-weight of each particle.
+//
+
+ArrayXd TemperedRefitter::getLogWeightOfPosteriorSample()
+{
+    return ArrayXd::Constant(particles.cols(), logEvidence - log(static_cast<double>(particles.cols())));
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::getLogEvidence()
+//
+// PURPOSE:
+//      Gets the natural logarithm of the evidence of the new dataset.
+//
+// OUTPUT:
+//      The log-evidence.
+//
+
+double TemperedRefitter::getLogEvidence()
+{
+    return logEvidence;
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::getLogEvidenceError()
+//
+// PURPOSE:
+//      Gets the error on the natural logarithm of the evidence, combining that of the previous run
+//      with the variance of the mean weight of each tempering step.
+//
+// OUTPUT:
+//      The error on the log-evidence.
+//
+
+double TemperedRefitter::getLogEvidenceError()
+{
+    return sqrt(logEvidenceVariance);
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::getInformationGain()
+//
+// PURPOSE:
+//      Gets the information gain of the posterior of the new dataset relative to the priors.
+//
+// OUTPUT:
+//      The information gain in natural units.
+//
+
+double TemperedRefitter::getInformationGain()
+{
+    return logLikelihoodOfParticles.mean() - logEvidence;
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::getPosteriorShift()
+//
+// PURPOSE:
+//      Gets the shift of the posterior of the new dataset with respect to the previous one.
+//
+// OUTPUT:
+//      The largest shift of the posterior mean of a free parameter, in units of its previous
+//      posterior standard deviation.
+//
+
+double TemperedRefitter::getPosteriorShift()
+{
+    return posteriorShift;
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::getFailureReason()
+//
+// PURPOSE:
+//      Gets the reason why the tempering could not be completed.
+//
+// OUTPUT:
+//      A string describing the reason, empty if the tempering was completed.
+//
+
+string TemperedRefitter::getFailureReason()
+{
+    return failureReason;
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::getNsteps()
+//
+// PURPOSE:
+//      Gets the number of tempering steps.
+//
+// OUTPUT:
+//      The number of tempering steps.
+//
+
+int TemperedRefitter::getNsteps()
+{
+    return Nsteps;
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::getNevaluations()
+//
+// PURPOSE:
+//      Gets the total number of evaluations of the previous and of the new likelihood.
+//
+// OUTPUT:
+//      The number of likelihood evaluations.
+//
+
+long TemperedRefitter::getNevaluations()
+{
+    return Nevaluations;
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::writeToFile()
+//
+// PURPOSE:
+//      Writes the outcome of the tempering into an ASCII file.
+//
+// INPUT:
+//      fileName:       a string containing the full path of the output file.
+//
+// OUTPUT:
+//      void
+//
+
+void TemperedRefitter::writeToFile(const string fileName)
+{
+    ofstream outputFile;
+    File::openOutputFile(outputFile, fileName);
+
+    outputFile << "# SMC tempering of the posterior sample of a previous run to a new dataset" << endl;
+    outputFile << "# Row #1: Output path prefix of the previous run" << endl;
+    outputFile << "# Row #2: log(Evidence) of the previous run" << endl;
+    outputFile << "# Row #3: Number of particles" << endl;
+    outputFile << "# Row #4: Number of tempering steps" << endl;
+    outputFile << "# Row #5: Number of likelihood evaluations" << endl;
+    outputFile << "# Row #6: Acceptance rate of the last Metropolis steps" << endl;
+    outputFile << "# Row #7: Shift of the posterior mean in previous posterior standard deviations" << endl;
+    outputFile << previousRun.getRunPathPrefix() << endl;
+    outputFile << setprecision(12) << previousRun.getLogEvidence() << endl;
+    outputFile << particles.cols() << endl;
+    outputFile << Nsteps << endl;
+    outputFile << Nevaluations << endl;
+    outputFile << acceptanceRate << endl;
+    outputFile << posteriorShift << endl;
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::refitDataset()
+//
+// PURPOSE:
+//      Refits the model on a new dataset by tempering the posterior sample of the previous run. 
+//      The previous likelihood uses the previous dataset, trimmed with the thresholds of the previous run, 
+//      and the same background model, evaluated on the previous frequencies. If the tempering ends and 
+//      the posterior does not shift too much, the outcome of the tempering is written in the file
+//      temperedRefit.txt, and its results are set into the nested sampler of the run, so that they are 
+//      written in the same output files of a nested sampling run.
+//
+// INPUT:
+//      nestedSampler:              the nested sampler of the run, which receives the results of the refit.
+//      previousRun:                the results of the previous run, on the previous dataset.
+//      ptrPriors:                  vector of pointers to the uniform priors of the new run.
+//      likelihood:                 the likelihood of the new dataset.
+//      previousDatasetFileName:    a string containing the full path of the ASCII file of the previous dataset.
+//      backgroundModelName:        the name of the background model of the run.
+//      NyquistFrequency:           the Nyquist frequency of the dataset, in muHz.
+//      Nparticles:                 the number of particles.
+//      NmovesPerStep:              the number of Metropolis steps of each particle after each resampling.
+//      maxNsteps:                  the maximum number of tempering steps.
+//      maxPosteriorShift:          the maximum shift of the posterior mean of a free parameter, in previous 
+//                                  posterior standard deviations, for the refit to be adopted.
+//      outputPathPrefix:           the path prefix of the output files of the run.
+//
+// OUTPUT:
+//      True if the refit is adopted, false if a full run is needed instead.
+//
+
+bool TemperedRefitter::refitDataset(NestedSampler &nestedSampler, PreviousRun &previousRun, vector<Prior*> ptrPriors, 
+                                    Likelihood &likelihood, const string previousDatasetFileName, const string backgroundModelName, 
+                                    const double NyquistFrequency, const int Nparticles, const int NmovesPerStep, 
+                                    const int maxNsteps, const double maxPosteriorShift, const string outputPathPrefix)
+{
+    ifstream inputFile;
+    unsigned long Nrows;
+    int Ncols;
+    File::openInputFile(inputFile, previousDatasetFileName);
+    File::sniffFile(inputFile, Nrows, Ncols);
+    ArrayXXd previousData = File::arrayXXdFromFile(inputFile, Nrows, Ncols);
+    inputFile.close();
+
+    double previousLowFrequencyThreshold = previousRun.getLowFrequencyThreshold();
+    double previousHighFrequencyThreshold = previousRun.getHighFrequencyThreshold();
+    SpectrumTrimmer previousTrimmer(previousData.col(0));
+    previousTrimmer.trim(previousLowFrequencyThreshold, previousHighFrequencyThreshold);
+    ArrayXd previousCovariates = previousTrimmer.getTrimmedView(previousData.col(0));
+    ArrayXd previousObservations = previousTrimmer.getTrimmedView(previousData.col(1));
+    previousData.resize(0, 0);
+
+    ArrayXd noBinWeights;
+    BackgroundModel *previousModel = BackgroundModelRegistry::createModel(backgroundModelName, previousCovariates, "");
+    previousModel->setNyquistFrequency(NyquistFrequency);
+    GammaLikelihood previousLikelihood(previousObservations, noBinWeights, *previousModel);
+
+    TemperedRefitter temperedRefitter(previousRun, ptrPriors, previousLikelihood, likelihood);
+    bool refitCompleted = temperedRefitter.refit(Nparticles, NmovesPerStep, maxNsteps);
+    bool refitAdopted = refitCompleted && (temperedRefitter.getPosteriorShift() <= maxPosteriorShift);
+
+    if (refitAdopted)
+    {
+        temperedRefitter.writeToFile(outputPathPrefix + "temperedRefit.txt");
+        ResultsWriter::setResults(nestedSampler, temperedRefitter.getPosteriorSample(), temperedRefitter.getLogLikelihoodOfPosteriorSample(),
+                                  temperedRefitter.getLogWeightOfPosteriorSample(), temperedRefitter.getLogEvidence(),
+                                  temperedRefitter.getLogEvidenceError(), temperedRefitter.getInformationGain());
+
+        cout << " Tempered refit of the previous run: log(Evidence) = " << setprecision(10) 
+             << temperedRefitter.getLogEvidence() << " in " << temperedRefitter.getNsteps() << " steps and " 
+             << temperedRefitter.getNevaluations() << " likelihood evaluations, posterior shift = " 
+             << setprecision(3) << temperedRefitter.getPosteriorShift() << endl;
+    }
+    else if (refitCompleted)
+    {
+        cout << " Posterior shift from the previous run is " << setprecision(3) << temperedRefitter.getPosteriorShift() 
+             << ", above " << maxPosteriorShift << ": a full run is performed." << endl;
+    }
+    else
+    {
+        cout << " Tempered refit of the previous run failed, since " << temperedRefitter.getFailureReason() 
+             << ": a full run is performed." << endl;
+    }
+
+    delete previousModel;
+
+    return refitAdopted;
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::resample()
+//
+// PURPOSE:
+//      Draws a set of equally-weighted particles from a weighted sample by systematic resampling,
+//      with a random offset common to all the draws.
+//
+// INPUT:
+//      logWeights:     one-dimensional array containing the natural logarithm of the weights.
+//      Nparticles:     the number of particles to draw.
+//
+// OUTPUT:
+//      A vector containing the index of the sampling point selected by each particle.
+//
+
+vector<long> TemperedRefitter::resample(const ArrayXd &logWeights, const int Nparticles)
+{
+    uniform_real_distribution<> uniform(0.0, 1.0);
+    ArrayXd weights = (logWeights - logWeights.maxCoeff()).exp();
+    double totalWeight = weights.sum();
+    double offset = uniform(engine);
+    double cumulativeWeight = 0.0;
+    vector<long> indices(Nparticles);
+    long index = 0;
+
+    for (int particle = 0; particle < Nparticles; ++particle)
+    {
+        double threshold = (particle + offset) / Nparticles * totalWeight;
+
+        while ((index < weights.size() - 1) && (cumulativeWeight + weights(index) < threshold))
+        {
+            cumulativeWeight += weights(index);
+            ++index;
+        }
+
+        indices[particle] = index;
+    }
+
+    return indices;
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::move()
+//
+// PURPOSE:
+//      Moves the particles by Metropolis steps targeting the tempered posterior, proportional to the
+//      uniform prior times L_previous^(1 - beta) * L_new^beta. The Gaussian proposal has the covariance of
+//      the particles, scaled by a factor that is adapted after each step to keep the acceptance rate
+//      between 15% and 40%.
+//
+// INPUT:
+//      beta:       the current temperature.
+//      Nmoves:     the number of Metropolis steps of each particle.
+//
+// OUTPUT:
+//      void
+//
+
+void TemperedRefitter::move(const double beta, const int Nmoves)
+{
+    int Ndimensions = particles.rows();
+    int Nparticles = particles.cols();
+    normal_distribution<> normal(0.0, 1.0);
+    uniform_real_distribution<> uniform(0.0, 1.0);
+
+    MatrixXd centered = (particles.colwise() - particles.rowwise().mean()).matrix();
+    MatrixXd covariance = centered * centered.transpose() / Nparticles;
+    covariance.diagonal() += 1.e-12 * covariance.diagonal().cwiseAbs().maxCoeff() * VectorXd::Ones(Ndimensions);
+    Eigen::LLT<MatrixXd> cholesky(covariance);
+    MatrixXd choleskyFactor = (cholesky.info() == Eigen::Success) ? MatrixXd(cholesky.matrixL()) 
+                                                                  : MatrixXd(covariance.diagonal().cwiseSqrt().asDiagonal());
+
+    for (int step = 0; step < Nmoves; ++step)
+    {
+        int Naccepted = 0;
+
+        for (int particle = 0; particle < Nparticles; ++particle)
+        {
+            VectorXd deviates(Ndimensions);
+
+            for (int parameter = 0; parameter < Ndimensions; ++parameter)
+            {
+                deviates(parameter) = normal(engine);
+            }
+
+            ArrayXd proposal = particles.col(particle) + proposalScale * (choleskyFactor * deviates).array();
+
+            if ((proposal < minima).any() || (proposal > maxima).any())
+            {
+                continue;
+            }
+
+            // At beta = 1 the previous likelihood does not enter the target, and is not evaluated
+
+            double proposalLogLikelihood = likelihood.logValue(proposal);
+            double proposalPreviousLogLikelihood = previousLogLikelihood(particle);
+            double logAcceptance = proposalLogLikelihood - logLikelihoodOfParticles(particle);
+            ++Nevaluations;
+
+            if (beta < 1.0)
+            {
+                proposalPreviousLogLikelihood = previousLikelihood.logValue(proposal);
+                logAcceptance = (1.0 - beta) * (proposalPreviousLogLikelihood - previousLogLikelihood(particle)) 
+                                + beta * logAcceptance;
+                ++Nevaluations;
+            }
+
+            if (log(uniform(engine)) < logAcceptance)
+            {
+                particles.col(particle) = proposal;
+                previousLogLikelihood(particle) = proposalPreviousLogLikelihood;
+                logLikelihoodOfParticles(particle) = proposalLogLikelihood;
+                ++Naccepted;
+            }
+        }
+
+        acceptanceRate = static_cast<double>(Naccepted) / Nparticles;
+
+        if (acceptanceRate < 0.15)
+        {
+            proposalScale *= 0.7;
+        }
+        else if (acceptanceRate > 0.4)
+        {
+            proposalScale *= 1.3;
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// TemperedRefitter::findTemperatureIncrement()
+//
+// PURPOSE:
+//      Finds the increment of the temperature for which the effective sample size of the
+//      incremental weights of the particles equals a target value, by bisection.
+//
+// INPUT:
+//      beta:                           the current temperature.
+//      targetEffectiveSampleSize:      the target effective sample size.
+//
+// OUTPUT:
+//      The increment of the temperature, at most 1 - beta.
+//
+
+double TemperedRefitter::findTemperatureIncrement(const double beta, const double targetEffectiveSampleSize)
+{
+    ArrayXd logLikelihoodChange = logLikelihoodOfParticles - previousLogLikelihood;
+
+    if (PreviousRun::computeEffectiveSampleSize((1.0 - beta) * logLikelihoodChange) >= targetEffectiveSampleSize)
+    {
+        return 1.0 - beta;
+    }
+
+    double lowerIncrement = 0.0;
+    double upperIncrement = 1.0 - beta;
+
+    for (int iteration = 0; iteration < 60; ++iteration)
+    {
+        double increment = 0.5 * (lowerIncrement + upperIncrement);
+
+        if (PreviousRun::computeEffectiveSampleSize(increment * logLikelihoodChange) >= targetEffectiveSampleSize)
+        {
+            lowerIncrement = increment;
+        }
+        else
+        {
+            upperIncrement = increment;
+        }
+    }
+
+    return max(lowerIncrement, 1.e-12);
+}
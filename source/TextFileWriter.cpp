@@ -0,0 +1,464 @@
+#include "TextFileWriter.h"
+
+
+namespace
+{
+    // Powers of ten that are represented exactly in double precision
+
+    const double exactPowersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                       1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const int maxExactPowerOfTen = 22;
+
+
+    // Largest number of decimal digits formatted without printf. The scaled value
+    // must stay well below 2^53 to be represented exactly as an integer.
+
+    const int maxFastPrecision = 12;
+
+
+    // Multiplies a positive value by 10^exponent, with a relative error of at most
+    // half an ulp for each power of ten applied.
+
+    double scaleByPowerOfTen(double value, int exponent)
+    {
+        if (exponent >= 0)
+        {
+            while (exponent > maxExactPowerOfTen)
+            {
+                value *= exactPowersOfTen[maxExactPowerOfTen];
+                exponent -= maxExactPowerOfTen;
+            }
+
+            return value * exactPowersOfTen[exponent];
+        }
+        else
+        {
+            exponent = -exponent;
+
+            while (exponent > maxExactPowerOfTen)
+            {
+                value /= exactPowersOfTen[maxExactPowerOfTen];
+                exponent -= maxExactPowerOfTen;
+            }
+
+            return value / exactPowersOfTen[exponent];
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// TextFileWriter::TextFileWriter()
+//
+// PURPOSE:
+//      Constructor. Opens the output file and allocates the buffer.
+//
+// INPUT:
+//      fileName:       a string specifying the full path (filename included) of the output file.
+//      precision:      the number of decimal digits of the numbers written, as in setprecision.
+//      bufferSize:     the size in bytes of the buffer, which is written to disk every time it is full.
+//
+
+TextFileWriter::TextFileWriter(const string fileName, const int precision, const size_t bufferSize)
+: precision(precision),
+  buffer(bufferSize),
+  bufferPosition(0)
+{
+    outputFile = fopen(fileName.c_str(), "w");
+
+    if (outputFile == nullptr)
+    {
+        cerr << "Error opening output file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// TextFileWriter::~TextFileWriter()
+//
+// PURPOSE:
+//      Destructor. Writes the remaining content of the buffer and closes the output file.
+//
+
+TextFileWriter::~TextFileWriter()
+{
+    flush();
+    fclose(outputFile);
+}
+
+
+
+
+
+
+
+
+
+
+// TextFileWriter::writeValue()
+//
+// PURPOSE:
+//      Appends a number in scientific notation to the buffer.
+//
+// INPUT:
+//      value:      the number to be written.
+//
+// OUTPUT:
+//      void
+//
+
+void TextFileWriter::writeValue(const double value)
+{
+    reserve(precision + 32);
+    bufferPosition += formatScientific(value, precision, &buffer[bufferPosition]);
+}
+
+
+
+
+
+
+
+
+
+
+// TextFileWriter::writeText()
+//
+// PURPOSE:
+//      Appends a string to the buffer. Strings longer than the buffer are written directly to disk.
+//
+// INPUT:
+//      text:       the string to be written.
+//
+// OUTPUT:
+//      void
+//
+
+void TextFileWriter::writeText(const string &text)
+{
+    if (text.size() > buffer.size())
+    {
+        flush();
+
+        if (fwrite(text.data(), 1, text.size(), outputFile) != text.size())
+        {
+            cerr << "Error writing to output file." << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        return;
+    }
+
+    reserve(text.size());
+    memcpy(&buffer[bufferPosition], text.data(), text.size());
+    bufferPosition += text.size();
+}
+
+
+
+
+
+
+
+
+
+
+// TextFileWriter::writeArrayXd()
+//
+// PURPOSE:
+//      Writes all the elements of a one-dimensional array, each one followed by a terminator.
+//      The output is the same as that of File::arrayXdToFile().
+//
+// INPUT:
+//      array:          the Eigen array to be written.
+//      terminator:     the string written after each element.
+//
+// OUTPUT:
+//      void
+//
+
+void TextFileWriter::writeArrayXd(const ArrayXd &array, const string terminator)
+{
+    for (int i = 0; i < array.size(); ++i)
+    {
+        writeValue(array(i));
+        writeText(terminator);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// TextFileWriter::writeArrayXXd()
+//
+// PURPOSE:
+//      Writes all the elements of a two-dimensional array, one row per line.
+//      The output is the same as that of File::arrayXXdToFile().
+//
+// INPUT:
+//      array:          the Eigen array to be written.
+//      separator:      the string written between two elements of the same row.
+//      terminator:     the string written after each row.
+//
+// OUTPUT:
+//      void
+//
+
+void TextFileWriter::writeArrayXXd(const ArrayXXd &array, const string separator, const string terminator)
+{
+    for (int i = 0; i < array.rows(); ++i)
+    {
+        for (int j = 0; j < array.cols(); ++j)
+        {
+            writeValue(array(i, j));
+
+            if (j < array.cols() - 1)
+            {
+                writeText(separator);
+            }
+        }
+
+        writeText(terminator);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// TextFileWriter::flush()
+//
+// PURPOSE:
+//      Writes the content of the buffer to disk and empties the buffer.
+//
+// OUTPUT:
+//      void
+//
+
+void TextFileWriter::flush()
+{
+    if (bufferPosition == 0)
+    {
+        return;
+    }
+
+    if (fwrite(&buffer[0], 1, bufferPosition, outputFile) != bufferPosition)
+    {
+        cerr << "Error writing to output file." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    bufferPosition = 0;
+}
+
+
+
+
+
+
+
+
+
+
+// TextFileWriter::reserve()
+//
+// PURPOSE:
+//      Makes room in the buffer for a given number of characters, by writing
+//      the buffer to disk if it is too full.
+//
+// INPUT:
+//      Ncharacters:        the number of characters to be appended to the buffer.
+//
+// OUTPUT:
+//      void
+//
+
+void TextFileWriter::reserve(const size_t Ncharacters)
+{
+    if (bufferPosition + Ncharacters > buffer.size())
+    {
+        flush();
+    }
+
+    if (Ncharacters > buffer.size())
+    {
+        buffer.resize(Ncharacters);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// TextFileWriter::formatScientific()
+//
+// PURPOSE:
+//      Formats a number in scientific notation with a given number of decimal digits,
+//      giving the same characters of printf with the format %.<precision>e.
+//      The value is scaled by a power of ten so that its significant digits form an integer,
+//      which is rounded to nearest. The scaling has an error of a few ulp, so that the rounding
+//      is exact unless the scaled value is very close to a half-integer: in that case,
+//      as for non-finite values, the number is formatted by printf.
+//
+// INPUT:
+//      value:          the number to be formatted.
+//      precision:      the number of digits after the decimal point.
+//      output:         a pointer to the first character written. At least precision + 32
+//                      characters must be available.
+//
+// OUTPUT:
+//      The number of characters written. No terminating null character is written.
+//
+
+int TextFileWriter::formatScientific(const double value, const int precision, char *output)
+{
+    if (!std::isfinite(value) || (precision < 1) || (precision > maxFastPrecision))
+    {
+        return formatWithPrintf(value, precision, output);
+    }
+
+    char *position = output;
+    double absoluteValue = fabs(value);
+
+    if (std::signbit(value))
+    {
+        *position++ = '-';
+    }
+
+    if (absoluteValue == 0.0)
+    {
+        *position++ = '0';
+        *position++ = '.';
+        memset(position, '0', precision);
+        position += precision;
+        memcpy(position, "e+00", 4);
+        return position + 4 - output;
+    }
+
+
+    // Scale the value into [10^precision, 10^(precision+1)), correcting the decimal exponent
+    // when the logarithm is off by one close to a power of ten
+
+    int exponent = static_cast<int>(floor(log10(absoluteValue)));
+    double scaledValue = scaleByPowerOfTen(absoluteValue, precision - exponent);
+
+    if (scaledValue < exactPowersOfTen[precision])
+    {
+        exponent--;
+        scaledValue = scaleByPowerOfTen(absoluteValue, precision - exponent);
+    }
+    else if (scaledValue >= exactPowersOfTen[precision + 1])
+    {
+        exponent++;
+        scaledValue = scaleByPowerOfTen(absoluteValue, precision - exponent);
+    }
+
+    double integerPart = floor(scaledValue);
+    double fractionalPart = scaledValue - integerPart;
+
+    if (fabs(fractionalPart - 0.5) < scaledValue * 1.e-13)
+    {
+        return formatWithPrintf(value, precision, output);
+    }
+
+    uint64_t digits = static_cast<uint64_t>(integerPart) + (fractionalPart > 0.5 ? 1 : 0);
+
+    if (digits == static_cast<uint64_t>(exactPowersOfTen[precision + 1]))
+    {
+        digits /= 10;
+        exponent++;
+    }
+
+
+    // Write the significant digits from the last one, then the exponent with at least two digits
+
+    char *lastDigit = position + precision + 1;
+
+    for (char *digit = lastDigit; digit > position + 1; --digit)
+    {
+        *digit = static_cast<char>('0' + digits % 10);
+        digits /= 10;
+    }
+
+    position[0] = static_cast<char>('0' + digits);
+    position[1] = '.';
+    position = lastDigit + 1;
+
+    *position++ = 'e';
+    *position++ = (exponent < 0) ? '-' : '+';
+    int absoluteExponent = abs(exponent);
+
+    if (absoluteExponent >= 100)
+    {
+        *position++ = static_cast<char>('0' + absoluteExponent / 100);
+        absoluteExponent %= 100;
+    }
+
+    *position++ = static_cast<char>('0' + absoluteExponent / 10);
+    *position++ = static_cast<char>('0' + absoluteExponent % 10);
+
+    return position - output;
+}
+
+
+
+
+
+
+
+
+
+
+// TextFileWriter::formatWithPrintf()
+//
+// PURPOSE:
+//      Formats a number in scientific notation by means of snprintf, for the cases that
+//      are not handled by formatScientific().
+//
+// INPUT:
+//      value:          the number to be formatted.
+//      precision:      the number of digits after the decimal point.
+//      output:         a pointer to the first character written.
+//
+// OUTPUT:
+//      The number of characters written. No terminating null character is written.
+//
+
+int TextFileWriter::formatWithPrintf(const double value, const int precision, char *output)
+{
+    char formattedValue[400];
+    int Ncharacters = snprintf(formattedValue, sizeof(formattedValue), "%.*e", precision, value);
+    memcpy(output, formattedValue, Ncharacters);
+    return Ncharacters;
+}
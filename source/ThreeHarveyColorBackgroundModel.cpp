@@ -23,8 +23,16 @@ ThreeHarveyColorBackgroundModel::ThreeHarveyColorBackgroundModel(const RefArrayX
 
     readNyquistFrequencyFromFile(inputNyquistFrequencyFileName);
 
-    ArrayXd sincFunctionArgument = (Functions::PI / 2.0) * covariates / NyquistFrequency;
-    responseFunction = (sincFunctionArgument.sin() / sincFunctionArgument).square();
+    updateResponseFunction();
+
+    // Additive components of the model, each one scaled by one of the free parameters
+
+    addComponent("flatNoise", 0);
+    addComponent("coloredNoise", 1);
+    addComponent("harvey1", 3);
+    addComponent("harvey2", 5);
+    addComponent("harvey3", 7);
+    addComponent("envelope", 9);
 }
 
 
@@ -64,6 +72,9 @@ ThreeHarveyColorBackgroundModel::~ThreeHarveyColorBackgroundModel()
 //      and a Gaussian for modeling the oscillation envelope.
 //      A component for colored noise is included, more indicated for low-numax stars
 //
+//      The model is evaluated either on the stored covariates or on the implicit
+//      uniform frequency grid, if the latter has been activated.
+//
 // INPUT:
 //      predictions:        one-dimensional array to contain the predictions
 //                          from the model
@@ -87,44 +98,71 @@ ThreeHarveyColorBackgroundModel::~ThreeHarveyColorBackgroundModel()
 
 void ThreeHarveyColorBackgroundModel::predict(RefArrayXd predictions, RefArrayXd const modelParameters)
 {
-    // Initialize global parameters
+    if (uniformGrid && !singlePrecision)
+    {
+        predictOnFrequencies(predictions, gridCovariates(), responseFunction, modelParameters);
+    }
+    else if (uniformGrid)
+    {
+        predictOnFrequencies(predictions, gridCovariates(), compressedResponseFunction.cast<double>(), modelParameters);
+    }
+    else if (singlePrecision)
+    {
+        predictOnFrequencies(predictions, singlePrecisionCovariates.cast<double>(), compressedResponseFunction.cast<double>(), modelParameters);
+    }
+    else
+    {
+        predictOnFrequencies(predictions, covariates, responseFunction, modelParameters);
+    }
+}
 
-    double flatNoiseLevel = modelParameters(0);
-    double amplitudeNoise = modelParameters(1);
-    double frequencyNoise = modelParameters(2);
-    double amplitudeHarvey1 = modelParameters(3);
-    double frequencyHarvey1 = modelParameters(4);
-    double amplitudeHarvey2 = modelParameters(5);
-    double frequencyHarvey2 = modelParameters(6);
-    double amplitudeHarvey3 = modelParameters(7);
-    double frequencyHarvey3 = modelParameters(8);
-    double heightOscillation = modelParameters(9);
-    double nuMax = modelParameters(10);
-    double sigma = modelParameters(11);
 
 
-    // Compute Harvey components and add them to the predictions
 
-    double zeta = 2.0*sqrt(2.0)/Functions::PI;
-    predictions = zeta*amplitudeHarvey1*amplitudeHarvey1/(frequencyHarvey1*(1.0 + (covariates/frequencyHarvey1).pow(4)));
-    predictions += zeta*amplitudeHarvey2*amplitudeHarvey2/(frequencyHarvey2*(1.0 + (covariates/frequencyHarvey2).pow(4)));
-    predictions += zeta*amplitudeHarvey3*amplitudeHarvey3/(frequencyHarvey3*(1.0 + (covariates/frequencyHarvey3).pow(4)));
 
 
-    // Compute Gaussian envelope for RGB Oscillations and add it to the predictions
 
-    predictions += heightOscillation * exp(-1.0*(nuMax - covariates)*(nuMax - covariates)/(2.0 * sigma * sigma));
 
-    
-    // Modulate the model by the response function (apodization)
-    
-    predictions *= responseFunction;           
 
 
-    // Add flat noise and colored noise components
 
-    predictions += flatNoiseLevel;
-    predictions += 2.0*Functions::PI*amplitudeNoise*amplitudeNoise/(frequencyNoise*(1.0 + (covariates/frequencyNoise).pow(2)));
+// ThreeHarveyColorBackgroundModel::predictSinglePrecision()
+//
+// PURPOSE:
+//      Builds the predictions of the model in single precision, by using the
+//      single-precision frequencies and response function.
+//
+// INPUT:
+//      predictions:        one-dimensional single-precision array to contain the 
+//                          predictions from the model
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model
+//
+// OUTPUT:
+//      void
+//
+// NOTE:
+//      The free parameters are to be given in the same order of predict().
+//
+
+void ThreeHarveyColorBackgroundModel::predictSinglePrecision(RefArrayXf predictions, RefArrayXd const modelParameters)
+{
+    if (uniformGrid && !singlePrecision)
+    {
+        predictOnFrequencies(predictions, singlePrecisionGridCovariates(), responseFunction.cast<float>(), modelParameters);
+    }
+    else if (uniformGrid)
+    {
+        predictOnFrequencies(predictions, singlePrecisionGridCovariates(), compressedResponseFunction, modelParameters);
+    }
+    else if (singlePrecision)
+    {
+        predictOnFrequencies(predictions, singlePrecisionCovariates, compressedResponseFunction, modelParameters);
+    }
+    else
+    {
+        predictOnFrequencies(predictions, covariates.cast<float>(), responseFunction.cast<float>(), modelParameters);
+    }
 }
 
 
@@ -136,4 +174,64 @@ void ThreeHarveyColorBackgroundModel::predict(RefArrayXd predictions, RefArrayXd
 
 
 
+// ThreeHarveyColorBackgroundModel::predictOnFrequencies()
+//
+// PURPOSE:
+//      Computes the predictions of the model for a given array of frequencies and
+//      response function, which can be either stored arrays or Eigen expressions
+//      generated on the fly.
+//
+// INPUT:
+//      predictions:        one-dimensional array, in either double or single precision,
+//                          to contain the predictions from the model
+//      frequencies:        one-dimensional array expression containing the 
+//                          frequency of each bin
+//      response:           one-dimensional array expression containing the 
+//                          response function of each bin
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model
+//
+// OUTPUT:
+//      void
+//
+// NOTE:
+//      The free parameters are to be given in the same order of predict().
+//
 
+template <typename PredictionArray, typename FrequencyArray, typename ResponseArray>
+void ThreeHarveyColorBackgroundModel::predictOnFrequencies(PredictionArray predictions, const Eigen::ArrayBase<FrequencyArray> &frequencies, 
+                                                           const Eigen::ArrayBase<ResponseArray> &response, RefArrayXd const modelParameters)
+{
+    // Initialize global parameters in the same precision of the predictions
+
+    typedef typename PredictionArray::Scalar Scalar;
+    Scalar flatNoiseLevel = modelParameters(0);
+    Scalar amplitudeNoise = modelParameters(1);
+    Scalar frequencyNoise = modelParameters(2);
+    Scalar amplitudeHarvey1 = modelParameters(3);
+    Scalar frequencyHarvey1 = modelParameters(4);
+    Scalar amplitudeHarvey2 = modelParameters(5);
+    Scalar frequencyHarvey2 = modelParameters(6);
+    Scalar amplitudeHarvey3 = modelParameters(7);
+    Scalar frequencyHarvey3 = modelParameters(8);
+    Scalar heightOscillation = modelParameters(9);
+    Scalar nuMax = modelParameters(10);
+    Scalar sigma = modelParameters(11);
+
+
+    // Compute the Harvey components and the Gaussian envelope for the oscillations, modulate them by the
+    // response function (apodization) and add the flat noise and colored noise components. The Gaussian
+    // envelope is first computed with the vectorized exponential, by using the predictions as temporary
+    // storage, then all the components are combined in a single expression.
+
+    predictions = -1.0*(nuMax - frequencies)*(nuMax - frequencies)/(2.0 * sigma * sigma);
+    VectorKernels::exponential(predictions.data(), predictions.size());
+
+    Scalar zeta = 2.0*sqrt(2.0)/Functions::PI;
+    predictions = (zeta*amplitudeHarvey1*amplitudeHarvey1/(frequencyHarvey1*(1.0 + (frequencies/frequencyHarvey1).square().square()))
+                   + zeta*amplitudeHarvey2*amplitudeHarvey2/(frequencyHarvey2*(1.0 + (frequencies/frequencyHarvey2).square().square()))
+                   + zeta*amplitudeHarvey3*amplitudeHarvey3/(frequencyHarvey3*(1.0 + (frequencies/frequencyHarvey3).square().square()))
+                   + heightOscillation * predictions) * response
+                  + flatNoiseLevel
+                  + 2.0*Functions::PI*amplitudeNoise*amplitudeNoise/(frequencyNoise*(1.0 + (frequencies/frequencyNoise).square()));
+}
@@ -0,0 +1,527 @@
+#include "ThresholdReweighter.h"
+
+
+// ThresholdReweighter::ThresholdReweighter()
+//
+// PURPOSE:
+//      Constructor.
+//
+// INPUT:
+//      previousRun:        the results of the previous run, whose posterior sample is reweighted.
+//
+
+ThresholdReweighter::ThresholdReweighter(PreviousRun &previousRun)
+: previousRun(previousRun),
+  posteriorSample(previousRun.getPosteriorSample()),
+  logEvidence(-numeric_limits<double>::infinity()),
+  logEvidenceError(0.0),
+  informationGain(0.0),
+  effectiveSampleSize(0.0)
+{
+    previousEffectiveSampleSize = PreviousRun::computeEffectiveSampleSize(previousRun.getLogWeightOfPosteriorSample());
+}
+
+
+
+
+
+
+
+
+
+
+// ThresholdReweighter::~ThresholdReweighter()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+ThresholdReweighter::~ThresholdReweighter()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// ThresholdReweighter::selectBins()
+//
+// PURPOSE:
+//      Selects the bins of the dataset that are added to the frequency range of the previous run,
+//      and those that are removed from it. The previous range is found by trimming the dataset with 
+//      the thresholds of the previous run.
+//
+// INPUT:
+//      data:           two-dimensional array containing the untrimmed dataset, with the frequencies
+//                      in the first column and the power spectral density in the second one.
+//      firstBin:       the index of the first bin of the new frequency range.
+//      Nbins:          the number of bins of the new frequency range.
+//
+// OUTPUT:
+//      void
+//
+
+void ThresholdReweighter::selectBins(ArrayXXd &data, const long firstBin, const long Nbins)
+{
+    double previousLowFrequencyThreshold = previousRun.getLowFrequencyThreshold();
+    double previousHighFrequencyThreshold = previousRun.getHighFrequencyThreshold();
+    SpectrumTrimmer previousTrimmer(data.col(0));
+    previousTrimmer.trim(previousLowFrequencyThreshold, previousHighFrequencyThreshold);
+
+    long endBin = firstBin + Nbins;
+    long previousFirstBin = previousTrimmer.getFirstBin();
+    long previousEndBin = previousFirstBin + previousTrimmer.getNbins();
+    addedBins = selectBinsOutside(data, firstBin, endBin, previousFirstBin, previousEndBin);
+    removedBins = selectBinsOutside(data, previousFirstBin, previousEndBin, firstBin, endBin);
+
+    cout << " Reweighting of the previous run: " << addedBins.rows() << " bins added and " 
+         << removedBins.rows() << " bins removed." << endl;
+    cout << endl;
+}
+
+
+
+
+
+
+
+
+
+
+// ThresholdReweighter::refit()
+//
+// PURPOSE:
+//      Refits the model by reweighting the posterior sample of the previous run for the bins selected
+//      by selectBins(). The likelihood of the added and of the removed bins uses a model evaluated on 
+//      those bins only. If the reweighting is efficient enough, its outcome is written in the file 
+//      reweighting.txt, and its results are set into the nested sampler of the run, so that they are
+//      written in the same output files of a nested sampling run.
+//
+// INPUT:
+//      nestedSampler:          the nested sampler of the run, which receives the results of the reweighting.
+//      ptrPriors:              vector of pointers to the priors of the new run.
+//      backgroundModelName:    the name of the background model of the run.
+//      NyquistFrequency:       the Nyquist frequency of the dataset, in muHz.
+//      minEfficiency:          the minimum efficiency for the reweighting to be adopted.
+//      outputPathPrefix:       the path prefix of the output files of the run.
+//
+// OUTPUT:
+//      True if the reweighting is adopted, false if a full run is needed instead.
+//
+
+bool ThresholdReweighter::refit(NestedSampler &nestedSampler, vector<Prior*> ptrPriors, const string backgroundModelName, 
+                                const double NyquistFrequency, const double minEfficiency, const string outputPathPrefix)
+{
+    ArrayXd noBinWeights;
+    vector<BackgroundModel*> binModels;
+    vector<GammaLikelihood> binLikelihoods;
+    vector<Likelihood*> ptrBinLikelihoods;
+    binLikelihoods.reserve(2);
+
+    for (ArrayXXd *bins : {&addedBins, &removedBins})
+    {
+        if (bins->rows() == 0)
+        {
+            ptrBinLikelihoods.push_back(nullptr);
+            continue;
+        }
+
+        ArrayXd binFrequencies = bins->col(0);
+        ArrayXd binObservations = bins->col(1);
+        binModels.push_back(BackgroundModelRegistry::createModel(backgroundModelName, binFrequencies, ""));
+        binModels.back()->setNyquistFrequency(NyquistFrequency);
+        binLikelihoods.emplace_back(binObservations, noBinWeights, *binModels.back());
+        ptrBinLikelihoods.push_back(&binLikelihoods.back());
+    }
+
+    reweight(ptrPriors, ptrBinLikelihoods[0], ptrBinLikelihoods[1]);
+    binLikelihoods.clear();
+
+    for (size_t binModel = 0; binModel < binModels.size(); ++binModel)
+    {
+        delete binModels[binModel];
+    }
+
+    if (getEfficiency() < minEfficiency)
+    {
+        cout << " Reweighting efficiency of the previous run is " << setprecision(3) << getEfficiency() 
+             << ", below " << minEfficiency << ": a full run is performed." << endl;
+
+        return false;
+    }
+
+    writeToFile(outputPathPrefix + "reweighting.txt");
+    ResultsWriter::setResults(nestedSampler, posteriorSample, logLikelihoodOfPosteriorSample, logWeightOfPosteriorSample, 
+                              logEvidence, logEvidenceError, informationGain);
+
+    cout << " Reweighting of the previous run: log(Evidence) = " << setprecision(10) << logEvidence 
+         << ", efficiency = " << setprecision(3) << getEfficiency() << endl;
+
+    return true;
+}
+
+
+
+
+
+
+
+
+
+
+// ThresholdReweighter::reweight()
+//
+// PURPOSE:
+//      Reweights the posterior sample of the previous run for the new frequency range and priors.
+//      The log-likelihood of each sampling point is corrected by the log-likelihood of the bins added to
+//      the frequency range minus that of the bins removed from it, and its nested sampling weight by the
+//      same amount and by the log-ratio of the new priors to the previous ones. The evidence is the sum of
+//      the new weights, and the error on its logarithm is scaled from that of the previous run by the square
+//      root of the ratio of the information gains, as for the same number of live points.
+//      If the new priors extend beyond the previous ones, the new evidence cannot be computed, since part
+//      of the new prior volume was never sampled, and the efficiency of the reweighting is set to 0.
+//
+// INPUT:
+//      ptrPriors:                  vector of pointers to the priors of the new run.
+//      addedBinsLikelihood:        the likelihood of the bins added to the frequency range, or a null pointer if none.
+//      removedBinsLikelihood:      the likelihood of the bins removed from the frequency range, or a null pointer if none.
+//
+// OUTPUT:
+//      void
+//
+
+void ThresholdReweighter::reweight(vector<Prior*> ptrPriors, Likelihood *addedBinsLikelihood, Likelihood *removedBinsLikelihood)
+{
+    int Nsamples = posteriorSample.cols();
+    ArrayXd minima;
+    ArrayXd maxima;
+    double logPriorRatio = previousRun.getLogPriorRatio(ptrPriors, minima, maxima);
+
+    if (std::isnan(logPriorRatio))
+    {
+        return;
+    }
+
+    logLikelihoodOfPosteriorSample = previousRun.getLogLikelihoodOfPosteriorSample();
+    logWeightOfPosteriorSample = previousRun.getLogWeightOfPosteriorSample();
+    logEvidence = -numeric_limits<double>::infinity();
+
+    for (int sample = 0; sample < Nsamples; ++sample)
+    {
+        ArrayXd parameters = posteriorSample.col(sample);
+
+        if ((parameters < minima).any() || (parameters > maxima).any())
+        {
+            logWeightOfPosteriorSample(sample) = -numeric_limits<double>::infinity();
+            continue;
+        }
+
+        double logLikelihoodChange = 0.0;
+
+        if (addedBinsLikelihood != nullptr)
+        {
+            logLikelihoodChange += addedBinsLikelihood->logValue(parameters);
+        }
+
+        if (removedBinsLikelihood != nullptr)
+        {
+            logLikelihoodChange -= removedBinsLikelihood->logValue(parameters);
+        }
+
+        logLikelihoodOfPosteriorSample(sample) += logLikelihoodChange;
+        logWeightOfPosteriorSample(sample) += logLikelihoodChange + logPriorRatio;
+        logEvidence = Functions::logExpSum(logEvidence, logWeightOfPosteriorSample(sample));
+    }
+
+    if (!std::isfinite(logEvidence))
+    {
+        return;
+    }
+
+    ArrayXd posteriorProbability = (logWeightOfPosteriorSample - logEvidence).exp();
+    informationGain = 0.0;
+
+    for (int sample = 0; sample < Nsamples; ++sample)
+    {
+        if (posteriorProbability(sample) > 0.0)
+        {
+            informationGain += posteriorProbability(sample) * (logLikelihoodOfPosteriorSample(sample) - logEvidence);
+        }
+    }
+
+    logEvidenceError = previousRun.getLogEvidenceError() * sqrt(fabs(informationGain / previousRun.getInformationGain()));
+    effectiveSampleSize = PreviousRun::computeEffectiveSampleSize(logWeightOfPosteriorSample);
+}
+
+
+
+
+
+
+
+
+
+
+// ThresholdReweighter::getPosteriorSample()
+//
+// PURPOSE:
+//      Gets the posterior sample, which is that of the previous run.
+//
+// OUTPUT:
+//      A two-dimensional array of size (Ndimensions, Nsamples) containing the posterior sample.
+//
+
+ArrayXXd ThresholdReweighter::getPosteriorSample()
+{
+    return posteriorSample;
+}
+
+
+
+
+
+
+
+
+
+
+// ThresholdReweighter::getLogLikelihoodOfPosteriorSample()
+//
+// PURPOSE:
+//      Gets the log-likelihood of the posterior sample for the new frequency range.
+//
+// OUTPUT:
+//      A one-dimensional array containing the log-likelihood of each sampling point.
+//
+
+ArrayXd ThresholdReweighter::getLogLikelihoodOfPosteriorSample()
+{
+    return logLikelihoodOfPosteriorSample;
+}
+
+
+
+
+
+
+
+
+
+
+// ThresholdReweighter::getLogWeightOfPosteriorSample()
+//
+// PURPOSE:
+//      Gets the reweighted nested sampling log-weights of the posterior sample.
+//
+// OUTPUT:
+//      A one-dimensional array containing the log-weight of each sampling point.
+//
+
+ArrayXd ThresholdReweighter::getLogWeightOfPosteriorSample()
+{
+    return logWeightOfPosteriorSample;
+}
+
+
+
+
+
+
+
+
+
+
+// ThresholdReweighter::getLogEvidence()
+//
+// PURPOSE:
+//      Gets the natural logarithm of the evidence for the new frequency range and priors.
+//
+// OUTPUT:
+//      The log-evidence, minus infinity if the reweighting was not possible.
+//
+
+double ThresholdReweighter::getLogEvidence()
+{
+    return logEvidence;
+}
+
+
+
+
+
+
+
+
+
+
+// ThresholdReweighter::getLogEvidenceError()
+//
+// PURPOSE:
+//      Gets the error on the natural logarithm of the evidence.
+//
+// OUTPUT:
+//      The error on the log-evidence.
+//
+
+double ThresholdReweighter::getLogEvidenceError()
+{
+    return logEvidenceError;
+}
+
+
+
+
+
+
+
+
+
+
+// ThresholdReweighter::getInformationGain()
+//
+// PURPOSE:
+//      Gets the information gain of the reweighted posterior relative to the new priors.
+//
+// OUTPUT:
+//      The information gain in natural units.
+//
+
+double ThresholdReweighter::getInformationGain()
+{
+    return informationGain;
+}
+
+
+
+
+
+
+
+
+
+
+// ThresholdReweighter::getEffectiveSampleSize()
+//
+// PURPOSE:
+//      Gets the effective sample size of the reweighted posterior sample.
+//
+// OUTPUT:
+//      The effective sample size, i.e. the inverse of the sum of the squared posterior probabilities.
+//
+
+double ThresholdReweighter::getEffectiveSampleSize()
+{
+    return effectiveSampleSize;
+}
+
+
+
+
+
+
+
+
+
+
+// ThresholdReweighter::getEfficiency()
+//
+// PURPOSE:
+//      Gets the efficiency of the reweighting, namely the ratio of the effective sample size of the
+//      reweighted posterior sample to that of the posterior sample of the previous run.
+//
+// OUTPUT:
+//      The efficiency, between 0 and about 1, 0 if the reweighting was not possible.
+//
+
+double ThresholdReweighter::getEfficiency()
+{
+    return effectiveSampleSize / previousEffectiveSampleSize;
+}
+
+
+
+
+
+
+
+
+
+
+// ThresholdReweighter::writeToFile()
+//
+// PURPOSE:
+//      Writes the outcome of the reweighting into an ASCII file.
+//
+// INPUT:
+//      fileName:       a string containing the full path of the output file.
+//
+// OUTPUT:
+//      void
+//
+
+void ThresholdReweighter::writeToFile(const string fileName)
+{
+    ofstream outputFile;
+    File::openOutputFile(outputFile, fileName);
+
+    outputFile << "# Reweighting of the posterior sample of a previous run for new frequency thresholds" << endl;
+    outputFile << "# Row #1: Output path prefix of the previous run" << endl;
+    outputFile << "# Row #2: Low-Frequency threshold of the previous run (0 if not used)" << endl;
+    outputFile << "# Row #3: High-Frequency threshold of the previous run (0 if not used)" << endl;
+    outputFile << "# Row #4: log(Evidence) of the previous run" << endl;
+    outputFile << "# Row #5: Effective sample size of the previous run" << endl;
+    outputFile << "# Row #6: Effective sample size of the reweighted sample" << endl;
+    outputFile << "# Row #7: Efficiency of the reweighting" << endl;
+    outputFile << previousRun.getRunPathPrefix() << endl;
+    outputFile << setprecision(12) << previousRun.getLowFrequencyThreshold() << endl;
+    outputFile << previousRun.getHighFrequencyThreshold() << endl;
+    outputFile << previousRun.getLogEvidence() << endl;
+    outputFile << previousEffectiveSampleSize << endl;
+    outputFile << effectiveSampleSize << endl;
+    outputFile << getEfficiency() << endl;
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+// ThresholdReweighter::selectBinsOutside()
+//
+// PURPOSE:
+//      Selects the bins of the dataset in the range [firstBin, endBin) that are not in the 
+//      range [otherFirstBin, otherEndBin).
+//
+// INPUT:
+//      data:           two-dimensional array containing the untrimmed dataset.
+//      firstBin:       the index of the first bin of the range.
+//      endBin:         the index following the last bin of the range.
+//      otherFirstBin:  the index of the first bin of the other range.
+//      otherEndBin:    the index following the last bin of the other range.
+//
+// OUTPUT:
+//      A two-dimensional array containing the selected rows of the dataset.
+//
+
+ArrayXXd ThresholdReweighter::selectBinsOutside(const ArrayXXd &data, const long firstBin, const long endBin, 
+                                                const long otherFirstBin, const long otherEndBin)
+{
+    long NlowerBins = max(0L, min(endBin, otherFirstBin) - firstBin);
+    long NupperBins = max(0L, endBin - max(firstBin, otherEndBin));
+    ArrayXXd bins(NlowerBins + NupperBins, 2);
+    bins.topRows(NlowerBins) = data.block(firstBin, 0, NlowerBins, 2);
+    bins.bottomRows(NupperBins) = data.block(endBin - NupperBins, 0, NupperBins, 2);
+
+    return bins;
+}
@@ -0,0 +1,431 @@
+#include "VectorKernels.h"
+
+
+// Kernels of the C library, used when no vectorized instruction set is available or selected
+
+namespace VectorKernelsScalar
+{
+    void exponential(double *values, const long Nvalues)
+    {
+        for (long index = 0; index < Nvalues; ++index) values[index] = exp(values[index]);
+    }
+
+    void exponential(float *values, const long Nvalues)
+    {
+        for (long index = 0; index < Nvalues; ++index) values[index] = exp(values[index]);
+    }
+
+    void logarithm(double *values, const long Nvalues)
+    {
+        for (long index = 0; index < Nvalues; ++index) values[index] = log(values[index]);
+    }
+
+    void logarithm(float *values, const long Nvalues)
+    {
+        for (long index = 0; index < Nvalues; ++index) values[index] = log(values[index]);
+    }
+
+    void power(double *values, const double exponent, const long Nvalues)
+    {
+        for (long index = 0; index < Nvalues; ++index) values[index] = pow(values[index], exponent);
+    }
+
+    void power(float *values, const double exponent, const long Nvalues)
+    {
+        float singlePrecisionExponent = static_cast<float>(exponent);
+        for (long index = 0; index < Nvalues; ++index) values[index] = pow(values[index], singlePrecisionExponent);
+    }
+
+    template <typename Scalar>
+    double sumLogLikelihoodTerms(const Scalar *observations, const Scalar *predictions, const Scalar *weights, const long Nvalues)
+    {
+        double sum = 0.0;
+
+        for (long index = 0; index < Nvalues; ++index)
+        {
+            Scalar term = observations[index]/predictions[index] + log(predictions[index]);
+            sum += (weights != 0) ? weights[index]*term : term;
+        }
+
+        return sum;
+    }
+}
+
+
+// Kernels compiled for each instruction set, in "VectorKernelsSSE42.cpp", "VectorKernelsAVX2.cpp"
+// and "VectorKernelsAVX512.cpp"
+
+#ifdef BACKGROUND_CPU_DISPATCH
+
+#define DECLARE_VECTOR_KERNELS(instructionSetNamespace)                                                                     \
+namespace instructionSetNamespace                                                                                           \
+{                                                                                                                           \
+    void exponential(double *values, const long Nvalues);                                                                   \
+    void exponential(float *values, const long Nvalues);                                                                    \
+    void logarithm(double *values, const long Nvalues);                                                                     \
+    void logarithm(float *values, const long Nvalues);                                                                      \
+    void power(double *values, const double exponent, const long Nvalues);                                                  \
+    void power(float *values, const double exponent, const long Nvalues);                                                   \
+    double sumLogLikelihoodTerms(const double *observations, const double *predictions, const double *weights, const long Nvalues); \
+    double sumLogLikelihoodTerms(const float *observations, const float *predictions, const float *weights, const long Nvalues);    \
+}
+
+DECLARE_VECTOR_KERNELS(VectorKernelsSSE42)
+DECLARE_VECTOR_KERNELS(VectorKernelsAVX2)
+DECLARE_VECTOR_KERNELS(VectorKernelsAVX512)
+
+#endif
+
+
+#define FILL_KERNEL_TABLE(table, instructionSetNamespace)                                                           \
+    table.exponentialDouble = instructionSetNamespace::exponential;                                                 \
+    table.exponentialFloat = instructionSetNamespace::exponential;                                                  \
+    table.logarithmDouble = instructionSetNamespace::logarithm;                                                     \
+    table.logarithmFloat = instructionSetNamespace::logarithm;                                                      \
+    table.powerDouble = instructionSetNamespace::power;                                                             \
+    table.powerFloat = instructionSetNamespace::power;                                                              \
+    table.sumLogLikelihoodTermsDouble = instructionSetNamespace::sumLogLikelihoodTerms;                             \
+    table.sumLogLikelihoodTermsFloat = instructionSetNamespace::sumLogLikelihoodTerms;
+
+
+// The widest instruction set supported by the CPU is selected when the program starts
+
+VectorKernels::KernelTable VectorKernels::kernels = VectorKernels::makeWidestKernelTable();
+
+
+
+
+
+
+
+
+
+
+// VectorKernels::isInstructionSetSupported()
+//
+// PURPOSE:
+//      Checks whether the CPU and the operating system support a given instruction set,
+//      and whether the kernels for it have been compiled.
+//
+// INPUT:
+//      instructionSetName:     a string among scalar, sse4.2, avx2 and avx512.
+//
+// OUTPUT:
+//      A boolean, true if the instruction set can be used.
+//
+
+bool VectorKernels::isInstructionSetSupported(const string instructionSetName)
+{
+    if (instructionSetName == "scalar")
+    {
+        return true;
+    }
+
+    #ifdef BACKGROUND_CPU_DISPATCH
+    
+        __builtin_cpu_init();
+
+        if (instructionSetName == "sse4.2")
+        {
+            return __builtin_cpu_supports("sse4.2");
+        }
+        else if (instructionSetName == "avx2")
+        {
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        }
+        else if (instructionSetName == "avx512")
+        {
+            return __builtin_cpu_supports("avx512f");
+        }
+    
+    #endif
+
+    return false;
+}
+
+
+
+
+
+
+
+
+
+
+// VectorKernels::makeKernelTable()
+//
+// PURPOSE:
+//      Builds the table of the kernels compiled for a given instruction set.
+//
+// INPUT:
+//      instructionSetName:     a string among scalar, sse4.2, avx2 and avx512. 
+//                              The instruction set is assumed to be supported.
+//
+// OUTPUT:
+//      A struct containing the pointers to the kernels.
+//
+
+VectorKernels::KernelTable VectorKernels::makeKernelTable(const string instructionSetName)
+{
+    KernelTable table;
+    table.instructionSetName = "scalar";
+    FILL_KERNEL_TABLE(table, VectorKernelsScalar);
+
+    #ifdef BACKGROUND_CPU_DISPATCH
+
+        if (instructionSetName == "sse4.2")
+        {
+            FILL_KERNEL_TABLE(table, VectorKernelsSSE42);
+            table.instructionSetName = instructionSetName;
+        }
+        else if (instructionSetName == "avx2")
+        {
+            FILL_KERNEL_TABLE(table, VectorKernelsAVX2);
+            table.instructionSetName = instructionSetName;
+        }
+        else if (instructionSetName == "avx512")
+        {
+            FILL_KERNEL_TABLE(table, VectorKernelsAVX512);
+            table.instructionSetName = instructionSetName;
+        }
+
+    #endif
+
+    return table;
+}
+
+
+
+
+
+
+
+
+
+
+// VectorKernels::makeWidestKernelTable()
+//
+// PURPOSE:
+//      Builds the table of the kernels compiled for the widest instruction set
+//      supported by the CPU.
+//
+// OUTPUT:
+//      A struct containing the pointers to the kernels.
+//
+
+VectorKernels::KernelTable VectorKernels::makeWidestKernelTable()
+{
+    const string instructionSetNames[] = {"avx512", "avx2", "sse4.2"};
+
+    for (int index = 0; index < 3; ++index)
+    {
+        if (isInstructionSetSupported(instructionSetNames[index]))
+        {
+            return makeKernelTable(instructionSetNames[index]);
+        }
+    }
+
+    return makeKernelTable("scalar");
+}
+
+
+
+
+
+
+
+
+
+
+// VectorKernels::selectInstructionSet()
+//
+// PURPOSE:
+//      Selects the instruction set of the kernels. 
+//
+// INPUT:
+//      instructionSetName:     a string among auto, scalar, sse4.2, avx2 and avx512.
+//                              If auto, the widest instruction set supported by the CPU is selected.
+//
+// OUTPUT:
+//      A boolean, true if the instruction set is supported. If it is not, the 
+//      instruction set previously selected is kept.
+//
+
+bool VectorKernels::selectInstructionSet(const string instructionSetName)
+{
+    if (instructionSetName == "auto")
+    {
+        kernels = makeWidestKernelTable();
+        return true;
+    }
+
+    if (!isInstructionSetSupported(instructionSetName))
+    {
+        return false;
+    }
+
+    kernels = makeKernelTable(instructionSetName);
+    return true;
+}
+
+
+
+
+
+
+
+
+
+
+// VectorKernels::getInstructionSetName()
+//
+// PURPOSE:
+//      Gets the name of the instruction set of the selected kernels.
+//
+// OUTPUT:
+//      A string among scalar, sse4.2, avx2 and avx512.
+//
+
+string VectorKernels::getInstructionSetName()
+{
+    return kernels.instructionSetName;
+}
+
+
+
+
+
+
+
+
+
+
+// VectorKernels::exponential()
+//
+// PURPOSE:
+//      Replaces each element of an array by its exponential.
+//
+// INPUT:
+//      values:         pointer to the first element of the array, either in double or single precision.
+//      Nvalues:        the number of elements of the array.
+//
+// OUTPUT:
+//      void
+//
+// NOTE:
+//      The accuracy of the vectorized kernels is documented in "VectorKernelsTemplate.h".
+//
+
+void VectorKernels::exponential(double *values, const long Nvalues)
+{
+    kernels.exponentialDouble(values, Nvalues);
+}
+
+void VectorKernels::exponential(float *values, const long Nvalues)
+{
+    kernels.exponentialFloat(values, Nvalues);
+}
+
+
+
+
+
+
+
+
+
+
+// VectorKernels::logarithm()
+//
+// PURPOSE:
+//      Replaces each element of an array by its natural logarithm.
+//
+// INPUT:
+//      values:         pointer to the first element of the array, either in double or single precision.
+//      Nvalues:        the number of elements of the array.
+//
+// OUTPUT:
+//      void
+//
+
+void VectorKernels::logarithm(double *values, const long Nvalues)
+{
+    kernels.logarithmDouble(values, Nvalues);
+}
+
+void VectorKernels::logarithm(float *values, const long Nvalues)
+{
+    kernels.logarithmFloat(values, Nvalues);
+}
+
+
+
+
+
+
+
+
+
+
+// VectorKernels::power()
+//
+// PURPOSE:
+//      Raises each positive element of an array to a given power.
+//
+// INPUT:
+//      values:         pointer to the first element of the array, either in double or single precision.
+//      exponent:       the power to which the elements are raised.
+//      Nvalues:        the number of elements of the array.
+//
+// OUTPUT:
+//      void
+//
+
+void VectorKernels::power(double *values, const double exponent, const long Nvalues)
+{
+    kernels.powerDouble(values, exponent, Nvalues);
+}
+
+void VectorKernels::power(float *values, const double exponent, const long Nvalues)
+{
+    kernels.powerFloat(values, exponent, Nvalues);
+}
+
+
+
+
+
+
+
+
+
+
+// VectorKernels::sumLogLikelihoodTerms()
+//
+// PURPOSE:
+//      Computes the sum over the bins of w*(P/m + ln m), which is the part of the 
+//      log-likelihood of a power spectrum that depends on the model.
+//
+// INPUT:
+//      observations:   pointer to the first element of the array containing the observed power P.
+//      predictions:    pointer to the first element of the array containing the model m.
+//      weights:        pointer to the first element of the array containing the weights w, 
+//                      i.e. the number of original bins averaged into each bin. 
+//                      If null, all the weights are equal to 1.
+//      Nvalues:        the number of bins.
+//
+// OUTPUT:
+//      A double containing the sum. In single precision the terms are accumulated in double precision.
+//
+
+double VectorKernels::sumLogLikelihoodTerms(const double *observations, const double *predictions, 
+                                            const double *weights, const long Nvalues)
+{
+    return kernels.sumLogLikelihoodTermsDouble(observations, predictions, weights, Nvalues);
+}
+
+double VectorKernels::sumLogLikelihoodTerms(const float *observations, const float *predictions, 
+                                            const float *weights, const long Nvalues)
+{
+    return kernels.sumLogLikelihoodTermsFloat(observations, predictions, weights, Nvalues);
+}
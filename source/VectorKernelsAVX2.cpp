@@ -0,0 +1,116 @@
+// Vectorized kernels of class VectorKernels, compiled for the AVX2 and FMA instruction sets.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Source file "VectorKernelsAVX2.cpp"
+// Generic implementation contained in "VectorKernelsTemplate.h"
+//
+// This file is compiled with -mavx2 -mfma and must only include <immintrin.h>, whose functions
+// are always inlined. The kernels are called only if the CPU supports both AVX2 and FMA.
+
+#if defined(BACKGROUND_CPU_DISPATCH) && defined(__AVX2__) && defined(__FMA__)
+
+#include <immintrin.h>
+
+
+namespace VectorKernelsAVX2
+{
+    typedef __m256d VectorDouble;
+    typedef __m256d MaskDouble;
+    typedef __m256 VectorFloat;
+    typedef __m256 MaskFloat;
+    const int NdoubleLanes = 4;
+    const int NfloatLanes = 8;
+
+
+    // Elementary operations on a vector of doubles
+
+    static inline VectorDouble setDouble(const double value) { return _mm256_set1_pd(value); }
+    static inline VectorDouble loadDouble(const double *address) { return _mm256_loadu_pd(address); }
+    static inline void storeDouble(double *address, const VectorDouble x) { _mm256_storeu_pd(address, x); }
+    static inline VectorDouble addDouble(const VectorDouble x, const VectorDouble y) { return _mm256_add_pd(x, y); }
+    static inline VectorDouble subDouble(const VectorDouble x, const VectorDouble y) { return _mm256_sub_pd(x, y); }
+    static inline VectorDouble mulDouble(const VectorDouble x, const VectorDouble y) { return _mm256_mul_pd(x, y); }
+    static inline VectorDouble divDouble(const VectorDouble x, const VectorDouble y) { return _mm256_div_pd(x, y); }
+    static inline VectorDouble fmaDouble(const VectorDouble x, const VectorDouble y, const VectorDouble z) { return _mm256_fmadd_pd(x, y, z); }
+    static inline VectorDouble minDouble(const VectorDouble x, const VectorDouble y) { return _mm256_min_pd(x, y); }
+    static inline VectorDouble maxDouble(const VectorDouble x, const VectorDouble y) { return _mm256_max_pd(x, y); }
+    static inline VectorDouble roundDouble(const VectorDouble x) { return _mm256_round_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static inline VectorDouble floorDouble(const VectorDouble x) { return _mm256_round_pd(x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static inline MaskDouble lessDouble(const VectorDouble x, const VectorDouble y) { return _mm256_cmp_pd(x, y, _CMP_LT_OQ); }
+    static inline MaskDouble equalDouble(const VectorDouble x, const VectorDouble y) { return _mm256_cmp_pd(x, y, _CMP_EQ_OQ); }
+    static inline MaskDouble isNaNDouble(const VectorDouble x) { return _mm256_cmp_pd(x, x, _CMP_UNORD_Q); }
+    static inline VectorDouble selectDouble(const MaskDouble mask, const VectorDouble x, const VectorDouble y) { return _mm256_blendv_pd(y, x, mask); }
+
+    static inline VectorDouble powerOfTwoDouble(const VectorDouble n)
+    {
+        // The biased exponent n + 1023 is stored in the lowest bits of the mantissa of n + 1023 + 2^52,
+        // from which it is shifted into the exponent field
+
+        __m256i bits = _mm256_castpd_si256(_mm256_add_pd(n, _mm256_set1_pd(4503599627371519.0)));
+        return _mm256_castsi256_pd(_mm256_slli_epi64(bits, 52));
+    }
+
+    static inline VectorDouble exponentOfDouble(const VectorDouble x)
+    {
+        __m256i biasedExponent = _mm256_srli_epi64(_mm256_castpd_si256(x), 52);
+        __m256i bits = _mm256_or_si256(biasedExponent, _mm256_set1_epi64x(0x4330000000000000LL));
+        return _mm256_sub_pd(_mm256_castsi256_pd(bits), _mm256_set1_pd(4503599627370496.0));
+    }
+
+    static inline VectorDouble mantissaOfDouble(const VectorDouble x)
+    {
+        __m256i bits = _mm256_and_si256(_mm256_castpd_si256(x), _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+        return _mm256_castsi256_pd(_mm256_or_si256(bits, _mm256_set1_epi64x(0x3FF0000000000000LL)));
+    }
+
+
+    // Elementary operations on a vector of floats
+
+    static inline VectorFloat setFloat(const float value) { return _mm256_set1_ps(value); }
+    static inline VectorFloat loadFloat(const float *address) { return _mm256_loadu_ps(address); }
+    static inline void storeFloat(float *address, const VectorFloat x) { _mm256_storeu_ps(address, x); }
+    static inline VectorFloat addFloat(const VectorFloat x, const VectorFloat y) { return _mm256_add_ps(x, y); }
+    static inline VectorFloat subFloat(const VectorFloat x, const VectorFloat y) { return _mm256_sub_ps(x, y); }
+    static inline VectorFloat mulFloat(const VectorFloat x, const VectorFloat y) { return _mm256_mul_ps(x, y); }
+    static inline VectorFloat divFloat(const VectorFloat x, const VectorFloat y) { return _mm256_div_ps(x, y); }
+    static inline VectorFloat fmaFloat(const VectorFloat x, const VectorFloat y, const VectorFloat z) { return _mm256_fmadd_ps(x, y, z); }
+    static inline VectorFloat minFloat(const VectorFloat x, const VectorFloat y) { return _mm256_min_ps(x, y); }
+    static inline VectorFloat maxFloat(const VectorFloat x, const VectorFloat y) { return _mm256_max_ps(x, y); }
+    static inline VectorFloat roundFloat(const VectorFloat x) { return _mm256_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static inline VectorFloat floorFloat(const VectorFloat x) { return _mm256_round_ps(x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static inline MaskFloat lessFloat(const VectorFloat x, const VectorFloat y) { return _mm256_cmp_ps(x, y, _CMP_LT_OQ); }
+    static inline MaskFloat equalFloat(const VectorFloat x, const VectorFloat y) { return _mm256_cmp_ps(x, y, _CMP_EQ_OQ); }
+    static inline MaskFloat isNaNFloat(const VectorFloat x) { return _mm256_cmp_ps(x, x, _CMP_UNORD_Q); }
+    static inline VectorFloat selectFloat(const MaskFloat mask, const VectorFloat x, const VectorFloat y) { return _mm256_blendv_ps(y, x, mask); }
+
+    static inline VectorFloat powerOfTwoFloat(const VectorFloat n)
+    {
+        __m256i bits = _mm256_castps_si256(_mm256_add_ps(n, _mm256_set1_ps(8388735.0f)));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(bits, 23));
+    }
+
+    static inline VectorFloat exponentOfFloat(const VectorFloat x)
+    {
+        __m256i biasedExponent = _mm256_srli_epi32(_mm256_castps_si256(x), 23);
+        __m256i bits = _mm256_or_si256(biasedExponent, _mm256_set1_epi32(0x4B000000));
+        return _mm256_sub_ps(_mm256_castsi256_ps(bits), _mm256_set1_ps(8388608.0f));
+    }
+
+    static inline VectorFloat mantissaOfFloat(const VectorFloat x)
+    {
+        __m256i bits = _mm256_and_si256(_mm256_castps_si256(x), _mm256_set1_epi32(0x007FFFFF));
+        return _mm256_castsi256_ps(_mm256_or_si256(bits, _mm256_set1_epi32(0x3F800000)));
+    }
+
+    static inline VectorDouble accumulateFloatInDouble(const VectorDouble sum, const VectorFloat x)
+    {
+        VectorDouble lowerHalf = _mm256_cvtps_pd(_mm256_castps256_ps128(x));
+        VectorDouble upperHalf = _mm256_cvtps_pd(_mm256_extractf128_ps(x, 1));
+        return _mm256_add_pd(_mm256_add_pd(sum, lowerHalf), upperHalf);
+    }
+
+
+    #include "VectorKernelsTemplate.h"
+}
+
+#endif
@@ -0,0 +1,123 @@
+// Vectorized kernels of class VectorKernels, compiled for the AVX-512 Foundation instruction set.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Source file "VectorKernelsAVX512.cpp"
+// Generic implementation contained in "VectorKernelsTemplate.h"
+//
+// This file is compiled with -mavx512f and must only include <immintrin.h>, whose functions
+// are always inlined. The kernels are called only if the CPU supports AVX-512F.
+
+#if defined(BACKGROUND_CPU_DISPATCH) && defined(__AVX512F__)
+
+// GCC warns about the undefined vectors used internally by the AVX-512 intrinsics
+
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include <immintrin.h>
+
+
+namespace VectorKernelsAVX512
+{
+    typedef __m512d VectorDouble;
+    typedef __mmask8 MaskDouble;
+    typedef __m512 VectorFloat;
+    typedef __mmask16 MaskFloat;
+    const int NdoubleLanes = 8;
+    const int NfloatLanes = 16;
+
+
+    // Elementary operations on a vector of doubles
+
+    static inline VectorDouble setDouble(const double value) { return _mm512_set1_pd(value); }
+    static inline VectorDouble loadDouble(const double *address) { return _mm512_loadu_pd(address); }
+    static inline void storeDouble(double *address, const VectorDouble x) { _mm512_storeu_pd(address, x); }
+    static inline VectorDouble addDouble(const VectorDouble x, const VectorDouble y) { return _mm512_add_pd(x, y); }
+    static inline VectorDouble subDouble(const VectorDouble x, const VectorDouble y) { return _mm512_sub_pd(x, y); }
+    static inline VectorDouble mulDouble(const VectorDouble x, const VectorDouble y) { return _mm512_mul_pd(x, y); }
+    static inline VectorDouble divDouble(const VectorDouble x, const VectorDouble y) { return _mm512_div_pd(x, y); }
+    static inline VectorDouble fmaDouble(const VectorDouble x, const VectorDouble y, const VectorDouble z) { return _mm512_fmadd_pd(x, y, z); }
+    static inline VectorDouble minDouble(const VectorDouble x, const VectorDouble y) { return _mm512_min_pd(x, y); }
+    static inline VectorDouble maxDouble(const VectorDouble x, const VectorDouble y) { return _mm512_max_pd(x, y); }
+    static inline VectorDouble roundDouble(const VectorDouble x) { return _mm512_roundscale_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static inline VectorDouble floorDouble(const VectorDouble x) { return _mm512_roundscale_pd(x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static inline MaskDouble lessDouble(const VectorDouble x, const VectorDouble y) { return _mm512_cmp_pd_mask(x, y, _CMP_LT_OQ); }
+    static inline MaskDouble equalDouble(const VectorDouble x, const VectorDouble y) { return _mm512_cmp_pd_mask(x, y, _CMP_EQ_OQ); }
+    static inline MaskDouble isNaNDouble(const VectorDouble x) { return _mm512_cmp_pd_mask(x, x, _CMP_UNORD_Q); }
+    static inline VectorDouble selectDouble(const MaskDouble mask, const VectorDouble x, const VectorDouble y) { return _mm512_mask_blend_pd(mask, y, x); }
+
+    static inline VectorDouble powerOfTwoDouble(const VectorDouble n)
+    {
+        // The biased exponent n + 1023 is stored in the lowest bits of the mantissa of n + 1023 + 2^52,
+        // from which it is shifted into the exponent field
+
+        __m512i bits = _mm512_castpd_si512(_mm512_add_pd(n, _mm512_set1_pd(4503599627371519.0)));
+        return _mm512_castsi512_pd(_mm512_slli_epi64(bits, 52));
+    }
+
+    static inline VectorDouble exponentOfDouble(const VectorDouble x)
+    {
+        __m512i biasedExponent = _mm512_srli_epi64(_mm512_castpd_si512(x), 52);
+        __m512i bits = _mm512_or_si512(biasedExponent, _mm512_set1_epi64(0x4330000000000000LL));
+        return _mm512_sub_pd(_mm512_castsi512_pd(bits), _mm512_set1_pd(4503599627370496.0));
+    }
+
+    static inline VectorDouble mantissaOfDouble(const VectorDouble x)
+    {
+        __m512i bits = _mm512_and_si512(_mm512_castpd_si512(x), _mm512_set1_epi64(0x000FFFFFFFFFFFFFLL));
+        return _mm512_castsi512_pd(_mm512_or_si512(bits, _mm512_set1_epi64(0x3FF0000000000000LL)));
+    }
+
+
+    // Elementary operations on a vector of floats
+
+    static inline VectorFloat setFloat(const float value) { return _mm512_set1_ps(value); }
+    static inline VectorFloat loadFloat(const float *address) { return _mm512_loadu_ps(address); }
+    static inline void storeFloat(float *address, const VectorFloat x) { _mm512_storeu_ps(address, x); }
+    static inline VectorFloat addFloat(const VectorFloat x, const VectorFloat y) { return _mm512_add_ps(x, y); }
+    static inline VectorFloat subFloat(const VectorFloat x, const VectorFloat y) { return _mm512_sub_ps(x, y); }
+    static inline VectorFloat mulFloat(const VectorFloat x, const VectorFloat y) { return _mm512_mul_ps(x, y); }
+    static inline VectorFloat divFloat(const VectorFloat x, const VectorFloat y) { return _mm512_div_ps(x, y); }
+    static inline VectorFloat fmaFloat(const VectorFloat x, const VectorFloat y, const VectorFloat z) { return _mm512_fmadd_ps(x, y, z); }
+    static inline VectorFloat minFloat(const VectorFloat x, const VectorFloat y) { return _mm512_min_ps(x, y); }
+    static inline VectorFloat maxFloat(const VectorFloat x, const VectorFloat y) { return _mm512_max_ps(x, y); }
+    static inline VectorFloat roundFloat(const VectorFloat x) { return _mm512_roundscale_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static inline VectorFloat floorFloat(const VectorFloat x) { return _mm512_roundscale_ps(x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static inline MaskFloat lessFloat(const VectorFloat x, const VectorFloat y) { return _mm512_cmp_ps_mask(x, y, _CMP_LT_OQ); }
+    static inline MaskFloat equalFloat(const VectorFloat x, const VectorFloat y) { return _mm512_cmp_ps_mask(x, y, _CMP_EQ_OQ); }
+    static inline MaskFloat isNaNFloat(const VectorFloat x) { return _mm512_cmp_ps_mask(x, x, _CMP_UNORD_Q); }
+    static inline VectorFloat selectFloat(const MaskFloat mask, const VectorFloat x, const VectorFloat y) { return _mm512_mask_blend_ps(mask, y, x); }
+
+    static inline VectorFloat powerOfTwoFloat(const VectorFloat n)
+    {
+        __m512i bits = _mm512_castps_si512(_mm512_add_ps(n, _mm512_set1_ps(8388735.0f)));
+        return _mm512_castsi512_ps(_mm512_slli_epi32(bits, 23));
+    }
+
+    static inline VectorFloat exponentOfFloat(const VectorFloat x)
+    {
+        __m512i biasedExponent = _mm512_srli_epi32(_mm512_castps_si512(x), 23);
+        __m512i bits = _mm512_or_si512(biasedExponent, _mm512_set1_epi32(0x4B000000));
+        return _mm512_sub_ps(_mm512_castsi512_ps(bits), _mm512_set1_ps(8388608.0f));
+    }
+
+    static inline VectorFloat mantissaOfFloat(const VectorFloat x)
+    {
+        __m512i bits = _mm512_and_si512(_mm512_castps_si512(x), _mm512_set1_epi32(0x007FFFFF));
+        return _mm512_castsi512_ps(_mm512_or_si512(bits, _mm512_set1_epi32(0x3F800000)));
+    }
+
+    static inline VectorDouble accumulateFloatInDouble(const VectorDouble sum, const VectorFloat x)
+    {
+        __m512d bits = _mm512_castps_pd(x);
+        VectorDouble lowerHalf = _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_castpd512_pd256(bits)));
+        VectorDouble upperHalf = _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(bits, 1)));
+        return _mm512_add_pd(_mm512_add_pd(sum, lowerHalf), upperHalf);
+    }
+
+
+    #include "VectorKernelsTemplate.h"
+}
+
+#endif
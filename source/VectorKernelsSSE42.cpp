@@ -0,0 +1,114 @@
+// Vectorized kernels of class VectorKernels, compiled for the SSE4.2 instruction set.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Source file "VectorKernelsSSE42.cpp"
+// Generic implementation contained in "VectorKernelsTemplate.h"
+//
+// This file is compiled with -msse4.2 and must only include <immintrin.h>, whose functions
+// are always inlined. The kernels are called only if the CPU supports SSE4.2.
+
+#if defined(BACKGROUND_CPU_DISPATCH) && defined(__SSE4_2__)
+
+#include <immintrin.h>
+
+
+namespace VectorKernelsSSE42
+{
+    typedef __m128d VectorDouble;
+    typedef __m128d MaskDouble;
+    typedef __m128 VectorFloat;
+    typedef __m128 MaskFloat;
+    const int NdoubleLanes = 2;
+    const int NfloatLanes = 4;
+
+
+    // Elementary operations on a vector of doubles. SSE4.2 has no fused multiply-add.
+
+    static inline VectorDouble setDouble(const double value) { return _mm_set1_pd(value); }
+    static inline VectorDouble loadDouble(const double *address) { return _mm_loadu_pd(address); }
+    static inline void storeDouble(double *address, const VectorDouble x) { _mm_storeu_pd(address, x); }
+    static inline VectorDouble addDouble(const VectorDouble x, const VectorDouble y) { return _mm_add_pd(x, y); }
+    static inline VectorDouble subDouble(const VectorDouble x, const VectorDouble y) { return _mm_sub_pd(x, y); }
+    static inline VectorDouble mulDouble(const VectorDouble x, const VectorDouble y) { return _mm_mul_pd(x, y); }
+    static inline VectorDouble divDouble(const VectorDouble x, const VectorDouble y) { return _mm_div_pd(x, y); }
+    static inline VectorDouble fmaDouble(const VectorDouble x, const VectorDouble y, const VectorDouble z) { return _mm_add_pd(_mm_mul_pd(x, y), z); }
+    static inline VectorDouble minDouble(const VectorDouble x, const VectorDouble y) { return _mm_min_pd(x, y); }
+    static inline VectorDouble maxDouble(const VectorDouble x, const VectorDouble y) { return _mm_max_pd(x, y); }
+    static inline VectorDouble roundDouble(const VectorDouble x) { return _mm_round_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static inline VectorDouble floorDouble(const VectorDouble x) { return _mm_round_pd(x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static inline MaskDouble lessDouble(const VectorDouble x, const VectorDouble y) { return _mm_cmplt_pd(x, y); }
+    static inline MaskDouble equalDouble(const VectorDouble x, const VectorDouble y) { return _mm_cmpeq_pd(x, y); }
+    static inline MaskDouble isNaNDouble(const VectorDouble x) { return _mm_cmpunord_pd(x, x); }
+    static inline VectorDouble selectDouble(const MaskDouble mask, const VectorDouble x, const VectorDouble y) { return _mm_blendv_pd(y, x, mask); }
+
+    static inline VectorDouble powerOfTwoDouble(const VectorDouble n)
+    {
+        // The biased exponent n + 1023 is stored in the lowest bits of the mantissa of n + 1023 + 2^52,
+        // from which it is shifted into the exponent field
+
+        __m128i bits = _mm_castpd_si128(_mm_add_pd(n, _mm_set1_pd(4503599627371519.0)));
+        return _mm_castsi128_pd(_mm_slli_epi64(bits, 52));
+    }
+
+    static inline VectorDouble exponentOfDouble(const VectorDouble x)
+    {
+        __m128i biasedExponent = _mm_srli_epi64(_mm_castpd_si128(x), 52);
+        __m128i bits = _mm_or_si128(biasedExponent, _mm_set1_epi64x(0x4330000000000000LL));
+        return _mm_sub_pd(_mm_castsi128_pd(bits), _mm_set1_pd(4503599627370496.0));
+    }
+
+    static inline VectorDouble mantissaOfDouble(const VectorDouble x)
+    {
+        __m128i bits = _mm_and_si128(_mm_castpd_si128(x), _mm_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+        return _mm_castsi128_pd(_mm_or_si128(bits, _mm_set1_epi64x(0x3FF0000000000000LL)));
+    }
+
+
+    // Elementary operations on a vector of floats
+
+    static inline VectorFloat setFloat(const float value) { return _mm_set1_ps(value); }
+    static inline VectorFloat loadFloat(const float *address) { return _mm_loadu_ps(address); }
+    static inline void storeFloat(float *address, const VectorFloat x) { _mm_storeu_ps(address, x); }
+    static inline VectorFloat addFloat(const VectorFloat x, const VectorFloat y) { return _mm_add_ps(x, y); }
+    static inline VectorFloat subFloat(const VectorFloat x, const VectorFloat y) { return _mm_sub_ps(x, y); }
+    static inline VectorFloat mulFloat(const VectorFloat x, const VectorFloat y) { return _mm_mul_ps(x, y); }
+    static inline VectorFloat divFloat(const VectorFloat x, const VectorFloat y) { return _mm_div_ps(x, y); }
+    static inline VectorFloat fmaFloat(const VectorFloat x, const VectorFloat y, const VectorFloat z) { return _mm_add_ps(_mm_mul_ps(x, y), z); }
+    static inline VectorFloat minFloat(const VectorFloat x, const VectorFloat y) { return _mm_min_ps(x, y); }
+    static inline VectorFloat maxFloat(const VectorFloat x, const VectorFloat y) { return _mm_max_ps(x, y); }
+    static inline VectorFloat roundFloat(const VectorFloat x) { return _mm_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static inline VectorFloat floorFloat(const VectorFloat x) { return _mm_round_ps(x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static inline MaskFloat lessFloat(const VectorFloat x, const VectorFloat y) { return _mm_cmplt_ps(x, y); }
+    static inline MaskFloat equalFloat(const VectorFloat x, const VectorFloat y) { return _mm_cmpeq_ps(x, y); }
+    static inline MaskFloat isNaNFloat(const VectorFloat x) { return _mm_cmpunord_ps(x, x); }
+    static inline VectorFloat selectFloat(const MaskFloat mask, const VectorFloat x, const VectorFloat y) { return _mm_blendv_ps(y, x, mask); }
+
+    static inline VectorFloat powerOfTwoFloat(const VectorFloat n)
+    {
+        __m128i bits = _mm_castps_si128(_mm_add_ps(n, _mm_set1_ps(8388735.0f)));
+        return _mm_castsi128_ps(_mm_slli_epi32(bits, 23));
+    }
+
+    static inline VectorFloat exponentOfFloat(const VectorFloat x)
+    {
+        __m128i biasedExponent = _mm_srli_epi32(_mm_castps_si128(x), 23);
+        __m128i bits = _mm_or_si128(biasedExponent, _mm_set1_epi32(0x4B000000));
+        return _mm_sub_ps(_mm_castsi128_ps(bits), _mm_set1_ps(8388608.0f));
+    }
+
+    static inline VectorFloat mantissaOfFloat(const VectorFloat x)
+    {
+        __m128i bits = _mm_and_si128(_mm_castps_si128(x), _mm_set1_epi32(0x007FFFFF));
+        return _mm_castsi128_ps(_mm_or_si128(bits, _mm_set1_epi32(0x3F800000)));
+    }
+
+    static inline VectorDouble accumulateFloatInDouble(const VectorDouble sum, const VectorFloat x)
+    {
+        return _mm_add_pd(_mm_add_pd(sum, _mm_cvtps_pd(x)), _mm_cvtps_pd(_mm_movehl_ps(x, x)));
+    }
+
+
+    #include "VectorKernelsTemplate.h"
+}
+
+#endif
@@ -0,0 +1,392 @@
+#include "WarmStartPrior.h"
+
+
+// WarmStartPrior::WarmStartPrior()
+//
+// PURPOSE:
+//      Constructor. Sets the original prior range and the inner box of each free parameter,
+//      and computes the logarithm of the mixture density inside and outside the inner box.
+//
+// INPUT:
+//      minima:             one-dimensional array containing the minima of the original uniform priors.
+//      maxima:             one-dimensional array containing the maxima of the original uniform priors.
+//      innerMinima:        one-dimensional array containing the minima of the inner boxes.
+//      innerMaxima:        one-dimensional array containing the maxima of the inner boxes.
+//                          The inner boxes are clipped to the original prior ranges.
+//      priorWeight:        the weight of the original uniform prior in the mixture, in (0, 1].
+//
+
+WarmStartPrior::WarmStartPrior(const RefArrayXd minima, const RefArrayXd maxima, const RefArrayXd innerMinima,
+                               const RefArrayXd innerMaxima, const double priorWeight)
+: Prior(minima.size()),
+  minima(minima),
+  maxima(maxima),
+  innerMinima(innerMinima.max(minima)),
+  innerMaxima(innerMaxima.min(maxima)),
+  priorWeight(priorWeight),
+  uniform(0.0, 1.0)
+{
+    if ((maxima.size() != Ndimensions) || (innerMinima.size() != Ndimensions) || (innerMaxima.size() != Ndimensions))
+    {
+        cerr << "Warm-start prior: the prior ranges and the inner boxes do not have the same number of dimensions." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if ((priorWeight <= 0.0) || (priorWeight > 1.0))
+    {
+        cerr << "Warm-start prior: the weight of the original prior must be in (0, 1]." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (((this->innerMaxima - this->innerMinima) <= 0.0).any())
+    {
+        cerr << "Warm-start prior: an inner box does not overlap with its original prior range." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // The density of each parameter is (1 - w)/(inner width) + w/(prior width) inside its inner box,
+    // and w/(prior width) outside it
+
+    ArrayXd priorWidths = maxima - minima;
+    ArrayXd innerWidths = this->innerMaxima - this->innerMinima;
+    logInnerDensity = ((1.0 - priorWeight)/innerWidths + priorWeight/priorWidths).log();
+    logOuterDensity = (priorWeight/priorWidths).log();
+}
+
+
+
+
+
+
+
+
+
+
+// WarmStartPrior::~WarmStartPrior()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+WarmStartPrior::~WarmStartPrior()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// WarmStartPrior::getInnerMinima()
+//
+// PURPOSE:
+//      Gets the minima of the inner boxes, after clipping to the original prior ranges.
+//
+// OUTPUT:
+//      An array containing the minima of the inner boxes.
+//
+
+ArrayXd WarmStartPrior::getInnerMinima()
+{
+    return innerMinima;
+}
+
+
+
+
+
+
+
+
+
+
+// WarmStartPrior::getInnerMaxima()
+//
+// PURPOSE:
+//      Gets the maxima of the inner boxes, after clipping to the original prior ranges.
+//
+// OUTPUT:
+//      An array containing the maxima of the inner boxes.
+//
+
+ArrayXd WarmStartPrior::getInnerMaxima()
+{
+    return innerMaxima;
+}
+
+
+
+
+
+
+
+
+
+
+// WarmStartPrior::logDensityRatio()
+//
+// PURPOSE:
+//      Computes the natural logarithm of the ratio of the original uniform prior to this prior,
+//      which is the importance weight that keeps the evidence computed with this prior
+//      equal to that of the original prior.
+//
+// INPUT:
+//      x:      one-dimensional array containing the free parameters, within the original prior ranges.
+//
+// OUTPUT:
+//      The natural logarithm of the ratio of the two prior densities.
+//
+
+double WarmStartPrior::logDensityRatio(RefArrayXd const x)
+{
+    return -(maxima - minima).log().sum() - logDensity(x, true);
+}
+
+
+
+
+
+
+
+
+
+
+// WarmStartPrior::logDensity()
+//
+// PURPOSE:
+//      Computes the natural logarithm of the prior density, as the product of the mixture densities
+//      of all the free parameters.
+//
+// INPUT:
+//      x:                      one-dimensional array containing the free parameters.
+//      includeConstantTerm:    if true, the density is normalized. If false, the density is relative to
+//                              its maximum, which is reached when all the parameters are in their inner box.
+//
+// OUTPUT:
+//      The natural logarithm of the prior density, or minus infinity outside the original prior ranges.
+//
+
+double WarmStartPrior::logDensity(RefArrayXd const x, const bool includeConstantTerm)
+{
+    if ((x < minima).any() || (x > maxima).any())
+    {
+        return minusInfinity;
+    }
+
+    double logDensityValue = 0.0;
+
+    for (int i = 0; i < Ndimensions; ++i)
+    {
+        bool insideInnerBox = (x(i) >= innerMinima(i)) && (x(i) <= innerMaxima(i));
+        logDensityValue += insideInnerBox ? logInnerDensity(i) : logOuterDensity(i);
+    }
+
+    if (!includeConstantTerm)
+    {
+        logDensityValue -= logInnerDensity.sum();
+    }
+
+    return logDensityValue;
+}
+
+
+
+
+
+
+
+
+
+
+// WarmStartPrior::drawnPointIsAccepted()
+//
+// PURPOSE:
+//      Accepts or rejects a point drawn uniformly by the sampler, with a probability proportional
+//      to the prior density, so that the accepted points are distributed according to this prior.
+//
+// INPUT:
+//      drawnPoint:     one-dimensional array containing the drawn point.
+//
+// OUTPUT:
+//      True if the point is accepted, false otherwise.
+//
+
+bool WarmStartPrior::drawnPointIsAccepted(RefArrayXd const drawnPoint)
+{
+    double logAcceptanceProbability = logDensity(drawnPoint, false);
+
+    if (logAcceptanceProbability == minusInfinity)
+    {
+        return false;
+    }
+
+    return (logAcceptanceProbability >= 0.0) || (log(uniform(engine)) < logAcceptanceProbability);
+}
+
+
+
+
+
+
+
+
+
+
+// WarmStartPrior::draw()
+//
+// PURPOSE:
+//      Draws a sample of points from the prior, by drawing each parameter from its inner box with
+//      probability 1 - w, or from its original prior range with probability w.
+//
+// INPUT:
+//      drawnSample:    two-dimensional array of size (Ndimensions, Npoints) to contain the drawn points.
+//
+// OUTPUT:
+//      void
+//
+
+void WarmStartPrior::draw(RefArrayXXd drawnSample)
+{
+    for (int j = 0; j < drawnSample.cols(); ++j)
+    {
+        for (int i = 0; i < Ndimensions; ++i)
+        {
+            if (uniform(engine) < priorWeight)
+            {
+                drawnSample(i, j) = minima(i) + (maxima(i) - minima(i))*uniform(engine);
+            }
+            else
+            {
+                drawnSample(i, j) = innerMinima(i) + (innerMaxima(i) - innerMinima(i))*uniform(engine);
+            }
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// WarmStartPrior::drawWithConstraint()
+//
+// PURPOSE:
+//      Replaces a point with a new one drawn from the prior, with a likelihood higher than
+//      that of the point to be replaced.
+//
+// INPUT:
+//      drawnPoint:     one-dimensional array containing the point to be replaced, which contains
+//                      the new point on output.
+//      likelihood:     the likelihood function used for the constraint.
+//
+// OUTPUT:
+//      void
+//
+
+void WarmStartPrior::drawWithConstraint(RefArrayXd drawnPoint, Likelihood &likelihood)
+{
+    double logLikelihoodConstraint = likelihood.logValue(drawnPoint);
+    ArrayXXd newPoint(Ndimensions, 1);
+
+    do
+    {
+        draw(newPoint);
+    }
+    while (likelihood.logValue(newPoint.col(0)) <= logLikelihoodConstraint);
+
+    drawnPoint = newPoint.col(0);
+}
+
+
+
+
+
+
+
+
+
+
+// WarmStartPrior::writeHyperParametersToFile()
+//
+// PURPOSE:
+//      Writes the original prior ranges and the inner boxes into an ASCII file, one row for each
+//      free parameter, followed by the weight of the original prior.
+//
+// INPUT:
+//      fullPath:       a string containing the output path prefix of the run.
+//
+// OUTPUT:
+//      void
+//
+
+void WarmStartPrior::writeHyperParametersToFile(string fullPath)
+{
+    ofstream outputFile;
+    File::openOutputFile(outputFile, fullPath + "hyperParametersWarmStart.txt");
+
+    outputFile << "# Hyper parameters of the warm-start prior" << endl;
+    outputFile << "# Column #1: Minimum of the original prior" << endl;
+    outputFile << "# Column #2: Maximum of the original prior" << endl;
+    outputFile << "# Column #3: Minimum of the inner box" << endl;
+    outputFile << "# Column #4: Maximum of the inner box" << endl;
+    outputFile << "# Weight of the original prior: " << priorWeight << endl;
+
+    ArrayXXd hyperParameters(Ndimensions, 4);
+    hyperParameters << minima, maxima, innerMinima, innerMaxima;
+    outputFile << scientific << setprecision(9);
+    File::arrayXXdToFile(outputFile, hyperParameters);
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+// WarmStartPrior::readPosteriorMoments()
+//
+// PURPOSE:
+//      Reads the posterior sample of a previous run, also from the archive of its results (see ArchivedRun),
+//      and computes the posterior mean and standard deviation of each free parameter, weighting each 
+//      sampling point by its posterior probability.
+//
+// INPUT:
+//      runPathPrefix:          a string containing the output path prefix of the previous run.
+//      mean:                   one-dimensional array to contain the posterior means.
+//      standardDeviation:      one-dimensional array to contain the posterior standard deviations.
+//
+// OUTPUT:
+//      void
+//
+
+void WarmStartPrior::readPosteriorMoments(const string runPathPrefix, ArrayXd &mean, ArrayXd &standardDeviation)
+{
+    ArchivedRun archivedRun(runPathPrefix);
+    ArrayXXd sampleColumns = BackgroundResults::readSampleColumns(archivedRun.getPathPrefix());
+    ArrayXXd posteriorSample = sampleColumns.leftCols(sampleColumns.cols() - 3);
+    ArrayXd posteriorProbability = sampleColumns.col(sampleColumns.cols() - 1);
+    double totalProbability = posteriorProbability.sum();
+
+    if ((posteriorSample.rows() == 0) || !(totalProbability > 0.0))
+    {
+        cerr << "Warm-start: the posterior sample with prefix " << runPathPrefix << " is empty." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    ArrayXd weights = posteriorProbability/totalProbability;
+    mean = (posteriorSample.colwise()*weights).colwise().sum().transpose();
+    standardDeviation = ((posteriorSample.rowwise() - mean.transpose()).square().colwise()*weights).colwise().sum().sqrt().transpose();
+}
@@ -0,0 +1,43 @@
+// Tool for extracting the output files of a run from the archive written by the background
+// executable when the option outputArchive is set to zip (see tutorials/README.md).
+// The files are recreated with their original names, as if the run had not been archived.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Source code file "extractResults.cpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ResultsArchive.h"
+
+
+int main(int argc, char *argv[])
+{
+    if ((argc != 2) && (argc != 3))
+    {
+        cerr << "Usage: ./extractResults <archive file> [output directory]" << endl;
+        cerr << "By default the files are extracted in the directory of the archive." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    string archiveFileName(argv[1]);
+    string outputDirectoryName;
+
+    if (argc == 3)
+    {
+        outputDirectoryName = argv[2];
+    }
+    else
+    {
+        size_t separatorPosition = archiveFileName.find_last_of('/');
+        outputDirectoryName = (separatorPosition == string::npos) ? "." : archiveFileName.substr(0, separatorPosition);
+    }
+
+    vector<string> fileNames = ResultsArchive::extractArchive(archiveFileName, outputDirectoryName);
+
+    cout << " Extracted " << fileNames.size() << " files from " << archiveFileName
+         << " into " << outputDirectoryName << endl;
+
+    return EXIT_SUCCESS;
+}
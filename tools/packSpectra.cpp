@@ -0,0 +1,93 @@
+// Tool for packing the datasets of a list of stars into a single spectrum container file,
+// which can be read by the background executable in place of the ASCII file of each star
+// when the option spectrumContainer is set (see tutorials/README.md).
+// Created by agent - October 2026
+// e-mail: agent@local
+// Source code file "packSpectra.cpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <Eigen/Dense>
+#include "File.h"
+#include "SpectrumContainer.h"
+
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        cerr << "Usage: ./packSpectra <output container file> <list of stars>" << endl;
+        cerr << "Each row of the list of stars contains the Catalog ID and the Star ID, e.g. KIC 012008916." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    string containerFileName(argv[1]);
+    string listFileName(argv[2]);
+    unsigned long Nrows;
+    int Ncols;
+
+
+    // Read the local path for the working session, as for the background executable
+
+    ifstream inputFile;
+    File::openInputFile(inputFile, "localPath.txt");
+    File::sniffFile(inputFile, Nrows, Ncols);
+    vector<string> myLocalPath = File::vectorStringFromFile(inputFile, Nrows);
+    inputFile.close();
+
+
+    // Read the list of stars. The dataset of each star is taken from the data folder, and its Nyquist
+    // frequency from the file NyquistFrequency.txt in the results folder of the star.
+
+    File::openInputFile(inputFile, listFileName);
+    File::sniffFile(inputFile, Nrows, Ncols);
+    vector<string> listRows = File::vectorStringFromFile(inputFile, Nrows);
+    inputFile.close();
+
+    vector<string> starIDs;
+    vector<string> spectrumFileNames;
+    vector<double> NyquistFrequencies;
+
+    for (size_t row = 0; row < listRows.size(); ++row)
+    {
+        istringstream rowStream(listRows[row]);
+        string CatalogID;
+        string StarID;
+
+        if (!(rowStream >> CatalogID >> StarID))
+        {
+            cerr << "Row " << row + 1 << " of " << listFileName << " does not contain a Catalog ID and a Star ID." << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        File::openInputFile(inputFile, myLocalPath[0] + "results/" + CatalogID + StarID + "/NyquistFrequency.txt");
+        unsigned long NNyquistRows;
+        File::sniffFile(inputFile, NNyquistRows, Ncols);
+        ArrayXXd NyquistFrequency = File::arrayXXdFromFile(inputFile, NNyquistRows, Ncols);
+        inputFile.close();
+
+        starIDs.push_back(CatalogID + StarID);
+        spectrumFileNames.push_back(myLocalPath[0] + "data/" + CatalogID + StarID + ".txt");
+        NyquistFrequencies.push_back(NyquistFrequency(0, 0));
+    }
+
+    SpectrumContainer::pack(containerFileName, starIDs, spectrumFileNames, NyquistFrequencies);
+
+
+    // Print a summary of the content of the container
+
+    SpectrumContainer container(containerFileName);
+    unsigned long NuniformGrids = 0;
+
+    for (uint64_t entry = 0; entry < container.getNstars(); ++entry)
+    {
+        NuniformGrids += container.getEntry(entry).uniformGrid;
+    }
+
+    cout << " Packed " << container.getNstars() << " stars into " << containerFileName
+         << " (" << NuniformGrids << " with uniformly spaced frequencies)." << endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,190 @@
+// Tool for validating the single-precision evaluation of the background models against
+// the double-precision one, by using the posterior sample of a completed run.
+// The log-likelihood of each sampling point is computed in both precisions, and the 
+// difference in log-evidence is estimated by importance reweighting of the posterior sample.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Source code file "precisionValidation.cpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <Eigen/Dense>
+#include "Functions.h"
+#include "File.h"
+#include "NpyFile.h"
+#include "SpectrumTrimmer.h"
+#include "ExponentialLikelihood.h"
+#include "SinglePrecisionLikelihood.h"
+#include "BackgroundModelRegistry.h"
+
+
+int main(int argc, char *argv[])
+{
+    if (argc != 7)
+    {
+        cerr << "Usage: ./precisionValidation <Catalog ID> <Star ID> <run number> <background model> <low-frequency threshold (uHz)> <high-frequency threshold (uHz)>" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    unsigned long Nrows;
+    int Ncols;
+    string CatalogID(argv[1]);
+    string StarID(argv[2]);
+    string runNumber(argv[3]);
+    string backgroundModelName(argv[4]);
+    double lowFrequencyThreshold = stod(argv[5]);
+    double highFrequencyThreshold = stod(argv[6]);
+
+
+    // Read the local path for the working session and set up the paths
+
+    ifstream inputFile;
+    File::openInputFile(inputFile, "localPath.txt");
+    File::sniffFile(inputFile, Nrows, Ncols);
+    vector<string> myLocalPath = File::vectorStringFromFile(inputFile, Nrows);
+    inputFile.close();
+
+    string inputFileName = myLocalPath[0] + "data/" + CatalogID + StarID + ".txt";
+    string outputDirName = myLocalPath[0] + "results/" + CatalogID + StarID + "/";
+    string outputPathPrefix = outputDirName + runNumber + "/background_";
+
+
+    // Read the dataset and trim it in the same frequency range of the run
+
+    File::openInputFile(inputFile, inputFileName);
+    File::sniffFile(inputFile, Nrows, Ncols);
+    ArrayXXd data = File::arrayXXdFromFile(inputFile, Nrows, Ncols);
+    inputFile.close();
+
+    SpectrumTrimmer trimmer(data.col(0));
+    trimmer.trim(lowFrequencyThreshold, highFrequencyThreshold);
+    ArrayXd covariates = trimmer.getTrimmedView(data.col(0));
+    ArrayXd observations = trimmer.getTrimmedView(data.col(1));
+
+    // Set up the same model and likelihood in double and single precision
+
+    inputFileName = outputDirName + "NyquistFrequency.txt";
+    BackgroundModel *doublePrecisionModel = BackgroundModelRegistry::createModel(backgroundModelName, covariates, inputFileName);
+    BackgroundModel *singlePrecisionModel = BackgroundModelRegistry::createModel(backgroundModelName, covariates, inputFileName);
+
+    if (doublePrecisionModel == nullptr)
+    {
+        cerr << "Background model " << backgroundModelName << " is not implemented." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    singlePrecisionModel->activateSinglePrecision();
+    ArrayXd binWeights;
+    ExponentialLikelihood doublePrecisionLikelihood(observations, *doublePrecisionModel);
+    SinglePrecisionLikelihood singlePrecisionLikelihood(observations, binWeights, *singlePrecisionModel);
+
+
+    // Read the posterior sample of the run, either from the single binary file (npy output format)
+    // or from one ASCII file per free parameter (text output format)
+
+    vector<ArrayXd> parameterSamples;
+    ArrayXd posteriorProbability;
+    ifstream sampleFile((outputPathPrefix + "samples.npy").c_str());
+
+    if (sampleFile.good())
+    {
+        sampleFile.close();
+        ArrayXXd sampleColumns = NpyFile::arrayXXdFromFile(outputPathPrefix + "samples.npy");
+        posteriorProbability = sampleColumns.col(sampleColumns.cols() - 1);
+
+        for (int dimension = 0; dimension < sampleColumns.cols() - 3; ++dimension)
+        {
+            parameterSamples.push_back(sampleColumns.col(dimension));
+        }
+    }
+    else
+    {
+        File::openInputFile(inputFile, outputPathPrefix + "posteriorDistribution.txt");
+        File::sniffFile(inputFile, Nrows, Ncols);
+        posteriorProbability = File::arrayXXdFromFile(inputFile, Nrows, 1);
+        inputFile.close();
+
+        while (true)
+        {
+            ostringstream parameterFileName;
+            parameterFileName << outputPathPrefix << "parameter" << setfill('0') << setw(3) << parameterSamples.size() << ".txt";
+            ifstream parameterFile(parameterFileName.str().c_str());
+
+            if (!parameterFile.good())
+            {
+                break;
+            }
+
+            parameterSamples.push_back(File::arrayXXdFromFile(parameterFile, Nrows, 1));
+            parameterFile.close();
+        }
+    }
+
+    int Nsamples = posteriorProbability.size();
+    int Ndimensions = parameterSamples.size();
+    
+    if (Ndimensions == 0)
+    {
+        cerr << "No posterior sample found with prefix " << outputPathPrefix << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Compute the log-likelihood in both precisions for each sampling point.
+    // The ratio of the evidences is the posterior expectation of the ratio of the likelihoods.
+
+    ArrayXd logLikelihoodDifference(Nsamples);
+    ArrayXd modelParameters(Ndimensions);
+
+    for (int sample = 0; sample < Nsamples; ++sample)
+    {
+        for (int dimension = 0; dimension < Ndimensions; ++dimension)
+        {
+            modelParameters(dimension) = parameterSamples[dimension](sample);
+        }
+
+        logLikelihoodDifference(sample) = singlePrecisionLikelihood.logValue(modelParameters) 
+                                          - doublePrecisionLikelihood.logValue(modelParameters);
+    }
+
+    ArrayXd logPosteriorProbability = (posteriorProbability / posteriorProbability.sum()).log();
+    ArrayXd logTerms = logPosteriorProbability + logLikelihoodDifference;
+    double maxLogTerm = logTerms.maxCoeff();
+    double logEvidenceDifference = maxLogTerm + log((logTerms - maxLogTerm).exp().sum());
+    double meanLogLikelihoodDifference = (logLikelihoodDifference * logPosteriorProbability.exp()).sum();
+    double maxAbsoluteLogLikelihoodDifference = logLikelihoodDifference.abs().maxCoeff();
+
+    
+    // Print the results on the screen and save them in an output ASCII file
+
+    cout << "------------------------------------------------------- " << endl;
+    cout << " Precision validation for " << CatalogID + StarID << " (run " << runNumber << ", " << backgroundModelName << ")" << endl;
+    cout << " Number of bins: " << observations.size() << endl;
+    cout << " Number of sampling points: " << Nsamples << endl;
+    cout << scientific << setprecision(6);
+    cout << " Max |Delta ln(L)|: " << maxAbsoluteLogLikelihoodDifference << endl;
+    cout << " Posterior mean of Delta ln(L): " << meanLogLikelihoodDifference << endl;
+    cout << " Delta ln(Evidence) (single - double): " << logEvidenceDifference << endl;
+    cout << "------------------------------------------------------- " << endl;
+
+    ofstream outputFile;
+    File::openOutputFile(outputFile, outputPathPrefix + "precisionValidation.txt");
+    outputFile << "# Validation of the single-precision evaluation against the double-precision one" << endl;
+    outputFile << "# Row #1: Number of bins" << endl;
+    outputFile << "# Row #2: Number of sampling points" << endl;
+    outputFile << "# Row #3: Maximum absolute difference in log-likelihood" << endl;
+    outputFile << "# Row #4: Posterior mean of the difference in log-likelihood" << endl;
+    outputFile << "# Row #5: Difference in log-evidence (single - double)" << endl;
+    outputFile << observations.size() << endl;
+    outputFile << Nsamples << endl;
+    outputFile << scientific << setprecision(9);
+    outputFile << maxAbsoluteLogLikelihoodDifference << endl;
+    outputFile << meanLogLikelihoodDifference << endl;
+    outputFile << logEvidenceDifference << endl;
+    outputFile.close();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,75 @@
+// Tool for querying the database of results collected by the background executable
+// when the option resultsDatabase is set (see tutorials/README.md).
+// Created by agent - October 2026
+// e-mail: agent@local
+// Source code file "queryResults.cpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ResultsDatabase.h"
+
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        cerr << "Usage: ./queryResults <database file> best" << endl;
+        cerr << "       ./queryResults <database file> runs <Catalog ID + Star ID>" << endl;
+        cerr << "       ./queryResults <database file> parameters <Catalog ID + Star ID> <background model> <run number>" << endl;
+        cerr << "       ./queryResults <database file> sql \"<SQL query>\"" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (!ResultsDatabase::isAvailable())
+    {
+        cerr << "The code was compiled without SQLite support." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    ResultsDatabase resultsDatabase(argv[1]);
+    string queryType(argv[2]);
+    string query;
+    vector<string> values;
+
+    if ((queryType == "best") && (argc == 3))
+    {
+        // Background model with the largest evidence for each star, together with the natural
+        // logarithm of the Bayes' factor with respect to the second best model of the same star
+
+        query = "SELECT star, model, run, logEvidence, "
+                "logEvidence - (SELECT MAX(other.logEvidence) FROM runs AS other "
+                "WHERE other.star = best.star AND other.model != best.model) AS lnBayesFactor "
+                "FROM runs AS best WHERE logEvidence = (SELECT MAX(logEvidence) FROM runs WHERE star = best.star) "
+                "ORDER BY star";
+    }
+    else if ((queryType == "runs") && (argc == 4))
+    {
+        query = "SELECT model, run, logEvidence, logEvidenceError, informationGain, Niterations, computationalTime, "
+                "lowFrequencyThreshold, highFrequencyThreshold, completionTime FROM runs "
+                "WHERE star = ?1 ORDER BY logEvidence DESC";
+        values.push_back(argv[3]);
+    }
+    else if ((queryType == "parameters") && (argc == 6))
+    {
+        query = "SELECT parameter, mean, median, mode, lowerCredibleLimit, upperCredibleLimit FROM parameters "
+                "WHERE star = ?1 AND model = ?2 AND run = ?3 ORDER BY parameter";
+        values.push_back(argv[3]);
+        values.push_back(argv[4]);
+        values.push_back(argv[5]);
+    }
+    else if ((queryType == "sql") && (argc == 4))
+    {
+        query = argv[3];
+    }
+    else
+    {
+        cerr << "Unknown query " << queryType << " or wrong number of arguments." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    resultsDatabase.printQuery(query, values);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,163 @@
+// Tool for running several background models of the same star side by side as an evidence race.
+// One background process is started for each model, and all the processes share the race board
+// of the star, so that the runs whose evidence can no longer reach that of the leader are stopped
+// early (see include/EvidenceRace.h). The evidence race has to be set in the configuring options
+// of each run, with the same race name. The final race board is printed once all the runs have ended.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Source code file "raceModels.cpp"
+
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "File.h"
+#include "BackgroundOptions.h"
+#include "EvidenceRace.h"
+
+
+int main(int argc, char *argv[])
+{
+    if (argc < 9)
+    {
+        cerr << "Usage: ./raceModels <Catalog ID> <Star ID> <input prior base filename> <low-frequency threshold (uHz)> "
+             << "<high-frequency threshold (uHz)> <PCA flag> <background model>:<run number> <background model>:<run number> ..." << endl;
+        cerr << "Each run must set the same evidenceRace in its configuring options." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    string CatalogID(argv[1]);
+    string StarID(argv[2]);
+    unsigned long Nrows;
+    int Ncols;
+
+
+    // Read the local path for the working session, as for the background executable
+
+    ifstream inputFile;
+    File::openInputFile(inputFile, "localPath.txt");
+    File::sniffFile(inputFile, Nrows, Ncols);
+    vector<string> myLocalPath = File::vectorStringFromFile(inputFile, Nrows);
+    inputFile.close();
+
+    string outputDirName = myLocalPath[0] + "results/" + CatalogID + StarID + "/";
+
+
+    // Check that all the runs take part in the same race
+
+    vector<string> backgroundModelNames;
+    vector<string> runNumbers;
+    string evidenceRaceName;
+
+    for (int run = 7; run < argc; ++run)
+    {
+        string runSpecification(argv[run]);
+        size_t separator = runSpecification.find(':');
+
+        if ((separator == string::npos) || (separator == 0) || (separator == runSpecification.size() - 1))
+        {
+            cerr << "Wrong run specification " << runSpecification << ". Use <background model>:<run number>." << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        backgroundModelNames.push_back(runSpecification.substr(0, separator));
+        runNumbers.push_back(runSpecification.substr(separator + 1));
+
+        BackgroundOptions options(outputDirName + "background_configuringOptions_" + runNumbers.back() + ".txt");
+        string runEvidenceRaceName = options.getString("evidenceRace", "");
+
+        if (runEvidenceRaceName.empty() || (!evidenceRaceName.empty() && (runEvidenceRaceName != evidenceRaceName)))
+        {
+            cerr << "Run " << runNumbers.back() << " does not set the same evidenceRace of the other runs "
+                 << "in its configuring options." << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        evidenceRaceName = runEvidenceRaceName;
+    }
+
+
+    // Start a new race, with one background process for each run. The output on the screen
+    // of each process is saved in the output folder of its run.
+
+    string raceBoardName = outputDirName + "background_evidenceRace_" + evidenceRaceName + ".txt";
+    remove(raceBoardName.c_str());
+
+    string executableName = argv[0];
+    size_t lastSlash = executableName.find_last_of('/');
+    executableName = (lastSlash == string::npos) ? "./background" : executableName.substr(0, lastSlash + 1) + "background";
+    vector<pid_t> processes;
+
+    for (size_t run = 0; run < runNumbers.size(); ++run)
+    {
+        string logFileName = outputDirName + runNumbers[run] + "/background_race.log";
+        pid_t process = fork();
+
+        if (process < 0)
+        {
+            cerr << "Error starting the run " << runNumbers[run] << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        if (process == 0)
+        {
+            int logFile = open(logFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+
+            if (logFile >= 0)
+            {
+                dup2(logFile, STDOUT_FILENO);
+                dup2(logFile, STDERR_FILENO);
+                close(logFile);
+            }
+
+            execl(executableName.c_str(), executableName.c_str(), argv[1], argv[2], runNumbers[run].c_str(),
+                  backgroundModelNames[run].c_str(), argv[3], argv[4], argv[5], argv[6], static_cast<char*>(nullptr));
+            cerr << "Error executing " << executableName << endl;
+            _exit(EXIT_FAILURE);
+        }
+
+        processes.push_back(process);
+        cout << " Run " << runNumbers[run] << " (" << backgroundModelNames[run] << ") started, output in " << logFileName << endl;
+    }
+
+    int NfailedRuns = 0;
+
+    for (size_t run = 0; run < processes.size(); ++run)
+    {
+        int status;
+        waitpid(processes[run], &status, 0);
+
+        if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+        {
+            cerr << " Run " << runNumbers[run] << " (" << backgroundModelNames[run] << ") failed." << endl;
+            ++NfailedRuns;
+        }
+    }
+
+
+    // Print the final race board
+
+    vector<EvidenceRace::Entry> board = EvidenceRace::readBoard(raceBoardName);
+
+    cout << endl;
+    cout << " Evidence race " << evidenceRaceName << " of " << CatalogID + StarID << endl;
+    cout << setw(6) << "Run" << setw(32) << "Model" << setw(10) << "Status" << setw(18) << "log(Evidence)"
+         << setw(12) << "Iterations" << endl;
+
+    for (size_t entry = 0; entry < board.size(); ++entry)
+    {
+        double logEvidence = (board[entry].status == "aborted") ? board[entry].upperLogEvidence : board[entry].lowerLogEvidence;
+
+        cout << setw(6) << board[entry].runNumber << setw(32) << board[entry].backgroundModelName << setw(10)
+             << board[entry].status << setw(18) << fixed << setprecision(3) << logEvidence
+             << setw(12) << board[entry].Niterations << (board[entry].status == "aborted" ? "  (upper bound)" : "") << endl;
+    }
+
+    return (NfailedRuns == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
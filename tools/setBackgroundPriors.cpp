@@ -0,0 +1,84 @@
+// Tool for writing the files of the prior boundaries and of the configuring parameters of a star,
+// as done by the routine set_background_priors of tutorials/background.py, from a raw guess of nuMax.
+// The same priors are built by the background executable when the input prior base filename
+// is given as auto:<nuMax> (see tutorials/README.md), in which case these files are not needed.
+// Created by agent - October 2026
+// e-mail: agent@local
+// Source code file "setBackgroundPriors.cpp"
+
+#include <cstdlib>
+#include <cerrno>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <Eigen/Dense>
+#include <sys/stat.h>
+#include "File.h"
+#include "BackgroundPriorMaker.h"
+
+
+int main(int argc, char *argv[])
+{
+    if ((argc != 5) && (argc != 6))
+    {
+        cerr << "Usage: ./setBackgroundPriors <Catalog ID> <Star ID> <nuMax (uHz)> <background model> [run number]" << endl;
+        cerr << "By default the prior boundaries are written for the run number 00." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    string CatalogID(argv[1]);
+    string StarID(argv[2]);
+    double nuMax = stod(argv[3]);
+    string backgroundModelName(argv[4]);
+    string runNumber = (argc == 6) ? argv[5] : "00";
+    unsigned long Nrows;
+    int Ncols;
+
+
+    // Read the local path for the working session, as for the background executable
+
+    ifstream inputFile;
+    File::openInputFile(inputFile, "localPath.txt");
+    File::sniffFile(inputFile, Nrows, Ncols);
+    vector<string> myLocalPath = File::vectorStringFromFile(inputFile, Nrows);
+    inputFile.close();
+
+
+    // Read the whole dataset of the star
+
+    string inputFileName = myLocalPath[0] + "data/" + CatalogID + StarID + ".txt";
+    File::openInputFile(inputFile, inputFileName);
+    File::sniffFile(inputFile, Nrows, Ncols);
+    ArrayXXd data = File::arrayXXdFromFile(inputFile, Nrows, Ncols);
+    inputFile.close();
+
+    string outputDirName = myLocalPath[0] + "results/" + CatalogID + StarID + "/";
+
+    if ((mkdir(outputDirName.c_str(), 0777) != 0) && (errno != EEXIST))
+    {
+        cerr << "Error creating the results directory " << outputDirName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    cout << " Creating Background priors for " << CatalogID + StarID << endl;
+
+    BackgroundPriorMaker priorMaker(data.col(0), data.col(1), nuMax);
+    priorMaker.writeBoundariesToFile(outputDirName + "background_hyperParameters_" + runNumber + ".txt", backgroundModelName);
+    BackgroundPriorMaker::writeConfiguringParametersToFile(outputDirName + "NSMC_configuringParameters.txt",
+                                                           BackgroundPriorMaker::getNSMCconfiguringParameters(), 1);
+    BackgroundPriorMaker::writeConfiguringParametersToFile(outputDirName + "Xmeans_configuringParameters.txt",
+                                                           BackgroundPriorMaker::getXmeansConfiguringParameters(), 0);
+
+
+    // The Nyquist frequency is set to the largest frequency of the dataset, as in the python routine
+
+    ofstream outputFile;
+    File::openOutputFile(outputFile, outputDirName + "NyquistFrequency.txt");
+    outputFile << BackgroundPriorMaker::formatShortest(data.col(0).maxCoeff());
+    outputFile.close();
+
+    cout << " Prior boundaries of the " << backgroundModelName << " model written in "
+         << outputDirName + "background_hyperParameters_" + runNumber + ".txt" << endl;
+
+    return EXIT_SUCCESS;
+}
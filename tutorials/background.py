@@ -8,7 +8,7 @@
  #   bkg.set_background_priors('KIC','012008916',162,'ThreeHarvey’,0)       # To generate priors and configuring parameters to run the background fit
  # ------------------------------------------------------------------------------------------------------
 
-import numpy as np, matplotlib.pyplot as plt, glob, os
+import numpy as np, matplotlib.pyplot as plt, glob, os, io, zipfile
 from matplotlib.backends.backend_pdf import PdfPages
 import matplotlib as mpl
 pi=np.pi
@@ -151,14 +151,14 @@ def get_prior_parameters(results_dir):
     Note: the prior type can be 0 = Uniform, 1 = Normal, 2 = Super Gaussian, 3 = Grid Uniform. This is set to 0 by default.
     """
     
-    if not os.path.isfile(results_dir + prefix + 'hyperParameters.txt'):
-        hyperpar1, hyperpar2 = np.loadtxt(results_dir + prefix + 'hyperParametersUniform.txt',unpack=True,comments='#',usecols=(0,1))
+    if not result_file_exists(results_dir,'hyperParameters.txt'):
+        hyperpar1, hyperpar2 = np.loadtxt(open_result_file(results_dir,'hyperParametersUniform.txt'),unpack=True,comments='#',usecols=(0,1))
         n_param = hyperpar1.size
         hyperpar3 = np.zeros(hyperpar1.size)
         hyperpar4 = np.zeros(hyperpar1.size)
         prior_type = np.zeros(n_param)
     else:
-        hyperpar1, hyperpar2, hyperpar3, hyperpar4, prior_type = np.loadtxt(results_dir + prefix + 'hyperParameters.txt',unpack=True, comments='#',usecols=(0,1,2,3,4))
+        hyperpar1, hyperpar2, hyperpar3, hyperpar4, prior_type = np.loadtxt(open_result_file(results_dir,'hyperParameters.txt'),unpack=True, comments='#',usecols=(0,1,2,3,4))
         n_param = hyperpar1.size
 
     log_density = np.zeros(n_param)
@@ -280,7 +280,7 @@ def get_background_name(catalog_id,star_id,results_dir):
 
     """
 
-    config = np.loadtxt(results_dir + prefix + 'computationParameters.txt',unpack=True,dtype=str)
+    config = np.loadtxt(open_result_file(results_dir,'computationParameters.txt'),unpack=True,dtype=str)
     bg_name = config[-2]
 
     print(' ----------------------------------------------------------------- ')
@@ -289,6 +289,190 @@ def get_background_name(catalog_id,star_id,results_dir):
     return bg_name
 
 
+def read_results_archive(results_dir):
+    """
+    Authors: agent
+    email: agent@local
+    Created: 19 Oct 2026
+
+    This method opens the archive containing all the output files of a run, as written by Background when 
+    the option outputArchive is set to zip. It returns None if the output files of the run are not archived.
+
+    :param results_dir: the output directory where the files generated by DIAMONDS are stored
+    :type results_dir: str
+
+    """
+
+    filename = results_dir + prefix + 'results.zip'
+    if os.path.isfile(filename):
+        return zipfile.ZipFile(filename)
+    return None
+
+
+def result_file_exists(results_dir,filename):
+    """
+    Authors: agent
+    email: agent@local
+    Created: 19 Oct 2026
+
+    This method checks whether an output file of a run is available, either in the output directory or 
+    in the archive of the run.
+
+    :param results_dir: the output directory where the files generated by DIAMONDS are stored
+    :type results_dir: str
+
+    :param filename: the name of the output file, without the prefix of the Background files
+    :type filename: str
+
+    """
+
+    if os.path.isfile(results_dir + prefix + filename):
+        return True
+    archive = read_results_archive(results_dir)
+    return (archive is not None) and (prefix + filename in archive.namelist())
+
+
+def open_result_file(results_dir,filename):
+    """
+    Authors: agent
+    email: agent@local
+    Created: 19 Oct 2026
+
+    This method provides an output file of a run to the numpy readers, either as the path of the file in the 
+    output directory or, if the output files of the run are archived, as a file object with the content 
+    extracted from the archive.
+
+    :param results_dir: the output directory where the files generated by DIAMONDS are stored
+    :type results_dir: str
+
+    :param filename: the name of the output file, without the prefix of the Background files
+    :type filename: str
+
+    """
+
+    if os.path.isfile(results_dir + prefix + filename):
+        return results_dir + prefix + filename
+    archive = read_results_archive(results_dir)
+    if archive is not None and prefix + filename in archive.namelist():
+        content = archive.read(prefix + filename)
+        if filename.endswith('.npy') or filename.endswith('.npz'):
+            return io.BytesIO(content)
+        return io.StringIO(content.decode('ascii'))
+    return results_dir + prefix + filename
+
+
+def read_sample_columns(results_dir):
+    """
+    Authors: agent
+    email: agent@local
+    Created: 19 Oct 2026
+
+    This method loads the binary file containing all the quantities of the posterior sample, as written by
+    Background when the option outputFormat is set to npy. The file is memory-mapped, so that only the columns 
+    actually used are read from disk. The columns are the free parameters, followed by the natural logarithm 
+    of the likelihood, the natural logarithm of the weight, and the posterior probability.
+    If the output files of the run are archived, the file is read from the archive instead.
+    It returns None if the run produced the ASCII files instead.
+
+    :param results_dir: the output directory where the files generated by DIAMONDS are stored
+    :type results_dir: str
+
+    """
+
+    filename = results_dir + prefix + 'samples.npy'
+    if os.path.isfile(filename):
+        return np.load(filename,mmap_mode='r')
+    if result_file_exists(results_dir,'samples.npy'):
+        return np.load(open_result_file(results_dir,'samples.npy'))
+    return None
+
+
+def read_predictive_bands(results_dir):
+    """
+    Authors: agent
+    email: agent@local
+    Created: 19 Oct 2026
+
+    This method loads the posterior-predictive bands of a run, as computed by Background when the option 
+    NpredictiveDraws is larger than 0. It returns a dictionary containing the array frequency and, for each 
+    curve (total, background and each component of the background model), an array with the median, the lower 
+    and the upper limit of the credible band in its three columns. It returns None if the bands were not computed.
+
+    :param results_dir: the output directory where the files generated by DIAMONDS are stored
+    :type results_dir: str
+
+    """
+
+    if not result_file_exists(results_dir,'predictiveBands.npz'):
+        return None
+    with np.load(open_result_file(results_dir,'predictiveBands.npz')) as bands:
+        return {name: bands[name] for name in bands.files}
+
+
+def get_number_of_parameters(results_dir):
+    """
+    Authors: agent
+    email: agent@local
+    Created: 19 Oct 2026
+
+    This method obtains the number of free parameters of the fit, from either the binary or the ASCII output files.
+
+    :param results_dir: the output directory where the files generated by DIAMONDS are stored
+    :type results_dir: str
+
+    """
+
+    columns = read_sample_columns(results_dir)
+    if columns is not None:
+        return columns.shape[1] - 3
+    n_param = np.sort(glob.glob(results_dir + prefix + 'parameter0*.txt')).size
+    archive = read_results_archive(results_dir)
+    if n_param == 0 and archive is not None:
+        n_param = len([name for name in archive.namelist() if name.startswith(prefix + 'parameter0') and name.endswith('.txt')])
+    return n_param
+
+
+def read_parameter_sampling(results_dir,parameter):
+    """
+    Authors: agent
+    email: agent@local
+    Created: 19 Oct 2026
+
+    This method reads the nested sampling of one free parameter, from either the binary or the ASCII output files.
+
+    :param results_dir: the output directory where the files generated by DIAMONDS are stored
+    :type results_dir: str
+
+    :param parameter: the number of the free parameter, starting from 0
+    :type parameter: int
+
+    """
+
+    columns = read_sample_columns(results_dir)
+    if columns is not None:
+        return np.array(columns[:,parameter])
+    return np.loadtxt(open_result_file(results_dir,'parameter' + str(parameter).zfill(3) + '.txt'))
+
+
+def read_posterior_distribution(results_dir):
+    """
+    Authors: agent
+    email: agent@local
+    Created: 19 Oct 2026
+
+    This method reads the posterior probability of each sampling point, from either the binary or the ASCII output files.
+
+    :param results_dir: the output directory where the files generated by DIAMONDS are stored
+    :type results_dir: str
+
+    """
+
+    columns = read_sample_columns(results_dir)
+    if columns is not None:
+        return np.array(columns[:,-1])
+    return np.loadtxt(open_result_file(results_dir,'posteriorDistribution.txt'))
+
+
 def get_background_params(catalog_id,star_id,results_dir):
     """
     Authors: Jean McKeever, Enrico Corsaro
@@ -313,13 +497,12 @@ def get_background_params(catalog_id,star_id,results_dir):
 
     """
 
-    if not os.path.isfile(results_dir + prefix + 'parameterSummary.txt'):
+    if not result_file_exists(results_dir,'parameterSummary.txt'):
         print(' Background fit did not produce Summary file.\n Using sampling evolution and posterior values to compute results.\n')
-        filename_summary = np.sort(glob.glob(results_dir + prefix + 'parameter0*.txt'))
-        n_param = filename_summary.size
+        n_param = get_number_of_parameters(results_dir)
         params = np.zeros(n_param)
         lower_error = np.zeros(n_param)
-        posterior = np.loadtxt(results_dir + prefix + 'posteriorDistribution.txt')
+        posterior = read_posterior_distribution(results_dir)
         posterior /= posterior.max()
 
         for par in range(0,n_param):
@@ -328,14 +511,14 @@ def get_background_params(catalog_id,star_id,results_dir):
             else:
                 parstr = str(par)
 
-            par_sampling = np.loadtxt(results_dir + prefix + 'parameter0' + parstr + '.txt')
+            par_sampling = read_parameter_sampling(results_dir,par)
             params[par] = ((posterior*par_sampling).sum())/posterior.sum()
             lower_error[par] = ((np.square(par_sampling - params[par])*posterior).sum())/posterior.sum()
     
         upper_error = lower_error
 
     else:
-        params,lowerpar,upperpar = np.loadtxt(results_dir + prefix + 'parameterSummary.txt',unpack=True,usecols=(1,4,5))   # Median value of the free parameter
+        params,lowerpar,upperpar = np.loadtxt(open_result_file(results_dir,'parameterSummary.txt'),unpack=True,usecols=(1,4,5))   # Median value of the free parameter
         lower_error = params - lowerpar
         upper_error = upperpar - params
 
@@ -608,6 +791,11 @@ def background_plot(catalog_id,star_id,subdir,root_path=None,params=None,save_bk
     plt.plot(freq,w,'y-.',lw=2)
     plt.plot(freq,b1,'r-',lw=3)
     plt.plot(freq,b2,'g--',lw=2)
+
+    bands = read_predictive_bands(results_dir)
+    if bands is not None:
+        plt.fill_between(bands['frequency'],bands['background'][:,1],bands['background'][:,2],color='r',alpha=0.3,lw=0)
+        plt.fill_between(bands['frequency'],bands['total'][:,1],bands['total'][:,2],color='g',alpha=0.3,lw=0)
     plt.subplots_adjust(left=.12,right=.97,top=.94,bottom=.2)
     
     plt.text(.1,.075,'%s%s'% (catalog_id,star_id), size='xx-large', transform=ax1.transAxes)
@@ -753,18 +941,17 @@ def background_mpd(catalog_id,star_id,subdir,root_path=None,x_label_rotation=0,f
 
     hyperpar1,hyperpar2,hyperpar3,hyperpar4,prior_type,log_density = get_prior_parameters(results_dir)
 
-    if not os.path.isfile(results_dir + prefix + 'parameterSummary.txt'):
+    if not result_file_exists(results_dir,'parameterSummary.txt'):
         print(" No marginal probability distributions are available.\n Using sampling evolution to plot standard histograms for each parameter.\n") 
         
-        filename_summary = np.sort(glob.glob(results_dir + prefix + 'parameter0*.txt'))
-        n_param = filename_summary.size
+        n_param = get_number_of_parameters(results_dir)
 
         pdf = PdfPages(star_dir + catalog_id + star_id + '_' + subdir + '_ParameterHistograms.pdf')
         plt.ion()
         fig = plt.figure(3,figsize=(11,7))
         plt.clf()
 
-        posterior = np.loadtxt(results_dir + prefix + 'posteriorDistribution.txt')
+        posterior = read_posterior_distribution(results_dir)
         
         for parnumb in range(0,n_param):
             if parnumb < 10:
@@ -774,7 +961,7 @@ def background_mpd(catalog_id,star_id,subdir,root_path=None,x_label_rotation=0,f
 
             hyperpars = [hyperpar1[parnumb],hyperpar2[parnumb],hyperpar3[parnumb],hyperpar4[parnumb]]
             
-            par = np.loadtxt(results_dir + prefix + 'parameter0' + parstr + '.txt')
+            par = read_parameter_sampling(results_dir,parnumb)
             
             plt.subplot(4,3,parnumb+1)
             
@@ -800,7 +987,7 @@ def background_mpd(catalog_id,star_id,subdir,root_path=None,x_label_rotation=0,f
         pdf.savefig()
         pdf.close()
     else:
-        medianpar,lowerpar,upperpar = np.loadtxt(results_dir + prefix + 'parameterSummary.txt',unpack=True,usecols=(1,4,5))
+        medianpar,lowerpar,upperpar = np.loadtxt(open_result_file(results_dir,'parameterSummary.txt'),unpack=True,usecols=(1,4,5))
 
         pdf = PdfPages(star_dir + catalog_id + star_id + '_' + subdir + '_MarginalDistributions.pdf')
         plt.ion()
@@ -817,10 +1004,10 @@ def background_mpd(catalog_id,star_id,subdir,root_path=None,x_label_rotation=0,f
             
             hyperpars = [hyperpar1[parnumb],hyperpar2[parnumb],hyperpar3[parnumb],hyperpar4[parnumb]]
         
-            if not os.path.isfile(results_dir + prefix + 'marginalDistribution0' + parstr + '.txt'):
+            if not result_file_exists(results_dir,'marginalDistribution0' + parstr + '.txt'):
                 print(" No marginal probability distribution produced for the parameter {} ({}).\n Plotting a standard histogram instead.".format('0'+ parstr, terminal_labels[parnumb]))
-                par = np.loadtxt(results_dir + prefix + 'parameter0' + parstr + '.txt')
-                posterior = np.loadtxt(results_dir + prefix + 'posteriorDistribution.txt')
+                par = read_parameter_sampling(results_dir,parnumb)
+                posterior = read_posterior_distribution(results_dir)
                 binwidth = 50
                 hist_y, hist_x, _ = plt.hist(par,weights=posterior,bins=binwidth,color='limegreen',alpha=.0,edgecolor='black')
                 
@@ -835,7 +1022,7 @@ def background_mpd(catalog_id,star_id,subdir,root_path=None,x_label_rotation=0,f
                 plt.ylabel('Counts',fontsize='small')
                 plt.vlines(params[parnumb],0,hist_y.max(),lw=1,color='k',linestyle='--')
             else:
-                par,marg = np.loadtxt(results_dir + prefix + 'marginalDistribution0' + parstr + '.txt',unpack=True)
+                par,marg = np.loadtxt(open_result_file(results_dir,'marginalDistribution0' + parstr + '.txt'),unpack=True)
                 
                 amplitude = np.max(marg)*.57
                 prior_pdf = prepare_prior_distribution(hyperpars,prior_type[parnumb],par,amplitude)
@@ -902,7 +1089,7 @@ def single_parameter_evolution(catalog_id,star_id,subdir,parameter,root_path=Non
         parstr = '0' + str(parameter)
     else:
         parstr = str(parameter)
-    sampling = np.loadtxt(results_dir + prefix + 'parameter0' + parstr + '.txt',unpack=True)
+    sampling = read_parameter_sampling(results_dir,parameter)
 
     plt.ion()
     fig = plt.figure(4,figsize=(11,4))
@@ -944,8 +1131,7 @@ def parameter_evolution(catalog_id,star_id,subdir,root_path=None):
     """
 
     data_dir,star_dir,results_dir = get_working_paths(catalog_id,star_id,subdir,root_path)
-    filename_summary = np.sort(glob.glob(results_dir + prefix + 'parameter0*.txt'))
-    n_param = filename_summary.size
+    n_param = get_number_of_parameters(results_dir)
    
     plt.ion()
     fig = plt.figure(5,figsize=(11,7))
@@ -957,7 +1143,7 @@ def parameter_evolution(catalog_id,star_id,subdir,root_path=None):
         else:
             parstr = str(parnumb)
 
-        sampling = np.loadtxt(results_dir + prefix + 'parameter0' + parstr + '.txt',unpack=True)
+        sampling = read_parameter_sampling(results_dir,parnumb)
         plt.subplot(4,3,parnumb+1)
         plt.xlim(0,sampling.size)
         plt.ylim(np.min(sampling),np.max(sampling))